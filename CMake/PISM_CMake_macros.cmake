@@ -164,6 +164,8 @@ macro(pism_find_prerequisites)
   find_package (NetCDF REQUIRED)
   find_package (FFTW REQUIRED)
   find_package (HDF5 COMPONENTS C HL)
+  # used to copy staged backups in the background
+  find_package (Threads REQUIRED)
 
   # Optional libraries
   if (Pism_USE_PNETCDF)
@@ -242,7 +244,8 @@ macro(pism_set_dependencies)
     ${NETCDF_LIBRARIES}
     ${MPI_C_LIBRARIES}
     ${HDF5_LIBRARIES}
-    ${HDF5_HL_LIBRARIES})
+    ${HDF5_HL_LIBRARIES}
+    ${CMAKE_THREAD_LIBS_INIT})
 
   # optional libraries
   if (Pism_USE_JANSSON)
@@ -302,6 +305,23 @@ macro(pism_check_petsc_scalar_type)
   endif()
 endmacro()
 
+# Check if the NetCDF library provides nc_open_mem() (NetCDF 4.4.0 and later), used to
+# read small input files into memory.
+macro(pism_check_netcdf_open_mem)
+  include(CheckSymbolExists)
+
+  set(CMAKE_REQUIRED_INCLUDES ${NETCDF_INCLUDES})
+  set(CMAKE_REQUIRED_LIBRARIES ${Pism_EXTERNAL_LIBS})
+  check_symbol_exists(nc_open_mem "netcdf.h;netcdf_mem.h" Pism_HAVE_NC_OPEN_MEM)
+  unset(CMAKE_REQUIRED_INCLUDES)
+  unset(CMAKE_REQUIRED_LIBRARIES)
+
+  if (NOT Pism_HAVE_NC_OPEN_MEM)
+    message(STATUS
+      "The NetCDF library does not support nc_open_mem(): input.in_memory_size_limit is ignored.")
+  endif()
+endmacro()
+
 # Create a list of subdirectories.
 # See https://stackoverflow.com/questions/7787823/cmake-how-to-get-the-name-of-all-subdirectories-of-a-directory
 MACRO(SUBDIRLIST result curdir)
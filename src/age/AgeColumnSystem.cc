@@ -1,4 +1,4 @@
-/* Copyright (C) 2016, 2017 PISM Authors
+/* Copyright (C) 2016, 2017, 2020 PISM Authors
  *
  * This file is part of PISM.
  *
@@ -74,11 +74,11 @@ void AgeColumnSystem::solve(std::vector<double> &x) {
   for (unsigned int k = 0; k < m_ks; k++) {
     // do lowest-order upwinding, explicitly for horizontal
     S.RHS(k) =  (m_u[k] < 0 ?
-                 m_u[k] * (m_A_e[k] -  m_A[k]) / m_dx :
-                 m_u[k] * (m_A[k]  - m_A_w[k]) / m_dx);
+                 m_u[k] * (m_A_e[k] -  m_A[k]) / m_dx_e :
+                 m_u[k] * (m_A[k]  - m_A_w[k]) / m_dx_w);
     S.RHS(k) += (m_v[k] < 0 ?
-                 m_v[k] * (m_A_n[k] -  m_A[k]) / m_dy :
-                 m_v[k] * (m_A[k]  - m_A_s[k]) / m_dy);
+                 m_v[k] * (m_A_n[k] -  m_A[k]) / m_dy_n :
+                 m_v[k] * (m_A[k]  - m_A_s[k]) / m_dy_s);
     // note it is the age eqn: dage/dt = 1.0 and we have moved the hor.
     //   advection terms over to right:
     S.RHS(k) = m_A[k] + m_dt * (1.0 - S.RHS(k));
@@ -1,4 +1,4 @@
-// Copyright (C) 2004-2017, 2019 Jed Brown, Ed Bueler, and Constantine Khroulev
+// Copyright (C) 2004-2017, 2019, 2020 Jed Brown, Ed Bueler, and Constantine Khroulev
 //
 // This file is part of PISM.
 //
@@ -72,6 +72,38 @@ void IceBasalResistancePlasticLaw::drag_with_derivative(double tauc, double vx,
   }
 }
 
+//! Compute drag coefficients at `n` points.
+void IceBasalResistancePlasticLaw::drag(unsigned int n, const double *tauc,
+                                        const Vector2 *velocity, double *result) const {
+  const double eps2 = square(m_plastic_regularize);
+
+  for (unsigned int k = 0; k < n; ++k) {
+    result[k] = tauc[k] / sqrt(eps2 + square(velocity[k].u) + square(velocity[k].v));
+  }
+}
+
+//! Compute drag coefficients and their derivatives at `n` points.
+/*!
+ * `dbeta` may be NULL.
+ */
+void IceBasalResistancePlasticLaw::drag_with_derivative(unsigned int n, const double *tauc,
+                                                        const Vector2 *velocity,
+                                                        double *beta, double *dbeta) const {
+  if (dbeta == nullptr) {
+    drag(n, tauc, velocity, beta);
+    return;
+  }
+
+  const double eps2 = square(m_plastic_regularize);
+
+  for (unsigned int k = 0; k < n; ++k) {
+    const double magreg2 = eps2 + square(velocity[k].u) + square(velocity[k].v);
+
+    beta[k]  = tauc[k] / sqrt(magreg2);
+    dbeta[k] = -1 * beta[k] / magreg2;
+  }
+}
+
 /* Pseudo-plastic */
 
 IceBasalResistancePseudoPlasticLaw::IceBasalResistancePseudoPlasticLaw(const Config &config)
@@ -79,6 +111,12 @@ IceBasalResistancePseudoPlasticLaw::IceBasalResistancePseudoPlasticLaw(const Con
   m_pseudo_q = config.get_number("basal_resistance.pseudo_plastic.q");
   m_pseudo_u_threshold = config.get_number("basal_resistance.pseudo_plastic.u_threshold", "m second-1");
   m_sliding_scale_factor_reduces_tauc = config.get_number("basal_resistance.pseudo_plastic.sliding_scale_factor");
+
+  m_Aq = 1.0;
+  if (m_sliding_scale_factor_reduces_tauc > 0.0) {
+    m_Aq = pow(m_sliding_scale_factor_reduces_tauc, m_pseudo_q);
+  }
+  m_u_threshold_factor = pow(m_pseudo_u_threshold, -m_pseudo_q);
 }
 
 IceBasalResistancePseudoPlasticLaw::~IceBasalResistancePseudoPlasticLaw() {
@@ -159,12 +197,7 @@ void IceBasalResistancePseudoPlasticLaw::print_info(const Logger &log,
 double IceBasalResistancePseudoPlasticLaw::drag(double tauc, double vx, double vy) const {
   const double magreg2 = square(m_plastic_regularize) + square(vx) + square(vy);
 
-  if (m_sliding_scale_factor_reduces_tauc > 0.0) {
-    double Aq = pow(m_sliding_scale_factor_reduces_tauc, m_pseudo_q);
-    return (tauc / Aq) * pow(magreg2, 0.5*(m_pseudo_q - 1)) * pow(m_pseudo_u_threshold, -m_pseudo_q);
-  } else {
-    return tauc * pow(magreg2, 0.5*(m_pseudo_q - 1)) * pow(m_pseudo_u_threshold, -m_pseudo_q);
-  }
+  return (tauc / m_Aq) * pow(magreg2, 0.5*(m_pseudo_q - 1)) * m_u_threshold_factor;
 }
 
 
@@ -181,12 +214,7 @@ void IceBasalResistancePseudoPlasticLaw::drag_with_derivative(double tauc, doubl
 {
   const double magreg2 = square(m_plastic_regularize) + square(vx) + square(vy);
 
-  if (m_sliding_scale_factor_reduces_tauc > 0.0) {
-    double Aq = pow(m_sliding_scale_factor_reduces_tauc, m_pseudo_q);
-    *beta = (tauc / Aq) * pow(magreg2, 0.5*(m_pseudo_q - 1)) * pow(m_pseudo_u_threshold, -m_pseudo_q);
-  } else {
-    *beta =  tauc * pow(magreg2, 0.5*(m_pseudo_q - 1)) * pow(m_pseudo_u_threshold, -m_pseudo_q);
-  }
+  *beta = (tauc / m_Aq) * pow(magreg2, 0.5*(m_pseudo_q - 1)) * m_u_threshold_factor;
 
   if (dbeta) {
     *dbeta = (m_pseudo_q - 1) * (*beta) / magreg2;
@@ -194,4 +222,61 @@ void IceBasalResistancePseudoPlasticLaw::drag_with_derivative(double tauc, doubl
 
 }
 
+//! Compute drag coefficients at `n` points.
+/*!
+ * Avoids calling `pow()` in the linear (@f$ q = 1 @f$) and purely plastic (@f$ q = 0 @f$)
+ * cases.
+ */
+void IceBasalResistancePseudoPlasticLaw::drag(unsigned int n, const double *tauc,
+                                              const Vector2 *velocity,
+                                              double *result) const {
+  const double
+    eps2     = square(m_plastic_regularize),
+    exponent = 0.5 * (m_pseudo_q - 1),
+    C        = m_u_threshold_factor;
+
+  if (m_pseudo_q == 1.0) {
+    for (unsigned int k = 0; k < n; ++k) {
+      result[k] = (tauc[k] / m_Aq) * C;
+    }
+  } else if (m_pseudo_q == 0.0) {
+    for (unsigned int k = 0; k < n; ++k) {
+      const double magreg2 = eps2 + square(velocity[k].u) + square(velocity[k].v);
+      result[k] = (tauc[k] / m_Aq) / sqrt(magreg2) * C;
+    }
+  } else {
+    for (unsigned int k = 0; k < n; ++k) {
+      const double magreg2 = eps2 + square(velocity[k].u) + square(velocity[k].v);
+      result[k] = (tauc[k] / m_Aq) * pow(magreg2, exponent) * C;
+    }
+  }
+}
+
+//! Compute drag coefficients and their derivatives at `n` points.
+/*!
+ * `dbeta` may be NULL.
+ */
+void IceBasalResistancePseudoPlasticLaw::drag_with_derivative(unsigned int n, const double *tauc,
+                                                              const Vector2 *velocity,
+                                                              double *beta, double *dbeta) const {
+  drag(n, tauc, velocity, beta);
+
+  if (dbeta == nullptr) {
+    return;
+  }
+
+  if (m_pseudo_q == 1.0) {
+    for (unsigned int k = 0; k < n; ++k) {
+      dbeta[k] = 0.0;
+    }
+  } else {
+    const double eps2 = square(m_plastic_regularize);
+
+    for (unsigned int k = 0; k < n; ++k) {
+      const double magreg2 = eps2 + square(velocity[k].u) + square(velocity[k].v);
+      dbeta[k] = (m_pseudo_q - 1) * beta[k] / magreg2;
+    }
+  }
+}
+
 } // end of namespace pism
@@ -1,4 +1,4 @@
-// Copyright (C) 2004-2015, 2017, 2019 Jed Brown, Ed Bueler, and Constantine Khroulev
+// Copyright (C) 2004-2015, 2017, 2019, 2020 Jed Brown, Ed Bueler, and Constantine Khroulev
 //
 // This file is part of PISM.
 //
@@ -20,6 +20,7 @@
 #define __basal_resistance_hh
 
 #include "pism/util/Units.hh"
+#include "pism/util/Vector2.hh"
 
 namespace pism {
 
@@ -30,6 +31,9 @@ class Logger;
 /*!
   This *pseudo* -plastic type can actually describe anything from linearly
   viscous till to purely plastic till.
+
+  Methods taking arrays evaluate the law at `n` points using one virtual call. Use them
+  in loops over grid rows and quadrature points.
 */
 class IceBasalResistancePlasticLaw {
 public:
@@ -39,6 +43,12 @@ public:
   virtual double drag(double tauc, double vx, double vy) const;
   virtual void drag_with_derivative(double tauc, double vx, double vy,
                                     double *drag, double *ddrag) const;
+
+  virtual void drag(unsigned int n, const double *tauc, const Vector2 *velocity,
+                    double *result) const;
+  virtual void drag_with_derivative(unsigned int n, const double *tauc,
+                                    const Vector2 *velocity,
+                                    double *drag, double *ddrag) const;
 protected:
   double m_plastic_regularize;
 };
@@ -51,8 +61,20 @@ public:
   virtual double drag(double tauc, double vx, double vy) const;
   virtual void drag_with_derivative(double tauc, double vx, double vy,
                                     double *drag, double *ddrag) const;
+
+  virtual void drag(unsigned int n, const double *tauc, const Vector2 *velocity,
+                    double *result) const;
+  virtual void drag_with_derivative(unsigned int n, const double *tauc,
+                                    const Vector2 *velocity,
+                                    double *drag, double *ddrag) const;
 protected:
   double m_pseudo_q, m_pseudo_u_threshold, m_sliding_scale_factor_reduces_tauc;
+
+  // constants computed in the constructor:
+  //! `sliding_scale_factor^q` (1 if the scale factor is not used)
+  double m_Aq;
+  //! `u_threshold^(-q)`
+  double m_u_threshold_factor;
 };
 
 } // end of namespace pism
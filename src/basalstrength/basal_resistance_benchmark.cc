@@ -0,0 +1,157 @@
+/* Copyright (C) 2020 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+static char help[] =
+  "Measures throughput of basal resistance laws (scalar and batched evaluation).\n\n";
+
+#include <algorithm>            // std::max
+#include <cmath>                // fabs
+#include <random>
+#include <vector>
+
+#include "pism/basalstrength/basal_resistance.hh"
+#include "pism/util/ConfigInterface.hh"
+#include "pism/util/Context.hh"
+#include "pism/util/Logger.hh"
+#include "pism/util/error_handling.hh"
+#include "pism/util/petscwrappers/PetscInitializer.hh"
+#include "pism/util/pism_options.hh"
+#include "pism/util/pism_utilities.hh"
+
+using namespace pism;
+
+static double max_relative_difference(const std::vector<double> &a,
+                                      const std::vector<double> &b) {
+  double result = 0.0;
+  for (size_t k = 0; k < a.size(); ++k) {
+    double scale = std::max(fabs(a[k]), fabs(b[k]));
+    if (scale > 0.0) {
+      result = std::max(result, fabs(a[k] - b[k]) / scale);
+    }
+  }
+  return result;
+}
+
+//! Evaluate `law` using scalar and batched methods and report throughput.
+static void benchmark(const Logger &log,
+                      const std::string &name,
+                      const IceBasalResistancePlasticLaw &law,
+                      const std::vector<double> &tauc,
+                      const std::vector<Vector2> &velocity,
+                      int repeat) {
+  const unsigned int n = tauc.size();
+
+  std::vector<double>
+    beta(n), dbeta(n),
+    beta_batch(n), dbeta_batch(n);
+
+  double t_scalar = 0.0, t_batch = 0.0, t_scalar_d = 0.0, t_batch_d = 0.0;
+
+  for (int r = 0; r < repeat; ++r) {
+    double t0 = get_time();
+    for (unsigned int k = 0; k < n; ++k) {
+      beta[k] = law.drag(tauc[k], velocity[k].u, velocity[k].v);
+    }
+    double t1 = get_time();
+    law.drag(n, tauc.data(), velocity.data(), beta_batch.data());
+    double t2 = get_time();
+    for (unsigned int k = 0; k < n; ++k) {
+      law.drag_with_derivative(tauc[k], velocity[k].u, velocity[k].v, &beta[k], &dbeta[k]);
+    }
+    double t3 = get_time();
+    law.drag_with_derivative(n, tauc.data(), velocity.data(),
+                             beta_batch.data(), dbeta_batch.data());
+    double t4 = get_time();
+
+    t_scalar   += t1 - t0;
+    t_batch    += t2 - t1;
+    t_scalar_d += t3 - t2;
+    t_batch_d  += t4 - t3;
+  }
+
+  // millions of points per second
+  const double N = 1e-6 * n * repeat;
+
+  log.message(1, "%-24s %12.2f %12.2f %12.2f %12.2f %12.3e %12.3e\n",
+              name.c_str(),
+              N / t_scalar, N / t_batch, N / t_scalar_d, N / t_batch_d,
+              max_relative_difference(beta, beta_batch),
+              max_relative_difference(dbeta, dbeta_batch));
+}
+
+int main(int argc, char *argv[]) {
+
+  MPI_Comm com = MPI_COMM_WORLD;
+  petsc::Initializer petsc(argc, argv, help);
+
+  com = PETSC_COMM_WORLD;
+
+  try {
+    Context::Ptr ctx = context_from_options(com, "basal_resistance_benchmark");
+    Logger::Ptr log = ctx->log();
+    Config::Ptr config = ctx->config();
+
+    options::Integer
+      N("-n", "Number of points", 1000000),
+      repeat("-repeat", "Number of repetitions", 20);
+
+    std::vector<double> tauc(N);
+    std::vector<Vector2> velocity(N);
+    {
+      // fixed seed to make results reproducible
+      std::mt19937 generator(42);
+
+      const double max_speed = 1000.0 / 3.15569259747e7; // 1000 m/year in m/s
+
+      std::uniform_real_distribution<double>
+        yield_stress(1e4, 2e5),          // Pa
+        speed(-max_speed, max_speed);    // m/s
+
+      for (int k = 0; k < N; ++k) {
+        tauc[k]       = yield_stress(generator);
+        velocity[k].u = speed(generator);
+        velocity[k].v = speed(generator);
+      }
+    }
+
+    log->message(1,
+                 "Throughput (millions of points per second), %d points, %d repetitions\n"
+                 "%-24s %12s %12s %12s %12s %12s %12s\n",
+                 (int)N, (int)repeat,
+                 "law", "drag", "drag (n)", "d. drag", "d. drag (n)",
+                 "diff(beta)", "diff(dbeta)");
+
+    {
+      IceBasalResistancePlasticLaw law(*config);
+      benchmark(*log, "plastic", law, tauc, velocity, repeat);
+    }
+
+    for (double q : {0.0, 0.25, 1.0}) {
+      config->set_number("basal_resistance.pseudo_plastic.q", q);
+      IceBasalResistancePseudoPlasticLaw law(*config);
+      benchmark(*log, pism::printf("pseudo-plastic, q=%.2f", q), law, tauc, velocity, repeat);
+    }
+  }
+  catch (...) {
+    handle_fatal_errors(com);
+    return 1;
+  }
+
+  return 0;
+}
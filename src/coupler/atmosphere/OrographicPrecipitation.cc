@@ -31,6 +31,7 @@ namespace atmosphere {
 OrographicPrecipitation::OrographicPrecipitation(IceGrid::ConstPtr grid,
                                                  std::shared_ptr<AtmosphereModel> in)
     : AtmosphereModel(grid, in) {
+  require_uniform_grid(*m_grid, "the orographic precipitation model");
 
   m_precipitation = allocate_precipitation(grid);
 
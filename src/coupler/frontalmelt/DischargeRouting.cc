@@ -28,6 +28,7 @@ namespace frontalmelt {
   
 DischargeRouting::DischargeRouting(IceGrid::ConstPtr grid)
   : FrontalMelt(grid, nullptr) {
+  require_uniform_grid(*m_grid, "the discharge routing frontal melt model");
 
   m_frontal_melt_rate = allocate_frontal_melt_rate(grid, 1);
 
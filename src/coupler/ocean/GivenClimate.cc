@@ -1,4 +1,4 @@
-// Copyright (C) 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019 PISM Authors
+// Copyright (C) 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019, 2020 PISM Authors
 //
 // This file is part of PISM.
 //
@@ -27,7 +27,8 @@ namespace pism {
 namespace ocean {
 
 Given::Given(IceGrid::ConstPtr g)
-  : OceanModel(g, std::shared_ptr<OceanModel>()) {
+  : OceanModel(g, std::shared_ptr<OceanModel>()),
+    m_forcing(m_grid) {
 
   m_shelf_base_temperature = allocate_shelf_base_temperature(g);
   m_shelf_base_mass_flux   = allocate_shelf_base_mass_flux(g);
@@ -65,6 +66,9 @@ Given::Given(IceGrid::ConstPtr g)
   m_shelfbmassflux->set_attrs("climate_forcing",
                               "ice mass flux from ice shelf base (positive flux is loss from ice shelf)",
                               "kg m-2 s-1", "kg m-2 year-1", "", 0);
+
+  m_forcing.add(m_shelfbtemp);
+  m_forcing.add(m_shelfbmassflux);
 }
 
 Given::~Given() {
@@ -79,8 +83,7 @@ void Given::init_impl(const Geometry &geometry) {
 
   ForcingOptions opt(*m_grid->ctx(), "ocean.given");
 
-  m_shelfbtemp->init(opt.filename, opt.period, opt.reference_time);
-  m_shelfbmassflux->init(opt.filename, opt.period, opt.reference_time);
+  m_forcing.init(opt.filename, opt.period, opt.reference_time);
 
   // read time-independent data right away:
   if (m_shelfbtemp->n_records() == 1 && m_shelfbmassflux->n_records() == 1) {
@@ -91,11 +94,8 @@ void Given::init_impl(const Geometry &geometry) {
 void Given::update_impl(const Geometry &geometry, double t, double dt) {
   (void) geometry;
 
-  m_shelfbmassflux->update(t, dt);
-  m_shelfbtemp->update(t, dt);
-
-  m_shelfbmassflux->average(t, dt);
-  m_shelfbtemp->average(t, dt);
+  m_forcing.update(t, dt);
+  m_forcing.average(t, dt);
 
   m_shelf_base_temperature->copy_from(*m_shelfbtemp);
   m_shelf_base_mass_flux->copy_from(*m_shelfbmassflux);
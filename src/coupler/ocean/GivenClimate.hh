@@ -1,4 +1,4 @@
-// Copyright (C) 2011, 2013, 2014, 2015, 2016, 2017, 2018 Constantine Khroulev
+// Copyright (C) 2011, 2013, 2014, 2015, 2016, 2017, 2018, 2020 Constantine Khroulev
 //
 // This file is part of PISM.
 //
@@ -22,6 +22,7 @@
 #include "pism/coupler/OceanModel.hh"
 
 #include "pism/util/iceModelVec2T.hh"
+#include "pism/util/ForcingGroup.hh"
 
 namespace pism {
 namespace ocean {
@@ -43,6 +44,8 @@ private:
   IceModelVec2T::Ptr m_shelfbtemp;
   IceModelVec2T::Ptr m_shelfbmassflux;
 
+  ForcingGroup m_forcing;
+
   IceModelVec2S::Ptr m_shelf_base_temperature;
   IceModelVec2S::Ptr m_shelf_base_mass_flux;
 };
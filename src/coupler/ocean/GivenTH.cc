@@ -1,4 +1,4 @@
-// Copyright (C) 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019 PISM Authors
+// Copyright (C) 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019, 2020 PISM Authors
 //
 // This file is part of PISM.
 //
@@ -61,7 +61,8 @@ GivenTH::Constants::Constants(const Config &config) {
 }
 
 GivenTH::GivenTH(IceGrid::ConstPtr g)
-  : CompleteOceanModel(g, std::shared_ptr<OceanModel>()) {
+  : CompleteOceanModel(g, std::shared_ptr<OceanModel>()),
+    m_forcing(m_grid) {
 
   ForcingOptions opt(*m_grid->ctx(), "ocean.th");
 
@@ -98,6 +99,9 @@ GivenTH::GivenTH(IceGrid::ConstPtr g)
   m_salinity_ocean->set_attrs("climate_forcing",
                               "salinity of the adjacent ocean",
                               "g/kg", "g/kg", "", 0);
+
+  m_forcing.add(m_theta_ocean);
+  m_forcing.add(m_salinity_ocean);
 }
 
 GivenTH::~GivenTH() {
@@ -112,8 +116,7 @@ void GivenTH::init_impl(const Geometry &geometry) {
 
   ForcingOptions opt(*m_grid->ctx(), "ocean.th");
 
-  m_theta_ocean->init(opt.filename, opt.period, opt.reference_time);
-  m_salinity_ocean->init(opt.filename, opt.period, opt.reference_time);
+  m_forcing.init(opt.filename, opt.period, opt.reference_time);
 
   // read time-independent data right away:
   if (m_theta_ocean->n_records() == 1 && m_salinity_ocean->n_records() == 1) {
@@ -122,11 +125,8 @@ void GivenTH::init_impl(const Geometry &geometry) {
 }
 
 void GivenTH::update_impl(const Geometry &geometry, double t, double dt) {
-  m_theta_ocean->update(t, dt);
-  m_salinity_ocean->update(t, dt);
-
-  m_theta_ocean->average(t, dt);
-  m_salinity_ocean->average(t, dt);
+  m_forcing.update(t, dt);
+  m_forcing.average(t, dt);
 
   Constants c(*m_config);
 
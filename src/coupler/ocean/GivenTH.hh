@@ -1,4 +1,4 @@
-// Copyright (C) 2011, 2012, 2014, 2015, 2016, 2017, 2018 PISM Authors
+// Copyright (C) 2011, 2012, 2014, 2015, 2016, 2017, 2018, 2020 PISM Authors
 //
 // This file is part of PISM.
 //
@@ -21,6 +21,7 @@
 
 #include "CompleteOceanModel.hh"
 #include "pism/util/iceModelVec2T.hh"
+#include "pism/util/ForcingGroup.hh"
 
 namespace pism {
 namespace ocean {
@@ -66,6 +67,8 @@ private:
   IceModelVec2T::Ptr m_theta_ocean;
   IceModelVec2T::Ptr m_salinity_ocean;
 
+  ForcingGroup m_forcing;
+
   void pointwise_update(const Constants &constants,
                         double sea_water_salinity,
                         double sea_water_potential_temperature,
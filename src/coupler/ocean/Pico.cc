@@ -1,4 +1,4 @@
-// Copyright (C) 2012-2019 Constantine Khrulev, Ricarda Winkelmann, Ronja Reese, Torsten
+// Copyright (C) 2012-2020 Constantine Khrulev, Ricarda Winkelmann, Ronja Reese, Torsten
 // Albrecht, and Matthias Mengel
 //
 // This file is part of PISM.
@@ -59,7 +59,8 @@ Pico::Pico(IceGrid::ConstPtr g)
     m_overturning(m_grid, "pico_overturning", WITHOUT_GHOSTS),
     m_basal_melt_rate(m_grid, "pico_basal_melt_rate", WITH_GHOSTS),
     m_basin_mask(m_grid, "basins", WITH_GHOSTS),
-    m_geometry(new PicoGeometry(g)) {
+    m_geometry(new PicoGeometry(g)),
+    m_forcing(m_grid) {
 
   ForcingOptions opt(*m_grid->ctx(), "ocean.pico");
 
@@ -97,6 +98,9 @@ Pico::Pico(IceGrid::ConstPtr g)
                               "salinity of the adjacent ocean",
                               "g/kg", "g/kg", "", 0);
 
+  m_forcing.add(m_theta_ocean);
+  m_forcing.add(m_salinity_ocean);
+
   m_basin_mask.set_attrs("climate_forcing", "mask determines basins for PICO",
                          "", "", "", 0);
 
@@ -152,8 +156,7 @@ void Pico::init_impl(const Geometry &geometry) {
 
   ForcingOptions opt(*m_grid->ctx(), "ocean.pico");
 
-  m_theta_ocean->init(opt.filename, opt.period, opt.reference_time);
-  m_salinity_ocean->init(opt.filename, opt.period, opt.reference_time);
+  m_forcing.init(opt.filename, opt.period, opt.reference_time);
 
   m_basin_mask.regrid(opt.filename, CRITICAL);
 
@@ -174,8 +177,7 @@ void Pico::init_impl(const Geometry &geometry) {
 
   // read time-independent data right away:
   if (m_theta_ocean->n_records() == 1 and m_salinity_ocean->n_records() == 1) {
-    m_theta_ocean->update(m_grid->ctx()->time()->current(), 0.0);
-    m_salinity_ocean->update(m_grid->ctx()->time()->current(), 0.0);
+    m_forcing.update(m_grid->ctx()->time()->current(), 0.0);
   }
 }
 
@@ -201,11 +203,8 @@ void Pico::write_model_state_impl(const File &output) const {
 
 void Pico::update_impl(const Geometry &geometry, double t, double dt) {
 
-  m_theta_ocean->update(t, dt);
-  m_salinity_ocean->update(t, dt);
-
-  m_theta_ocean->average(t, dt);
-  m_salinity_ocean->average(t, dt);
+  m_forcing.update(t, dt);
+  m_forcing.average(t, dt);
 
   // set values that will be used outside of floating ice areas
   {
@@ -782,10 +781,9 @@ void Pico::compute_box_area(int box_id,
 
   IceModelVec::AccessList list{ &shelf_mask, &box_mask };
 
-  auto cell_area = m_grid->cell_area();
-
   for (Points p(*m_grid); p; p.next()) {
     const int i = p.i(), j = p.j();
+    const double cell_area = m_grid->cell_area(i, j);
 
     int shelf_id = shelf_mask.as_int(i, j);
 
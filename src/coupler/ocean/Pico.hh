@@ -24,6 +24,7 @@
 
 #include "pism/util/IceModelVec2CellType.hh"
 #include "pism/util/iceModelVec2T.hh"
+#include "pism/util/ForcingGroup.hh"
 
 namespace pism {
 namespace ocean {
@@ -63,6 +64,8 @@ private:
 
   IceModelVec2T::Ptr m_theta_ocean, m_salinity_ocean;
 
+  ForcingGroup m_forcing;
+
   void compute_ocean_input_per_basin(const PicoPhysics &physics,
                                      const IceModelVec2Int &basin_mask,
                                      const IceModelVec2Int &continental_shelf_mask,
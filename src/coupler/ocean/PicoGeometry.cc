@@ -153,7 +153,7 @@ static void relabel(RelabelingType type,
 
         if (index > 0) {
           // count areas of actual components, ignoring the background (index == 0)
-          area[index] += 1.0;
+          area[index] += grid->cell_area(i, j);
         }
       }
     } catch (...) {
@@ -162,7 +162,7 @@ static void relabel(RelabelingType type,
     loop.check();
 
     for (unsigned int k = 0; k < area.size(); ++k) {
-      area[k] = grid->cell_area() * GlobalSum(grid->com, area[k]);
+      area[k] = GlobalSum(grid->com, area[k]);
     }
   }
 
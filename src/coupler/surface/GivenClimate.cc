@@ -1,4 +1,4 @@
-// Copyright (C) 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019 PISM Authors
+// Copyright (C) 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019, 2020 PISM Authors
 //
 // This file is part of PISM.
 //
@@ -26,7 +26,8 @@ namespace pism {
 namespace surface {
 
 Given::Given(IceGrid::ConstPtr grid, std::shared_ptr<atmosphere::AtmosphereModel> input)
-  : SurfaceModel(grid)
+  : SurfaceModel(grid),
+    m_forcing(m_grid)
 {
   (void) input;
 
@@ -70,6 +71,9 @@ Given::Given(IceGrid::ConstPtr grid, std::shared_ptr<atmosphere::AtmosphereModel
                          "land_ice_surface_specific_mass_balance_flux", 0);
 
   m_mass_flux->metadata().set_numbers("valid_range", {-smb_max, smb_max});
+
+  m_forcing.add(m_temperature);
+  m_forcing.add(m_mass_flux);
 }
 
 Given::~Given() {
@@ -84,8 +88,7 @@ void Given::init_impl(const Geometry &geometry) {
 
   ForcingOptions opt(*m_grid->ctx(), "surface.given");
 
-  m_temperature->init(opt.filename, opt.period, opt.reference_time);
-  m_mass_flux->init(opt.filename, opt.period, opt.reference_time);
+  m_forcing.init(opt.filename, opt.period, opt.reference_time);
 
   // read time-independent data right away:
   if (m_temperature->n_records() == 1 && m_mass_flux->n_records() == 1) {
@@ -96,11 +99,8 @@ void Given::init_impl(const Geometry &geometry) {
 void Given::update_impl(const Geometry &geometry, double t, double dt) {
   (void) geometry;
 
-  m_mass_flux->update(t, dt);
-  m_temperature->update(t, dt);
-
-  m_mass_flux->average(t, dt);
-  m_temperature->average(t, dt);
+  m_forcing.update(t, dt);
+  m_forcing.average(t, dt);
 
   dummy_accumulation(*m_mass_flux, *m_accumulation);
   dummy_melt(*m_mass_flux, *m_melt);
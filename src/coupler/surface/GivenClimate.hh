@@ -1,4 +1,4 @@
-// Copyright (C) 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019 PISM Authors
+// Copyright (C) 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019, 2020 PISM Authors
 //
 // This file is part of PISM.
 //
@@ -21,6 +21,7 @@
 
 #include "pism/coupler/SurfaceModel.hh"
 #include "pism/util/iceModelVec2T.hh"
+#include "pism/util/ForcingGroup.hh"
 
 namespace pism {
 namespace surface {
@@ -45,6 +46,8 @@ protected:
 
   IceModelVec2T::Ptr m_mass_flux;
   IceModelVec2T::Ptr m_temperature;
+
+  ForcingGroup m_forcing;
 };
 
 } // end of namespace surface
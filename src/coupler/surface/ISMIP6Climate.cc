@@ -1,4 +1,4 @@
-// Copyright (C) 2019 PISM Authors
+// Copyright (C) 2019, 2020 PISM Authors
 //
 // This file is part of PISM.
 //
@@ -30,7 +30,8 @@ ISMIP6::ISMIP6(IceGrid::ConstPtr grid, std::shared_ptr<atmosphere::AtmosphereMod
   : SurfaceModel(grid),
     m_mass_flux_reference(m_grid, "climatic_mass_balance", WITHOUT_GHOSTS),
     m_temperature_reference(m_grid, "ice_surface_temp", WITHOUT_GHOSTS),
-    m_surface_reference(m_grid, "usurf", WITHOUT_GHOSTS)
+    m_surface_reference(m_grid, "usurf", WITHOUT_GHOSTS),
+    m_forcing(m_grid)
 {
   (void) input;
 
@@ -134,6 +135,11 @@ ISMIP6::ISMIP6(IceGrid::ConstPtr grid, std::shared_ptr<atmosphere::AtmosphereMod
     }
 
   }
+
+  m_forcing.add(m_mass_flux_anomaly);
+  m_forcing.add(m_mass_flux_gradient);
+  m_forcing.add(m_temperature_anomaly);
+  m_forcing.add(m_temperature_gradient);
 }
 
 ISMIP6::~ISMIP6() {
@@ -158,11 +164,7 @@ void ISMIP6::init_impl(const Geometry &geometry) {
   {
     ForcingOptions opt(*m_grid->ctx(), "surface.ismip6");
 
-    m_mass_flux_anomaly->init(opt.filename, opt.period, opt.reference_time);
-    m_mass_flux_gradient->init(opt.filename, opt.period, opt.reference_time);
-
-    m_temperature_anomaly->init(opt.filename, opt.period, opt.reference_time);
-    m_temperature_gradient->init(opt.filename, opt.period, opt.reference_time);
+    m_forcing.init(opt.filename, opt.period, opt.reference_time);
   }
 }
 
@@ -185,15 +187,8 @@ void ISMIP6::update_impl(const Geometry &geometry, double t, double dt) {
 
   // get time-dependent input fields at the current time
   {
-    aT.update(t, dt);
-    aSMB.update(t, dt);
-    dTdz.update(t, dt);
-    dSMBdz.update(t, dt);
-
-    aT.average(t, dt);
-    aSMB.average(t, dt);
-    dTdz.average(t, dt);
-    dSMBdz.average(t, dt);
+    m_forcing.update(t, dt);
+    m_forcing.average(t, dt);
   }
 
   // From http://www.climate-cryosphere.org/wiki/index.php?title=ISMIP6-Projections-Greenland:
@@ -216,12 +211,7 @@ void ISMIP6::update_impl(const Geometry &geometry, double t, double dt) {
 }
 
 MaxTimestep ISMIP6::max_timestep_impl(double t) const {
-  using std::min;
-
-  auto dt = m_temperature_anomaly->max_timestep(t);
-  dt = min(dt, m_temperature_gradient->max_timestep(t));
-  dt = min(dt, m_mass_flux_anomaly->max_timestep(t));
-  dt = min(dt, m_mass_flux_gradient->max_timestep(t));
+  auto dt = m_forcing.max_timestep(t);
 
   if (dt.finite()) {
     return MaxTimestep(dt.value(), "surface ISMIP6");
@@ -1,4 +1,4 @@
-// Copyright (C) 2019 PISM Authors
+// Copyright (C) 2019, 2020 PISM Authors
 //
 // This file is part of PISM.
 //
@@ -21,6 +21,7 @@
 
 #include "pism/coupler/SurfaceModel.hh"
 #include "pism/util/iceModelVec2T.hh"
+#include "pism/util/ForcingGroup.hh"
 
 namespace pism {
 namespace surface {
@@ -47,6 +48,9 @@ protected:
   IceModelVec2T::Ptr m_mass_flux_gradient;
   IceModelVec2T::Ptr m_temperature_gradient;
 
+  // all time-dependent inputs (read from the same file)
+  ForcingGroup m_forcing;
+
   // time-independent inputs
   IceModelVec2S m_mass_flux_reference;
   IceModelVec2S m_temperature_reference;
@@ -548,12 +548,12 @@ protected:
     const IceModelVec2S &melt_amount = model->melt();
 
     if (m_kind == MASS) {
-      double cell_area = m_grid->cell_area();
 
       IceModelVec::AccessList list{&m_melt_mass, &melt_amount};
 
       for (Points p(*m_grid); p; p.next()) {
         const int i = p.i(), j = p.j();
+        const double cell_area = m_grid->cell_area(i, j);
         m_melt_mass(i, j) = melt_amount(i, j) * cell_area;
       }
       return m_melt_mass;
@@ -609,12 +609,12 @@ protected:
     const IceModelVec2S &runoff_amount = model->runoff();
 
     if (m_kind == MASS) {
-      double cell_area = m_grid->cell_area();
 
       IceModelVec::AccessList list{&m_runoff_mass, &runoff_amount};
 
       for (Points p(*m_grid); p; p.next()) {
         const int i = p.i(), j = p.j();
+        const double cell_area = m_grid->cell_area(i, j);
         m_runoff_mass(i, j) = runoff_amount(i, j) * cell_area;
       }
       return m_runoff_mass;
@@ -670,12 +670,12 @@ protected:
     const IceModelVec2S &accumulation_amount = model->accumulation();
 
     if (m_kind == MASS) {
-      double cell_area = m_grid->cell_area();
 
       IceModelVec::AccessList list{&m_accumulation_mass, &accumulation_amount};
 
       for (Points p(*m_grid); p; p.next()) {
         const int i = p.i(), j = p.j();
+        const double cell_area = m_grid->cell_area(i, j);
         m_accumulation_mass(i, j) = accumulation_amount(i, j) * cell_area;
       }
       return m_accumulation_mass;
@@ -696,14 +696,13 @@ private:
 static double integrate(const IceModelVec2S &input) {
   IceGrid::ConstPtr grid = input.grid();
 
-  double cell_area = grid->cell_area();
-
   IceModelVec::AccessList list{&input};
 
   double result = 0.0;
 
   for (Points p(*grid); p; p.next()) {
     const int i = p.i(), j = p.j();
+    const double cell_area = grid->cell_area(i, j);
 
     result += input(i, j) * cell_area;
   }
@@ -27,7 +27,9 @@
 #include "pism/util/MaxTimestep.hh"
 #include "pism/util/pism_utilities.hh"
 #include "pism/util/fftw_utilities.hh"
+#include "pism/util/Proc0Scatter.hh"
 #include "LingleClarkSerial.hh"
+#include "LoadResponseMatrix.hh"
 
 namespace pism {
 namespace bed {
@@ -38,6 +40,7 @@ LingleClark::LingleClark(IceGrid::ConstPtr grid)
     m_relief(m_grid, "bed_relief", WITHOUT_GHOSTS),
     m_load_thickness(grid, "load_thickness", WITHOUT_GHOSTS),
     m_elastic_displacement(grid, "elastic_bed_displacement", WITHOUT_GHOSTS) {
+  require_uniform_grid(*m_grid, "the Lingle-Clark bed deformation model");
 
   m_time_name = m_config->get_string("time.dimension_name") + "_lingle_clark";
   m_t_last = m_grid->ctx()->time()->current();
@@ -104,13 +107,32 @@ LingleClark::LingleClark(IceGrid::ConstPtr grid)
 
   m_viscous_displacement0 = m_viscous_displacement.allocate_proc0_copy();
 
+  m_scatter.reset(new Proc0Scatter(m_grid, 2));
+  m_viscous_scatter.reset(new Proc0Scatter(m_extended_grid, 1));
+
+  // The elastic load response matrix is computed using all ranks (it is expensive) and
+  // gathered on rank 0.
+  std::vector<double> lrm_quadrant;
+  if (use_elastic_model) {
+    // check if the extended grid is large enough (it has to be at least twice the size of
+    // the physical grid so that the load in one corner of the domain affects the grid
+    // point in the opposite corner).
+    if (Z < 2) {
+      throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                    "bed_deformation.lc.elastic_model"
+                                    " requires bed_deformation.lc.grid_size_factor > 1");
+    }
+
+    lrm_quadrant = elastic_load_response_quadrant();
+  }
+
   ParallelSection rank0(m_grid->com);
   try {
     if (m_grid->rank() == 0) {
       m_serial_model.reset(new LingleClarkSerial(m_log, *m_config, use_elastic_model,
                                                  Mx, My,
                                                  m_grid->dx(), m_grid->dy(),
-                                                 Nx, Ny));
+                                                 Nx, Ny, lrm_quadrant));
     }
   } catch (...) {
     rank0.failed();
@@ -171,16 +193,29 @@ void LingleClark::bootstrap_impl(const IceModelVec2S &bed_elevation,
     rank0.check();
   }
 
-  m_viscous_displacement.get_from_proc0(*m_viscous_displacement0);
+  m_viscous_scatter->get({*m_viscous_displacement0}, {&m_viscous_displacement});
 
-  m_elastic_displacement.get_from_proc0(*m_elastic_displacement0);
-
-  m_total_displacement.get_from_proc0(*m_work0);
+  m_scatter->get({*m_work0, *m_elastic_displacement0},
+                 {&m_total_displacement, &m_elastic_displacement});
 
   // compute bed relief
   m_topg.add(-1.0, m_total_displacement, m_relief);
 }
 
+/*!
+ * Compute (or read from the cache file) the elastic load response matrix on the top left
+ * quadrant of the extended grid.
+ *
+ * Collective. The result is available on rank 0 only.
+ */
+std::vector<double> LingleClark::elastic_load_response_quadrant() const {
+  auto cache_file = m_config->get_string("bed_deformation.lc.load_response_matrix_file");
+
+  return bed::elastic_load_response_quadrant(m_grid->com, *m_log, cache_file,
+                                             m_extended_grid->dx(), m_extended_grid->dy(),
+                                             m_extended_grid->Mx(), m_extended_grid->My());
+}
+
 /*!
  * Return the load response matrix for the elastic response.
  *
@@ -195,13 +230,15 @@ IceModelVec2S::Ptr LingleClark::elastic_load_response_matrix() const {
 
   auto lrm0 = result->allocate_proc0_copy();
 
+  std::vector<double> quadrant = elastic_load_response_quadrant();
+
   {
     ParallelSection rank0(m_grid->com);
     try {
       if (m_grid->rank() == 0) {
         std::vector<std::complex<double> > array(Nx * Ny);
 
-        m_serial_model->compute_load_response_matrix((fftw_complex*)array.data());
+        m_serial_model->compute_load_response_matrix(quadrant, (fftw_complex*)array.data());
 
         get_real_part((fftw_complex*)array.data(), 1.0, Nx, Ny, Nx, Ny, 0, 0, *lrm0);
       }
@@ -350,27 +387,42 @@ void LingleClark::step(const IceModelVec2S &ice_thickness,
     if (m_grid->rank() == 0) {  // only processor zero does the step
       PetscErrorCode ierr = 0;
 
-      m_serial_model->step(dt, *m_work0);
-
-      ierr = VecCopy(m_serial_model->total_displacement(), *m_work0);
-      PISM_CHK(ierr, "VecCopy");
+      m_serial_model->update_viscous_displacement(dt, *m_work0);
 
       ierr = VecCopy(m_serial_model->viscous_displacement(), *m_viscous_displacement0);
       PISM_CHK(ierr, "VecCopy");
-
-      ierr = VecCopy(m_serial_model->elastic_displacement(), *m_elastic_displacement0);
-      PISM_CHK(ierr, "VecCopy");
     }
   } catch (...) {
     rank0.failed();
   }
   rank0.check();
 
-  m_viscous_displacement.get_from_proc0(*m_viscous_displacement0);
+  // Send the viscous displacement while rank 0 computes the elastic part.
+  m_viscous_scatter->get_begin({*m_viscous_displacement0});
+  {
+    ParallelSection rank0(m_grid->com);
+    try {
+      if (m_grid->rank() == 0) {
+        PetscErrorCode ierr = 0;
 
-  m_elastic_displacement.get_from_proc0(*m_elastic_displacement0);
+        m_serial_model->update_elastic_displacement(*m_work0);
 
-  m_total_displacement.get_from_proc0(*m_work0);
+        ierr = VecCopy(m_serial_model->total_displacement(), *m_work0);
+        PISM_CHK(ierr, "VecCopy");
+
+        ierr = VecCopy(m_serial_model->elastic_displacement(), *m_elastic_displacement0);
+        PISM_CHK(ierr, "VecCopy");
+      }
+    } catch (...) {
+      rank0.failed();
+    }
+    // finish the transfer even if rank 0 failed
+    m_viscous_scatter->get_end({&m_viscous_displacement});
+    rank0.check();
+  }
+
+  m_scatter->get({*m_work0, *m_elastic_displacement0},
+                 {&m_total_displacement, &m_elastic_displacement});
 
   // Update bed elevation using bed displacement and relief.
   {
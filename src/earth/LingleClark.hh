@@ -1,4 +1,4 @@
-/* Copyright (C) 2013, 2014, 2015, 2016, 2017, 2018, 2019 PISM Authors
+/* Copyright (C) 2013, 2014, 2015, 2016, 2017, 2018, 2019, 2020 PISM Authors
  *
  * This file is part of PISM.
  *
@@ -21,10 +21,14 @@
 #define _PBLINGLECLARK_H_
 
 #include <memory>               // std::unique_ptr
+#include <vector>
 
 #include "BedDef.hh"
 
 namespace pism {
+
+class Proc0Scatter;
+
 namespace bed {
 
 class LingleClarkSerial;
@@ -49,6 +53,8 @@ public:
 
   IceModelVec2S::Ptr elastic_load_response_matrix() const;
 protected:
+  std::vector<double> elastic_load_response_quadrant() const;
+
   virtual void define_model_state_impl(const File &output) const;
   virtual void write_model_state_impl(const File &output) const;
 
@@ -81,6 +87,11 @@ protected:
   //! Serial viscoelastic bed deformation model.
   std::unique_ptr<LingleClarkSerial> m_serial_model;
 
+  //! Moves total and elastic displacements from rank 0.
+  std::unique_ptr<Proc0Scatter> m_scatter;
+  //! Moves the viscous displacement from rank 0.
+  std::unique_ptr<Proc0Scatter> m_viscous_scatter;
+
   //! extended grid for the viscous plate displacement
   IceGrid::Ptr m_extended_grid;
 
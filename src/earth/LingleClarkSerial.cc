@@ -1,4 +1,4 @@
-// Copyright (C) 2004-2009, 2011, 2013, 2014, 2015, 2016, 2017, 2018, 2019 Ed Bueler and Constantine Khroulev
+// Copyright (C) 2004-2009, 2011, 2013, 2014, 2015, 2016, 2017, 2018, 2019, 2020 Ed Bueler and Constantine Khroulev
 //
 // This file is part of PISM.
 //
@@ -21,8 +21,6 @@
 #include <fftw3.h>
 #include <gsl/gsl_math.h>       // M_PI
 
-#include "matlablike.hh"
-#include "greens.hh"
 #include "LingleClarkSerial.hh"
 
 #include "pism/util/pism_utilities.hh"
@@ -43,30 +41,22 @@ namespace bed {
  * @param[in] dy grid spacing in the Y direction
  * @param[in] Nx extended grid size in the X direction
  * @param[in] Ny extended grid size in the Y direction
+ * @param[in] lrm_quadrant elastic load response matrix on the top left quadrant of the
+ *                         extended grid (see elastic_load_response_quadrant()); not used
+ *                         if `include_elastic` is false
  */
 LingleClarkSerial::LingleClarkSerial(Logger::ConstPtr log,
                                      const Config &config,
                                      bool include_elastic,
                                      int Mx, int My,
                                      double dx, double dy,
-                                     int Nx, int Ny)
+                                     int Nx, int Ny,
+                                     const std::vector<double> &lrm_quadrant)
   : m_log(log) {
 
   // set parameters
   m_include_elastic = include_elastic;
 
-  if (include_elastic) {
-    // check if the extended grid is large enough (it has to be at least twice the size of
-    // the physical grid so that the load in one corner of the domain affects the grid
-    // point in the opposite corner).
-
-    if (config.get_number("bed_deformation.lc.grid_size_factor") < 2) {
-      throw RuntimeError::formatted(PISM_ERROR_LOCATION,
-                                    "bed_deformation.lc.elastic_model"
-                                    " requires bed_deformation.lc.grid_size_factor > 1");
-    }
-  }
-
   // grid parameters
   m_Mx = Mx;
   m_My = My;
@@ -122,7 +112,7 @@ LingleClarkSerial::LingleClarkSerial(Logger::ConstPtr log,
   //
   // (Constantine Khroulev, February 1, 2015)
 
-  precompute_coefficients();
+  precompute_coefficients(lrm_quadrant);
 }
 
 LingleClarkSerial::~LingleClarkSerial() {
@@ -155,27 +145,29 @@ Vec LingleClarkSerial::elastic_displacement() const {
   return m_Ue;
 }
 
-void LingleClarkSerial::compute_load_response_matrix(fftw_complex *output) {
+/*!
+ * Fill the load response matrix on the extended grid using its values on the top left
+ * quadrant (computed by elastic_load_response_quadrant()) and symmetry.
+ */
+void LingleClarkSerial::compute_load_response_matrix(const std::vector<double> &quadrant,
+                                                     fftw_complex *output) {
 
   FFTWArray LRM(output, m_Nx, m_Ny);
 
-  greens_elastic G;
-  ge_data ge_data {m_dx, m_dy, 0, 0, &G};
-
   int Nx2 = m_Nx / 2;
   int Ny2 = m_Ny / 2;
 
+  if (quadrant.size() != (size_t)((Nx2 + 1) * (Ny2 + 1))) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "invalid load response matrix size: %d (expected %d)",
+                                  (int)quadrant.size(), (Nx2 + 1) * (Ny2 + 1));
+  }
+
   // Top half
   for (int j = 0; j <= Ny2; ++j) {
     // Top left quarter
     for (int i = 0; i <= Nx2; ++i) {
-      ge_data.p = Nx2 - i;
-      ge_data.q = Ny2 - j;
-
-      LRM(i, j) = dblquad_cubature(ge_integrand,
-                                   -m_dx / 2, m_dx / 2,
-                                   -m_dy / 2, m_dy / 2,
-                                   1.0e-8, &ge_data);
+      LRM(i, j) = quadrant[j * (Nx2 + 1) + i];
     }
 
     // Top right quarter
@@ -215,7 +207,7 @@ void LingleClarkSerial::compute_load_response_matrix(fftw_complex *output) {
 /**
  * Pre-compute coefficients used by the model.
  */
-void LingleClarkSerial::precompute_coefficients() {
+void LingleClarkSerial::precompute_coefficients(const std::vector<double> &lrm_quadrant) {
 
   // Coefficients for Fourier spectral method Laplacian
   // MATLAB version:  cx=(pi/Lx)*[0:Nx/2 Nx/2-1:-1:1]
@@ -224,14 +216,10 @@ void LingleClarkSerial::precompute_coefficients() {
 
   // compare geforconv.m
   if (m_include_elastic) {
-    m_log->message(2, "     computing spherical elastic load response matrix ...");
-    {
-      compute_load_response_matrix(m_fftw_input);
-      // Compute fft2(LRM) and save it in m_lrm_hat
-      fftw_execute(m_dft_forward);
-      copy_fftw_array(m_fftw_output, m_lrm_hat, m_Nx, m_Ny);
-    }
-    m_log->message(2, " done\n");
+    compute_load_response_matrix(lrm_quadrant, m_fftw_input);
+    // Compute fft2(LRM) and save it in m_lrm_hat
+    fftw_execute(m_dft_forward);
+    copy_fftw_array(m_fftw_output, m_lrm_hat, m_Nx, m_Ny);
   }
 }
 
@@ -352,12 +340,9 @@ void LingleClarkSerial::init(Vec viscous_displacement,
 }
 
 /*!
- * Perform a time step.
- *
- * @param[in] dt time step length
- * @param[in] H load thickness on the physical (Mx*My) grid
+ * Update the viscous displacement using the load thickness `H` and the time step `dt`.
  */
-void LingleClarkSerial::step(double dt, Vec H) {
+void LingleClarkSerial::update_viscous_displacement(double dt, Vec H) {
   // solves:
   //     (2 eta |grad| U^{n+1}) + (dt/2) * (rho_r g U^{n+1} + D grad^4 U^{n+1})
   //   = (2 eta |grad| U^n) - (dt/2) * (rho_r g U^n + D grad^4 U^n) - dt * rho g H_start
@@ -421,8 +406,16 @@ void LingleClarkSerial::step(double dt, Vec H) {
     // zero time step: viscous displacement is zero
     PetscErrorCode ierr = VecSet(m_Uv, 0.0); PISM_CHK(ierr, "VecSet");
   }
+}
 
-  // now compute elastic response if desired
+/*!
+ * Update the elastic displacement using the load thickness `H`, then update the total
+ * displacement.
+ *
+ * Call update_viscous_displacement() first.
+ */
+void LingleClarkSerial::update_elastic_displacement(Vec H) {
+  // compute elastic response if desired
   if (m_include_elastic) {
     compute_elastic_response(H, m_Ue);
   }
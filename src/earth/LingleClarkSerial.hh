@@ -1,4 +1,4 @@
-// Copyright (C) 2007--2009, 2011, 2012, 2013, 2014, 2015, 2017, 2018, 2019 Ed Bueler and Constantine Khroulev
+// Copyright (C) 2007--2009, 2011, 2012, 2013, 2014, 2015, 2017, 2018, 2019, 2020 Ed Bueler and Constantine Khroulev
 //
 // This file is part of PISM.
 //
@@ -61,7 +61,8 @@ public:
                     bool include_elastic,
                     int Mx, int My,
                     double dx, double dy,
-                    int Nx, int Ny);
+                    int Nx, int Ny,
+                    const std::vector<double> &lrm_quadrant);
   ~LingleClarkSerial();
 
   void init(Vec viscous_displacement,
@@ -69,7 +70,9 @@ public:
 
   void bootstrap(Vec thickness, Vec uplift);
 
-  void step(double dt_seconds, Vec H);
+  void update_viscous_displacement(double dt_seconds, Vec H);
+
+  void update_elastic_displacement(Vec H);
 
   Vec total_displacement() const;
 
@@ -77,13 +80,14 @@ public:
 
   Vec elastic_displacement() const;
 
-  void compute_load_response_matrix(fftw_complex *output);
+  void compute_load_response_matrix(const std::vector<double> &quadrant,
+                                    fftw_complex *output);
 private:
   void compute_elastic_response(Vec H, Vec dE);
 
   void uplift_problem(Vec load_thickness, Vec bed_uplift, Vec output);
 
-  void precompute_coefficients();
+  void precompute_coefficients(const std::vector<double> &lrm_quadrant);
 
   void update_displacement(Vec V, Vec dE, Vec dU);
 
@@ -0,0 +1,303 @@
+/* Copyright (C) 2020 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <algorithm>            // std::copy
+#include <cmath>                // fabs
+#include <cstdio>               // fopen
+
+#include "LoadResponseMatrix.hh"
+#include "greens.hh"
+#include "matlablike.hh"
+
+#include "pism/util/io/File.hh"
+#include "pism/util/Logger.hh"
+#include "pism/util/error_handling.hh"
+
+namespace pism {
+namespace bed {
+
+//! Requested relative error of the numerical integration.
+static const double cubature_tolerance = 1.0e-8;
+
+//! Describes the elastic Green's function. Saved in the cache file to identify it.
+static const char *earth_model = "spherical layered elastic Earth (Farrell, 1972)";
+
+//! Name of the variable used to store the load response matrix in a cache file.
+static const char *variable_name = "elastic_lrm";
+
+/*!
+ * Compute the elastic response at the distance of (p, q) grid cells from a load applied
+ * to one grid cell.
+ */
+static double elastic_load_response(double dx, double dy, int p, int q,
+                                    greens_elastic &G) {
+  ge_data data {dx, dy, p, q, &G};
+
+  return dblquad_cubature(ge_integrand,
+                          -dx / 2, dx / 2,
+                          -dy / 2, dy / 2,
+                          cubature_tolerance, &data);
+}
+
+/*!
+ * Compute the load response matrix on the top left quadrant of the extended grid.
+ *
+ * The work is split into rows of the quadrant and distributed using a dynamic work queue
+ * (a shared counter stored on rank 0): the cost of the numerical integration grows
+ * sharply near the load, so a static partition would be poorly balanced. Rows closest to
+ * the load are handed out first for the same reason.
+ *
+ * Collective on `com`. Returns the result on rank 0 and an empty vector on other ranks.
+ */
+static std::vector<double> compute_quadrant(MPI_Comm com, double dx, double dy,
+                                            int Nx2, int Ny2) {
+  int rank = 0, size = 1;
+  MPI_Comm_rank(com, &rank);
+  MPI_Comm_size(com, &size);
+
+  const int
+    row_length = Nx2 + 1,
+    n_rows     = Ny2 + 1;
+
+  // the number of rows handed out so far (stored on rank 0)
+  int *counter = nullptr;
+  MPI_Win window;
+  MPI_Win_allocate(rank == 0 ? sizeof(int) : 0, sizeof(int), MPI_INFO_NULL, com,
+                   &counter, &window);
+  if (rank == 0) {
+    MPI_Win_lock(MPI_LOCK_EXCLUSIVE, 0, 0, window);
+    *counter = 0;
+    MPI_Win_unlock(0, window);
+  }
+  MPI_Barrier(com);
+
+  std::vector<int> rows;
+  std::vector<double> values;
+  {
+    greens_elastic G;
+    const int one = 1;
+
+    while (true) {
+      int k = 0;
+      MPI_Win_lock(MPI_LOCK_SHARED, 0, 0, window);
+      MPI_Fetch_and_op(&one, &k, MPI_INT, 0, 0, MPI_SUM, window);
+      MPI_Win_unlock(0, window);
+
+      if (k >= n_rows) {
+        break;
+      }
+
+      // row k of the work queue corresponds to j = Ny2 - k, i.e. the distance (in grid
+      // cells) from the load in the Y direction is k
+      rows.push_back(Ny2 - k);
+      for (int i = 0; i <= Nx2; ++i) {
+        values.push_back(elastic_load_response(dx, dy, Nx2 - i, k, G));
+      }
+    }
+  }
+
+  MPI_Win_free(&window);
+
+  // gather results on rank 0
+  int n_local = rows.size();
+  std::vector<int> n_rows_per_rank(size), row_offsets(size), counts(size), offsets(size);
+  MPI_Gather(&n_local, 1, MPI_INT, n_rows_per_rank.data(), 1, MPI_INT, 0, com);
+
+  if (rank == 0) {
+    for (int r = 0; r < size; ++r) {
+      row_offsets[r] = r > 0 ? row_offsets[r - 1] + n_rows_per_rank[r - 1] : 0;
+      counts[r]      = n_rows_per_rank[r] * row_length;
+      offsets[r]     = row_offsets[r] * row_length;
+    }
+  }
+
+  std::vector<int> all_rows(rank == 0 ? n_rows : 0);
+  std::vector<double> all_values(rank == 0 ? n_rows * row_length : 0);
+
+  MPI_Gatherv(rows.data(), n_local, MPI_INT,
+              all_rows.data(), n_rows_per_rank.data(), row_offsets.data(), MPI_INT,
+              0, com);
+  MPI_Gatherv(values.data(), n_local * row_length, MPI_DOUBLE,
+              all_values.data(), counts.data(), offsets.data(), MPI_DOUBLE,
+              0, com);
+
+  std::vector<double> result;
+  if (rank == 0) {
+    result.resize(n_rows * row_length);
+    for (int r = 0; r < n_rows; ++r) {
+      std::copy(&all_values[r * row_length], &all_values[r * row_length] + row_length,
+                &result[all_rows[r] * row_length]);
+    }
+  }
+
+  return result;
+}
+
+//! Return true if `a` and `b` are equal (up to round-off).
+static bool same(double a, double b) {
+  return fabs(a - b) <= 1e-12 * std::max(fabs(a), fabs(b));
+}
+
+/*!
+ * Read the load response matrix from `filename` if it was computed using the same grid
+ * and the same Earth model.
+ *
+ * Returns an empty vector if the file is missing or does not match.
+ *
+ * Called on rank 0 only.
+ */
+static std::vector<double> read_cache(const Logger &log, const std::string &filename,
+                                      double dx, double dy, int Nx, int Ny) {
+  if (FILE *f = fopen(filename.c_str(), "r")) {
+    fclose(f);
+  } else {
+    return {};
+  }
+
+  File file(MPI_COMM_SELF, filename, PISM_NETCDF3, PISM_READONLY);
+
+  if (not file.find_variable(variable_name)) {
+    return {};
+  }
+
+  auto attribute = [&file](const char *name) {
+    auto value = file.read_double_attribute(variable_name, name);
+    return value.size() == 1 ? value[0] : -1.0;
+  };
+
+  if (not (same(attribute("dx"), dx) and
+           same(attribute("dy"), dy) and
+           same(attribute("Nx"), Nx) and
+           same(attribute("Ny"), Ny) and
+           same(attribute("tolerance"), cubature_tolerance) and
+           file.read_text_attribute(variable_name, "earth_model") == earth_model)) {
+    log.message(2,
+                "     '%s' contains a load response matrix for a different grid;"
+                " it will be re-computed\n", filename.c_str());
+    return {};
+  }
+
+  const unsigned int
+    Nx2 = Nx / 2,
+    Ny2 = Ny / 2;
+
+  std::vector<double> result((Nx2 + 1) * (Ny2 + 1));
+  file.read_variable(variable_name, {0, 0}, {Ny2 + 1, Nx2 + 1}, result.data());
+
+  return result;
+}
+
+/*!
+ * Save the load response matrix to `filename`, overwriting it if present.
+ *
+ * Called on rank 0 only.
+ */
+static void write_cache(const std::string &filename,
+                        double dx, double dy, int Nx, int Ny,
+                        const std::vector<double> &quadrant) {
+  const unsigned int
+    Nx2 = Nx / 2,
+    Ny2 = Ny / 2;
+
+  File file(MPI_COMM_SELF, filename, PISM_NETCDF3, PISM_READWRITE_CLOBBER);
+
+  file.define_dimension("x_lrm", Nx2 + 1);
+  file.define_dimension("y_lrm", Ny2 + 1);
+  file.define_variable(variable_name, PISM_DOUBLE, {"y_lrm", "x_lrm"});
+
+  file.write_attribute(variable_name, "long_name",
+                       "elastic load response matrix (top left quadrant of the extended grid)");
+  file.write_attribute(variable_name, "earth_model", earth_model);
+  file.write_attribute(variable_name, "dx", PISM_DOUBLE, {dx});
+  file.write_attribute(variable_name, "dy", PISM_DOUBLE, {dy});
+  file.write_attribute(variable_name, "Nx", PISM_INT, {(double)Nx});
+  file.write_attribute(variable_name, "Ny", PISM_INT, {(double)Ny});
+  file.write_attribute(variable_name, "tolerance", PISM_DOUBLE, {cubature_tolerance});
+
+  file.write_variable(variable_name, {0, 0}, {Ny2 + 1, Nx2 + 1}, quadrant.data());
+}
+
+/*!
+ * Compute the load response matrix of the spherical elastic Earth model on the top left
+ * quadrant of the extended grid of size `Nx` by `Ny` (the rest of it is obtained using
+ * symmetry; see LingleClarkSerial::compute_load_response_matrix()).
+ *
+ * The result has `(Nx/2 + 1) * (Ny/2 + 1)` elements. Element `(i, j)` is stored at
+ * `j * (Nx/2 + 1) + i`.
+ *
+ * If `cache_file` is not empty, try reading the matrix from this file first. If it is not
+ * there (or was computed using a different grid), compute it and save it to this file.
+ *
+ * Collective on `com`. Returns the result on rank 0 and an empty vector on other ranks.
+ */
+std::vector<double> elastic_load_response_quadrant(MPI_Comm com,
+                                                   const Logger &log,
+                                                   const std::string &cache_file,
+                                                   double dx, double dy,
+                                                   int Nx, int Ny) {
+  int rank = 0;
+  MPI_Comm_rank(com, &rank);
+
+  std::vector<double> result;
+
+  if (not cache_file.empty()) {
+    ParallelSection rank0(com);
+    try {
+      if (rank == 0) {
+        result = read_cache(log, cache_file, dx, dy, Nx, Ny);
+      }
+    } catch (...) {
+      rank0.failed();
+    }
+    rank0.check();
+
+    int found = result.empty() ? 0 : 1;
+    MPI_Bcast(&found, 1, MPI_INT, 0, com);
+
+    if (found == 1) {
+      log.message(2, "     read the elastic load response matrix from '%s'\n",
+                  cache_file.c_str());
+      return result;
+    }
+  }
+
+  log.message(2, "     computing spherical elastic load response matrix ...");
+  result = compute_quadrant(com, dx, dy, Nx / 2, Ny / 2);
+  log.message(2, " done\n");
+
+  if (not cache_file.empty()) {
+    ParallelSection rank0(com);
+    try {
+      if (rank == 0) {
+        write_cache(cache_file, dx, dy, Nx, Ny, result);
+      }
+    } catch (...) {
+      rank0.failed();
+    }
+    rank0.check();
+
+    log.message(2, "     saved the elastic load response matrix to '%s'\n",
+                cache_file.c_str());
+  }
+
+  return result;
+}
+
+} // end of namespace bed
+} // end of namespace pism
@@ -0,0 +1,42 @@
+/* Copyright (C) 2020 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef PISM_LOADRESPONSEMATRIX_H
+#define PISM_LOADRESPONSEMATRIX_H
+
+#include <string>
+#include <vector>
+#include <mpi.h>
+
+namespace pism {
+
+class Logger;
+
+namespace bed {
+
+std::vector<double> elastic_load_response_quadrant(MPI_Comm com,
+                                                   const Logger &log,
+                                                   const std::string &cache_file,
+                                                   double dx, double dy,
+                                                   int Nx, int Ny);
+
+} // end of namespace bed
+} // end of namespace pism
+
+#endif /* PISM_LOADRESPONSEMATRIX_H */
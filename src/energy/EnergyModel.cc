@@ -1,4 +1,4 @@
-/* Copyright (C) 2016, 2017, 2018, 2019 PISM Authors
+/* Copyright (C) 2016, 2017, 2018, 2019, 2020 PISM Authors
  *
  * This file is part of PISM.
  *
@@ -17,6 +17,9 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#include <algorithm>            // std::max
+#include <cmath>                // std::fabs
+
 #include "EnergyModel.hh"
 #include "pism/util/MaxTimestep.hh"
 #include "pism/stressbalance/StressBalance.hh"
@@ -158,6 +161,97 @@ EnergyModel::EnergyModel(IceGrid::ConstPtr grid,
                      "usually new values of temperature or enthalpy during time step",
                      "", "", "", 0);
   }
+
+  if (implicit_horizontal_advection()) {
+    m_advection_iterate.create(m_grid, "advection_iterate", WITH_GHOSTS);
+    m_advection_iterate.set_attrs("internal",
+                                  "previous iterate of temperature or enthalpy"
+                                  " (implicit horizontal advection)",
+                                  "", "", "", 0);
+  }
+}
+
+//! Returns true if horizontal advection is treated implicitly.
+bool EnergyModel::implicit_horizontal_advection() const {
+  return m_config->get_flag("energy.horizontal_advection.implicit");
+}
+
+/*!
+ * Start block Jacobi iterations used to treat horizontal advection implicitly: copy
+ * `input` (temperature or enthalpy at the beginning of the time step) to
+ * m_advection_iterate.
+ */
+void EnergyModel::init_advection_iterate(const IceModelVec3 &input) {
+  IceModelVec::AccessList list{&input, &m_advection_iterate};
+
+  for (Points p(*m_grid); p; p.next()) {
+    const int i = p.i(), j = p.j();
+
+    m_advection_iterate.set_column(i, j, input.get_column(i, j));
+  }
+
+  m_advection_iterate.update_ghosts();
+}
+
+/*!
+ * Check if block Jacobi iterations used to treat horizontal advection implicitly are done
+ * and copy new values (in m_work) to m_advection_iterate.
+ *
+ * Each iteration solves all column systems using values in neighboring columns from the
+ * previous iteration. Iterations converge because the upwinded system is diagonally
+ * dominant; the convergence rate depends on the horizontal Courant number.
+ *
+ * Returns true if the relative change is below energy.horizontal_advection.relative_tolerance
+ * or if `iteration` reached energy.horizontal_advection.max_iterations.
+ */
+bool EnergyModel::advection_iterations_done(int iteration) {
+  const unsigned int Mz = m_grid->Mz();
+
+  // maximum change and maximum absolute value
+  double local[2] = {0.0, 0.0};
+  {
+    IceModelVec::AccessList list{&m_work, &m_advection_iterate};
+
+    for (Points p(*m_grid); p; p.next()) {
+      const int i = p.i(), j = p.j();
+
+      const double
+        *new_value = m_work.get_column(i, j),
+        *old_value = m_advection_iterate.get_column(i, j);
+
+      for (unsigned int k = 0; k < Mz; ++k) {
+        local[0] = std::max(local[0], std::fabs(new_value[k] - old_value[k]));
+        local[1] = std::max(local[1], std::fabs(new_value[k]));
+      }
+    }
+  }
+
+  double global[2] = {0.0, 0.0};
+  GlobalMax(m_grid->com, local, global, 2);
+
+  m_work.update_ghosts(m_advection_iterate);
+
+  const double
+    relative_change = global[1] > 0.0 ? global[0] / global[1] : 0.0,
+    tolerance       = m_config->get_number("energy.horizontal_advection.relative_tolerance");
+  const int
+    max_iterations  = m_config->get_number("energy.horizontal_advection.max_iterations");
+
+  if (relative_change <= tolerance) {
+    m_log->message(3, "  implicit horizontal advection: %d iterations (relative change: %e)\n",
+                   iteration + 1, relative_change);
+    return true;
+  }
+
+  if (iteration + 1 >= max_iterations) {
+    m_log->message(2,
+                   "PISM WARNING: implicit horizontal advection did not converge"
+                   " after %d iterations (relative change: %e)\n",
+                   iteration + 1, relative_change);
+    return true;
+  }
+
+  return false;
 }
 
 void EnergyModel::init_enthalpy(const File &input_file, bool do_regrid, int record) {
@@ -321,6 +415,11 @@ MaxTimestep EnergyModel::max_timestep_impl(double t) const {
                                   " Cannot compute max. time step.");
   }
 
+  if (implicit_horizontal_advection()) {
+    // horizontal advection is implicit and vertical advection is always implicit
+    return MaxTimestep("energy");
+  }
+
   return MaxTimestep(m_stress_balance->max_timestep_cfl_3d().dt_max.value(), "energy");
 }
 
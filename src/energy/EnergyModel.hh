@@ -1,4 +1,4 @@
-/* Copyright (C) 2016, 2017, 2018 PISM Authors
+/* Copyright (C) 2016, 2017, 2018, 2020 PISM Authors
  *
  * This file is part of PISM.
  *
@@ -135,11 +135,19 @@ protected:
 
   /*! @brief Regrid enthalpy from the -regrid_file. */
   void regrid_enthalpy();
+
+  bool implicit_horizontal_advection() const;
+  void init_advection_iterate(const IceModelVec3 &input);
+  bool advection_iterations_done(int iteration);
 protected:
   IceModelVec3 m_ice_enthalpy;
   IceModelVec3 m_work;
   IceModelVec2S m_basal_melt_rate;
 
+  //! Previous iterate of enthalpy (or temperature) used when horizontal advection is
+  //! implicit. Ghosted; allocated only if energy.horizontal_advection.implicit is set.
+  IceModelVec3 m_advection_iterate;
+
   EnergyModelStats m_stats;
 
 private:
@@ -1,4 +1,4 @@
-/* Copyright (C) 2016, 2017, 2018 PISM Authors
+/* Copyright (C) 2016, 2017, 2018, 2020 PISM Authors
  *
  * This file is part of PISM.
  *
@@ -109,6 +109,33 @@ void EnthalpyModel::update_impl(double t, double dt, const Inputs &inputs) {
   // current time does not matter here
   (void) t;
 
+  if (not implicit_horizontal_advection()) {
+    update_columns(dt, inputs, NULL);
+    return;
+  }
+
+  init_advection_iterate(m_ice_enthalpy);
+
+  for (int iteration = 0; ; ++iteration) {
+    // reported statistics describe the last iteration
+    m_stats = EnergyModelStats();
+
+    update_columns(dt, inputs, &m_advection_iterate);
+
+    if (advection_iterations_done(iteration)) {
+      break;
+    }
+  }
+}
+
+/*!
+ * Update enthalpy in all columns, putting results in m_work.
+ *
+ * If `neighbors` is not NULL, horizontal advection is treated implicitly using enthalpy in
+ * neighboring columns from `neighbors`.
+ */
+void EnthalpyModel::update_columns(double dt, const Inputs &inputs,
+                                   const IceModelVec3 *neighbors) {
   EnthalpyConverter::Ptr EC = m_grid->ctx()->enthalpy_converter();
 
   const double
@@ -150,6 +177,11 @@ void EnthalpyModel::update_impl(double t, double dt, const Inputs &inputs) {
       &cell_type, &u3, &v3, &w3, &strain_heating3, &m_basal_melt_rate, &m_ice_enthalpy,
       &m_work};
 
+  if (neighbors != NULL) {
+    system.set_implicit_horizontal_advection(*neighbors);
+    list.add(*neighbors);
+  }
+
   double margin_threshold = m_config->get_number("energy.margin_ice_thickness_limit");
   
   double tillwatmax  = m_config->get_number("hydrology.tillwat_max"),
@@ -157,6 +189,9 @@ void EnthalpyModel::update_impl(double t, double dt, const Inputs &inputs) {
          H_critical = tillwatmax * dt / one_year;
 
   unsigned int liquifiedCount = 0;
+  // total area of columns containing liquified ice, counting each liquified layer (used on
+  // non-uniform grids)
+  double liquified_area = 0.0;
 
   ParallelSection loop(m_grid->com);
   try {
@@ -252,6 +287,7 @@ void EnthalpyModel::update_impl(double t, double dt, const Inputs &inputs) {
 
             if (Enthnew[k] >= system.Enth_s(k) + 0.5 * L) {
               liquifiedCount++; // count these rare events...
+              liquified_area += m_grid->cell_area(i, j);
               Enthnew[k] = system.Enth_s(k) + 0.5 * L; //  but lose the energy
             }
 
@@ -388,7 +424,11 @@ void EnthalpyModel::update_impl(double t, double dt, const Inputs &inputs) {
   }
   loop.check();
 
-  m_stats.liquified_ice_volume = ((double) liquifiedCount) * dz * m_grid->cell_area();
+  if (m_grid->uniform()) {
+    m_stats.liquified_ice_volume = ((double) liquifiedCount) * dz * m_grid->cell_area();
+  } else {
+    m_stats.liquified_ice_volume = liquified_area * dz;
+  }
 }
 
 void EnthalpyModel::define_model_state_impl(const File &output) const {
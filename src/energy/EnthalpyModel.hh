@@ -1,4 +1,4 @@
-/* Copyright (C) 2016, 2017 PISM Authors
+/* Copyright (C) 2016, 2017, 2020 PISM Authors
  *
  * This file is part of PISM.
  *
@@ -48,6 +48,8 @@ protected:
   using EnergyModel::update_impl;
   virtual void update_impl(double t, double dt, const Inputs &inputs);
 
+  void update_columns(double dt, const Inputs &inputs, const IceModelVec3 *neighbors);
+
   virtual void define_model_state_impl(const File &output) const;
   virtual void write_model_state_impl(const File &output) const;
 };
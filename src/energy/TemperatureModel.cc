@@ -1,4 +1,4 @@
-/* Copyright (C) 2016, 2017, 2018, 2019 PISM Authors
+/* Copyright (C) 2016, 2017, 2018, 2019, 2020 PISM Authors
  *
  * This file is part of PISM.
  *
@@ -167,6 +167,38 @@ void TemperatureModel::update_impl(double t, double dt, const Inputs &inputs) {
   // current time does not matter here
   (void) t;
 
+  if (not implicit_horizontal_advection()) {
+    update_columns(dt, inputs, NULL);
+  } else {
+    init_advection_iterate(m_ice_temperature);
+
+    for (int iteration = 0; ; ++iteration) {
+      // reported statistics describe the last iteration
+      m_stats = EnergyModelStats();
+
+      update_columns(dt, inputs, &m_advection_iterate);
+
+      if (advection_iterations_done(iteration)) {
+        break;
+      }
+    }
+  }
+
+  // copy to m_ice_temperature, updating ghosts
+  m_work.update_ghosts(m_ice_temperature);
+
+  // Set ice enthalpy in place. EnergyModel::update will scatter ghosts
+  compute_enthalpy_cold(m_work, *inputs.ice_thickness, m_work);
+}
+
+/*!
+ * Update temperature in all columns, putting results in m_work.
+ *
+ * If `neighbors` is not NULL, horizontal advection is treated implicitly using temperature
+ * in neighboring columns from `neighbors`.
+ */
+void TemperatureModel::update_columns(double dt, const Inputs &inputs,
+                                      const IceModelVec3 *neighbors) {
   using mask::ocean;
 
   Logger log(MPI_COMM_SELF, m_log->get_threshold());
@@ -210,6 +242,11 @@ void TemperatureModel::update_impl(double t, double dt, const Inputs &inputs) {
                                *m_config,
                                m_ice_temperature, u3, v3, w3, strain_heating3);
 
+  if (neighbors != NULL) {
+    system.set_implicit_horizontal_advection(*neighbors);
+    list.add(*neighbors);
+  }
+
   double dz = system.dz();
   const std::vector<double>& z_fine = system.z();
   size_t Mz_fine = z_fine.size();
@@ -227,6 +264,8 @@ void TemperatureModel::update_impl(double t, double dt, const Inputs &inputs) {
     for (Points p(*m_grid); p; p.next()) {
       const int i = p.i(), j = p.j();
 
+      const double cell_area = m_grid->cell_area(i, j);
+
       MaskValue mask = static_cast<MaskValue>(cell_type.as_int(i,j));
 
       const double H = ice_thickness(i, j);
@@ -267,7 +306,7 @@ void TemperatureModel::update_impl(double t, double dt, const Inputs &inputs) {
           if (x[k] > Tpmp) {
             Tnew[k] = Tpmp;
             double Texcess = x[k] - Tpmp; // always positive
-            column_drainage(ice_density, ice_c, L, z_fine[k], dz, &Texcess, &bwatnew);
+            column_drainage(ice_density, ice_c, L, z_fine[k], dz, cell_area, &Texcess, &bwatnew);
             // Texcess  will always come back zero here; ignore it
           } else {
             Tnew[k] = x[k];
@@ -298,9 +337,9 @@ void TemperatureModel::update_impl(double t, double dt, const Inputs &inputs) {
           if (ocean(mask)) {
             // when floating, only half a segment has had its temperature raised
             // above Tpmp
-            column_drainage(ice_density, ice_c, L, 0.0, dz/2.0, &Texcess, &bwatnew);
+            column_drainage(ice_density, ice_c, L, 0.0, dz/2.0, cell_area, &Texcess, &bwatnew);
           } else {
-            column_drainage(ice_density, ice_c, L, 0.0, dz, &Texcess, &bwatnew);
+            column_drainage(ice_density, ice_c, L, 0.0, dz, cell_area, &Texcess, &bwatnew);
           }
           Tnew[0] = Tpmp + Texcess;
           if (Tnew[0] > (Tpmp + 0.00001)) {
@@ -351,12 +390,6 @@ void TemperatureModel::update_impl(double t, double dt, const Inputs &inputs) {
     throw RuntimeError::formatted(PISM_ERROR_LOCATION, "too many low temps: %d",
                                   m_stats.low_temperature_counter);
   }
-
-  // copy to m_ice_temperature, updating ghosts
-  m_work.update_ghosts(m_ice_temperature);
-
-  // Set ice enthalpy in place. EnergyModel::update will scatter ghosts
-  compute_enthalpy_cold(m_work, ice_thickness, m_work);
 }
 
 void TemperatureModel::define_model_state_impl(const File &output) const {
@@ -372,12 +405,14 @@ void TemperatureModel::write_model_state_impl(const File &output) const {
 }
 
 //! Compute the melt water which should go to the base if \f$T\f$ is above pressure-melting.
+/*!
+ * `darea` is the area of the current grid cell.
+ */
 void TemperatureModel::column_drainage(const double rho, const double c, const double L,
-                                       const double z, const double dz,
+                                       const double z, const double dz, const double darea,
                                        double *Texcess, double *bwat) const {
 
   const double
-    darea      = m_grid->cell_area(),
     dvol       = darea * dz,
     dE         = rho * c * (*Texcess) * dvol,
     massmelted = dE / L;
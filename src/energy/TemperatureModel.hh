@@ -1,4 +1,4 @@
-/* Copyright (C) 2016, 2017 PISM Authors
+/* Copyright (C) 2016, 2017, 2020 PISM Authors
  *
  * This file is part of PISM.
  *
@@ -49,11 +49,13 @@ protected:
   using EnergyModel::update_impl;
   void update_impl(double t, double dt, const Inputs &inputs);
 
+  void update_columns(double dt, const Inputs &inputs, const IceModelVec3 *neighbors);
+
   void define_model_state_impl(const File &output) const;
   void write_model_state_impl(const File &output) const;
 
   void column_drainage(const double rho, const double c, const double L,
-                       const double z, const double dz,
+                       const double z, const double dz, const double darea,
                        double *Texcess, double *bwat) const;
 
   IceModelVec3 m_ice_temperature;
@@ -1,4 +1,4 @@
-// Copyright (C) 2009-2018 Andreas Aschwanden and Ed Bueler and Constantine Khroulev
+// Copyright (C) 2009-2018, 2020 Andreas Aschwanden and Ed Bueler and Constantine Khroulev
 //
 // This file is part of PISM.
 //
@@ -39,8 +39,10 @@ enthSystemCtx::enthSystemCtx(const std::vector<double>& storage_grid,
                              const IceModelVec3 &strain_heating3,
                              EnthalpyConverter::Ptr EC)
 : columnSystemCtx(storage_grid, prefix, dx, dy, dt, u3, v3, w3),
+  m_implicit_horizontal_advection(false),
   m_Enth3(Enth3),
   m_strain_heating3(strain_heating3),
+  m_Enth3_neighbors(&Enth3),
   m_EC(EC) {
 
   // set some values so we can check if init was called
@@ -134,10 +136,10 @@ void enthSystemCtx::init(int i, int j, bool marginal, double ice_thickness) {
   coarse_to_fine(m_strain_heating3, m_i, m_j, &m_strain_heating[0]);
   coarse_to_fine(m_Enth3, m_i, m_j, &m_Enth[0]);
 
-  coarse_to_fine(m_Enth3, m_i, m_j+1, &m_E_n[0]);
-  coarse_to_fine(m_Enth3, m_i+1, m_j, &m_E_e[0]);
-  coarse_to_fine(m_Enth3, m_i, m_j-1, &m_E_s[0]);
-  coarse_to_fine(m_Enth3, m_i-1, m_j, &m_E_w[0]);
+  coarse_to_fine(*m_Enth3_neighbors, m_i, m_j+1, &m_E_n[0]);
+  coarse_to_fine(*m_Enth3_neighbors, m_i+1, m_j, &m_E_e[0]);
+  coarse_to_fine(*m_Enth3_neighbors, m_i, m_j-1, &m_E_s[0]);
+  coarse_to_fine(*m_Enth3_neighbors, m_i-1, m_j, &m_E_w[0]);
 
   compute_enthalpy_CTS();
 
@@ -198,10 +200,41 @@ void enthSystemCtx::set_surface_dirichlet_bc(double E_surface) {
   m_B_ks = E_surface;
 }
 
-static inline double upwind(double u, double E_m, double E, double E_p, double delta_inverse) {
+static inline double upwind(double u, double E_m, double E, double E_p,
+                            double delta_m, double delta_p) {
+  const double delta_inverse = 1.0 / (u < 0 ? delta_p : delta_m);
   return u * delta_inverse * (u < 0 ? (E_p -  E) : (E  - E_m));
 }
 
+//! Treat horizontal advection implicitly.
+/*!
+  Enthalpy in the current column is treated as unknown, so the upwinded horizontal
+  advection term contributes to the diagonal entry. Enthalpy in neighboring columns is
+  taken from `Enth3_neighbors`, which is usually the previous iterate of the block Jacobi
+  iteration in EnthalpyModel::update_impl().
+
+  This removes the 3D CFL time step restriction: the resulting system is diagonally
+  dominant for any time step length.
+
+  Has to be called before init().
+ */
+void enthSystemCtx::set_implicit_horizontal_advection(const IceModelVec3 &Enth3_neighbors) {
+  m_implicit_horizontal_advection = true;
+  m_Enth3_neighbors = &Enth3_neighbors;
+}
+
+//! Add implicitly treated horizontal advection at the level `k` to the diagonal entry `D` and the right-hand side `B`.
+void enthSystemCtx::add_implicit_horizontal_advection(unsigned int k, double &D, double &B) const {
+  const double
+    C_x = m_dt * fabs(m_u[k]) / (m_u[k] < 0 ? m_dx_e : m_dx_w),
+    C_y = m_dt * fabs(m_v[k]) / (m_v[k] < 0 ? m_dy_n : m_dy_s),
+    E_x = m_u[k] < 0 ? m_E_e[k] : m_E_w[k],
+    E_y = m_v[k] < 0 ? m_E_n[k] : m_E_s[k];
+
+  D += C_x + C_y;
+  B += C_x * E_x + C_y * E_y;
+}
+
 
 //! Set the top surface heat flux *into* the ice.
 /** @param[in] heat_flux prescribed heat flux (positive means flux into the ice)
@@ -247,9 +280,9 @@ void enthSystemCtx::set_surface_neumann_bc(double G) {
   // treat horizontal velocity using first-order upwinding:
   double upwind_u = 0.0;
   double upwind_v = 0.0;
-  if (include_horizontal_advection) {
-    upwind_u = upwind(m_u[m_ks], m_E_w[m_ks], m_Enth[m_ks], m_E_e[m_ks], 1.0 / m_dx);
-    upwind_v = upwind(m_v[m_ks], m_E_s[m_ks], m_Enth[m_ks], m_E_n[m_ks], 1.0 / m_dy);
+  if (include_horizontal_advection and not m_implicit_horizontal_advection) {
+    upwind_u = upwind(m_u[m_ks], m_E_w[m_ks], m_Enth[m_ks], m_E_e[m_ks], m_dx_w, m_dx_e);
+    upwind_v = upwind(m_v[m_ks], m_E_s[m_ks], m_Enth[m_ks], m_E_n[m_ks], m_dy_s, m_dy_n);
   }
   double Sigma    = 0.0;
   if (include_strain_heating) {
@@ -257,6 +290,10 @@ void enthSystemCtx::set_surface_neumann_bc(double G) {
   }
 
   m_B_ks += m_dt * ((Sigma / m_ice_density) - upwind_u - upwind_v);  // = rhs[m_ks]
+
+  if (include_horizontal_advection and m_implicit_horizontal_advection) {
+    add_implicit_horizontal_advection(m_ks, m_D_ks, m_B_ks);
+  }
 }
 
 void enthSystemCtx::checkReadyToSolve() {
@@ -362,9 +399,9 @@ void enthSystemCtx::set_basal_neumann_bc(double G) {
   // treat horizontal velocity using first-order upwinding:
   double upwind_u = 0.0;
   double upwind_v = 0.0;
-  if (include_horizontal_advection) {
-    upwind_u = upwind(m_u[0], m_E_w[0], m_Enth[0], m_E_e[0], 1.0 / m_dx);
-    upwind_v = upwind(m_v[0], m_E_s[0], m_Enth[0], m_E_n[0], 1.0 / m_dy);
+  if (include_horizontal_advection and not m_implicit_horizontal_advection) {
+    upwind_u = upwind(m_u[0], m_E_w[0], m_Enth[0], m_E_e[0], m_dx_w, m_dx_e);
+    upwind_v = upwind(m_v[0], m_E_s[0], m_Enth[0], m_E_n[0], m_dy_s, m_dy_n);
   }
   double Sigma    = 0.0;
   if (include_strain_heating) {
@@ -372,6 +409,10 @@ void enthSystemCtx::set_basal_neumann_bc(double G) {
   }
 
   m_B0 += m_dt * ((Sigma / m_ice_density) - upwind_u - upwind_v);  // = rhs[m_ks]
+
+  if (include_horizontal_advection and m_implicit_horizontal_advection) {
+    add_implicit_horizontal_advection(0, m_D0, m_B0);
+  }
 }
 
 
@@ -495,10 +536,7 @@ void enthSystemCtx::solve(std::vector<double> &x) {
   S.U(0)   = m_U0;
   S.RHS(0) = m_B0;
 
-  const double
-    one_over_rho = 1.0 / m_ice_density,
-    Dx = 1.0 / m_dx,
-    Dy = 1.0 / m_dy;
+  const double one_over_rho = 1.0 / m_ice_density;
 
   const bool include_horizontal_advection = not (m_marginal and m_exclude_horizontal_advection);
   const bool include_strain_heating       = not (m_marginal and m_exclude_strain_heat);
@@ -522,9 +560,9 @@ void enthSystemCtx::solve(std::vector<double> &x) {
     // horizontal velocity and strain heating
     double upwind_u = 0.0;
     double upwind_v = 0.0;
-    if (include_horizontal_advection) {
-      upwind_u = upwind(m_u[k], m_E_w[k], m_Enth[k], m_E_e[k], Dx);
-      upwind_v = upwind(m_v[k], m_E_s[k], m_Enth[k], m_E_n[k], Dy);
+    if (include_horizontal_advection and not m_implicit_horizontal_advection) {
+      upwind_u = upwind(m_u[k], m_E_w[k], m_Enth[k], m_E_e[k], m_dx_w, m_dx_e);
+      upwind_v = upwind(m_v[k], m_E_s[k], m_Enth[k], m_E_n[k], m_dy_s, m_dy_n);
     }
     double Sigma    = 0.0;
     if (include_strain_heating) {
@@ -532,6 +570,10 @@ void enthSystemCtx::solve(std::vector<double> &x) {
     }
 
     S.RHS(k) = m_Enth[k] + m_dt * (one_over_rho * Sigma - upwind_u - upwind_v);
+
+    if (include_horizontal_advection and m_implicit_horizontal_advection) {
+      add_implicit_horizontal_advection(k, S.D(k), S.RHS(k));
+    }
   }
 
   // Assemble the top surface equation. Values m_{L,D,U,B}_ks are set using set_surface_dirichlet()
@@ -1,4 +1,4 @@
-// Copyright (C) 2009-2011, 2013, 2014, 2015, 2016, 2017, 2018 Andreas Aschwanden and Ed Bueler
+// Copyright (C) 2009-2011, 2013, 2014, 2015, 2016, 2017, 2018, 2020 Andreas Aschwanden and Ed Bueler
 //
 // This file is part of PISM.
 //
@@ -63,6 +63,8 @@ public:
   void set_basal_heat_flux(double hf);
   void set_basal_neumann_bc(double dE);
 
+  void set_implicit_horizontal_advection(const IceModelVec3 &Enth3_neighbors);
+
   virtual void save_system(std::ostream &output, unsigned int M) const;
 
   void solve(std::vector<double> &result);
@@ -107,7 +109,12 @@ protected:
   bool m_exclude_vertical_advection;
   bool m_exclude_strain_heat;
 
+  //! true if horizontal advection is treated implicitly
+  bool m_implicit_horizontal_advection;
+
   const IceModelVec3 &m_Enth3, &m_strain_heating3;
+  //! enthalpy used in neighboring columns
+  const IceModelVec3 *m_Enth3_neighbors;
   EnthalpyConverter::Ptr m_EC;  // conductivity has known dependence on T, not enthalpy
 
   void compute_enthalpy_CTS();
@@ -115,6 +122,7 @@ protected:
 
   void assemble_R();
   void checkReadyToSolve();
+  void add_implicit_horizontal_advection(unsigned int k, double &D, double &B) const;
 };
 
 } // end of namespace energy
@@ -1,4 +1,4 @@
-// Copyright (C) 2004-2011, 2013, 2014, 2015, 2016, 2017, 2018 Jed Brown, Ed Bueler and Constantine Khroulev
+// Copyright (C) 2004-2011, 2013, 2014, 2015, 2016, 2017, 2018, 2020 Jed Brown, Ed Bueler and Constantine Khroulev
 //
 // This file is part of PISM.
 //
@@ -17,6 +17,7 @@
 // Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include <cassert>
+#include <cmath>                // fabs
 
 #include "pism/util/pism_utilities.hh"
 #include "pism/util/iceModelVec.hh"
@@ -39,7 +40,9 @@ tempSystemCtx::tempSystemCtx(const std::vector<double>& storage_grid,
                              const IceModelVec3 &strain_heating3)
   : columnSystemCtx(storage_grid, prefix, dx, dy, dt, u3, v3, w3),
     m_T3(T3),
-    m_strain_heating3(strain_heating3) {
+    m_strain_heating3(strain_heating3),
+    m_T3_neighbors(&T3),
+    m_implicit_horizontal_advection(false) {
 
   // set flags to indicate nothing yet set
   m_surfBCsValid      = false;
@@ -84,10 +87,10 @@ void tempSystemCtx::initThisColumn(int i, int j, bool is_marginal, MaskValue mas
   coarse_to_fine(m_strain_heating3, m_i, m_j, &m_strain_heating[0]);
   coarse_to_fine(m_T3, m_i, m_j, &m_T[0]);
 
-  coarse_to_fine(m_T3, m_i, m_j+1, &m_T_n[0]);
-  coarse_to_fine(m_T3, m_i+1, m_j, &m_T_e[0]);
-  coarse_to_fine(m_T3, m_i, m_j-1, &m_T_s[0]);
-  coarse_to_fine(m_T3, m_i-1, m_j, &m_T_w[0]);
+  coarse_to_fine(*m_T3_neighbors, m_i, m_j+1, &m_T_n[0]);
+  coarse_to_fine(*m_T3_neighbors, m_i+1, m_j, &m_T_e[0]);
+  coarse_to_fine(*m_T3_neighbors, m_i, m_j-1, &m_T_s[0]);
+  coarse_to_fine(*m_T3_neighbors, m_i-1, m_j, &m_T_w[0]);
 
   m_lambda = compute_lambda();
 }
@@ -112,6 +115,33 @@ void tempSystemCtx::setBasalBoundaryValuesThisColumn(double my_G0,
   m_basalBCsValid = true;
 }
 
+//! Treat horizontal advection implicitly.
+/*!
+  Temperature in the current column is treated as unknown; temperature in neighboring
+  columns is taken from `T3_neighbors` (usually the previous iterate of the block Jacobi
+  iteration in TemperatureModel::update_impl()). This removes the 3D CFL time step
+  restriction.
+
+  Has to be called before initThisColumn().
+ */
+void tempSystemCtx::set_implicit_horizontal_advection(const IceModelVec3 &T3_neighbors) {
+  m_implicit_horizontal_advection = true;
+  m_T3_neighbors = &T3_neighbors;
+}
+
+//! Add implicitly treated horizontal advection at the level `k`, scaled by `weight`, to the diagonal entry `D` and the right-hand side `RHS`.
+void tempSystemCtx::add_implicit_horizontal_advection(unsigned int k, double weight,
+                                                      double &D, double &RHS) const {
+  const double
+    C_x = m_dt * fabs(m_u[k]) / (m_u[k] < 0 ? m_dx_e : m_dx_w),
+    C_y = m_dt * fabs(m_v[k]) / (m_v[k] < 0 ? m_dy_n : m_dy_s),
+    T_x = m_u[k] < 0 ? m_T_e[k] : m_T_w[k],
+    T_y = m_v[k] < 0 ? m_T_n[k] : m_T_s[k];
+
+  D   += weight * (C_x + C_y);
+  RHS += weight * (C_x * T_x + C_y * T_y);
+}
+
 double tempSystemCtx::compute_lambda() {
   double result = 1.0; // start with centered implicit for more accuracy
   const double epsilon = 1e-6 / 3.15569259747e7;
@@ -162,13 +192,13 @@ void tempSystemCtx::solveThisColumn(std::vector<double> &x) {
 
       double UpTu = 0.0;
       double UpTv = 0.0;
-      if (not m_is_marginal) {
+      if (not m_is_marginal and not m_implicit_horizontal_advection) {
         UpTu = (m_u[0] < 0 ?
-                m_u[0] * (m_T_e[0] -  m_T[0]) / m_dx :
-                m_u[0] * (m_T[0]  - m_T_w[0]) / m_dx);
+                m_u[0] * (m_T_e[0] -  m_T[0]) / m_dx_e :
+                m_u[0] * (m_T[0]  - m_T_w[0]) / m_dx_w);
         UpTv = (m_v[0] < 0 ?
-                m_v[0] * (m_T_n[0] -  m_T[0]) / m_dy :
-                m_v[0] * (m_T[0]  - m_T_s[0]) / m_dy);
+                m_v[0] * (m_T_n[0] -  m_T[0]) / m_dy_n :
+                m_v[0] * (m_T[0]  - m_T_s[0]) / m_dy_s);
       }
       S.RHS(0) -= m_dt  * (0.5 * (UpTu + UpTv));
 
@@ -183,6 +213,10 @@ void tempSystemCtx::solveThisColumn(std::vector<double> &x) {
       }
       // apply geothermal flux G0 here
       S.RHS(0) += 2.0 * m_dt * m_G0 / (m_rho_c_I * m_dz);
+
+      if (not m_is_marginal and m_implicit_horizontal_advection) {
+        add_implicit_horizontal_advection(0, 0.5, S.D(0), S.RHS(0));
+      }
     }
   }
 
@@ -207,16 +241,20 @@ void tempSystemCtx::solveThisColumn(std::vector<double> &x) {
 
     double UpTu = 0.0;
     double UpTv = 0.0;
-    if (not m_is_marginal) {
+    if (not m_is_marginal and not m_implicit_horizontal_advection) {
       UpTu = (m_u[k] < 0 ?
-              m_u[k] * (m_T_e[k] -  m_T[k]) / m_dx :
-              m_u[k] * (m_T[k]  - m_T_w[k]) / m_dx);
+              m_u[k] * (m_T_e[k] -  m_T[k]) / m_dx_e :
+              m_u[k] * (m_T[k]  - m_T_w[k]) / m_dx_w);
       UpTv = (m_v[k] < 0 ?
-              m_v[k] * (m_T_n[k] -  m_T[k]) / m_dy :
-              m_v[k] * (m_T[k]  - m_T_s[k]) / m_dy);
+              m_v[k] * (m_T_n[k] -  m_T[k]) / m_dy_n :
+              m_v[k] * (m_T[k]  - m_T_s[k]) / m_dy_s);
     }
 
     S.RHS(k) += m_dt * (Sigma / m_rho_c_I - UpTu - UpTv);
+
+    if (not m_is_marginal and m_implicit_horizontal_advection) {
+      add_implicit_horizontal_advection(k, 1.0, S.D(k), S.RHS(k));
+    }
   }
 
   // surface b.c.
@@ -1,4 +1,4 @@
-// Copyright (C) 2009-2011, 2013, 2014, 2015, 2017 Ed Bueler
+// Copyright (C) 2009-2011, 2013, 2014, 2015, 2017, 2020 Ed Bueler
 //
 // This file is part of PISM.
 //
@@ -67,6 +67,8 @@ public:
   void setBasalBoundaryValuesThisColumn(double my_G0, double my_Tshelfbase,
                                                   double my_Rb);
 
+  void set_implicit_horizontal_advection(const IceModelVec3 &T3_neighbors);
+
   void solveThisColumn(std::vector<double> &x);
 
   double lambda() {
@@ -79,6 +81,10 @@ public:
 protected:
   double m_ice_density, m_ice_c, m_ice_k;
   const IceModelVec3 &m_T3, &m_strain_heating3;
+  //! temperature used in neighboring columns
+  const IceModelVec3 *m_T3_neighbors;
+  //! true if horizontal advection is treated implicitly
+  bool m_implicit_horizontal_advection;
 
   std::vector<double>  m_T, m_strain_heating;
   std::vector<double> m_T_n, m_T_e, m_T_s, m_T_w;
@@ -96,6 +102,7 @@ private:
     m_basalBCsValid;
 
   double compute_lambda();
+  void add_implicit_horizontal_advection(unsigned int k, double weight, double &D, double &RHS) const;
 };
 
 } // end of namespace energy
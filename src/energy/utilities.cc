@@ -226,8 +226,6 @@ double total_ice_enthalpy(double thickness_threshold,
   IceGrid::ConstPtr grid = ice_enthalpy.grid();
   Config::ConstPtr config = grid->ctx()->config();
 
-  auto cell_area = grid->cell_area();
-
   const std::vector<double> &z = grid->z();
 
   IceModelVec::AccessList list{&ice_enthalpy, &ice_thickness};
@@ -235,6 +233,7 @@ double total_ice_enthalpy(double thickness_threshold,
   try {
     for (Points p(*grid); p; p.next()) {
       const int i = p.i(), j = p.j();
+      const double cell_area = grid->cell_area(i, j);
 
       const double H = ice_thickness(i, j);
 
@@ -44,6 +44,7 @@ FractureDensity::FractureDensity(IceGrid::ConstPtr grid,
                           3), // dof
     m_velocity(grid, "ghosted_velocity", WITH_GHOSTS, 1),
     m_flow_law(flow_law) {
+  require_uniform_grid(*m_grid, "the fracture density model");
 
   m_density.set_attrs("model_state", "fracture density in ice shelf", "1", "1", "", 0);
   m_density.metadata().set_number("valid_max", 1.0);
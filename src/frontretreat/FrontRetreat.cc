@@ -24,12 +24,14 @@
 #include "pism/util/pism_utilities.hh"
 #include "pism/geometry/part_grid_threshold_thickness.hh"
 #include "pism/geometry/Geometry.hh"
+#include "pism/frontretreat/util/FrontBand.hh"
 
 namespace pism {
 
 FrontRetreat::FrontRetreat(IceGrid::ConstPtr g)
   : Component(g),
     m_tmp(m_grid, "temporary_storage", WITH_GHOSTS, 1) {
+  require_uniform_grid(*m_grid, "the front retreat code");
 
   m_tmp.set_attrs("internal", "additional mass loss at points near the front",
                   "m", "m", "", 0);
@@ -77,6 +79,21 @@ void FrontRetreat::compute_modified_mask(const IceModelVec2CellType &input,
 MaxTimestep FrontRetreat::max_timestep(const IceModelVec2CellType &cell_type,
                                        const IceModelVec2Int &bc_mask,
                                        const IceModelVec2S &retreat_rate) const {
+  FrontBand front(m_grid);
+  front.reset(cell_type);
+
+  return max_timestep(cell_type, front, bc_mask, retreat_rate);
+}
+
+/*!
+ * Compute the maximum time step length provided a horizontal retreat rate.
+ *
+ * Only cells in `front` are examined; `front` has to be consistent with `cell_type`.
+ */
+MaxTimestep FrontRetreat::max_timestep(const IceModelVec2CellType &cell_type,
+                                       const FrontBand &front,
+                                       const IceModelVec2Int &bc_mask,
+                                       const IceModelVec2S &retreat_rate) const {
 
   IceGrid::ConstPtr grid = retreat_rate.grid();
   units::System::Ptr sys = grid->ctx()->unit_system();
@@ -93,7 +110,7 @@ MaxTimestep FrontRetreat::max_timestep(const IceModelVec2CellType &cell_type,
 
   IceModelVec::AccessList list{&cell_type, &bc_mask, &retreat_rate};
 
-  for (Points pt(*grid); pt; pt.next()) {
+  for (FrontBand::Points pt(front); pt; pt.next()) {
     const int i = pt.i(), j = pt.j();
 
     if (cell_type.ice_free_ocean(i, j) and
@@ -152,6 +169,25 @@ void FrontRetreat::update_geometry(double dt,
                                    const IceModelVec2S &retreat_rate,
                                    IceModelVec2S &Href,
                                    IceModelVec2S &ice_thickness) {
+  FrontBand front(m_grid);
+  front.reset(geometry.cell_type);
+
+  update_geometry(dt, geometry, front, bc_mask, retreat_rate, Href, ice_thickness);
+}
+
+/*!
+ * Update ice geometry by applying a horizontal retreat rate.
+ *
+ * Same as above, but uses cells in `front` (which has to be consistent with
+ * `geometry.cell_type`) instead of scanning the whole grid.
+ */
+void FrontRetreat::update_geometry(double dt,
+                                   const Geometry &geometry,
+                                   const FrontBand &front,
+                                   const IceModelVec2Int &bc_mask,
+                                   const IceModelVec2S &retreat_rate,
+                                   IceModelVec2S &Href,
+                                   IceModelVec2S &ice_thickness) {
 
   const IceModelVec2S &bed = geometry.bed_elevation;
   const IceModelVec2S &sea_level = geometry.sea_level_elevation;
@@ -177,7 +213,7 @@ void FrontRetreat::update_geometry(double dt,
   const Direction dirs[] = {North, East, South, West};
 
   // Step 1: Apply the computed horizontal retreat rate:
-  for (Points pt(*m_grid); pt; pt.next()) {
+  for (FrontBand::Points pt(front); pt; pt.next()) {
     const int i = pt.i(), j = pt.j();
 
     // apply retreat rate at the margin (i.e. to partially-filled cells) only
@@ -250,7 +286,9 @@ void FrontRetreat::update_geometry(double dt,
   // Step 2: update ice thickness and Href in neighboring cells if we need to propagate mass losses.
   m_tmp.update_ghosts();
 
-  for (Points p(*m_grid); p; p.next()) {
+  // Cells receiving mass losses are icy cells next to ice-free cells, i.e. they are in
+  // the front band.
+  for (FrontBand::Points p(front); p; p.next()) {
     const int i = p.i(), j = p.j();
 
     // Note: this condition has to match the one in step 1 above.
@@ -28,6 +28,7 @@
 namespace pism {
 
 class Geometry;
+class FrontBand;
 
 //! An abstract class implementing calving front retreat resulting from application of a
 //! spatially-variable horizontal retreat rate.
@@ -46,7 +47,20 @@ public:
                        IceModelVec2S &Href,
                        IceModelVec2S &ice_thickness);
 
+  void update_geometry(double dt,
+                       const Geometry &geometry,
+                       const FrontBand &front,
+                       const IceModelVec2Int &bc_mask,
+                       const IceModelVec2S &retreat_rate,
+                       IceModelVec2S &Href,
+                       IceModelVec2S &ice_thickness);
+
+  MaxTimestep max_timestep(const IceModelVec2CellType &cell_type,
+                           const IceModelVec2Int &bc_mask,
+                           const IceModelVec2S &retreat_rate) const;
+
   MaxTimestep max_timestep(const IceModelVec2CellType &cell_type,
+                           const FrontBand &front,
                            const IceModelVec2Int &bc_mask,
                            const IceModelVec2S &retreat_rate) const;
 private:
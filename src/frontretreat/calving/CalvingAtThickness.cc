@@ -22,6 +22,7 @@
 #include "pism/util/Mask.hh"
 #include "pism/util/IceGrid.hh"
 #include "pism/util/pism_utilities.hh"
+#include "pism/frontretreat/util/FrontBand.hh"
 
 namespace pism {
 
@@ -79,12 +80,27 @@ void CalvingAtThickness::init() {
  */
 void CalvingAtThickness::update(IceModelVec2CellType &pism_mask,
                                 IceModelVec2S &ice_thickness) {
+  FrontBand front(m_grid);
+  front.reset(pism_mask);
+
+  update(pism_mask, front, ice_thickness);
+}
+
+/**
+ * Same as above, but examines cells in `front` only. Floating cells next to ice-free
+ * ocean are always in the front band.
+ *
+ * Note that `front` is not updated.
+ */
+void CalvingAtThickness::update(IceModelVec2CellType &pism_mask,
+                                const FrontBand &front,
+                                IceModelVec2S &ice_thickness) {
 
   // this call fills ghosts of m_old_mask
   m_old_mask.copy_from(pism_mask);
 
   IceModelVec::AccessList list{&pism_mask, &ice_thickness, &m_old_mask, &m_calving_threshold};
-  for (Points p(*m_grid); p; p.next()) {
+  for (FrontBand::Points p(front); p; p.next()) {
     const int i = p.i(), j = p.j();
 
     if (m_old_mask.floating_ice(i, j)           &&
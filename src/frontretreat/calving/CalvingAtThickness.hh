@@ -25,6 +25,9 @@
 #include "pism/util/IceModelVec2CellType.hh"
 
 namespace pism {
+
+class FrontBand;
+
 namespace calving {
 
 /*! \brief Calving mechanism removing the ice at the shelf front that
@@ -37,6 +40,8 @@ public:
 
   virtual void init();
   void update(IceModelVec2CellType &pism_mask, IceModelVec2S &ice_thickness);
+  void update(IceModelVec2CellType &pism_mask, const FrontBand &front,
+              IceModelVec2S &ice_thickness);
   const IceModelVec2S& threshold() const;
 
 protected:
@@ -24,6 +24,7 @@
 #include "pism/util/IceModelVec2CellType.hh"
 #include "pism/stressbalance/StressBalance.hh"
 #include "pism/geometry/Geometry.hh"
+#include "pism/frontretreat/util/FrontBand.hh"
 
 namespace pism {
 namespace calving {
@@ -63,6 +64,19 @@ void EigenCalving::init() {
 */
 void EigenCalving::update(const IceModelVec2CellType &cell_type,
                           const IceModelVec2V &ice_velocity) {
+  FrontBand front(m_grid);
+  front.reset(cell_type);
+
+  update(cell_type, front, ice_velocity);
+}
+
+/*!
+ * Same as above, but computes the calving rate at cells in `front` only. The calving
+ * rate is zero elsewhere.
+ */
+void EigenCalving::update(const IceModelVec2CellType &cell_type,
+                          const FrontBand &front,
+                          const IceModelVec2V &ice_velocity) {
 
   // make a copy with a wider stencil
   m_cell_type.copy_from(cell_type);
@@ -78,10 +92,12 @@ void EigenCalving::update(const IceModelVec2CellType &cell_type,
                                                    m_strain_rates);
   m_strain_rates.update_ghosts();
 
+  m_calving_rate.set(0.0);
+
   IceModelVec::AccessList list{&m_cell_type, &m_calving_rate, &m_strain_rates};
 
   // Compute the horizontal calving rate
-  for (Points pt(*m_grid); pt; pt.next()) {
+  for (FrontBand::Points pt(front); pt; pt.next()) {
     const int i = pt.i(), j = pt.j();
 
     // Find partially filled or empty grid boxes on the icefree ocean, which
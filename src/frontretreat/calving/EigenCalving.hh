@@ -24,6 +24,7 @@
 namespace pism {
 
 class Geometry;
+class FrontBand;
 
 namespace calving {
 
@@ -35,6 +36,9 @@ public:
   void init();
 
   void update(const IceModelVec2CellType &cell_type, const IceModelVec2V &ice_velocity);
+
+  void update(const IceModelVec2CellType &cell_type, const FrontBand &front,
+              const IceModelVec2V &ice_velocity);
 protected:
   DiagnosticList diagnostics_impl() const;
 
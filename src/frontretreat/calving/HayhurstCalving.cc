@@ -23,6 +23,7 @@
 #include "pism/util/error_handling.hh"
 #include "pism/util/IceModelVec2CellType.hh"
 #include "pism/geometry/Geometry.hh"
+#include "pism/frontretreat/util/FrontBand.hh"
 
 namespace pism {
 namespace calving {
@@ -31,6 +32,8 @@ HayhurstCalving::HayhurstCalving(IceGrid::ConstPtr grid)
   : Component(grid),
     m_calving_rate(grid, "hayhurst_calving_rate", WITH_GHOSTS)
 {
+  require_uniform_grid(*m_grid, "Hayhurst calving");
+
   m_calving_rate.set_attrs("diagnostic",
                            "horizontal calving rate due to Hayhurst calving",
                            "m s-1", "m day-1", "", 0);
@@ -70,6 +73,21 @@ void HayhurstCalving::update(const IceModelVec2CellType &cell_type,
                              const IceModelVec2S &ice_thickness,
                              const IceModelVec2S &sea_level,
                              const IceModelVec2S &bed_elevation) {
+  FrontBand front(m_grid);
+  front.reset(cell_type);
+
+  update(cell_type, front, ice_thickness, sea_level, bed_elevation);
+}
+
+/*!
+ * Same as above, but uses cells in `front` to set the calving rate near grounded
+ * termini.
+ */
+void HayhurstCalving::update(const IceModelVec2CellType &cell_type,
+                             const FrontBand &front,
+                             const IceModelVec2S &ice_thickness,
+                             const IceModelVec2S &sea_level,
+                             const IceModelVec2S &bed_elevation) {
 
   using std::min;
 
@@ -131,7 +149,7 @@ void HayhurstCalving::update(const IceModelVec2CellType &cell_type,
 
   const Direction dirs[] = {North, East, South, West};
 
-  for (Points p(*m_grid); p; p.next()) {
+  for (FrontBand::Points p(front); p; p.next()) {
     const int i = p.i(), j = p.j();
 
     if (cell_type.ice_free(i, j) and cell_type.next_to_ice(i, j) ) {
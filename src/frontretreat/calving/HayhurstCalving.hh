@@ -25,6 +25,7 @@
 namespace pism {
 
 class Geometry;
+class FrontBand;
 
 namespace calving {
 
@@ -38,6 +39,10 @@ public:
   void update(const IceModelVec2CellType &cell_type, const IceModelVec2S &ice_thickness,
               const IceModelVec2S &sea_level, const IceModelVec2S &bed_elevation);
 
+  void update(const IceModelVec2CellType &cell_type, const FrontBand &front,
+              const IceModelVec2S &ice_thickness,
+              const IceModelVec2S &sea_level, const IceModelVec2S &bed_elevation);
+
   const IceModelVec2S &calving_rate() const;
 
 protected:
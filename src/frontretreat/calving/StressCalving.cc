@@ -29,6 +29,7 @@ StressCalving::StressCalving(IceGrid::ConstPtr grid,
     m_strain_rates(m_grid, "strain_rates", WITH_GHOSTS,
                    m_stencil_width,
                    2 /* 2 components */) {
+  require_uniform_grid(*m_grid, "stress-based calving");
 
   m_strain_rates.metadata(0).set_name("eigen1");
   m_strain_rates.set_attrs("internal",
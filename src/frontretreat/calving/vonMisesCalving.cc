@@ -26,6 +26,7 @@
 #include "pism/rheology/FlowLawFactory.hh"
 #include "pism/rheology/FlowLaw.hh"
 #include "pism/geometry/Geometry.hh"
+#include "pism/frontretreat/util/FrontBand.hh"
 
 namespace pism {
 namespace calving {
@@ -100,6 +101,21 @@ void vonMisesCalving::update(const IceModelVec2CellType &cell_type,
                              const IceModelVec2S &ice_thickness,
                              const IceModelVec2V &ice_velocity,
                              const IceModelVec3 &ice_enthalpy) {
+  FrontBand front(m_grid);
+  front.reset(cell_type);
+
+  update(cell_type, front, ice_thickness, ice_velocity, ice_enthalpy);
+}
+
+/*!
+ * Same as above, but computes the calving rate at cells in `front` only. The calving
+ * rate is zero elsewhere.
+ */
+void vonMisesCalving::update(const IceModelVec2CellType &cell_type,
+                             const FrontBand &front,
+                             const IceModelVec2S &ice_thickness,
+                             const IceModelVec2V &ice_velocity,
+                             const IceModelVec3 &ice_enthalpy) {
 
   using std::max;
 
@@ -113,6 +129,8 @@ void vonMisesCalving::update(const IceModelVec2CellType &cell_type,
                                                    m_strain_rates);
   m_strain_rates.update_ghosts();
 
+  m_calving_rate.set(0.0);
+
   IceModelVec::AccessList list{&ice_enthalpy, &ice_thickness, &m_cell_type, &ice_velocity,
                                &m_strain_rates, &m_calving_rate, &m_calving_threshold};
 
@@ -120,7 +138,7 @@ void vonMisesCalving::update(const IceModelVec2CellType &cell_type,
 
   double glen_exponent = m_flow_law->exponent();
 
-  for (Points pt(*m_grid); pt; pt.next()) {
+  for (FrontBand::Points pt(front); pt; pt.next()) {
     const int i = pt.i(), j = pt.j();
 
     // Find partially filled or empty grid boxes on the icefree ocean, which
@@ -30,6 +30,8 @@ namespace rheology {
 class FlowLaw;
 } // end of namespace rheology
 
+class FrontBand;
+
 namespace calving {
 
 class vonMisesCalving : public StressCalving {
@@ -43,6 +45,13 @@ public:
               const IceModelVec2S &ice_thickness,
               const IceModelVec2V &ice_velocity,
               const IceModelVec3 &ice_enthalpy);
+
+  void update(const IceModelVec2CellType &cell_type,
+              const FrontBand &front,
+              const IceModelVec2S &ice_thickness,
+              const IceModelVec2V &ice_velocity,
+              const IceModelVec3 &ice_enthalpy);
+
   const IceModelVec2S& threshold() const;
 
 protected:
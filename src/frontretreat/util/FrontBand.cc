@@ -0,0 +1,154 @@
+/* Copyright (C) 2020 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <algorithm>            // std::sort
+
+#include "FrontBand.hh"
+
+#include "pism/util/IceModelVec2CellType.hh"
+
+namespace pism {
+
+FrontBand::FrontBand(IceGrid::ConstPtr grid)
+  : m_grid(grid) {
+  m_marked.resize(m_grid->xm() * m_grid->ym(), 0);
+}
+
+//! Returns true if (i, j) is an icy cell next to an ice-free cell or vice versa.
+bool FrontBand::front(const IceModelVec2CellType &cell_type, int i, int j) {
+  if (cell_type.icy(i, j)) {
+    return cell_type.ice_margin(i, j);
+  }
+  return cell_type.next_to_ice(i, j);
+}
+
+//! Number of cells in the band (in this sub-domain).
+size_t FrontBand::size() const {
+  return m_cells.size();
+}
+
+/*!
+ * Re-build the band by scanning the whole sub-domain.
+ *
+ * Use this if the ice extent may have changed away from the front (for example, after a
+ * mass continuity step).
+ */
+void FrontBand::reset(const IceModelVec2CellType &cell_type) {
+  m_cells.clear();
+
+  IceModelVec::AccessList list{&cell_type};
+
+  for (pism::Points p(*m_grid); p; p.next()) {
+    const int i = p.i(), j = p.j();
+
+    if (front(cell_type, i, j)) {
+      m_cells.push_back({i, j});
+    }
+  }
+}
+
+/*!
+ * Add (i, j) to `result` unless it is outside of this sub-domain or already marked.
+ */
+void FrontBand::mark(int i, int j, std::vector<Cell> &result) {
+  const int
+    xs = m_grid->xs(),
+    xm = m_grid->xm(),
+    ys = m_grid->ys(),
+    ym = m_grid->ym();
+
+  if (i < xs or i >= xs + xm or j < ys or j >= ys + ym) {
+    return;
+  }
+
+  char &flag = m_marked[(j - ys) * xm + (i - xs)];
+  if (flag == 0) {
+    flag = 1;
+    result.push_back({i, j});
+  }
+}
+
+/*!
+ * Update the band after a change of the cell type mask.
+ *
+ * Only cells within `width` cells of the current band are re-examined, so the cost of
+ * this update is proportional to the length of the front.
+ *
+ * The caller has to ensure that the ice extent changed only in cells that are within
+ * `width - 1` cells of the band (in particular, `width == 1` is sufficient if only cells
+ * *in* the band changed, which is the case for all calving and front retreat code).
+ *
+ * Cells near sub-domain boundaries are always re-examined since changes in a neighboring
+ * sub-domain may affect them.
+ */
+void FrontBand::update(const IceModelVec2CellType &cell_type, unsigned int width) {
+  const int
+    w  = width,
+    xs = m_grid->xs(),
+    xm = m_grid->xm(),
+    ys = m_grid->ys(),
+    ym = m_grid->ym();
+
+  std::vector<Cell> candidates;
+  candidates.reserve(m_cells.size() * 3);
+
+  // cells near the current band
+  for (const auto &c : m_cells) {
+    for (int m = -w; m <= w; ++m) {
+      for (int n = -w; n <= w; ++n) {
+        mark(c.i + m, c.j + n, candidates);
+      }
+    }
+  }
+
+  // cells near sub-domain boundaries
+  for (int j = ys; j < ys + ym; ++j) {
+    for (int k = 0; k < w; ++k) {
+      mark(xs + k, j, candidates);
+      mark(xs + xm - 1 - k, j, candidates);
+    }
+  }
+  for (int i = xs; i < xs + xm; ++i) {
+    for (int k = 0; k < w; ++k) {
+      mark(i, ys + k, candidates);
+      mark(i, ys + ym - 1 - k, candidates);
+    }
+  }
+
+  m_cells.clear();
+
+  IceModelVec::AccessList list{&cell_type};
+
+  for (const auto &c : candidates) {
+    m_marked[(c.j - ys) * xm + (c.i - xs)] = 0;
+
+    if (front(cell_type, c.i, c.j)) {
+      m_cells.push_back(c);
+    }
+  }
+
+  // Use the same traversal order as pism::Points: some of the code using the band
+  // modifies fields in place and depends on it.
+  std::sort(m_cells.begin(), m_cells.end(),
+            [](const Cell &a, const Cell &b) {
+              return a.j < b.j or (a.j == b.j and a.i < b.i);
+            });
+}
+
+} // end of namespace pism
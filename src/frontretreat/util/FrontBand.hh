@@ -0,0 +1,101 @@
+/* Copyright (C) 2020 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef FRONTBAND_H
+#define FRONTBAND_H
+
+#include <vector>
+
+#include "pism/util/IceGrid.hh"
+
+namespace pism {
+
+class IceModelVec2CellType;
+
+//! List of grid cells (owned by this sub-domain) at the ice front.
+/*!
+ * A cell belongs to the "front band" if it is icy and has at least one ice-free neighbor
+ * or if it is ice-free and has at least one icy neighbor (using the 4-point stencil).
+ *
+ * This is the set of cells front retreat and calving code has to look at, so iterating
+ * over it instead of the whole grid makes the cost of these computations proportional to
+ * the length of the front instead of the area of the domain.
+ *
+ * Usage:
+ *
+ * `for (FrontBand::Points p(band); p; p.next()) { int i = p.i(), j = p.j(); ... }`
+ *
+ * The cell type mask used to build and update the band has to have valid ghosts.
+ */
+class FrontBand {
+public:
+  FrontBand(IceGrid::ConstPtr grid);
+
+  void reset(const IceModelVec2CellType &cell_type);
+
+  void update(const IceModelVec2CellType &cell_type, unsigned int width = 1);
+
+  size_t size() const;
+
+  static bool front(const IceModelVec2CellType &cell_type, int i, int j);
+
+  //! Iterator class for traversing cells in the band.
+  class Points {
+  public:
+    Points(const FrontBand &band)
+      : m_band(band), m_k(0) {
+      // empty
+    }
+
+    int i() const {
+      return m_band.m_cells[m_k].i;
+    }
+    int j() const {
+      return m_band.m_cells[m_k].j;
+    }
+
+    void next() {
+      m_k += 1;
+    }
+
+    operator bool() const {
+      return m_k < m_band.m_cells.size();
+    }
+  private:
+    const FrontBand &m_band;
+    size_t m_k;
+  };
+private:
+  struct Cell {
+    int i, j;
+  };
+
+  void mark(int i, int j, std::vector<Cell> &result);
+
+  IceGrid::ConstPtr m_grid;
+
+  std::vector<Cell> m_cells;
+
+  //! Flags used to avoid adding a cell to the band twice (one per cell in the sub-domain).
+  std::vector<char> m_marked;
+};
+
+} // end of namespace pism
+
+#endif /* FRONTBAND_H */
@@ -21,6 +21,7 @@
 
 #include "pism/util/IceGrid.hh"
 #include "pism/geometry/Geometry.hh"
+#include "FrontBand.hh"
 
 namespace pism {
 
@@ -59,16 +60,27 @@ namespace pism {
  */
 void remove_narrow_tongues(const Geometry &geometry,
                            IceModelVec2S &ice_thickness) {
+  FrontBand front(geometry.cell_type.grid());
+  front.reset(geometry.cell_type);
+
+  remove_narrow_tongues(geometry, front, ice_thickness);
+}
+
+/*!
+ * Same as above, but examines cells in `front` only: a cell can be removed only if it has
+ * at least three ice-free neighbors, so it is always in the front band.
+ */
+void remove_narrow_tongues(const Geometry &geometry,
+                           const FrontBand &front,
+                           IceModelVec2S &ice_thickness) {
 
   auto &mask      = geometry.cell_type;
   auto &bed       = geometry.bed_elevation;
   auto &sea_level = geometry.sea_level_elevation;
 
-  IceGrid::ConstPtr grid = mask.grid();
-
   IceModelVec::AccessList list{&mask, &bed, &sea_level, &ice_thickness};
 
-  for (Points p(*grid); p; p.next()) {
+  for (FrontBand::Points p(front); p; p.next()) {
     const int i = p.i(), j = p.j();
     if (mask.ice_free(i,j) or
         (mask.grounded_ice(i,j) and bed(i,j) >= sea_level(i, j))) {
@@ -24,9 +24,13 @@ namespace pism {
 
 class IceModelVec2S;
 class Geometry;
+class FrontBand;
 
 void remove_narrow_tongues(const Geometry &geometry, IceModelVec2S &ice_thickness);
 
+void remove_narrow_tongues(const Geometry &geometry, const FrontBand &front,
+                           IceModelVec2S &ice_thickness);
+
 } // end of namespace pism
 
 
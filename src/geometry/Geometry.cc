@@ -1,4 +1,4 @@
-/* Copyright (C) 2017, 2018, 2019 PISM Authors
+/* Copyright (C) 2017, 2018, 2019, 2020 PISM Authors
  *
  * This file is part of PISM.
  *
@@ -230,14 +230,12 @@ double ice_volume(const Geometry &geometry, double thickness_threshold) {
 
   double volume = 0.0;
 
-  auto cell_area = grid->cell_area();
-
   {
     for (Points p(*grid); p; p.next()) {
       const int i = p.i(), j = p.j();
 
       if (geometry.ice_thickness(i,j) >= thickness_threshold) {
-        volume += geometry.ice_thickness(i,j) * cell_area;
+        volume += geometry.ice_thickness(i,j) * grid->cell_area(i, j);
       }
     }
   }
@@ -248,7 +246,7 @@ double ice_volume(const Geometry &geometry, double thickness_threshold) {
     for (Points p(*grid); p; p.next()) {
       const int i = p.i(), j = p.j();
 
-      volume += geometry.ice_area_specific_volume(i,j) * cell_area;
+      volume += geometry.ice_area_specific_volume(i,j) * grid->cell_area(i, j);
     }
   }
 
@@ -262,8 +260,7 @@ double ice_volume_not_displacing_seawater(const Geometry &geometry,
 
   const double
     sea_water_density = config->get_number("constants.sea_water.density"),
-    ice_density       = config->get_number("constants.ice.density"),
-    cell_area         = grid->cell_area();
+    ice_density       = config->get_number("constants.ice.density");
 
   IceModelVec::AccessList list{&geometry.cell_type, &geometry.ice_thickness,
       &geometry.bed_elevation, &geometry.sea_level_elevation};
@@ -276,7 +273,8 @@ double ice_volume_not_displacing_seawater(const Geometry &geometry,
     const double
       bed       = geometry.bed_elevation(i, j),
       thickness = geometry.ice_thickness(i, j),
-      sea_level = geometry.sea_level_elevation(i, j);
+      sea_level = geometry.sea_level_elevation(i, j),
+      cell_area = grid->cell_area(i, j);
 
     if (geometry.cell_type.grounded(i, j) and thickness > thickness_threshold) {
       const double cell_ice_volume = thickness * cell_area;
@@ -298,14 +296,12 @@ double ice_area(const Geometry &geometry, double thickness_threshold) {
 
   double area = 0.0;
 
-  auto cell_area = grid->cell_area();
-
   IceModelVec::AccessList list{&geometry.ice_thickness};
   for (Points p(*grid); p; p.next()) {
     const int i = p.i(), j = p.j();
 
     if (geometry.ice_thickness(i, j) >= thickness_threshold) {
-      area += cell_area;
+      area += grid->cell_area(i, j);
     }
   }
 
@@ -318,15 +314,13 @@ double ice_area_grounded(const Geometry &geometry, double thickness_threshold) {
 
   double area = 0.0;
 
-  auto cell_area = grid->cell_area();
-
   IceModelVec::AccessList list{&geometry.cell_type, &geometry.ice_thickness};
   for (Points p(*grid); p; p.next()) {
     const int i = p.i(), j = p.j();
 
     if (geometry.cell_type.grounded(i, j) and
         geometry.ice_thickness(i, j) >= thickness_threshold) {
-      area += cell_area;
+      area += grid->cell_area(i, j);
     }
   }
 
@@ -339,15 +333,13 @@ double ice_area_floating(const Geometry &geometry, double thickness_threshold) {
 
   double area = 0.0;
 
-  auto cell_area = grid->cell_area();
-
   IceModelVec::AccessList list{&geometry.cell_type, &geometry.ice_thickness};
   for (Points p(*grid); p; p.next()) {
     const int i = p.i(), j = p.j();
 
     if (geometry.cell_type.ocean(i, j) and
         geometry.ice_thickness(i, j) >= thickness_threshold) {
-      area += cell_area;
+      area += grid->cell_area(i, j);
     }
   }
 
@@ -1,4 +1,4 @@
-/* Copyright (C) 2016, 2017, 2018, 2019 PISM Authors
+/* Copyright (C) 2016, 2017, 2018, 2019, 2020 PISM Authors
  *
  * This file is part of PISM.
  *
@@ -17,6 +17,9 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 */
 
+#include <cmath>                // std::fabs
+#include <limits>               // std::numeric_limits
+
 #include "GeometryEvolution.hh"
 
 #include "pism/util/iceModelVec.hh"
@@ -27,6 +30,7 @@
 #include "pism/util/pism_utilities.hh"
 #include "pism/util/Logger.hh"
 #include "pism/util/Profiling.hh"
+#include "pism/util/error_handling.hh"
 
 namespace pism {
 
@@ -52,6 +56,21 @@ struct GeometryEvolution::Impl {
   //! True if the part-grid scheme is enabled.
   bool use_part_grid;
 
+  //! True if multirate (local) time stepping is enabled.
+  bool multirate;
+
+  //! Maximum number of times the time step is halved in "fast" parts of the domain.
+  int multirate_max_level;
+
+  //! Number of interface flux evaluations (local, multirate time stepping).
+  double multirate_flux_evaluations;
+
+  //! Number of interface flux evaluations a single-rate scheme would need (local).
+  double multirate_flux_evaluations_single_rate;
+
+  //! Total volume of ice added to keep ice thickness non-negative during sub-steps.
+  double multirate_conservation_error;
+
   //! Flux divergence (used to track thickness changes due to flow).
   IceModelVec2S flux_divergence;
 
@@ -73,6 +92,16 @@ struct GeometryEvolution::Impl {
   //! Flux through cell interfaces. Ghosted.
   IceModelVec2Stag flux_staggered;
 
+  //! Time step level of each cell interface (multirate time stepping only).
+  IceModelVec2Stag::Ptr interface_level;
+
+  //! Time-averaged flux through cell interfaces (multirate time stepping only).
+  IceModelVec2Stag::Ptr flux_average;
+
+  //! Conservation error due to clipping ice thickness during sub-steps (multirate time
+  //! stepping only).
+  IceModelVec2S::Ptr substep_error;
+
   // Work space
   IceModelVec2V        input_velocity;       // ghosted copy; not modified
   IceModelVec2S        bed_elevation;        // ghosted copy; not modified
@@ -116,6 +145,35 @@ GeometryEvolution::Impl::Impl(IceGrid::ConstPtr grid)
     ice_density   = config->get_number("constants.ice.density");
     use_bmr       = config->get_flag("geometry.update.use_basal_melt_rate");
     use_part_grid = config->get_flag("geometry.part_grid.enabled");
+
+    multirate           = config->get_flag("geometry.multirate.enabled");
+    multirate_max_level = config->get_number("geometry.multirate.max_level");
+
+    if (multirate_max_level < 0 or multirate_max_level > 10) {
+      throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                    "geometry.multirate.max_level = %d is invalid"
+                                    " (has to be between 0 and 10)", multirate_max_level);
+    }
+
+    multirate_flux_evaluations             = 0.0;
+    multirate_flux_evaluations_single_rate = 0.0;
+    multirate_conservation_error           = 0.0;
+  }
+
+  // storage used by multirate time stepping
+  if (multirate) {
+    interface_level.reset(new IceModelVec2Stag(grid, "interface_level", WITHOUT_GHOSTS));
+    interface_level->set_attrs("internal", "time step level of cell interfaces",
+                               "", "", "", 0);
+
+    flux_average.reset(new IceModelVec2Stag(grid, "flux_average", WITHOUT_GHOSTS));
+    flux_average->set_attrs("internal", "time-averaged flux through cell interfaces",
+                            "m2 s-1", "m2 s-1", "", 0);
+
+    substep_error.reset(new IceModelVec2S(grid, "substep_error", WITHOUT_GHOSTS));
+    substep_error->set_attrs("internal", "conservation error due to enforcing non-negativity"
+                             " of ice thickness during sub-steps",
+                             "meters", "meters", "", 0);
   }
 
   // reported quantities
@@ -184,6 +242,11 @@ GeometryEvolution::Impl::Impl(IceGrid::ConstPtr grid)
 GeometryEvolution::GeometryEvolution(IceGrid::ConstPtr grid)
   : Component(grid) {
   m_impl = new Impl(grid);
+
+  if (m_impl->use_part_grid) {
+    // residual redistribution assumes that all cells have the same area
+    require_uniform_grid(*grid, "the sub-grid parameterization of the ice front (part_grid)");
+  }
 }
 
 GeometryEvolution::~GeometryEvolution() {
@@ -227,6 +290,32 @@ const IceModelVec2S& GeometryEvolution::conservation_error() const {
   return m_impl->conservation_error;
 }
 
+/*!
+ * Fraction of interface flux evaluations saved by multirate time stepping.
+ *
+ * This is one minus the ratio of the number of interface fluxes computed to the number
+ * a single-rate scheme would compute using the time step of the fastest part of the
+ * domain everywhere. Zero if multirate time stepping is disabled or was never used.
+ */
+double GeometryEvolution::multirate_saved_flux_evaluations() const {
+  const double
+    evaluations = GlobalSum(m_grid->com, m_impl->multirate_flux_evaluations),
+    single_rate = GlobalSum(m_grid->com, m_impl->multirate_flux_evaluations_single_rate);
+
+  if (single_rate == 0.0) {
+    return 0.0;
+  }
+  return 1.0 - evaluations / single_rate;
+}
+
+/*!
+ * Total mass (kg) of ice added to keep ice thickness non-negative during multirate
+ * sub-steps.
+ */
+double GeometryEvolution::multirate_conservation_error() const {
+  return m_impl->multirate_conservation_error;
+}
+
 /*!
  * @param[in] geometry ice geometry
  * @param[in] dt time step, seconds
@@ -263,33 +352,48 @@ void GeometryEvolution::flow_step(const Geometry &geometry, double dt,
   }
   m_impl->profile.end("ge.update_ghosted_copies");
 
-  // Derived classes can include modifications for regional runs.
-  m_impl->profile.begin("ge.interface_fluxes");
-  compute_interface_fluxes(m_impl->cell_type,          // in (uses ghosts)
-                           m_impl->ice_thickness,      // in (uses ghosts)
-                           m_impl->input_velocity,     // in (uses ghosts)
-                           m_impl->velocity_bc_mask,   // in (uses ghosts)
-                           diffusive_flux,             // in
-                           m_impl->flux_staggered);    // out
-  m_impl->profile.end("ge.interface_fluxes");
-
-  m_impl->flux_staggered.update_ghosts();
-
-  m_impl->profile.begin("ge.flux_divergence");
-  compute_flux_divergence(m_impl->flux_staggered,   // in (uses ghosts)
-                          thickness_bc_mask,        // in
-                          m_impl->flux_divergence); // out
-  m_impl->profile.end("ge.flux_divergence");
-
-  // This is where part_grid is implemented.
-  m_impl->profile.begin("ge.update_in_place");
-  update_in_place(dt,                            // in
-                  m_impl->bed_elevation,         // in
-                  m_impl->sea_level,             // in
-                  m_impl->flux_divergence,       // in
-                  m_impl->ice_thickness,         // in/out
-                  m_impl->area_specific_volume); // in/out
-  m_impl->profile.end("ge.update_in_place");
+  int n_substeps = 1;
+  if (m_impl->multirate) {
+    m_impl->profile.begin("ge.interface_levels");
+    n_substeps = compute_interface_levels(dt,
+                                          m_impl->cell_type,          // in
+                                          m_impl->input_velocity,     // in (uses ghosts)
+                                          *m_impl->interface_level);  // out
+    m_impl->profile.end("ge.interface_levels");
+  }
+
+  if (n_substeps > 1) {
+    multirate_flow_step(dt, n_substeps, diffusive_flux, thickness_bc_mask);
+  } else {
+    // Derived classes can include modifications for regional runs.
+    m_impl->profile.begin("ge.interface_fluxes");
+    compute_interface_fluxes(m_impl->cell_type,          // in (uses ghosts)
+                             m_impl->ice_thickness,      // in (uses ghosts)
+                             m_impl->input_velocity,     // in (uses ghosts)
+                             m_impl->velocity_bc_mask,   // in (uses ghosts)
+                             diffusive_flux,             // in
+                             nullptr, 0,                 // all interfaces
+                             m_impl->flux_staggered);    // out
+    m_impl->profile.end("ge.interface_fluxes");
+
+    m_impl->flux_staggered.update_ghosts();
+
+    m_impl->profile.begin("ge.flux_divergence");
+    compute_flux_divergence(m_impl->flux_staggered,   // in (uses ghosts)
+                            thickness_bc_mask,        // in
+                            m_impl->flux_divergence); // out
+    m_impl->profile.end("ge.flux_divergence");
+
+    // This is where part_grid is implemented.
+    m_impl->profile.begin("ge.update_in_place");
+    update_in_place(dt,                            // in
+                    m_impl->bed_elevation,         // in
+                    m_impl->sea_level,             // in
+                    m_impl->flux_divergence,       // in
+                    m_impl->ice_thickness,         // in/out
+                    m_impl->area_specific_volume); // in/out
+    m_impl->profile.end("ge.update_in_place");
+  }
 
   // Compute ice thickness and area specific volume changes.
   m_impl->profile.begin("ge.compute_changes");
@@ -316,6 +420,11 @@ void GeometryEvolution::flow_step(const Geometry &geometry, double dt,
                        m_impl->conservation_error);             // out
   m_impl->profile.end("ge.ensure_nonnegativity");
 
+  if (n_substeps > 1) {
+    // include ice added to keep ice thickness non-negative during sub-steps
+    m_impl->conservation_error.add(1.0, *m_impl->substep_error);
+  }
+
   // Now the caller can compute
   //
   // H_new    = H_old + thickness_change
@@ -531,17 +640,27 @@ static double limit_diffusive_flux(int current, int neighbor, double flux) {
  * Uses first-order upwinding to compute the advective flux.
  *
  * Limits the diffusive flux to prevent SIA-driven flow in the ocean and ice-free areas.
+ *
+ * If `interface_level` is not NULL, only fluxes through interfaces of the level
+ * `min_level` and above are computed (multirate time stepping). Other values in `output`
+ * are left unchanged.
  */
 void GeometryEvolution::compute_interface_fluxes(const IceModelVec2CellType &cell_type,
                                                  const IceModelVec2S        &ice_thickness,
                                                  const IceModelVec2V        &velocity,
                                                  const IceModelVec2Int      &velocity_bc_mask,
                                                  const IceModelVec2Stag     &diffusive_flux,
+                                                 const IceModelVec2Stag     *interface_level,
+                                                 int                         min_level,
                                                  IceModelVec2Stag           &output) {
 
   IceModelVec::AccessList list{&cell_type, &velocity, &velocity_bc_mask, &ice_thickness,
       &diffusive_flux, &output};
 
+  if (interface_level) {
+    list.add(*interface_level);
+  }
+
   ParallelSection loop(m_grid->com);
   try {
     for (Points p(*m_grid); p; p.next()) {
@@ -555,6 +674,11 @@ void GeometryEvolution::compute_interface_fluxes(const IceModelVec2CellType &cel
       const Vector2 V  = velocity(i, j);
 
       for (int n = 0; n < 2; ++n) {
+        if (interface_level and (*interface_level)(i, j, n) < min_level) {
+          // this interface is not active during the current sub-step
+          continue;
+        }
+
         const int
           oi  = 1 - n,               // offset in the i direction
           oj  = n,                   // offset in the j direction
@@ -636,6 +760,26 @@ void GeometryEvolution::compute_interface_fluxes(const IceModelVec2CellType &cel
   loop.check();
 }
 
+//! Computes the integral of `thickness` over the domain, in m^3.
+static double total_volume(const IceModelVec2S &thickness) {
+  auto grid = thickness.grid();
+
+  if (grid->uniform()) {
+    return thickness.sum() * grid->cell_area();
+  }
+
+  IceModelVec::AccessList list{&thickness};
+
+  double volume = 0.0;
+  for (Points p(*grid); p; p.next()) {
+    const int i = p.i(), j = p.j();
+
+    volume += thickness(i, j) * grid->cell_area(i, j);
+  }
+
+  return GlobalSum(grid->com, volume);
+}
+
 /*!
  * Compute flux divergence using cell interface fluxes on the staggered grid.
  *
@@ -644,10 +788,6 @@ void GeometryEvolution::compute_interface_fluxes(const IceModelVec2CellType &cel
 void GeometryEvolution::compute_flux_divergence(const IceModelVec2Stag &flux,
                                                 const IceModelVec2Int &thickness_bc_mask,
                                                 IceModelVec2S &output) {
-  const double
-    dx = m_grid->dx(),
-    dy = m_grid->dy();
-
   IceModelVec::AccessList list{&flux, &thickness_bc_mask, &output};
 
   ParallelSection loop(m_grid->com);
@@ -660,7 +800,8 @@ void GeometryEvolution::compute_flux_divergence(const IceModelVec2Stag &flux,
       } else {
         StarStencil<double> Q = flux.star(i, j);
 
-        output(i, j) = (Q.e - Q.w) / dx + (Q.n - Q.s) / dy;
+        output(i, j) = ((Q.e - Q.w) / m_grid->cell_width(i) +
+                        (Q.n - Q.s) / m_grid->cell_height(j));
       }
     }
   } catch (...) {
@@ -669,6 +810,228 @@ void GeometryEvolution::compute_flux_divergence(const IceModelVec2Stag &flux,
   loop.check();
 }
 
+/*!
+ * Return the time step level of a cell: the smallest `level` such that `dt / 2^level`
+ * satisfies the CFL condition in this cell. The result does not exceed `max_level`.
+ */
+static int timestep_level(double dt, double dt_cfl, int max_level) {
+  int level = 0;
+  while (level < max_level and dt > dt_cfl * (1 << level)) {
+    ++level;
+  }
+  return level;
+}
+
+/*!
+ * Maximum time step allowed by the CFL condition in a cell with the advective velocity
+ * `V`.
+ */
+static double cfl_timestep(const Vector2 &V, double dx, double dy) {
+  const double denominator = std::fabs(V.u) / dx + std::fabs(V.v) / dy;
+
+  return denominator > 0.0 ? 1.0 / denominator : std::numeric_limits<double>::max();
+}
+
+/*!
+ * Assign each cell interface to a time step level (multirate time stepping).
+ *
+ * Icy cells are partitioned into classes using the CFL condition: cells of the level `L`
+ * need the time step `dt / 2^L`. An interface uses the shorter time step of the two cells
+ * it separates.
+ *
+ * Returns the number of sub-steps needed by the finest level present in the domain.
+ */
+int GeometryEvolution::compute_interface_levels(double dt,
+                                                const IceModelVec2CellType &cell_type,
+                                                const IceModelVec2V &velocity,
+                                                IceModelVec2Stag &result) {
+  const int max_level = m_impl->multirate_max_level;
+
+  auto level = [&](int i, int j) {
+    if (not cell_type.icy(i, j)) {
+      return 0;
+    }
+    return timestep_level(dt,
+                          cfl_timestep(velocity(i, j),
+                                       m_grid->cell_width(i), m_grid->cell_height(j)),
+                          max_level);
+  };
+
+  IceModelVec::AccessList list{&cell_type, &velocity, &result};
+
+  int local_max = 0;
+  for (Points p(*m_grid); p; p.next()) {
+    const int i = p.i(), j = p.j();
+
+    const int
+      L   = level(i, j),
+      L_e = std::max(L, level(i + 1, j)),
+      L_n = std::max(L, level(i, j + 1));
+
+    result(i, j, 0) = L_e;
+    result(i, j, 1) = L_n;
+
+    local_max = std::max(local_max, std::max(L_e, L_n));
+  }
+
+  const int level_max = GlobalMax(m_grid->com, local_max);
+
+  return 1 << level_max;
+}
+
+/*!
+ * Return the lowest time step level active during the sub-step `s` (multirate time
+ * stepping with `n_substeps` sub-steps).
+ *
+ * Interfaces of the level `L` are updated once every `n_substeps / 2^L` sub-steps, so the
+ * set of interfaces active during a sub-step always consists of levels `L >= min_level`.
+ */
+static int multirate_min_level(int s, int n_substeps) {
+  if (s == 0) {
+    // all interfaces are updated at the beginning of a step
+    return 0;
+  }
+
+  int level = 0;
+  while ((n_substeps >> level) > 1 and s % (n_substeps >> level) != 0) {
+    ++level;
+  }
+  return level;
+}
+
+/*!
+ * Multirate (local) time stepping for the mass continuity equation.
+ *
+ * Takes `n_substeps` sub-steps of length `dt / n_substeps`. The flux through an interface
+ * of the level `L` (see compute_interface_levels()) is re-computed once every `n_substeps
+ * / 2^L` sub-steps using the current ice thickness and cell type and is kept constant in
+ * between, so slow parts of the domain take few long steps while fast parts take many
+ * short ones. Fluxes through inactive interfaces are not re-computed.
+ *
+ * Each interface flux is applied to both cells it separates, so the scheme conserves
+ * mass. The only exception is the clipping of negative ice thickness during sub-steps;
+ * the ice added by clipping is stored in `substep_error`.
+ *
+ * Sets `flux_staggered` and `flux_divergence` to their averages over the step.
+ */
+void GeometryEvolution::multirate_flow_step(double dt, int n_substeps,
+                                            const IceModelVec2Stag &diffusive_flux,
+                                            const IceModelVec2Int &thickness_bc_mask) {
+  const double dt_substep = dt / n_substeps;
+
+  // fluxes through interfaces that are not active during a sub-step are kept in
+  // flux_staggered until they are re-computed
+  IceModelVec2Stag &flux = m_impl->flux_staggered;
+  IceModelVec2S &divergence = m_impl->flux_divergence;
+
+  IceModelVec2Stag
+    &level        = *m_impl->interface_level,
+    &flux_average = *m_impl->flux_average;
+  IceModelVec2S &substep_error = *m_impl->substep_error;
+
+  flux_average.set(0.0);
+  substep_error.set(0.0);
+
+  double n_evaluations = 0.0;
+
+  for (int s = 0; s < n_substeps; ++s) {
+    const int min_level = multirate_min_level(s, n_substeps);
+
+    m_impl->profile.begin("ge.interface_fluxes");
+    compute_interface_fluxes(m_impl->cell_type,          // in (uses ghosts)
+                             m_impl->ice_thickness,      // in (uses ghosts)
+                             m_impl->input_velocity,     // in (uses ghosts)
+                             m_impl->velocity_bc_mask,   // in (uses ghosts)
+                             diffusive_flux,             // in
+                             &level, min_level,          // active interfaces only
+                             flux);                      // in/out
+    m_impl->profile.end("ge.interface_fluxes");
+
+    {
+      IceModelVec::AccessList list{&flux, &level, &flux_average};
+
+      for (Points p(*m_grid); p; p.next()) {
+        const int i = p.i(), j = p.j();
+
+        for (int n = 0; n < 2; ++n) {
+          if (level(i, j, n) >= min_level) {
+            n_evaluations += 1.0;
+          }
+
+          flux_average(i, j, n) += flux(i, j, n) / n_substeps;
+        }
+      }
+    }
+    flux.update_ghosts();
+
+    m_impl->profile.begin("ge.flux_divergence");
+    compute_flux_divergence(flux,              // in (uses ghosts)
+                            thickness_bc_mask, // in
+                            divergence);       // out
+    m_impl->profile.end("ge.flux_divergence");
+
+    // Note: this updates cell_type.
+    m_impl->profile.begin("ge.update_in_place");
+    update_in_place(dt_substep,                    // in
+                    m_impl->bed_elevation,         // in
+                    m_impl->sea_level,             // in
+                    divergence,                    // in
+                    m_impl->ice_thickness,         // in/out
+                    m_impl->area_specific_volume); // in/out
+    m_impl->profile.end("ge.update_in_place");
+
+    // Fluxes through interfaces of a cell may be computed at different times, so
+    // intermediate ice thickness may become negative. Clip it and keep track of the ice
+    // added.
+    {
+      IceModelVec2S
+        &H    = m_impl->ice_thickness,
+        &Href = m_impl->area_specific_volume;
+
+      IceModelVec::AccessList list{&H, &Href, &substep_error};
+
+      for (Points p(*m_grid); p; p.next()) {
+        const int i = p.i(), j = p.j();
+
+        if (H(i, j) < 0.0) {
+          substep_error(i, j) += - H(i, j);
+          H(i, j) = 0.0;
+        }
+
+        if (Href(i, j) < 0.0) {
+          substep_error(i, j) += - Href(i, j);
+          Href(i, j) = 0.0;
+        }
+      }
+    }
+    m_impl->ice_thickness.update_ghosts();
+    m_impl->area_specific_volume.update_ghosts();
+
+    // Clipping may have changed the cell type: update it before the next sub-step.
+    m_impl->gc.compute(m_impl->sea_level,          // in (uses ghosts)
+                       m_impl->bed_elevation,      // in (uses ghosts)
+                       m_impl->ice_thickness,      // in (uses ghosts)
+                       m_impl->cell_type,          // out (ghosts are updated)
+                       m_impl->surface_elevation); // out (ghosts are updated)
+  }
+
+  m_impl->multirate_flux_evaluations += n_evaluations;
+  m_impl->multirate_flux_evaluations_single_rate += (2.0 * n_substeps *
+                                                     m_grid->xm() * m_grid->ym());
+
+  // Report the average flux and its divergence. The divergence is linear in the flux, so
+  // this is the same as averaging the divergence over sub-steps.
+  flux.copy_from(flux_average);
+  flux.update_ghosts();
+
+  compute_flux_divergence(flux,              // in (uses ghosts)
+                          thickness_bc_mask, // in
+                          divergence);       // out
+
+  m_impl->multirate_conservation_error += (total_volume(substep_error) *
+                                           m_impl->ice_density);
+}
+
 /*!
  * Update ice thickness and area_specific_volume *in place*.
  *
@@ -795,7 +1158,7 @@ void GeometryEvolution::update_in_place(double dt,
     if (not done) {
       m_log->message(2,
                      "WARNING: not done redistributing mass after %d iterations, remaining residual: %f m^3.\n",
-                     max_n_iterations, m_impl->residual.sum() * m_grid->cell_area());
+                     max_n_iterations, total_volume(m_impl->residual));
 
       // Add residual to ice thickness, preserving total ice mass. (This is not great, but
       // better than losing mass.)
@@ -1164,10 +1527,13 @@ void RegionalGeometryEvolution::compute_interface_fluxes(const IceModelVec2CellT
                                                          const IceModelVec2V        &velocity,
                                                          const IceModelVec2Int      &velocity_bc_mask,
                                                          const IceModelVec2Stag     &diffusive_flux,
+                                                         const IceModelVec2Stag     *interface_level,
+                                                         int                         min_level,
                                                          IceModelVec2Stag           &output) {
 
   GeometryEvolution::compute_interface_fluxes(cell_type, ice_thickness,
                                               velocity, velocity_bc_mask, diffusive_flux,
+                                              interface_level, min_level,
                                               output);
 
   IceModelVec::AccessList list{&m_no_model_mask, &output};
@@ -1256,12 +1622,6 @@ void grounding_line_flux(const IceModelVec2CellType &cell_type,
 
   auto grid = output.grid();
 
-  const double
-    dx = grid->dx(),
-    dy = grid->dy();
-
-  auto cell_area = grid->cell_area();
-
   auto ice_density = grid->ctx()->config()->get_number("constants.ice.density");
 
   IceModelVec::AccessList list{&cell_type, &flux, &output};
@@ -1277,6 +1637,11 @@ void grounding_line_flux(const IceModelVec2CellType &cell_type,
         auto M = cell_type.int_star(i, j);
         auto Q = flux.star(i, j);
 
+        // lengths of cell interfaces
+        const double
+          dx = grid->cell_width(i),
+          dy = grid->cell_height(j);
+
         if (grounded(M.n) and Q.n <= 0.0) {
           result += Q.n * dx;
         }
@@ -1294,7 +1659,7 @@ void grounding_line_flux(const IceModelVec2CellType &cell_type,
         }
 
         // convert from "m^3 / s" to "kg / m^2"
-        result *= dt * (ice_density / cell_area);
+        result *= dt * (ice_density / grid->cell_area(i, j));
       }
 
       if (flag == ADD_VALUES) {
@@ -1319,10 +1684,6 @@ double total_grounding_line_flux(const IceModelVec2CellType &cell_type,
 
   auto grid = cell_type.grid();
 
-  const double
-    dx = grid->dx(),
-    dy = grid->dy();
-
   auto ice_density = grid->ctx()->config()->get_number("constants.ice.density");
 
   double total_flux = 0.0;
@@ -1340,6 +1701,11 @@ double total_grounding_line_flux(const IceModelVec2CellType &cell_type,
         auto M = cell_type.int_star(i, j);
         auto Q = flux.star(i, j); // m^2 / s
 
+        // lengths of cell interfaces
+        const double
+          dx = grid->cell_width(i),
+          dy = grid->cell_height(j);
+
         if (grounded(M.n) and Q.n <= 0.0) {
           volume_flux += Q.n * dx;
         }
@@ -1,4 +1,4 @@
-/* Copyright (C) 2016, 2017, 2019 PISM Authors
+/* Copyright (C) 2016, 2017, 2019, 2020 PISM Authors
  *
  * This file is part of PISM.
  *
@@ -64,6 +64,10 @@ public:
 
   const IceModelVec2S& conservation_error() const;
 
+  // multirate time stepping statistics
+  double multirate_saved_flux_evaluations() const;
+  double multirate_conservation_error() const;
+
   // diagnostic
   const IceModelVec2Stag& flux_staggered() const;
   const IceModelVec2S& flux_divergence() const;
@@ -96,8 +100,19 @@ protected:
                                         const IceModelVec2V        &velocity,
                                         const IceModelVec2Int      &velocity_bc_mask,
                                         const IceModelVec2Stag     &diffusive_flux,
+                                        const IceModelVec2Stag     *interface_level,
+                                        int                         min_level,
                                         IceModelVec2Stag           &output);
 
+  int compute_interface_levels(double dt,
+                               const IceModelVec2CellType &cell_type,
+                               const IceModelVec2V &velocity,
+                               IceModelVec2Stag &result);
+
+  void multirate_flow_step(double dt, int n_substeps,
+                           const IceModelVec2Stag &diffusive_flux,
+                           const IceModelVec2Int &thickness_bc_mask);
+
   virtual void compute_flux_divergence(const IceModelVec2Stag &flux_staggered,
                                        const IceModelVec2Int &thickness_bc_mask,
                                        IceModelVec2S &flux_fivergence);
@@ -137,6 +152,8 @@ protected:
                                 const IceModelVec2V        &velocity,
                                 const IceModelVec2Int      &velocity_bc_mask,
                                 const IceModelVec2Stag     &diffusive_flux,
+                                const IceModelVec2Stag     *interface_level,
+                                int                         min_level,
                                 IceModelVec2Stag           &output);
 
   void compute_surface_and_basal_mass_balance(double dt,
@@ -125,6 +125,7 @@ EmptyingProblem::EmptyingProblem(IceGrid::ConstPtr grid)
     m_q_sg(grid, "_effective_water_velocity", WITHOUT_GHOSTS),
     m_adjustment(grid, "hydraulic_potential_adjustment", WITHOUT_GHOSTS),
     m_sinks(grid, "sinks", WITHOUT_GHOSTS) {
+  require_uniform_grid(*m_grid, "the emptying problem solver of the steady state hydrology model");
 
   m_potential.set_attrs("diagnostic", "estimate of the steady state hydraulic potential in the steady hydrology model",
                         "Pa", "Pa", "", 0);
@@ -128,12 +128,10 @@ public:
   }
 
 protected:
-  void update_impl(double dt) {
+  std::vector<const IceModelVec2S*> model_inputs() {
     m_flux_magnitude.set_to_magnitude(model->flux());
 
-    m_accumulator.add(dt, m_flux_magnitude);
-
-    m_interval_length += dt;
+    return {&m_flux_magnitude};
   }
 
   IceModelVec2S m_flux_magnitude;
@@ -443,13 +441,14 @@ void Hydrology::update(double t, double dt, const Inputs& inputs) {
   // convert from m to kg
   // kg = m * (kg / m^3) * m^2
 
-  double
-    water_density = m_config->get_number("constants.fresh_water.density"),
-    kg_per_m      = water_density * m_grid->cell_area();
+  double water_density = m_config->get_number("constants.fresh_water.density");
 
   list.add({&m_flow_change, &m_input_change});
   for (Points p(*m_grid); p; p.next()) {
     const int i = p.i(), j = p.j();
+
+    const double kg_per_m = water_density * m_grid->cell_area(i, j);
+
     m_total_change(i, j) *= kg_per_m;
     m_input_change(i, j) *= kg_per_m;
     m_flow_change(i, j)  *= kg_per_m;
@@ -693,15 +692,15 @@ void Hydrology::enforce_bounds(const IceModelVec2CellType &cell_type,
       &grounded_margin_change, &grounding_line_change, &conservation_error_change,
       &no_model_mask_change};
 
-  double
-    fresh_water_density = m_config->get_number("constants.fresh_water.density"),
-    kg_per_m            = m_grid->cell_area() * fresh_water_density; // kg m-1
+  double fresh_water_density = m_config->get_number("constants.fresh_water.density");
 
   const bool tillwat_ocean = m_config->get_flag("hydrology.set_tillwat_ocean");
 
   for (Points p(*m_grid); p; p.next()) {
     const int i = p.i(), j = p.j();
 
+    const double kg_per_m = m_grid->cell_area(i, j) * fresh_water_density; // kg m-1
+
     if (water_thickness(i, j) < 0.0) {
       conservation_error_change(i, j) += -water_thickness(i, j) * kg_per_m;
       water_thickness(i, j) = 0.0;
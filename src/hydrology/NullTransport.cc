@@ -1,4 +1,4 @@
-// Copyright (C) 2012-2019 PISM Authors
+// Copyright (C) 2012-2020 PISM Authors
 //
 // This file is part of PISM.
 //
@@ -28,6 +28,8 @@ namespace hydrology {
 
 NullTransport::NullTransport(IceGrid::ConstPtr g)
   : Hydrology(g) {
+  require_uniform_grid(*m_grid, "the null-transport hydrology model");
+
   m_diffuse_tillwat    = m_config->get_flag("hydrology.null_diffuse_till_water");
   m_diffusion_time     = m_config->get_number("hydrology.null_diffusion_time", "seconds");
   m_diffusion_distance = m_config->get_number("hydrology.null_diffusion_distance", "meters");
@@ -122,9 +124,7 @@ void NullTransport::update_impl(double t, double dt, const Inputs& inputs) {
     m_input_change.add(dt, m_surface_input_rate);
   }
 
-  const double
-    water_density = m_config->get_number("constants.fresh_water.density"),
-    kg_per_m      = m_grid->cell_area() * water_density; // kg m-1
+  const double water_density = m_config->get_number("constants.fresh_water.density");
 
   const IceModelVec2CellType &cell_type = inputs.geometry->cell_type;
 
@@ -138,6 +138,8 @@ void NullTransport::update_impl(double t, double dt, const Inputs& inputs) {
   for (Points p(*m_grid); p; p.next()) {
     const int i = p.i(), j = p.j();
 
+    const double kg_per_m = m_grid->cell_area(i, j) * water_density; // kg m-1
+
     double
       W_old    = m_Wtill(i, j),
       dW_input = dt * m_basal_melt_rate(i, j);
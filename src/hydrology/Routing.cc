@@ -269,6 +269,7 @@ Routing::Routing(IceGrid::ConstPtr grid)
     m_dx(grid->dx()),
     m_dy(grid->dy()),
     m_bottom_surface(grid, "ice_bottom_surface_elevation", WITH_GHOSTS) {
+  require_uniform_grid(*m_grid, "the routing hydrology model");
 
   m_W.metadata().set_string("pism_intent", "model_state");
 
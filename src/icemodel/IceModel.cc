@@ -50,12 +50,15 @@
 #include "pism/util/pism_signal.h"
 #include "pism/util/Vars.hh"
 #include "pism/util/Profiling.hh"
+#include "pism/util/WallClock.hh"
 #include "pism/util/pism_utilities.hh"
 #include "pism/age/AgeModel.hh"
 #include "pism/energy/EnergyModel.hh"
 #include "pism/util/io/File.hh"
+#include "pism/util/io/BackupDrainer.hh"
 #include "pism/util/iceModelVec2T.hh"
 #include "pism/fracturedensity/FractureDensity.hh"
+#include "pism/frontretreat/util/FrontBand.hh"
 #include "pism/coupler/util/options.hh" // ForcingOptions
 
 namespace pism {
@@ -382,6 +385,47 @@ YieldStressInputs IceModel::yield_stress_inputs() {
   return result;
 }
 
+//! Declare data dependencies between parts of the time step.
+/*!
+ * Names of "fields" below refer to groups of model state variables, not to individual
+ * IceModelVec instances. See step() for task boundaries.
+ */
+void IceModel::init_task_graph() {
+  // timing is recorded only if the report is requested
+  m_task_graph.enable(m_config->get_flag("output.task_graph_report"));
+
+  m_task_graph.add_task("basal_melt_rate", {"geometry", "ocean", "energy"}, {"basal_melt_rate"});
+  m_task_graph.add_task("stress_balance",
+                        {"geometry", "basal_melt_rate", "basal_yield_stress", "ocean",
+                         "energy", "age", "fracture_density"},
+                        {"velocity"});
+  m_task_graph.add_task("time_step", {"geometry", "velocity", "hydrology"}, {"dt"});
+  m_task_graph.add_task("basal_yield_stress", {"geometry", "hydrology", "dt"},
+                        {"basal_yield_stress"});
+  m_task_graph.add_task("age", {"geometry", "velocity", "dt"}, {"age"});
+  m_task_graph.add_task("energy",
+                        {"geometry", "velocity", "ocean", "surface", "hydrology", "dt"},
+                        {"energy"});
+  m_task_graph.add_task("fracture_density", {"geometry", "velocity", "dt"},
+                        {"fracture_density"});
+  m_task_graph.add_task("mass_transport", {"geometry", "velocity", "dt"}, {"geometry"});
+  m_task_graph.add_task("front_retreat", {"geometry", "velocity", "ocean", "energy", "dt"},
+                        {"geometry"});
+  m_task_graph.add_task("sea_level", {"geometry", "dt"}, {"sea_level"});
+  m_task_graph.add_task("ocean", {"geometry", "sea_level", "dt"}, {"ocean"});
+  m_task_graph.add_task("sea_level_mask", {"geometry", "sea_level"}, {"geometry"});
+  m_task_graph.add_task("surface", {"geometry", "dt"}, {"surface"});
+  m_task_graph.add_task("source_term", {"geometry", "surface", "basal_melt_rate", "dt"},
+                        {"geometry"});
+  m_task_graph.add_task("hydrology",
+                        {"geometry", "velocity", "basal_melt_rate", "surface", "dt"},
+                        {"hydrology"});
+  m_task_graph.add_task("bed_deformation", {"geometry", "sea_level", "dt"},
+                        {"bed_deformation"});
+  m_task_graph.add_task("bed_elevation_mask", {"geometry", "bed_deformation"},
+                        {"geometry"});
+}
+
 //! The contents of the main PISM time-step.
 /*!
 During the time-step we perform the following actions:
@@ -413,15 +457,19 @@ void IceModel::step(bool do_mass_continuity,
   // Basal melt rate may be used by a stress balance model to compute vertical velocity of
   // ice.
   {
+    m_task_graph.begin("basal_melt_rate");
     combine_basal_melt_rate(m_geometry,
                             m_ocean->shelf_base_mass_flux(),
                             m_energy_model->basal_melt_rate(),
                             m_basal_melt_rate);
+    m_task_graph.end("basal_melt_rate");
   }
 
   try {
     profiling.begin("stress_balance");
+    m_task_graph.begin("stress_balance");
     m_stress_balance->update(stress_balance_inputs(), updateAtDepth);
+    m_task_graph.end("stress_balance");
     profiling.end("stress_balance");
   } catch (RuntimeError &e) {
     std::string output_file = m_config->get_string("output.file_name");
@@ -455,14 +503,18 @@ void IceModel::step(bool do_mass_continuity,
   m_stdout_flags += (updateAtDepth ? "v" : "V");
 
   //! \li determine the time step according to a variety of stability criteria
+  m_task_graph.begin("time_step");
   max_timestep(m_dt, m_skip_countdown);
+  m_task_graph.end("time_step");
 
   //! \li update the yield stress for the plastic till model (if appropriate)
   if (m_basal_yield_stress_model) {
     profiling.begin("basal_yield_stress");
+    m_task_graph.begin("basal_yield_stress");
     m_basal_yield_stress_model->update(yield_stress_inputs(), current_time, m_dt);
-    profiling.end("basal_yield_stress");
     m_basal_yield_stress.copy_from(m_basal_yield_stress_model->basal_material_yield_stress());
+    m_task_graph.end("basal_yield_stress");
+    profiling.end("basal_yield_stress");
     m_stdout_flags += "y";
   } else {
     m_stdout_flags += "$";
@@ -479,7 +531,9 @@ void IceModel::step(bool do_mass_continuity,
     inputs.w3            = &m_stress_balance->velocity_w();
 
     profiling.begin("age");
+    m_task_graph.begin("age");
     m_age_model->update(current_time, dt_TempAge, inputs);
+    m_task_graph.end("age");
     profiling.end("age");
     m_stdout_flags += "a";
   } else {
@@ -491,7 +545,9 @@ void IceModel::step(bool do_mass_continuity,
   //!  energy_step()
   if (updateAtDepth) { // do the energy step
     profiling.begin("energy");
+    m_task_graph.begin("energy");
     energy_step();
+    m_task_graph.end("energy");
     profiling.end("energy");
     m_stdout_flags += "E";
   } else {
@@ -501,7 +557,9 @@ void IceModel::step(bool do_mass_continuity,
   //! \li update the fracture density field; see update_fracture_density()
   if (m_config->get_flag("fracture_density.enabled")) {
     profiling.begin("fracture_density");
+    m_task_graph.begin("fracture_density");
     update_fracture_density();
+    m_task_graph.end("fracture_density");
     profiling.end("fracture_density");
   }
 
@@ -513,6 +571,7 @@ void IceModel::step(bool do_mass_continuity,
 
   if (do_mass_continuity) {
     profiling.begin("mass_transport");
+    m_task_graph.begin("mass_transport");
     {
       // Note that there are three adaptive time-stepping criteria. Two of them (using max.
       // diffusion and 2D CFL) are limiting the mass-continuity time-step and the third (3D
@@ -541,11 +600,14 @@ void IceModel::step(bool do_mass_continuity,
 
       enforce_consistency_of_geometry(DONT_REMOVE_ICEBERGS);
     }
+    m_task_graph.end("mass_transport");
     profiling.end("mass_transport");
 
     // calving, frontal melt, and discharge accounting
     profiling.begin("front_retreat");
+    m_task_graph.begin("front_retreat");
     front_retreat_step();
+    m_task_graph.end("front_retreat");
     profiling.end("front_retreat");
 
     m_stdout_flags += "h";
@@ -554,25 +616,34 @@ void IceModel::step(bool do_mass_continuity,
   }
 
   profiling.begin("sea_level");
+  m_task_graph.begin("sea_level");
   m_sea_level->update(m_geometry, current_time, m_dt);
+  m_task_graph.end("sea_level");
   profiling.end("sea_level");
 
   profiling.begin("ocean");
+  m_task_graph.begin("ocean");
   m_ocean->update(m_geometry, current_time, m_dt);
+  m_task_graph.end("ocean");
   profiling.end("ocean");
 
   // The sea level elevation might have changed, so we need to update the mask, etc. Note
   // that THIS MAY PRODUCE ICEBERGS, but we assume that the surface model does not care.
+  m_task_graph.begin("sea_level_mask");
   enforce_consistency_of_geometry(DONT_REMOVE_ICEBERGS);
+  m_task_graph.end("sea_level_mask");
 
   //! \li Update surface and ocean models.
   profiling.begin("surface");
+  m_task_graph.begin("surface");
   m_surface->update(m_geometry, current_time, m_dt);
+  m_task_graph.end("surface");
   profiling.end("surface");
 
 
   if (do_mass_continuity) {
     // compute and apply effective surface and basal mass balance
+    m_task_graph.begin("source_term");
 
     m_geometry_evolution->source_term_step(m_geometry, m_dt,
                                            thickness_bc_mask,
@@ -594,6 +665,11 @@ void IceModel::step(bool do_mass_continuity,
       // the last call has to remove icebergs
       enforce_consistency_of_geometry(REMOVE_ICEBERGS);
 
+      // Surface and basal mass fluxes and iceberg removal change the ice extent near the
+      // front in all but rare cases (e.g. an ice-free "hole" opened far from the front).
+      // Such cells are picked up when front_retreat_step() re-builds the band.
+      m_front_band->update(m_geometry.cell_type);
+
       bool add_values = true;
       compute_geometry_change(m_geometry.ice_thickness,
                               m_geometry.ice_area_specific_volume,
@@ -601,12 +677,15 @@ void IceModel::step(bool do_mass_continuity,
                               add_values,
                               m_thickness_change.calving);
     }
+    m_task_graph.end("source_term");
   }
 
   //! \li update the state variables in the subglacial hydrology model (typically
   //!  water thickness and sometimes pressure)
   profiling.begin("basal_hydrology");
+  m_task_graph.begin("hydrology");
   hydrology_step();
+  m_task_graph.end("hydrology");
   profiling.end("basal_hydrology");
 
   //! \li compute the bed deformation, which depends on current thickness, bed elevation,
@@ -615,9 +694,11 @@ void IceModel::step(bool do_mass_continuity,
     int topg_state_counter = m_beddef->bed_elevation().state_counter();
 
     profiling.begin("bed_deformation");
+    m_task_graph.begin("bed_deformation");
     m_beddef->update(m_geometry.ice_thickness,
                      m_geometry.sea_level_elevation,
                      current_time, m_dt);
+    m_task_graph.end("bed_deformation");
     profiling.end("bed_deformation");
 
     if (m_beddef->bed_elevation().state_counter() != topg_state_counter) {
@@ -630,7 +711,9 @@ void IceModel::step(bool do_mass_continuity,
   }
 
   if (m_new_bed_elevation) {
+    m_task_graph.begin("bed_elevation_mask");
     enforce_consistency_of_geometry(DONT_REMOVE_ICEBERGS);
+    m_task_graph.end("bed_elevation_mask");
     m_stdout_flags += "b";
   } else {
     m_stdout_flags += " ";
@@ -827,6 +910,15 @@ void IceModel::run() {
 
   profiling.stage_end("time-stepping loop");
 
+  if (m_backup_drainer) {
+    // make sure that the last backup is complete
+    m_backup_drainer->wait();
+  }
+
+  if (m_config->get_flag("output.task_graph_report")) {
+    m_task_graph.report(*m_log);
+  }
+
   if (stepcount >= 0) {
     m_log->message(1,
                "count_time_steps:  run() took %d steps\n"
@@ -844,7 +936,7 @@ explanations of their intended uses.
 void IceModel::init() {
   // Get the start time in seconds and ensure that it is consistent
   // across all processors.
-  m_start_time = GlobalMax(m_grid->com, get_time());
+  m_start_time = GlobalMax(m_grid->com, m_ctx->wall_clock().time());
 
   const Profiling &profiling = m_ctx->profiling();
 
@@ -877,6 +969,9 @@ void IceModel::init() {
   //! regridding.
   misc_setup();
 
+  //! 9) Report fields that were not used (if `grid.lazy_allocation` is set):
+  report_unused_fields();
+
   profiling.end("initialization");
 }
 
@@ -1034,14 +1129,24 @@ void IceModel::prune_diagnostics() {
  * Call this after prune_diagnostics() to avoid unnecessary work.
  */
 void IceModel::update_diagnostics(double dt) {
-  for (auto d : m_diagnostics) {
-    d.second->update(dt);
+  if (m_config->get_flag("output.fused_diagnostic_updates")) {
+    pism::update_diagnostics(m_diagnostics, dt);
+  } else {
+    for (auto d : m_diagnostics) {
+      d.second->update(dt);
+    }
   }
 
   const double time = m_time->current();
   for (auto d : m_ts_diagnostics) {
     d.second->update(time - dt, time);
   }
+
+  // write scalar time-series if the buffer is full
+  if (m_ts_writer and
+      m_ts_writer->buffered_records() >= (size_t)m_config->get_number("output.timeseries.buffer_size")) {
+    flush_timeseries();
+  }
 }
 
 /*!
@@ -48,6 +48,7 @@
 #include "pism/util/Time.hh"
 #include "pism/util/Diagnostic.hh"
 #include "pism/util/MaxTimestep.hh"
+#include "pism/util/TaskGraph.hh"
 #include "pism/geometry/Geometry.hh"
 #include "pism/geometry/GeometryEvolution.hh"
 #include "pism/stressbalance/StressBalance.hh"
@@ -102,6 +103,8 @@ class IceModelVec2CellType;
 class IceModelVec2T;
 class Component;
 class FrontRetreat;
+class FrontBand;
+class BackupDrainer;
 class PrescribedRetreat;
 
 //! The base class for PISM. Contains all essential variables, parameters, and flags for modelling
@@ -174,6 +177,7 @@ protected:
   virtual void time_setup();
   virtual void model_state_setup();
   virtual void misc_setup();
+  void report_unused_fields() const;
   virtual void init_diagnostics();
   virtual void init_calving();
   virtual void init_frontal_melt();
@@ -182,6 +186,10 @@ protected:
   virtual void update_diagnostics(double dt);
   virtual void reset_diagnostics();
 
+  // data dependencies between parts of a time step; see output.task_graph_report
+  TaskGraph m_task_graph;
+  void init_task_graph();
+
   virtual void step(bool do_mass_continuity, bool do_skip);
   virtual void pre_step_hook();
   virtual void post_step_hook();
@@ -267,6 +275,8 @@ protected:
   std::shared_ptr<PrescribedRetreat>           m_prescribed_retreat;
 
   std::shared_ptr<FrontRetreat> m_front_retreat;
+  //! cells at the ice front (used by calving and front retreat code)
+  std::shared_ptr<FrontBand> m_front_band;
 
   std::shared_ptr<surface::SurfaceModel>      m_surface;
   std::shared_ptr<ocean::OceanModel>          m_ocean;
@@ -408,6 +418,8 @@ protected:
   //! requested times for scalar time-series
   std::shared_ptr<std::vector<double>> m_ts_times;
   std::set<std::string> m_ts_vars;
+  //! writer used to save scalar time-series (note: has to be destroyed before diagnostics)
+  std::unique_ptr<TSDiagnosticWriter> m_ts_writer;
   void init_timeseries();
   void flush_timeseries();
   MaxTimestep ts_max_timestep(double my_t);
@@ -429,6 +441,10 @@ protected:
   std::string m_backup_filename;
   double m_last_backup_time;
   std::set<std::string> m_backup_vars;
+  // used if backups are staged on fast storage (see output.backup_staging_dir)
+  std::string m_backup_staged_filename;
+  std::string m_backup_run_id;
+  std::unique_ptr<BackupDrainer> m_backup_drainer;
   void init_backups();
   void write_backup();
 
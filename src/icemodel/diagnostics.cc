@@ -198,6 +198,11 @@ protected:
 
     m_interval_length += dt;
   }
+
+  std::vector<const IceModelVec2S*> model_inputs() {
+    // uses a custom update_impl()
+    return {};
+  }
 };
 
 //! \brief Computes vertically-averaged ice hardness.
@@ -1179,13 +1184,12 @@ public:
       &dH = model->geometry_evolution().thickness_change_due_to_flow(),
       &dV = model->geometry_evolution().area_specific_volume_change_due_to_flow();
 
-    auto cell_area = m_grid->cell_area();
-
     IceModelVec::AccessList list{&dH, &dV};
 
     double volume_change = 0.0;
     for (Points p(*m_grid); p; p.next()) {
       const int i = p.i(), j = p.j();
+      const double cell_area = m_grid->cell_area(i, j);
       // m * m^2 = m^3
       volume_change += (dH(i, j) + dV(i, j)) * cell_area;
     }
@@ -1417,15 +1421,14 @@ public:
 
     const IceModelVec2S &ice_thickness = model->geometry().ice_thickness;
 
-    const double
-      thickness_threshold = m_config->get_number("output.ice_free_thickness_standard"),
-      cell_area           = m_grid->cell_area();
+    const double thickness_threshold = m_config->get_number("output.ice_free_thickness_standard");
 
     IceModelVec::AccessList list{&ice_thickness, &cell_type};
 
     double volume = 0.0;
     for (Points p(*m_grid); p; p.next()) {
       const int i = p.i(), j = p.j();
+      const double cell_area = m_grid->cell_area(i, j);
 
       const double H = ice_thickness(i, j);
 
@@ -1455,15 +1458,14 @@ public:
 
     const IceModelVec2S &ice_thickness = model->geometry().ice_thickness;
 
-    const double
-      thickness_threshold = m_config->get_number("output.ice_free_thickness_standard"),
-      cell_area           = m_grid->cell_area();
+    const double thickness_threshold = m_config->get_number("output.ice_free_thickness_standard");
 
     IceModelVec::AccessList list{&ice_thickness, &cell_type};
 
     double volume = 0.0;
     for (Points p(*m_grid); p; p.next()) {
       const int i = p.i(), j = p.j();
+      const double cell_area = m_grid->cell_area(i, j);
 
       const double H = ice_thickness(i, j);
 
@@ -1569,9 +1571,7 @@ double mass_change(const IceModel *model, TermType term, AreaType area) {
   const IceGrid &grid = *model->grid();
   const Config &config = *grid.ctx()->config();
 
-  const double
-    ice_density = config.get_number("constants.ice.density"),
-    cell_area   = grid.cell_area();
+  const double ice_density = config.get_number("constants.ice.density");
 
   const IceModelVec2CellType &cell_type = model->geometry().cell_type;
 
@@ -1606,6 +1606,7 @@ double mass_change(const IceModel *model, TermType term, AreaType area) {
   double volume_change = 0.0;
   for (Points p(grid); p; p.next()) {
     const int i = p.i(), j = p.j();
+    const double cell_area = grid.cell_area(i, j);
 
     if ((area == BOTH) or
         (area == GROUNDED and cell_type.grounded(i, j)) or
@@ -1751,14 +1752,13 @@ public:
     const IceModelVec2S &frontal_melt = model->frontal_melt();
     const IceModelVec2S &forced_retreat = model->forced_retreat();
 
-    auto cell_area = m_grid->cell_area();
-
     double volume_change = 0.0;
 
     IceModelVec::AccessList list{&calving, &frontal_melt, &forced_retreat};
 
     for (Points p(*m_grid); p; p.next()) {
       const int i = p.i(), j = p.j();
+      const double cell_area = m_grid->cell_area(i, j);
       // m^2 * m = m^3
       volume_change += cell_area * (calving(i, j) + frontal_melt(i, j) + forced_retreat(i, j));
     }
@@ -1790,14 +1790,13 @@ public:
 
     const IceModelVec2S &calving = model->calving();
 
-    auto cell_area = m_grid->cell_area();
-
     double volume_change = 0.0;
 
     IceModelVec::AccessList list{&calving};
 
     for (Points p(*m_grid); p; p.next()) {
       const int i = p.i(), j = p.j();
+      const double cell_area = m_grid->cell_area(i, j);
       // m^2 * m = m^3
       volume_change += cell_area * calving(i, j);
     }
@@ -2234,14 +2233,13 @@ IceModelVec::Ptr IceMass::compute_impl() const {
   const IceModelVec2S
     &ice_thickness = model->geometry().ice_thickness;
 
-  auto cell_area = m_grid->cell_area();
-
   IceModelVec::AccessList list{&cell_type, result.get(), &ice_thickness};
 
   ParallelSection loop(m_grid->com);
   try {
     for (Points p(*m_grid); p; p.next()) {
       const int i = p.i(), j = p.j();
+      const double cell_area = m_grid->cell_area(i, j);
 
       // count all ice, including cells which have so little they
       // are considered "ice-free"
@@ -2425,9 +2423,6 @@ IceModelVec::Ptr IceViscosity::compute_impl() const {
   W_without_ghosts.update_ghosts(W);
 
   const unsigned int Mz = m_grid->Mz();
-  const double
-    dx = m_grid->dx(),
-    dy = m_grid->dy();
   const std::vector<double> &z = m_grid->z();
 
   const IceModelVec2CellType &mask = model->geometry().cell_type;
@@ -2470,6 +2465,13 @@ IceModelVec::Ptr IceViscosity::compute_impl() const {
         south = ice_free(m.s) ? 0 : 1,
         north = ice_free(m.n) ? 0 : 1;
 
+      // grid spacing to the west, east, south, and north of (i, j)
+      const double
+        dx_w = m_grid->spacing_x(i - 1),
+        dx_e = m_grid->spacing_x(i),
+        dy_s = m_grid->spacing_y(j - 1),
+        dy_n = m_grid->spacing_y(j);
+
       double *viscosity = result->get_column(i, j);
 
       if (ice_free(m.ij)) {
@@ -2492,7 +2494,7 @@ IceModelVec::Ptr IceViscosity::compute_impl() const {
 
         double u_x = 0.0, v_x = 0.0, w_x = 0.0;
         if (west + east > 0) {
-          const double D = 1.0 / (dx * (west + east));
+          const double D = 1.0 / (west * dx_w + east * dx_e);
           u_x = D * (west * (u[k] - u_w[k]) + east * (u_e[k] - u[k]));
           v_x = D * (west * (v[k] - v_w[k]) + east * (v_e[k] - v[k]));
           w_x = D * (west * (w[k] - w_w[k]) + east * (w_e[k] - w[k]));
@@ -2500,7 +2502,7 @@ IceModelVec::Ptr IceViscosity::compute_impl() const {
 
         double u_y = 0.0, v_y = 0.0, w_y = 0.0;
         if (south + north > 0) {
-          const double D = 1.0 / (dy * (south + north));
+          const double D = 1.0 / (south * dy_s + north * dy_n);
           u_y = D * (south * (u[k] - u_s[k]) + north * (u_n[k] - u[k]));
           v_y = D * (south * (v[k] - v_s[k]) + north * (v_n[k] - v[k]));
           w_y = D * (south * (w[k] - w_s[k]) + north * (w_n[k] - w[k]));
@@ -2677,6 +2679,11 @@ protected:
 
     m_interval_length += dt;
   }
+
+  std::vector<const IceModelVec2S*> model_inputs() {
+    // uses a custom update_impl()
+    return {};
+  }
 };
 
 
@@ -2998,8 +3005,6 @@ double IceModel::compute_temperate_base_fraction(double total_ice_area) {
 
   EnthalpyConverter::Ptr EC = m_ctx->enthalpy_converter();
 
-  auto cell_area = m_grid->cell_area();
-
   double result = 0.0, meltarea = 0.0;
 
   const IceModelVec3 &enthalpy = m_energy_model->enthalpy();
@@ -3009,6 +3014,7 @@ double IceModel::compute_temperate_base_fraction(double total_ice_area) {
   try {
     for (Points p(*m_grid); p; p.next()) {
       const int i = p.i(), j = p.j();
+      const double cell_area = m_grid->cell_area(i, j);
 
       if (m_geometry.cell_type.icy(i, j)) {
         const double
@@ -3052,8 +3058,7 @@ double IceModel::compute_original_ice_fraction(double total_ice_volume) {
     return result;  // leave now
   }
 
-  const double a = m_grid->cell_area() * 1e-3 * 1e-3, // area unit (km^2)
-    currtime = m_time->current(); // seconds
+  const double currtime = m_time->current(); // seconds
 
   const IceModelVec3 &ice_age = m_age_model->age();
 
@@ -3069,6 +3074,8 @@ double IceModel::compute_original_ice_fraction(double total_ice_volume) {
       const int i = p.i(), j = p.j();
 
       if (m_geometry.cell_type.icy(i, j)) {
+        const double a = m_grid->cell_area(i, j) * 1e-3 * 1e-3; // area unit (km^2)
+
         // accumulate volume of ice which is original
         const double *age = ice_age.get_column(i, j);
         const int  ks = m_grid->kBelowHeight(m_geometry.ice_thickness(i,j));
@@ -3106,8 +3113,6 @@ double IceModel::ice_volume_temperate(double thickness_threshold) const {
 
   const IceModelVec3 &ice_enthalpy = m_energy_model->enthalpy();
 
-  auto cell_area = m_grid->cell_area();
-
   double volume = 0.0;
 
   IceModelVec::AccessList list{&m_geometry.ice_thickness, &ice_enthalpy};
@@ -3115,6 +3120,7 @@ double IceModel::ice_volume_temperate(double thickness_threshold) const {
   try {
     for (Points p(*m_grid); p; p.next()) {
       const int i = p.i(), j = p.j();
+      const double cell_area = m_grid->cell_area(i, j);
 
       if (m_geometry.ice_thickness(i,j) >= thickness_threshold) {
         const int ks = m_grid->kBelowHeight(m_geometry.ice_thickness(i,j));
@@ -3149,14 +3155,13 @@ double IceModel::ice_volume_cold(double thickness_threshold) const {
 
   double volume = 0.0;
 
-  auto cell_area = m_grid->cell_area();
-
   IceModelVec::AccessList list{&m_geometry.ice_thickness, &ice_enthalpy};
 
   ParallelSection loop(m_grid->com);
   try {
     for (Points p(*m_grid); p; p.next()) {
       const int i = p.i(), j = p.j();
+      const double cell_area = m_grid->cell_area(i, j);
 
       const double thickness = m_geometry.ice_thickness(i, j);
 
@@ -3195,13 +3200,12 @@ double IceModel::ice_area_temperate(double thickness_threshold) const {
 
   double area = 0.0;
 
-  auto cell_area = m_grid->cell_area();
-
   IceModelVec::AccessList list{&m_geometry.ice_thickness, &ice_enthalpy};
   ParallelSection loop(m_grid->com);
   try {
     for (Points p(*m_grid); p; p.next()) {
       const int i = p.i(), j = p.j();
+      const double cell_area = m_grid->cell_area(i, j);
 
       const double
         thickness      = m_geometry.ice_thickness(i, j),
@@ -3229,13 +3233,12 @@ double IceModel::ice_area_cold(double thickness_threshold) const {
 
   double area = 0.0;
 
-  auto cell_area = m_grid->cell_area();
-
   IceModelVec::AccessList list{&ice_enthalpy, &m_geometry.ice_thickness};
   ParallelSection loop(m_grid->com);
   try {
     for (Points p(*m_grid); p; p.next()) {
       const int i = p.i(), j = p.j();
+      const double cell_area = m_grid->cell_area(i, j);
 
       const double
         thickness = m_geometry.ice_thickness(i, j),
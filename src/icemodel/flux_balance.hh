@@ -1,4 +1,4 @@
-/* Copyright (C) 2017, 2018, 2019 PISM Authors
+/* Copyright (C) 2017, 2018, 2019, 2020 PISM Authors
  *
  * This file is part of PISM.
  *
@@ -75,8 +75,6 @@ protected:
     if (m_interval_length > 0.0) {
       double ice_density = m_config->get_number("constants.ice.density");
 
-      auto cell_area = m_grid->cell_area();
-
       const IceModelVec2S& thickness = model->geometry().ice_thickness;
       const IceModelVec2S& area_specific_volume = model->geometry().ice_area_specific_volume;
 
@@ -85,6 +83,7 @@ protected:
 
       for (Points p(*m_grid); p; p.next()) {
         const int i = p.i(), j = p.j();
+        const double cell_area = m_grid->cell_area(i, j);
 
         // m * (kg / m^3) = kg / m^2
         double amount = (thickness(i, j) + area_specific_volume(i, j)) * ice_density;
@@ -141,8 +140,7 @@ public:
     : DiagAverageRate<IceModel>(m,
                                 kind == AMOUNT
                                 ? "tendency_of_ice_amount_due_to_flow"
-                                : "tendency_of_ice_mass_due_to_flow", TOTAL_CHANGE),
-    m_kind(kind) {
+                                : "tendency_of_ice_mass_due_to_flow", TOTAL_CHANGE) {
 
     std::string
       name              = "tendency_of_ice_amount_due_to_flow",
@@ -162,6 +160,8 @@ public:
     }
 
     m_factor = m_config->get_number("constants.ice.density");
+    // convert from kg m-2 to kg
+    m_per_cell_area = (kind == MASS);
 
     m_vars = {SpatialVariableMetadata(m_sys, name)};
     m_accumulator.metadata().set_string("units", accumulator_units);
@@ -173,26 +173,10 @@ public:
   }
 
 protected:
-  void update_impl(double dt) {
-    const IceModelVec2S
-      &dH = model->geometry_evolution().thickness_change_due_to_flow(),
-      &dV = model->geometry_evolution().area_specific_volume_change_due_to_flow();
-
-    auto cell_area = m_grid->cell_area();
-
-    IceModelVec::AccessList list{&m_accumulator, &dH, &dV};
-
-    for (Points p(*m_grid); p; p.next()) {
-      const int i = p.i(), j = p.j();
-
-      double C = m_factor * (m_kind == AMOUNT ? 1.0 : cell_area);
-
-      m_accumulator(i, j) += C * (dH(i, j) + dV(i, j));
-    }
-
-    m_interval_length += dt;
+  std::vector<const IceModelVec2S*> model_inputs() {
+    return {&model->geometry_evolution().thickness_change_due_to_flow(),
+            &model->geometry_evolution().area_specific_volume_change_due_to_flow()};
   }
-  AmountKind m_kind;
 };
 
 /*! @brief Report surface mass balance flux, averaged over the reporting interval */
@@ -204,9 +188,10 @@ public:
                                 kind == AMOUNT
                                 ? "tendency_of_ice_amount_due_to_surface_mass_flux"
                                 : "tendency_of_ice_mass_due_to_surface_mass_flux",
-                                TOTAL_CHANGE),
-    m_kind(kind) {
+                                TOTAL_CHANGE) {
     m_factor = m_config->get_number("constants.ice.density");
+    // convert from kg m-2 to kg
+    m_per_cell_area = (kind == MASS);
 
     auto ismip6 = m_config->get_flag("output.ISMIP6");
 
@@ -237,25 +222,9 @@ public:
   }
 
 protected:
-  void update_impl(double dt) {
-    const IceModelVec2S
-      &SMB = model->geometry_evolution().top_surface_mass_balance();
-
-    auto cell_area = m_grid->cell_area();
-
-    IceModelVec::AccessList list{&m_accumulator, &SMB};
-
-    for (Points p(*m_grid); p; p.next()) {
-      const int i = p.i(), j = p.j();
-
-      double C = m_factor * (m_kind == AMOUNT ? 1.0 : cell_area);
-
-      m_accumulator(i, j) += C * SMB(i, j);
-    }
-
-    m_interval_length += dt;
+  std::vector<const IceModelVec2S*> model_inputs() {
+    return {&model->geometry_evolution().top_surface_mass_balance()};
   }
-  AmountKind m_kind;
 };
 
 /*! @brief Report basal mass balance flux, averaged over the reporting interval */
@@ -267,9 +236,10 @@ public:
                                 kind == AMOUNT
                                 ? "tendency_of_ice_amount_due_to_basal_mass_flux"
                                 : "tendency_of_ice_mass_due_to_basal_mass_flux",
-                                TOTAL_CHANGE),
-    m_kind(kind) {
+                                TOTAL_CHANGE) {
     m_factor = m_config->get_number("constants.ice.density");
+    // convert from kg m-2 to kg
+    m_per_cell_area = (kind == MASS);
 
     std::string
       name              = "tendency_of_ice_amount_due_to_basal_mass_flux",
@@ -297,25 +267,9 @@ public:
   }
 
 protected:
-  void update_impl(double dt) {
-    const IceModelVec2S
-      &BMB = model->geometry_evolution().bottom_surface_mass_balance();
-
-    auto cell_area = m_grid->cell_area();
-
-    IceModelVec::AccessList list{&m_accumulator, &BMB};
-
-    for (Points p(*m_grid); p; p.next()) {
-      const int i = p.i(), j = p.j();
-
-      double C = m_factor * (m_kind == AMOUNT ? 1.0 : cell_area);
-
-      m_accumulator(i, j) += C * BMB(i, j);
-    }
-
-    m_interval_length += dt;
+  std::vector<const IceModelVec2S*> model_inputs() {
+    return {&model->geometry_evolution().bottom_surface_mass_balance()};
   }
-  AmountKind m_kind;
 };
 
 class ConservationErrorFlux : public DiagAverageRate<IceModel>
@@ -326,9 +280,10 @@ public:
                                 kind == AMOUNT
                                 ? "tendency_of_ice_amount_due_to_conservation_error"
                                 : "tendency_of_ice_mass_due_to_conservation_error" ,
-                                TOTAL_CHANGE),
-    m_kind(kind) {
+                                TOTAL_CHANGE) {
     m_factor = m_config->get_number("constants.ice.density");
+    // convert from kg m-2 to kg
+    m_per_cell_area = (kind == MASS);
 
     std::string
       name              = "tendency_of_ice_amount_due_to_conservation_error",
@@ -357,25 +312,9 @@ public:
   }
 
 protected:
-  void update_impl(double dt) {
-    const IceModelVec2S
-      &error = model->geometry_evolution().conservation_error();
-
-    IceModelVec::AccessList list{&m_accumulator, &error};
-
-    auto cell_area = m_grid->cell_area();
-
-    for (Points p(*m_grid); p; p.next()) {
-      const int i = p.i(), j = p.j();
-
-      double C = m_factor * (m_kind == AMOUNT ? 1.0 : cell_area);
-
-      m_accumulator(i, j) += C * error(i, j);
-    }
-
-    m_interval_length += dt;
+  std::vector<const IceModelVec2S*> model_inputs() {
+    return {&model->geometry_evolution().conservation_error()};
   }
-  AmountKind m_kind;
 };
 
 /*! @brief Report discharge (calving and frontal melt) flux. */
@@ -387,10 +326,11 @@ public:
                                 kind == AMOUNT
                                 ? "tendency_of_ice_amount_due_to_discharge"
                                 : "tendency_of_ice_mass_due_to_discharge",
-                                TOTAL_CHANGE),
-    m_kind(kind) {
+                                TOTAL_CHANGE) {
 
     m_factor = m_config->get_number("constants.ice.density");
+    // convert from kg m-2 to kg
+    m_per_cell_area = (kind == MASS);
 
     auto ismip6 = m_config->get_flag("output.ISMIP6");
 
@@ -421,26 +361,9 @@ public:
   }
 
 protected:
-  void update_impl(double dt) {
-    const IceModelVec2S &calving = model->calving();
-    const IceModelVec2S &frontal_melt = model->frontal_melt();
-    const IceModelVec2S &forced_retreat = model->forced_retreat();
-
-    IceModelVec::AccessList list{&m_accumulator, &calving, &frontal_melt, &forced_retreat};
-
-    auto cell_area = m_grid->cell_area();
-
-    for (Points p(*m_grid); p; p.next()) {
-      const int i = p.i(), j = p.j();
-
-      double C = m_factor * (m_kind == AMOUNT ? 1.0 : cell_area);
-
-      m_accumulator(i, j) += C * (calving(i, j) + frontal_melt(i, j) + forced_retreat(i, j));
-    }
-
-    m_interval_length += dt;
+  std::vector<const IceModelVec2S*> model_inputs() {
+    return {&model->calving(), &model->frontal_melt(), &model->forced_retreat()};
   }
-  AmountKind m_kind;
 };
 
 /*! @brief Report discharge (calving and frontal melt) flux. */
@@ -452,10 +375,11 @@ public:
                                 kind == AMOUNT
                                 ? "tendency_of_ice_amount_due_to_calving"
                                 : "tendency_of_ice_mass_due_to_calving",
-                                TOTAL_CHANGE),
-    m_kind(kind) {
+                                TOTAL_CHANGE) {
 
     m_factor = m_config->get_number("constants.ice.density");
+    // convert from kg m-2 to kg
+    m_per_cell_area = (kind == MASS);
 
     auto ismip6 = m_config->get_flag("output.ISMIP6");
 
@@ -486,24 +410,9 @@ public:
   }
 
 protected:
-  void update_impl(double dt) {
-    const IceModelVec2S &calving = model->calving();
-
-    IceModelVec::AccessList list{&m_accumulator, &calving};
-
-    auto cell_area = m_grid->cell_area();
-
-    for (Points p(*m_grid); p; p.next()) {
-      const int i = p.i(), j = p.j();
-
-      double C = m_factor * (m_kind == AMOUNT ? 1.0 : cell_area);
-
-      m_accumulator(i, j) += C * calving(i, j);
-    }
-
-    m_interval_length += dt;
+  std::vector<const IceModelVec2S*> model_inputs() {
+    return {&model->calving()};
   }
-  AmountKind m_kind;
 };
 
 
@@ -37,6 +37,7 @@
 #include "pism/hydrology/Hydrology.hh"
 #include "pism/frontretreat/util/remove_narrow_tongues.hh"
 #include "pism/frontretreat/PrescribedRetreat.hh"
+#include "pism/frontretreat/util/FrontBand.hh"
 
 namespace pism {
 
@@ -45,17 +46,24 @@ void IceModel::front_retreat_step() {
     add_values    = true,
     insert_values = false;
 
+  // The mass continuity step may have changed the ice extent anywhere, so we re-build
+  // the list of cells at the ice front by scanning the whole grid. This is the only place
+  // where this is done during a time step: all the code below (and the rest of
+  // IceModel::step()) updates the list incrementally.
+  FrontBand &front = *m_front_band;
+  front.reset(m_geometry.cell_type);
+
   // compute retreat rates due to eigencalving, von Mises calving, Hayhurst calving,
   // and frontal melt.
   // We do this first to make sure that all three mechanisms use the same ice geometry.
   {
     if (m_eigen_calving) {
-      m_eigen_calving->update(m_geometry.cell_type,
+      m_eigen_calving->update(m_geometry.cell_type, front,
                               m_stress_balance->shallow()->velocity());
     }
 
     if (m_hayhurst_calving) {
-      m_hayhurst_calving->update(m_geometry.cell_type,
+      m_hayhurst_calving->update(m_geometry.cell_type, front,
                                  m_geometry.ice_thickness,
                                  m_geometry.sea_level_elevation,
                                  m_geometry.bed_elevation);
@@ -64,7 +72,7 @@ void IceModel::front_retreat_step() {
     if (m_vonmises_calving) {
       // FIXME: consider computing vertically-averaged hardness here and providing that
       // instead of using ice thickness and enthalpy.
-      m_vonmises_calving->update(m_geometry.cell_type,
+      m_vonmises_calving->update(m_geometry.cell_type, front,
                                  m_geometry.ice_thickness,
                                  m_stress_balance->shallow()->velocity(),
                                  m_energy_model->enthalpy());
@@ -96,7 +104,7 @@ void IceModel::front_retreat_step() {
     old_Href.copy_from(m_geometry.ice_area_specific_volume);
 
     // apply frontal melt rate
-    m_front_retreat->update_geometry(m_dt, m_geometry, m_ssa_dirichlet_bc_mask,
+    m_front_retreat->update_geometry(m_dt, m_geometry, front, m_ssa_dirichlet_bc_mask,
                                      m_frontal_melt->retreat_rate(),
                                      m_geometry.ice_area_specific_volume,
                                      m_geometry.ice_thickness);
@@ -135,7 +143,7 @@ void IceModel::front_retreat_step() {
         retreat_rate.add(1.0, m_vonmises_calving->calving_rate());
       }
 
-      m_front_retreat->update_geometry(m_dt, m_geometry, m_ssa_dirichlet_bc_mask,
+      m_front_retreat->update_geometry(m_dt, m_geometry, front, m_ssa_dirichlet_bc_mask,
                                        retreat_rate,
                                        m_geometry.ice_area_specific_volume,
                                        m_geometry.ice_thickness);
@@ -143,20 +151,26 @@ void IceModel::front_retreat_step() {
       auto thickness_threshold = m_config->get_number("stress_balance.ice_free_thickness_standard");
 
       m_geometry.ensure_consistency(thickness_threshold);
+      front.update(m_geometry.cell_type);
 
       if (m_eigen_calving or m_vonmises_calving or m_hayhurst_calving) {
-        remove_narrow_tongues(m_geometry, m_geometry.ice_thickness);
+        remove_narrow_tongues(m_geometry, front, m_geometry.ice_thickness);
 
         m_geometry.ensure_consistency(thickness_threshold);
+        front.update(m_geometry.cell_type);
       }
     }
 
     if (m_float_kill_calving) {
+      // FloatKill modifies the mask in place and its result depends on the traversal
+      // order, so it has to scan the whole grid. It may remove ice anywhere.
       m_float_kill_calving->update(m_geometry.cell_type, m_geometry.ice_thickness);
+      front.reset(m_geometry.cell_type);
     }
 
     if (m_thickness_threshold_calving) {
-      m_thickness_threshold_calving->update(m_geometry.cell_type, m_geometry.ice_thickness);
+      m_thickness_threshold_calving->update(m_geometry.cell_type, front,
+                                            m_geometry.ice_thickness);
     }
 
     compute_geometry_change(m_geometry.ice_thickness,
@@ -196,6 +210,7 @@ void IceModel::front_retreat_step() {
     old_Href.copy_from(m_geometry.ice_area_specific_volume);
 
     enforce_consistency_of_geometry(REMOVE_ICEBERGS);
+    front.update(m_geometry.cell_type);
 
     compute_geometry_change(m_geometry.ice_thickness,
                             m_geometry.ice_area_specific_volume,
@@ -65,6 +65,7 @@
 #include "pism/energy/TemperatureModel.hh"
 #include "pism/fracturedensity/FractureDensity.hh"
 #include "pism/frontretreat/FrontRetreat.hh"
+#include "pism/frontretreat/util/FrontBand.hh"
 #include "pism/frontretreat/PrescribedRetreat.hh"
 #include "pism/coupler/frontalmelt/Factory.hh"
 #include "pism/coupler/util/options.hh" // ForcingOptions
@@ -173,6 +174,16 @@ void IceModel::model_state_setup() {
       m_output_global_attributes.set_string("history",
                                             history + m_output_global_attributes.get_string("history"));
 
+      if (input.type == INIT_RESTART) {
+        // Record the projection used to compute longitude and latitude saved in the
+        // input file (if any) so that compute_lat_lon() can re-use them.
+        for (auto *v : {&m_geometry.longitude, &m_geometry.latitude}) {
+          std::string name = v->metadata().get_name();
+          if (input_file->find_variable(name)) {
+            v->metadata().set_string("proj", input_file->read_text_attribute(name, "proj"));
+          }
+        }
+      }
     }
 
     compute_lat_lon();
@@ -713,6 +724,44 @@ void IceModel::allocate_couplers() {
 }
 
 //! Miscellaneous initialization tasks plus tasks that need the fields that can come from regridding.
+/*!
+ * List fields in the dictionary of variables (IceGrid::variables()) that were not used
+ * during initialization, i.e. the ones that don't use any memory thanks to
+ * `grid.lazy_allocation`.
+ */
+void IceModel::report_unused_fields() const {
+  if (not m_config->get_flag("grid.lazy_allocation")) {
+    return;
+  }
+
+  const Vars &variables = m_grid->variables();
+
+  auto names = variables.keys();
+
+  std::vector<std::string> unused;
+  double size = 0.0;
+  for (const auto &name : names) {
+    const IceModelVec *f = variables.get(name);
+
+    if (not f->is_materialized()) {
+      unused.push_back(name);
+
+      double N = 1.0;
+      for (auto n : f->shape()) {
+        N *= n;
+      }
+      size += N * sizeof(double);
+    }
+  }
+
+  m_log->message(2,
+                 "* Lazy allocation: %d of %d fields were not used during initialization"
+                 " (%.1f Mb not allocated)%s%s\n",
+                 (int)unused.size(), (int)names.size(), size / (1024.0 * 1024.0),
+                 unused.empty() ? "" : ": ",
+                 join(unused, ", ").c_str());
+}
+
 void IceModel::misc_setup() {
 
   m_log->message(3, "Finishing initialization...\n");
@@ -784,6 +833,7 @@ void IceModel::misc_setup() {
   init_backups();
   init_timeseries();
   init_extras();
+  init_task_graph();
 
   // a report on whether PISM-PIK modifications of IceModel are in use
   {
@@ -956,6 +1006,13 @@ void IceModel::init_calving() {
   if (not m_front_retreat and allocate_front_retreat) {
     m_front_retreat.reset(new FrontRetreat(m_grid));
   }
+
+  if (not m_front_band) {
+    m_front_band.reset(new FrontBand(m_grid));
+  }
+  // The band is re-built once per time step by front_retreat_step(); this makes it
+  // usable in the first call of max_timestep().
+  m_front_band->reset(m_geometry.cell_type);
 }
 
 void IceModel::allocate_bed_deformation() {
@@ -1045,13 +1102,27 @@ void IceModel::compute_lat_lon() {
 
   if (m_config->get_flag("grid.recompute_longitude_and_latitude") and
       not projection.empty()) {
+    auto &lon = m_geometry.longitude;
+    auto &lat = m_geometry.latitude;
+
+    // Longitude and latitude saved by PISM include the PROJ string used to compute them.
+    if (lon.metadata().get_string("proj") == projection and
+        lat.metadata().get_string("proj") == projection) {
+      m_log->message(2,
+                     "* Using longitude and latitude computed using \"%s\" during a previous run.\n",
+                     projection.c_str());
+      return;
+    }
+
     m_log->message(2,
                    "* Computing longitude and latitude using projection parameters...\n");
 
-    compute_longitude(projection, m_geometry.longitude);
-    m_geometry.longitude.metadata().set_string("missing_at_bootstrap", "");
-    compute_latitude(projection, m_geometry.latitude);
-    m_geometry.latitude.metadata().set_string("missing_at_bootstrap", "");
+    compute_lon_lat(projection, lon, lat);
+
+    for (auto *v : {&lon, &lat}) {
+      v->metadata().set_string("missing_at_bootstrap", "");
+      v->metadata().set_string("proj", projection);
+    }
   }
 }
 
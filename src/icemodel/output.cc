@@ -1,4 +1,4 @@
-// Copyright (C) 2004-2019 Jed Brown, Ed Bueler and Constantine Khroulev
+// Copyright (C) 2004-2020 Jed Brown, Ed Bueler and Constantine Khroulev
 //
 // This file is part of PISM.
 //
@@ -35,6 +35,7 @@
 #include "pism/util/Vars.hh"
 #include "pism/util/io/io_helpers.hh"
 #include "pism/util/Profiling.hh"
+#include "pism/util/WallClock.hh"
 #include "pism/util/pism_utilities.hh"
 #include "pism/util/projection.hh"
 #include "pism/util/Component.hh"
@@ -245,7 +246,7 @@ void IceModel::save_variables(const File &file,
     unsigned int time_length = file.dimension_length(m_config->get_string("time.dimension_name"));
     size_t start = time_length > 0 ? static_cast<size_t>(time_length - 1) : 0;
     io::write_timeseries(file, m_timestamp, start,
-                         wall_clock_hours(m_grid->com, m_start_time));
+                         m_ctx->wall_clock().hours_since(m_start_time));
   }
 }
 
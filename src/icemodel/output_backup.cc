@@ -1,4 +1,4 @@
-/* Copyright (C) 2017, 2019 PISM Authors
+/* Copyright (C) 2017, 2019, 2020 PISM Authors
  *
  * This file is part of PISM.
  *
@@ -17,10 +17,14 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#include <cstdio>               // rename
+
 #include "IceModel.hh"
 
 #include "pism/util/pism_utilities.hh"
 #include "pism/util/Profiling.hh"
+#include "pism/util/io/BackupDrainer.hh"
+#include "pism/util/error_handling.hh"
 
 namespace pism {
 
@@ -36,6 +40,15 @@ void IceModel::init_backups() {
 
   m_backup_vars = output_variables(m_config->get_string("output.backup_size"));
   m_last_backup_time = 0.0;
+
+  std::string staging_dir = m_config->get_string("output.backup_staging_dir");
+  if (not staging_dir.empty()) {
+    m_backup_staged_filename = staged_file_name(staging_dir, m_backup_filename);
+    m_backup_run_id = backup_run_id(m_grid->com);
+    m_backup_drainer.reset(new BackupDrainer(m_grid->com));
+
+    m_log->message(2, "* Staging automatic backups in '%s'...\n", staging_dir.c_str());
+  }
 }
 
   //! Write a backup (i.e. an intermediate result of a run).
@@ -43,7 +56,11 @@ void IceModel::write_backup() {
 
   double backup_interval = m_config->get_number("output.backup_interval");
 
-  double wall_clock_hours = pism::wall_clock_hours(m_grid->com, m_start_time);
+  // Use the wall clock time reduced together with the CFL time step restriction during
+  // this time step: all ranks have to make the same decision and this way they do not need
+  // to communicate.
+  double wall_clock_hours = (m_stress_balance->max_timestep_cfl_2d().wall_clock_time -
+                             m_start_time) / 3600.0;
 
   if (wall_clock_hours - m_last_backup_time < backup_interval) {
     return;
@@ -61,7 +78,38 @@ void IceModel::write_backup() {
 
   double backup_start_time = get_time();
   profiling.begin("io.backup");
-  {
+  if (m_backup_drainer) {
+    // The staged copy is about to be overwritten, so the previous one has to be drained
+    // first. Usually this is done long before the next backup is due.
+    m_backup_drainer->wait();
+
+    // Write to a temporary file so that the staged copy is always complete. The staging
+    // directory is usually visible to rank 0 only, so we use the rank-0-only backend.
+    std::string tmp = m_backup_staged_filename + ".partial";
+    {
+      File file(m_grid->com, tmp, PISM_NETCDF3, PISM_READWRITE_CLOBBER);
+
+      write_metadata(file, WRITE_MAPPING, PREPEND_HISTORY);
+      write_run_stats(file);
+      // used to check that a staged copy belongs to a backup when re-starting
+      write_backup_id(file, m_backup_run_id, m_backup_filename);
+
+      save_variables(file, INCLUDE_MODEL_STATE, m_backup_vars, m_time->current());
+    }
+
+    int stat = 0;
+    if (m_grid->rank() == 0) {
+      stat = rename(tmp.c_str(), m_backup_staged_filename.c_str());
+    }
+    MPI_Bcast(&stat, 1, MPI_INT, 0, m_grid->com);
+
+    if (stat != 0) {
+      throw RuntimeError::formatted(PISM_ERROR_LOCATION, "can't move '%s' to '%s'",
+                                    tmp.c_str(), m_backup_staged_filename.c_str());
+    }
+
+    m_backup_drainer->start(m_backup_staged_filename, m_backup_filename);
+  } else {
     File file(m_grid->com,
               m_backup_filename,
               string_to_backend(m_config->get_string("output.format")),
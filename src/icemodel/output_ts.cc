@@ -80,7 +80,11 @@ void IceModel::init_timeseries() {
     // default behavior is to move the file aside if it exists already; option allows appending
     bool append = m_config->get_flag("output.timeseries.append");
     IO_Mode mode = append ? PISM_READWRITE : PISM_READWRITE_MOVE;
-    File file(m_grid->com, m_ts_filename, PISM_NETCDF3, mode);      // Use NetCDF-3 to write time-series.
+
+    // The writer keeps this file open for the duration of the run.
+    m_ts_writer.reset(new TSDiagnosticWriter(m_grid, m_ts_filename, mode));
+    const File &file = m_ts_writer->file();
+
     // add the last saved time to the list of requested times so that the first time is interpreted
     // as the end of a reporting time step
     if (append and file.dimension_length("time") > 0) {
@@ -97,10 +101,8 @@ void IceModel::init_timeseries() {
     write_metadata(file, SKIP_MAPPING, PREPEND_HISTORY);
     write_run_stats(file);
 
-    // initialize scalar diagnostics
-    for (auto d : m_ts_diagnostics) {
-      d.second->init(file, m_ts_times);
-    }
+    // initialize scalar diagnostics and define all time-series variables
+    m_ts_writer->init(m_ts_diagnostics, m_ts_times);
   }
 }
 
@@ -117,16 +119,17 @@ MaxTimestep IceModel::ts_max_timestep(double my_t) {
 
 //! Flush scalar time-series.
 void IceModel::flush_timeseries() {
-  // flush all the time-series buffers:
-  for (auto d : m_ts_diagnostics) {
-    d.second->flush();
+  if (not m_ts_writer) {
+    return;
   }
 
   // update run_stats in the time series output file
   if (not m_ts_diagnostics.empty()) {
-    File file(m_grid->com, m_ts_filename, PISM_NETCDF3, PISM_READWRITE);
-    write_run_stats(file);
+    write_run_stats(m_ts_writer->file());
   }
+
+  // write all the time-series buffers (this synchronizes the file)
+  m_ts_writer->flush();
 }
 
 } // end of namespace pism
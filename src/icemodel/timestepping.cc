@@ -1,4 +1,4 @@
-// Copyright (C) 2004-2017, 2019 Jed Brown, Ed Bueler and Constantine Khroulev
+// Copyright (C) 2004-2017, 2019, 2020 Jed Brown, Ed Bueler and Constantine Khroulev
 //
 // This file is part of PISM.
 //
@@ -32,6 +32,7 @@
 #include "pism/frontretreat/calving/HayhurstCalving.hh"
 #include "pism/frontretreat/calving/vonMisesCalving.hh"
 #include "pism/frontretreat/FrontRetreat.hh"
+#include "pism/frontretreat/util/FrontBand.hh"
 
 #include "pism/energy/EnergyModel.hh"
 #include "pism/coupler/OceanModel.hh"
@@ -47,17 +48,27 @@ updates dt.
 Note adapt_ratio * 2 is multiplied by dx^2/(2*maxD) so dt <= adapt_ratio *
 dx^2/maxD (if dx=dy).
 
+On non-uniform grids this uses the maximum of maxD * (1/dx^2 + 1/dy^2) computed using
+local grid spacing (see StressBalance::max_diffusivity_rate()).
+
 Reference: [\ref MortonMayers] pp 62--63.
  */
 MaxTimestep IceModel::max_timestep_diffusivity() {
   double D_max = m_stress_balance->max_diffusivity();
 
   if (D_max > 0.0) {
+    const double adaptive_timestepping_ratio = m_config->get_number("time_stepping.adaptive_ratio");
+
+    if (not m_grid->uniform()) {
+      // use local grid spacing
+      return MaxTimestep(adaptive_timestepping_ratio * 2.0 / m_stress_balance->max_diffusivity_rate(),
+                         "diffusivity");
+    }
+
     const double
       dx = m_grid->dx(),
       dy = m_grid->dy(),
-      adaptive_timestepping_ratio = m_config->get_number("time_stepping.adaptive_ratio"),
-      grid_factor                 = 1.0 / (dx*dx) + 1.0 / (dy*dy);
+      grid_factor = 1.0 / (dx*dx) + 1.0 / (dy*dy);
 
     return MaxTimestep(adaptive_timestepping_ratio * 2.0 / (D_max * grid_factor),
                        "diffusivity");
@@ -145,7 +156,11 @@ void IceModel::max_timestep(double &dt_result, unsigned int &skip_counter_result
 
     assert(m_front_retreat);
 
+    // m_front_band was re-built during the last front retreat step and updated after all
+    // later changes of the ice extent (see IceModel::step()), so there is no need to
+    // scan the whole grid here
     restrictions.push_back(m_front_retreat->max_timestep(m_geometry.cell_type,
+                                                         *m_front_band,
                                                          m_ssa_dirichlet_bc_mask,
                                                          retreat_rate));
   }
@@ -174,7 +189,15 @@ void IceModel::max_timestep(double &dt_result, unsigned int &skip_counter_result
   if (m_config->get_flag("geometry.update.enabled")) {
     CFLData cfl = m_stress_balance->max_timestep_cfl_2d();
 
-    restrictions.push_back(MaxTimestep(cfl.dt_max.value(), "2D CFL"));
+    if (m_config->get_flag("geometry.multirate.enabled")) {
+      // GeometryEvolution sub-cycles parts of the domain that need shorter time steps
+      const int max_level = m_config->get_number("geometry.multirate.max_level");
+
+      restrictions.push_back(MaxTimestep(cfl.dt_max.value() * (1 << max_level),
+                                         "2D CFL (multirate)"));
+    } else {
+      restrictions.push_back(MaxTimestep(cfl.dt_max.value(), "2D CFL"));
+    }
     restrictions.push_back(max_timestep_diffusivity());
   }
 
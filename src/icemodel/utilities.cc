@@ -1,4 +1,4 @@
-// Copyright (C) 2004-2019 Jed Brown, Ed Bueler and Constantine Khroulev
+// Copyright (C) 2004-2020 Jed Brown, Ed Bueler and Constantine Khroulev
 //
 // This file is part of PISM.
 //
@@ -26,6 +26,7 @@
 #include "pism/util/Time.hh"
 #include "pism/util/io/File.hh"
 #include "pism/util/pism_utilities.hh"
+#include "pism/util/WallClock.hh"
 #include "pism/util/projection.hh"
 #include "pism/util/pism_signal.h"
 
@@ -96,7 +97,7 @@ void IceModel::update_run_stats() {
   // timing stats
   // MYPPH stands for "model years per processor hour"
   double
-    wall_clock_hours = pism::wall_clock_hours(m_grid->com, m_start_time),
+    wall_clock_hours = m_ctx->wall_clock().hours_since(m_start_time),
     proc_hours       = m_grid->size() * wall_clock_hours,
     model_years      = units::convert(m_sys, m_time->current() - m_time->start(),
                                       "seconds", "years");
@@ -104,6 +105,13 @@ void IceModel::update_run_stats() {
   m_run_stats.set_number("wall_clock_hours", wall_clock_hours);
   m_run_stats.set_number("processor_hours", proc_hours);
   m_run_stats.set_number("model_years_per_processor_hour", model_years / proc_hours);
+
+  if (m_geometry_evolution and m_config->get_flag("geometry.multirate.enabled")) {
+    m_run_stats.set_number("multirate_saved_flux_evaluations",
+                           m_geometry_evolution->multirate_saved_flux_evaluations());
+    m_run_stats.set_number("multirate_conservation_error_kg",
+                           m_geometry_evolution->multirate_conservation_error());
+  }
 }
 
 //! Get time and user/host name and add it to the given string.
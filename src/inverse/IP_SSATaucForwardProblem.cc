@@ -1,4 +1,4 @@
-// Copyright (C) 2012, 2014, 2015, 2016, 2017, 2019  David Maxwell and Constantine Khroulev
+// Copyright (C) 2012, 2014, 2015, 2016, 2017, 2019, 2020  David Maxwell and Constantine Khroulev
 //
 // This file is part of PISM.
 //
@@ -341,13 +341,16 @@ void IP_SSATaucForwardProblem::apply_jacobian_design(IceModelVec2V &u,
                             mask, thickness, tauc, hardness);
         }
 
+        // Determine "dbeta / dzeta" at quadrature points
+        double dbeta_q[Nq_max];
+        m_basal_sliding_law->drag(Nq, dtauc_q, u_q, dbeta_q);
+
         for (unsigned int q = 0; q < Nq; q++) {
           Vector2 u_qq = u_q[q];
 
-          // Determine "dbeta / dzeta" at the quadrature point
           double dbeta = 0;
           if (mask::grounded_ice(mask[q])) {
-            dbeta = m_basal_sliding_law->drag(dtauc_q[q], u_qq.u, u_qq.v);
+            dbeta = dbeta_q[q];
           }
 
           for (unsigned int k = 0; k < Nk; k++) {
@@ -495,14 +498,23 @@ void IP_SSATaucForwardProblem::apply_jacobian_design_transpose(IceModelVec2V &u,
                             mask, thickness, tauc, hardness);
         }
 
+        // Determine "dbeta/dtauc" at quadrature points
+        double dbeta_dtauc_q[Nq_max];
+        {
+          double one[Nq_max];
+          for (unsigned int q = 0; q < Nq; q++) {
+            one[q] = 1.0;
+          }
+          m_basal_sliding_law->drag(Nq, one, u_q, dbeta_dtauc_q);
+        }
+
         for (unsigned int q=0; q<Nq; q++) {
           Vector2 du_qq = du_q[q];
           Vector2 u_qq = u_q[q];
 
-          // Determine "dbeta/dtauc" at the quadrature point
           double dbeta_dtauc = 0;
           if (mask::grounded_ice(mask[q])) {
-            dbeta_dtauc = m_basal_sliding_law->drag(1., u_qq.u, u_qq.v);
+            dbeta_dtauc = dbeta_dtauc_q[q];
           }
 
           for (unsigned int k=0; k<Nk; k++) {
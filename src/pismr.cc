@@ -32,6 +32,7 @@ static char help[] =
 #include "pism/util/error_handling.hh"
 #include "pism/util/Context.hh"
 #include "pism/util/Profiling.hh"
+#include "pism/util/io/BackupDrainer.hh"
 
 #include "pism/regional/IceGrid_Regional.hh"
 #include "pism/regional/IceRegionalModel.hh"
@@ -77,6 +78,10 @@ int main(int argc, char *argv[]) {
       ctx->profiling().start();
     }
 
+    // If this run is re-started from a backup that was not completely copied from the
+    // staging directory, use the staged copy.
+    recover_staged_backup(com, *config, *log);
+
     IceGrid::Ptr grid;
     std::unique_ptr<IceModel> model;
 
@@ -58,6 +58,8 @@
 #include "util/Context.hh"
 #include "util/Logger.hh"
 #include "util/Profiling.hh"
+#include "util/WallClock.hh"
+#include "util/TaskGraph.hh"
 
 #include "util/projection.hh"
 #include "energy/bootstrapping.hh"
@@ -240,6 +242,8 @@
 %include "util/Time_Calendar.hh"
 
 %include "util/Profiling.hh"
+%include "util/WallClock.hh"
+%include "util/TaskGraph.hh"
 %shared_ptr(pism::Context);
 %include "util/Context.hh"
 
@@ -257,10 +261,18 @@
 /* IceModelVec uses IceGrid and VariableMetadata so they have to be wrapped first. */
 %include pism_IceModelVec.i
 
+/* Proc0Scatter uses IceModelVec2S. */
+%include pism_Proc0Scatter.i
+
 /* pism::Vars uses IceModelVec, so IceModelVec has to be wrapped first. */
 %include pism_Vars.i
 
 
+/* fused updates of time-averaged diagnostics are used internally */
+%ignore pism::AccumulatorUpdate;
+%ignore pism::accumulate;
+%ignore pism::Diagnostic::fused_update;
+%ignore pism::DiagnosticBuffers;
 %shared_ptr(pism::Diagnostic)
 %include "util/Diagnostic.hh"
 %include "stressbalance/timestepping.hh"
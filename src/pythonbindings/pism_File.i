@@ -5,8 +5,12 @@
 
 %ignore pism::File::read_variable(const std::string &, const std::vector<unsigned int> &, const std::vector<unsigned int> &, double *) const;
 %ignore pism::File::write_variable(const std::string &, const std::vector<unsigned int> &, const std::vector<unsigned int> &, const double *) const;
+%ignore pism::File::write_session;
+%ignore pism::File::WriteSession;
 
 %include "util/io/IO_Flags.hh"
+%template(AttributeVector) std::vector<pism::Attribute>;
+
 %include "util/io/File.hh"
 %include "util/io/io_helpers.hh"
 
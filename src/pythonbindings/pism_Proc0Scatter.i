@@ -0,0 +1,52 @@
+%{
+#include "util/Proc0Scatter.hh"
+%}
+
+%template(IceModelVec2SVector) std::vector<std::shared_ptr<pism::IceModelVec2S> >;
+%template(VecPtrVector) std::vector<std::shared_ptr<pism::petsc::Wrapper< ::Vec > > >;
+
+/* disable methods that use regular pointers */
+%ignore pism::Proc0Scatter::get;
+%ignore pism::Proc0Scatter::get_begin;
+%ignore pism::Proc0Scatter::get_end;
+
+/* replace with methods that use shared pointers */
+%rename(get) pism::Proc0Scatter::get_shared;
+%rename(get_begin) pism::Proc0Scatter::get_begin_shared;
+%rename(get_end) pism::Proc0Scatter::get_end_shared;
+
+%include "util/Proc0Scatter.hh"
+
+%extend pism::Proc0Scatter {
+
+  void get_begin_shared(const std::vector<std::shared_ptr<pism::petsc::Wrapper< ::Vec > > > &proc0) {
+    std::vector<Vec> vecs;
+    for (auto v : proc0) {
+      vecs.push_back(v->get());
+    }
+    $self->get_begin(vecs);
+  }
+
+  void get_end_shared(const std::vector<std::shared_ptr<pism::IceModelVec2S> > &fields) {
+    std::vector<pism::IceModelVec2S*> ptrs;
+    for (auto f : fields) {
+      ptrs.push_back(f.get());
+    }
+    $self->get_end(ptrs);
+  }
+
+  void get_shared(const std::vector<std::shared_ptr<pism::petsc::Wrapper< ::Vec > > > &proc0,
+                  const std::vector<std::shared_ptr<pism::IceModelVec2S> > &fields) {
+    std::vector<Vec> vecs;
+    for (auto v : proc0) {
+      vecs.push_back(v->get());
+    }
+
+    std::vector<pism::IceModelVec2S*> ptrs;
+    for (auto f : fields) {
+      ptrs.push_back(f.get());
+    }
+
+    $self->get(vecs, ptrs);
+  }
+}
@@ -4,8 +4,25 @@
 #include "frontretreat/calving/FloatKill.hh"
 #include "frontretreat/calving/HayhurstCalving.hh"
 #include "frontretreat/calving/vonMisesCalving.hh"
+#include "frontretreat/util/FrontBand.hh"
 %}
 
+%ignore pism::FrontBand::Points;
+%include "frontretreat/util/FrontBand.hh"
+
+%extend pism::FrontBand
+{
+  // Returns cells in the band (in this sub-domain) as a list [i0, j0, i1, j1, ...].
+  std::vector<int> cells() const {
+    std::vector<int> result;
+    for (pism::FrontBand::Points p(*$self); p; p.next()) {
+      result.push_back(p.i());
+      result.push_back(p.j());
+    }
+    return result;
+  }
+};
+
 %shared_ptr(pism::calving::CalvingAtThickness)
 %rename(CalvingAtThickness) pism::calving::CalvingAtThickness;
 %include "frontretreat/calving/CalvingAtThickness.hh"
@@ -1,4 +1,4 @@
-/* Copyright (C) 2015, 2016, 2017 PISM Authors
+/* Copyright (C) 2015, 2016, 2017, 2020 PISM Authors
  *
  * This file is part of PISM.
  *
@@ -78,10 +78,6 @@ void SSAFD_Regional::compute_driving_stress(const IceModelVec2S &ice_thickness,
 
   SSAFD::compute_driving_stress(ice_thickness, surface_elevation, cell_type, no_model_mask, result);
 
-  double
-    dx = m_grid->dx(),
-    dy = m_grid->dy();
-
   int
     Mx = m_grid->Mx(),
     My = m_grid->My();
@@ -120,7 +116,8 @@ void SSAFD_Regional::compute_driving_stress(const IceModelVec2S &ice_thickness,
       east *= weight(CT.ij, CT.e, h.ij, h.e);
 
       if (east + west > 0) {
-        h_x = 1.0 / ((west + east) * dx) * (west * (h.ij - h.w) + east * (h.e - h.ij));
+        h_x = 1.0 / (west * m_grid->spacing_x(i - 1) + east * m_grid->spacing_x(i)) *
+          (west * (h.ij - h.w) + east * (h.e - h.ij));
       } else {
         h_x = 0.0;
       }
@@ -138,7 +135,8 @@ void SSAFD_Regional::compute_driving_stress(const IceModelVec2S &ice_thickness,
       north *= weight(CT.ij, CT.n, h.ij, h.n);
 
       if (north + south > 0) {
-        h_y = 1.0 / ((south + north) * dy) * (south * (h.ij - h.s) + north * (h.n - h.ij));
+        h_y = 1.0 / (south * m_grid->spacing_y(j - 1) + north * m_grid->spacing_y(j)) *
+          (south * (h.ij - h.s) + north * (h.n - h.ij));
       } else {
         h_y = 0.0;
       }
@@ -35,6 +35,7 @@ SSB_Modifier::SSB_Modifier(IceGrid::ConstPtr g)
     m_v(m_grid, "vvel", WITH_GHOSTS),
     m_strain_heating(m_grid, "strainheat", WITHOUT_GHOSTS) {
   m_D_max = 0.0;
+  m_D_rate_max = 0.0;
 
   m_u.set_attrs("diagnostic", "horizontal velocity of ice in the X direction",
                 "m s-1", "m year-1", "land_ice_x_velocity", 0);
@@ -70,6 +71,10 @@ double SSB_Modifier::max_diffusivity() const {
   return m_D_max;
 }
 
+double SSB_Modifier::max_diffusivity_rate() const {
+  return m_D_rate_max;
+}
+
 const IceModelVec3& SSB_Modifier::velocity_u() const {
   return m_u;
 }
@@ -142,6 +147,7 @@ void ConstantInColumn::update(const IceModelVec2V &sliding_velocity,
   // diffusive flux and maximum diffusivity
   m_diffusive_flux.set(0.0);
   m_D_max = 0.0;
+  m_D_rate_max = 0.0;
 }
 
 } // end of namespace stressbalance
@@ -53,6 +53,10 @@ public:
   //! \brief Get the max diffusivity (for the adaptive time-stepping).
   virtual double max_diffusivity() const;
 
+  //! \brief Get the maximum of \f$D (1/dx^2 + 1/dy^2)\f$ using local grid spacing
+  //! (for the adaptive time-stepping on non-uniform grids).
+  virtual double max_diffusivity_rate() const;
+
   const IceModelVec3& velocity_u() const;
 
   const IceModelVec3& velocity_v() const;
@@ -67,6 +71,8 @@ protected:
   std::shared_ptr<rheology::FlowLaw> m_flow_law;
   EnthalpyConverter::Ptr m_EC;
   double m_D_max;
+  //! maximum of D (1/dx^2 + 1/dy^2) (using local grid spacing; set on non-uniform grids only)
+  double m_D_rate_max;
   IceModelVec2Stag m_diffusive_flux;
   IceModelVec3 m_u, m_v, m_strain_heating;
 };
@@ -1,4 +1,4 @@
-// Copyright (C) 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019 Constantine Khroulev and Ed Bueler
+// Copyright (C) 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019, 2020 Constantine Khroulev and Ed Bueler
 //
 // This file is part of PISM.
 //
@@ -230,6 +230,10 @@ double StressBalance::max_diffusivity() const {
   return m_modifier->max_diffusivity();
 }
 
+double StressBalance::max_diffusivity_rate() const {
+  return m_modifier->max_diffusivity_rate();
+}
+
 const IceModelVec3& StressBalance::velocity_u() const {
   return m_modifier->velocity_u();
 }
@@ -297,10 +301,6 @@ void StressBalance::compute_vertical_velocity(const IceModelVec2CellType &mask,
   const std::vector<double> &z = m_grid->z();
   const unsigned int Mz = m_grid->Mz();
 
-  const double
-    dx = m_grid->dx(),
-    dy = m_grid->dy();
-
   std::vector<double> u_x_plus_v_y(Mz);
 
   for (Points p(*m_grid); p; p.next()) {
@@ -323,8 +323,8 @@ void StressBalance::compute_vertical_velocity(const IceModelVec2CellType &mask,
       south = 1.0,
       north = 1.0;
     double
-      D_x = 0,                  // 1/(dx), 1/(2dx), or 0
-      D_y = 0;                  // 1/(dy), 1/(2dy), or 0
+      D_x = 0,                  // 1/(dx_w), 1/(dx_e), 1/(dx_w + dx_e), or 0
+      D_y = 0;                  // 1/(dy_s), 1/(dy_n), 1/(dy_s + dy_n), or 0
 
     // Switch between second-order centered differences in the interior and
     // first-order one-sided differences at ice margins.
@@ -358,7 +358,7 @@ void StressBalance::compute_vertical_velocity(const IceModelVec2CellType &mask,
       }
 
       if (east + west > 0) {
-        D_x = 1.0 / (dx * (east + west));
+        D_x = 1.0 / (west * m_grid->spacing_x(i - 1) + east * m_grid->spacing_x(i));
       } else {
         D_x = 0.0;
       }
@@ -393,7 +393,7 @@ void StressBalance::compute_vertical_velocity(const IceModelVec2CellType &mask,
       }
 
       if (north + south > 0) {
-        D_y = 1.0 / (dy * (north + south));
+        D_y = 1.0 / (south * m_grid->spacing_y(j - 1) + north * m_grid->spacing_y(j));
       } else {
         D_y = 0.0;
       }
@@ -545,8 +545,8 @@ void StressBalance::compute_volumetric_strain_heating(const Inputs &inputs) {
       const double *E_ij;
 
       double west = 1, east = 1, south = 1, north = 1,
-        D_x = 0,                // 1/(dx), 1/(2dx), or 0
-        D_y = 0;                // 1/(dy), 1/(2dy), or 0
+        D_x = 0,                // 1/(dx_w), 1/(dx_e), 1/(dx_w + dx_e), or 0
+        D_y = 0;                // 1/(dy_s), 1/(dy_n), 1/(dy_s + dy_n), or 0
 
       // x-derivative
       {
@@ -558,7 +558,7 @@ void StressBalance::compute_volumetric_strain_heating(const Inputs &inputs) {
         }
 
         if (east + west > 0) {
-          D_x = 1.0 / (m_grid->dx() * (east + west));
+          D_x = 1.0 / (west * m_grid->spacing_x(i - 1) + east * m_grid->spacing_x(i));
         } else {
           D_x = 0.0;
         }
@@ -574,7 +574,7 @@ void StressBalance::compute_volumetric_strain_heating(const Inputs &inputs) {
         }
 
         if (north + south > 0) {
-          D_y = 1.0 / (m_grid->dy() * (north + south));
+          D_y = 1.0 / (south * m_grid->spacing_y(j - 1) + north * m_grid->spacing_y(j));
         } else {
           D_y = 0.0;
         }
@@ -688,7 +688,6 @@ void compute_2D_principal_strain_rates(const IceModelVec2V &V,
   using mask::ice_free;
 
   IceGrid::ConstPtr grid = result.grid();
-  double    dx = grid->dx(), dy = grid->dy();
 
   if (result.ndof() != 2) {
     throw RuntimeError(PISM_ERROR_LOCATION, "result.dof() == 2 is required");
@@ -744,13 +743,15 @@ void compute_2D_principal_strain_rates(const IceModelVec2V &V,
     }
 
     if (west + east > 0) {
-      u_x = 1.0 / (dx * (west + east)) * (west * (U.ij.u - U[West].u) + east * (U[East].u - U.ij.u));
-      v_x = 1.0 / (dx * (west + east)) * (west * (U.ij.v - U[West].v) + east * (U[East].v - U.ij.v));
+      const double D_x = 1.0 / (west * grid->spacing_x(i - 1) + east * grid->spacing_x(i));
+      u_x = D_x * (west * (U.ij.u - U[West].u) + east * (U[East].u - U.ij.u));
+      v_x = D_x * (west * (U.ij.v - U[West].v) + east * (U[East].v - U.ij.v));
     }
 
     if (south + north > 0) {
-      u_y = 1.0 / (dy * (south + north)) * (south * (U.ij.u - U[South].u) + north * (U[North].u - U.ij.u));
-      v_y = 1.0 / (dy * (south + north)) * (south * (U.ij.v - U[South].v) + north * (U[North].v - U.ij.v));
+      const double D_y = 1.0 / (south * grid->spacing_y(j - 1) + north * grid->spacing_y(j));
+      u_y = D_y * (south * (U.ij.u - U[South].u) + north * (U[North].u - U.ij.u));
+      v_y = D_y * (south * (U.ij.v - U[South].v) + north * (U[North].v - U.ij.v));
     }
 
     const double A = 0.5 * (u_x + v_y),  // A = (1/2) trace(D)
@@ -775,10 +776,6 @@ void compute_2D_stresses(const rheology::FlowLaw &flow_law,
 
   auto grid = result.grid();
 
-  const double
-    dx = grid->dx(),
-    dy = grid->dy();
-
   if (result.ndof() != 3) {
     throw RuntimeError(PISM_ERROR_LOCATION, "result.get_dof() == 3 is required");
   }
@@ -834,13 +831,15 @@ void compute_2D_stresses(const rheology::FlowLaw &flow_law,
     }
 
     if (west + east > 0) {
-      u_x = 1.0 / (dx * (west + east)) * (west * (U.ij.u - U[West].u) + east * (U[East].u - U.ij.u));
-      v_x = 1.0 / (dx * (west + east)) * (west * (U.ij.v - U[West].v) + east * (U[East].v - U.ij.v));
+      const double D_x = 1.0 / (west * grid->spacing_x(i - 1) + east * grid->spacing_x(i));
+      u_x = D_x * (west * (U.ij.u - U[West].u) + east * (U[East].u - U.ij.u));
+      v_x = D_x * (west * (U.ij.v - U[West].v) + east * (U[East].v - U.ij.v));
     }
 
     if (south + north > 0) {
-      u_y = 1.0 / (dy * (south + north)) * (south * (U.ij.u - U[South].u) + north * (U[North].u - U.ij.u));
-      v_y = 1.0 / (dy * (south + north)) * (south * (U.ij.v - U[South].v) + north * (U[North].v - U.ij.v));
+      const double D_y = 1.0 / (south * grid->spacing_y(j - 1) + north * grid->spacing_y(j));
+      u_y = D_y * (south * (U.ij.u - U[South].u) + north * (U[North].u - U.ij.u));
+      v_y = D_y * (south * (U.ij.v - U[South].v) + north * (U[North].v - U.ij.v));
     }
 
     double nu = 0.0;
@@ -97,6 +97,9 @@ public:
   //! \brief Get the max diffusivity (for the adaptive time-stepping).
   double max_diffusivity() const;
 
+  //! \brief Get the maximum of \f$D (1/dx^2 + 1/dy^2)\f$ using local grid spacing.
+  double max_diffusivity_rate() const;
+
   CFLData max_timestep_cfl_2d() const;
   CFLData max_timestep_cfl_3d() const;
 
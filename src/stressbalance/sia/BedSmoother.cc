@@ -1,4 +1,4 @@
-// Copyright (C) 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019 Ed Bueler and Constantine Khroulev
+// Copyright (C) 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019, 2020 Ed Bueler and Constantine Khroulev
 //
 // This file is part of PISM.
 //
@@ -16,6 +16,7 @@
 // along with PISM; if not, write to the Free Software
 // Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
+#include <algorithm>            // std::copy, std::max
 #include <cassert>
 
 #include "BedSmoother.hh"
@@ -60,13 +61,11 @@ BedSmoother::BedSmoother(IceGrid::ConstPtr g, int MAX_GHOSTS)
                    "polynomial coeff of H^-4, in bed roughness parameterization",
                    "m4", "m4", "", 0);
 
-    // allocate Vecs that live on processor 0:
+    // allocate the Vec that lives on processor 0:
     m_topgp0 = m_topgsmooth.allocate_proc0_copy();
-    m_topgsmoothp0 = m_topgsmooth.allocate_proc0_copy();
-    m_maxtlp0 = m_maxtl.allocate_proc0_copy();
-    m_C2p0 = m_C2.allocate_proc0_copy();
-    m_C3p0 = m_C3.allocate_proc0_copy();
-    m_C4p0 = m_C4.allocate_proc0_copy();
+
+    // whole-domain arrays shared by all ranks on a node are allocated by preprocess_bed()
+    // if smoothing is enabled
   }
 
   m_Glen_exponent = m_config->get_number("stress_balance.sia.Glen_exponent"); // choice is SIA; see #285
@@ -82,8 +81,8 @@ BedSmoother::BedSmoother(IceGrid::ConstPtr g, int MAX_GHOSTS)
   // preprocess_bed() and set appropriate values, but in a zero-length (-y 0) run IceModel does not
   // call SIAFD::update()... We may need to re-structure this class so that everything is
   // initialized right after construction and users don't have to call preprocess_bed() manually.
-  m_Nx = -1;
-  m_Ny = -1;
+  m_Nx.clear();
+  m_Ny.clear();
 }
 
 
@@ -103,22 +102,24 @@ void BedSmoother::preprocess_bed(const IceModelVec2S &topg) {
     //   including ghosts, to public member topgsmooth ...
     topg.update_ghosts(m_topgsmooth);
     // and we tell theta() to return theta=1
-    m_Nx = -1;
-    m_Ny = -1;
+    m_Nx.clear();
+    m_Ny.clear();
     return;
   }
 
-  // determine Nx, Ny, which are always at least one if m_smoothing_range > 0
-  m_Nx = static_cast<int>(ceil(m_smoothing_range / m_grid->dx()));
-  m_Ny = static_cast<int>(ceil(m_smoothing_range / m_grid->dy()));
-  if (m_Nx < 1) {
-    m_Nx = 1;
+  // determine half-widths (in grid points) of the smoothing window in each column and
+  // row; they are always at least one if m_smoothing_range > 0. These use local grid
+  // spacing, so the window has (roughly) the same physical size everywhere on non-uniform
+  // grids.
+  std::vector<int> Nx(m_grid->Mx()), Ny(m_grid->My());
+  for (unsigned int i = 0; i < Nx.size(); ++i) {
+    Nx[i] = std::max(static_cast<int>(ceil(m_smoothing_range / m_grid->cell_width(i))), 1);
   }
-  if (m_Ny < 1) {
-    m_Ny = 1;
+  for (unsigned int j = 0; j < Ny.size(); ++j) {
+    Ny[j] = std::max(static_cast<int>(ceil(m_smoothing_range / m_grid->cell_height(j))), 1);
   }
 
-  preprocess_bed(topg, m_Nx, m_Ny);
+  preprocess_bed(topg, Nx, Ny);
 }
 
 const IceModelVec2S& BedSmoother::smoothed_bed() const {
@@ -131,139 +132,157 @@ average.
  */
 void BedSmoother::preprocess_bed(const IceModelVec2S &topg,
                                  unsigned int Nx, unsigned int Ny) {
+  preprocess_bed(topg,
+                 std::vector<int>(m_grid->Mx(), Nx),
+                 std::vector<int>(m_grid->My(), Ny));
+}
+
+/*!
+ * Inputs `Nx` and `Ny` contain half-widths (in number of grid points) of the smoothing
+ * window in each column and each row of the grid, respectively.
+ */
+void BedSmoother::preprocess_bed(const IceModelVec2S &topg,
+                                 const std::vector<int> &Nx,
+                                 const std::vector<int> &Ny) {
 
-  if ((Nx >= m_grid->Mx()) || (Ny >= m_grid->My())) {
+  const int
+    Nx_max = *std::max_element(Nx.begin(), Nx.end()),
+    Ny_max = *std::max_element(Ny.begin(), Ny.end());
+
+  if ((Nx_max >= (int)m_grid->Mx()) || (Ny_max >= (int)m_grid->My())) {
     throw RuntimeError(PISM_ERROR_LOCATION, "input Nx, Ny in bed smoother is too large because\n"
                        "domain of smoothing exceeds IceGrid domain");
   }
   m_Nx = Nx;
   m_Ny = Ny;
 
+  // allocate whole-domain arrays shared by all ranks on a node (once)
+  if (not m_topg_shared) {
+    const size_t size = m_grid->Mx() * m_grid->My();
+    m_topg_shared.reset(new NodeSharedArray(m_grid->com, size));
+    m_topgsmooth_shared.reset(new NodeSharedArray(m_grid->com, size));
+  }
+
+  // gather topg on processor 0 and copy it to all nodes
   topg.put_on_proc0(*m_topgp0);
-  smooth_the_bed_on_proc0();
-  // next call *does indeed* fill ghosts in topgsmooth
-  m_topgsmooth.get_from_proc0(*m_topgsmoothp0);
-
-  compute_coefficients_on_proc0();
-  // following calls *do* fill the ghosts
-  m_maxtl.get_from_proc0(*m_maxtlp0);
-  m_C2.get_from_proc0(*m_C2p0);
-  m_C3.get_from_proc0(*m_C3p0);
-  m_C4.get_from_proc0(*m_C4p0);
+  if (m_grid->rank() == 0) {
+    petsc::VecArray b0(*m_topgp0);
+    std::copy(b0.get(), b0.get() + m_topg_shared->size(), m_topg_shared->data());
+  }
+  m_topg_shared->broadcast();
+
+  smooth_the_bed();
+
+  compute_coefficients();
 }
 
 
 //! Computes the smoothed bed by a simple average over a rectangle of grid points.
-void BedSmoother::smooth_the_bed_on_proc0() {
-
-  ParallelSection rank0(m_grid->com);
-  try {
-    if (m_grid->rank() == 0) {
-      const int Mx = (int)m_grid->Mx();
-      const int My = (int)m_grid->My();
-
-      petsc::VecArray2D
-        b0(*m_topgp0,       Mx, My),
-        bs(*m_topgsmoothp0, Mx, My);
-
-      for (int j=0; j < My; j++) {
-        for (int i=0; i < Mx; i++) {
-          // average only over those points which are in the grid; do
-          // not wrap periodically
-          double sum = 0.0, count = 0.0;
-          for (int r = -m_Nx; r <= m_Nx; r++) {
-            for (int s = -m_Ny; s <= m_Ny; s++) {
-              if ((i+r >= 0) and (i+r < Mx) and (j+s >= 0) and (j+s < My)) {
-                sum   += b0(i+r, j+s);
-                count += 1.0;
-              }
-            }
+/*!
+ * Ranks on a node share the work: each computes every `node_size`-th row of the smoothed
+ * bed in the whole domain.
+ */
+void BedSmoother::smooth_the_bed() {
+
+  const int
+    Mx = (int)m_grid->Mx(),
+    My = (int)m_grid->My(),
+    node_rank = m_topgsmooth_shared->node_rank(),
+    node_size = m_topgsmooth_shared->node_size();
+
+  const double *b0 = m_topg_shared->data();
+  double *bs = m_topgsmooth_shared->data();
+
+  for (int j = node_rank; j < My; j += node_size) {
+    for (int i = 0; i < Mx; i++) {
+      // average only over those points which are in the grid; do
+      // not wrap periodically
+      double sum = 0.0, count = 0.0;
+      for (int r = -m_Nx[i]; r <= m_Nx[i]; r++) {
+        for (int s = -m_Ny[j]; s <= m_Ny[j]; s++) {
+          if ((i+r >= 0) and (i+r < Mx) and (j+s >= 0) and (j+s < My)) {
+            sum   += b0[(j+s) * Mx + (i+r)];
+            count += 1.0;
           }
-          // unprotected division by count but r=0,s=0 case guarantees count>=1
-          bs(i, j) = sum / count;
         }
       }
+      // unprotected division by count but r=0,s=0 case guarantees count>=1
+      bs[j * Mx + i] = sum / count;
     }
-  } catch (...) {
-    rank0.failed();
   }
-  rank0.check();
-}
 
+  m_topgsmooth_shared->sync();
 
-void BedSmoother::compute_coefficients_on_proc0() {
+  IceModelVec::AccessList list{&m_topgsmooth};
 
-  const unsigned int Mx = m_grid->Mx(), My = m_grid->My();
+  for (Points p(*m_grid); p; p.next()) {
+    const int i = p.i(), j = p.j();
 
-  ParallelSection rank0(m_grid->com);
-  try {
-    if (m_grid->rank() == 0) {
-      petsc::VecArray2D
-        b0(*m_topgp0,       Mx, My),
-        bs(*m_topgsmoothp0, Mx, My),
-        mt(*m_maxtlp0,      Mx, My),
-        c2(*m_C2p0,         Mx, My),
-        c3(*m_C3p0,         Mx, My),
-        c4(*m_C4p0,         Mx, My);
-
-      for (int j=0; j < (int)My; j++) {
-        for (int i=0; i < (int)Mx; i++) {
-          // average only over those points which are in the grid
-          // do not wrap periodically
-          double
-            topgs     = bs(i, j),
-            maxtltemp = 0.0,
-            sum2      = 0.0,
-            sum3      = 0.0,
-            sum4      = 0.0,
-            count     = 0.0;
-
-          for (int r = -m_Nx; r <= m_Nx; r++) {
-            for (int s = -m_Ny; s <= m_Ny; s++) {
-              if ((i+r >= 0) && (i+r < (int)Mx) && (j+s >= 0) && (j+s < (int)My)) {
-                // tl is elevation of local topography at a pt in patch
-                const double tl  = b0(i+r, j+s) - topgs;
-                maxtltemp = std::max(maxtltemp, tl);
-                // accumulate 2nd, 3rd, and 4th powers with only 3 multiplications
-                const double tl2 = tl * tl;
-                sum2 += tl2;
-                sum3 += tl2 * tl;
-                sum4 += tl2 * tl2;
-                count += 1.0;
-              }
-            }
-          }
-          mt(i, j) = maxtltemp;
+    m_topgsmooth(i, j) = bs[j * Mx + i];
+  }
 
-          // unprotected division by count but r=0,s=0 case guarantees count>=1
-          c2(i, j) = sum2 / count;
-          c3(i, j) = sum3 / count;
-          c4(i, j) = sum4 / count;
-        }
-      }
+  m_topgsmooth.update_ghosts();
+}
 
-      // scale the coeffs in Taylor series
-      const double
-        n = m_Glen_exponent,
-        k  = (n + 2) / n,
-        s2 = k * (2 * n + 2) / (2 * n),
-        s3 = s2 * (3 * n + 2) / (3 * n),
-        s4 = s3 * (4 * n + 2) / (4 * n);
+//! Computes coefficients of the bed roughness parameterization in this sub-domain.
+void BedSmoother::compute_coefficients() {
 
-      PetscErrorCode ierr;
-      ierr = VecScale(*m_C2p0,s2);
-      PISM_CHK(ierr, "VecScale");
+  const int Mx = m_grid->Mx(), My = m_grid->My();
 
-      ierr = VecScale(*m_C3p0,s3);
-      PISM_CHK(ierr, "VecScale");
+  const double
+    *b0 = m_topg_shared->data(),
+    *bs = m_topgsmooth_shared->data();
 
-      ierr = VecScale(*m_C4p0,s4);
-      PISM_CHK(ierr, "VecScale");
+  // scale the coeffs in Taylor series
+  const double
+    n = m_Glen_exponent,
+    k  = (n + 2) / n,
+    s2 = k * (2 * n + 2) / (2 * n),
+    s3 = s2 * (3 * n + 2) / (3 * n),
+    s4 = s3 * (4 * n + 2) / (4 * n);
+
+  IceModelVec::AccessList list{&m_maxtl, &m_C2, &m_C3, &m_C4};
+
+  for (Points p(*m_grid); p; p.next()) {
+    const int i = p.i(), j = p.j();
+
+    // average only over those points which are in the grid
+    // do not wrap periodically
+    double
+      topgs     = bs[j * Mx + i],
+      maxtltemp = 0.0,
+      sum2      = 0.0,
+      sum3      = 0.0,
+      sum4      = 0.0,
+      count     = 0.0;
+
+    for (int r = -m_Nx[i]; r <= m_Nx[i]; r++) {
+      for (int s = -m_Ny[j]; s <= m_Ny[j]; s++) {
+        if ((i+r >= 0) && (i+r < Mx) && (j+s >= 0) && (j+s < My)) {
+          // tl is elevation of local topography at a pt in patch
+          const double tl  = b0[(j+s) * Mx + (i+r)] - topgs;
+          maxtltemp = std::max(maxtltemp, tl);
+          // accumulate 2nd, 3rd, and 4th powers with only 3 multiplications
+          const double tl2 = tl * tl;
+          sum2 += tl2;
+          sum3 += tl2 * tl;
+          sum4 += tl2 * tl2;
+          count += 1.0;
+        }
+      }
     }
-  } catch (...) {
-    rank0.failed();
+    m_maxtl(i, j) = maxtltemp;
+
+    // unprotected division by count but r=0,s=0 case guarantees count>=1
+    m_C2(i, j) = sum2 / count * s2;
+    m_C3(i, j) = sum3 / count * s3;
+    m_C4(i, j) = sum4 / count * s4;
   }
-  rank0.check();
+
+  m_maxtl.update_ghosts();
+  m_C2.update_ghosts();
+  m_C3.update_ghosts();
+  m_C4.update_ghosts();
 }
 
 
@@ -350,7 +369,7 @@ Call preprocess_bed() first.
  */
 void BedSmoother::theta(const IceModelVec2S &usurf, IceModelVec2S &result) const {
 
-  if ((m_Nx < 0) || (m_Ny < 0)) {
+  if (m_Nx.empty() or m_Ny.empty()) {
     result.set(1.0);
     return;
   }
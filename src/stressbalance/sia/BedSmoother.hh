@@ -1,4 +1,4 @@
-// Copyright (C) 2010, 2011, 2013, 2014, 2015, 2016, 2017 Ed Bueler and Constantine Khroulev
+// Copyright (C) 2010, 2011, 2013, 2014, 2015, 2016, 2017, 2020 Ed Bueler and Constantine Khroulev
 //
 // This file is part of PISM.
 //
@@ -19,10 +19,13 @@
 #ifndef __BedSmoother_hh
 #define __BedSmoother_hh
 
+#include <memory>
+#include <vector>
 #include <petsc.h>
 
 #include "pism/util/iceModelVec.hh"
 #include "pism/util/ConfigInterface.hh"
+#include "pism/util/NodeSharedArray.hh"
 
 namespace pism {
 
@@ -100,22 +103,28 @@ protected:
   const Config::ConstPtr m_config;
   IceModelVec2S m_maxtl, m_C2, m_C3, m_C4;
 
-  int m_Nx, m_Ny;  //!< number of grid points to smooth over; e.g.
-  //!i=-Nx,-Nx+1,...,-1,0,1,...,Nx-1,Nx; note Nx>=1 and Ny>=1
-  //!always, unless lambda<=0
+  //! number of grid points to smooth over in each column and row; e.g.
+  //! i=-Nx[i],-Nx[i]+1,...,-1,0,1,...,Nx[i]-1,Nx[i]; note Nx[i]>=1 and Ny[j]>=1
+  //! always; empty if lambda<=0
+  std::vector<int> m_Nx, m_Ny;
 
   double m_Glen_exponent, m_smoothing_range;
 
-  petsc::Vec::Ptr m_topgp0,         //!< original bed elevation on processor 0
-    m_topgsmoothp0,   //!< smoothed bed elevation on processor 0
-    m_maxtlp0,        //!< maximum elevation at (i,j) of local topography (nearby patch)
-    m_C2p0, m_C3p0, m_C4p0;
+  //! original bed elevation on processor 0 (used to gather `topg`)
+  petsc::Vec::Ptr m_topgp0;
+
+  //! original and smoothed bed elevation (whole domain, shared by all ranks on a node);
+  //! allocated only if the bed is smoothed
+  std::unique_ptr<NodeSharedArray> m_topg_shared, m_topgsmooth_shared;
 
   virtual void preprocess_bed(const IceModelVec2S &topg,
                               unsigned int Nx_in, unsigned int Ny_in);
 
-  void smooth_the_bed_on_proc0();
-  void compute_coefficients_on_proc0();
+  void preprocess_bed(const IceModelVec2S &topg,
+                      const std::vector<int> &Nx, const std::vector<int> &Ny);
+
+  void smooth_the_bed();
+  void compute_coefficients();
 };
 
 } // end of namespace stressbalance
@@ -1,4 +1,4 @@
-// Copyright (C) 2004--2019 Jed Brown, Craig Lingle, Ed Bueler and Constantine Khroulev
+// Copyright (C) 2004--2020 Jed Brown, Craig Lingle, Ed Bueler and Constantine Khroulev
 //
 // This file is part of PISM.
 //
@@ -18,6 +18,7 @@
 
 #include <cstdlib>
 #include <cassert>
+#include <algorithm>              // std::min, std::max
 
 #include "SIAFD.hh"
 #include "BedSmoother.hh"
@@ -228,7 +229,6 @@ void SIAFD::surface_gradient_eta(const IceModelVec2S &ice_thickness,
     etapow  = (2.0 * n + 2.0)/n,  // = 8/3 if n = 3
     invpow  = 1.0 / etapow,
     dinvpow = (- n - 2.0) / (2.0 * n + 2.0);
-  const double dx = m_grid->dx(), dy = m_grid->dy();  // convenience
   IceModelVec2S &eta = m_work_2d_0;
 
   // compute eta = H^{8/3}, which is more regular, on reg grid
@@ -258,20 +258,27 @@ void SIAFD::surface_gradient_eta(const IceModelVec2S &ice_thickness,
     auto b = bed_elevation.box(i, j);
     auto e = eta.box(i, j);
 
+    // distances between grid points (dx_2 and dy_2 span two intervals)
+    const double
+      dx   = m_grid->spacing_x(i),
+      dy   = m_grid->spacing_y(j),
+      dx_2 = m_grid->spacing_x(i - 1) + dx,
+      dy_2 = m_grid->spacing_y(j - 1) + dy;
+
     // i-offset
     {
       double mean_eta = 0.5 * (e.e + e.ij);
       if (mean_eta > 0.0) {
         double factor = invpow * pow(mean_eta, dinvpow);
         h_x(i, j, 0) = factor * (e.e - e.ij) / dx;
-        h_y(i, j, 0) = factor * (e.ne + e.n - e.se - e.s) / (4.0 * dy);
+        h_y(i, j, 0) = factor * (e.ne + e.n - e.se - e.s) / (2.0 * dy_2);
       } else {
         h_x(i, j, 0) = 0.0;
         h_y(i, j, 0) = 0.0;
       }
       // now add bed slope to get actual h_x, h_y
       h_x(i, j, 0) += (b.e - b.ij) / dx;
-      h_y(i, j, 0) += (b.ne + b.n - b.se - b.s) / (4.0 * dy);
+      h_y(i, j, 0) += (b.ne + b.n - b.se - b.s) / (2.0 * dy_2);
     }
 
     // j-offset
@@ -279,14 +286,14 @@ void SIAFD::surface_gradient_eta(const IceModelVec2S &ice_thickness,
       double mean_eta = 0.5 * (e.n + e.ij);
       if (mean_eta > 0.0) {
         double factor = invpow * pow(mean_eta, dinvpow);
-        h_x(i, j, 1) = factor * (e.ne + e.e - e.nw - e.w) / (4.0 * dx);
+        h_x(i, j, 1) = factor * (e.ne + e.e - e.nw - e.w) / (2.0 * dx_2);
         h_y(i, j, 1) = factor * (e.n - e.ij) / dy;
       } else {
         h_x(i, j, 1) = 0.0;
         h_y(i, j, 1) = 0.0;
       }
       // now add bed slope to get actual h_x, h_y
-      h_x(i, j, 1) += (b.ne + b.e - b.nw - b.w) / (4.0 * dx);
+      h_x(i, j, 1) += (b.ne + b.e - b.nw - b.w) / (2.0 * dx_2);
       h_y(i, j, 1) += (b.n - b.ij) / dy;
     }
   } // end of the loop over grid points
@@ -297,8 +304,6 @@ void SIAFD::surface_gradient_eta(const IceModelVec2S &ice_thickness,
 //! see [\ref Mahaffy].
 void SIAFD::surface_gradient_mahaffy(const IceModelVec2S &ice_surface_elevation,
                                      IceModelVec2Stag &h_x, IceModelVec2Stag &h_y) {
-  const double dx = m_grid->dx(), dy = m_grid->dy();  // convenience
-
   const IceModelVec2S &h = ice_surface_elevation;
 
   IceModelVec::AccessList list{&h_x, &h_y, &h};
@@ -312,14 +317,21 @@ void SIAFD::surface_gradient_mahaffy(const IceModelVec2S &ice_surface_elevation,
   for (PointsWithGhosts p(*m_grid); p; p.next()) {
     const int i = p.i(), j = p.j();
 
+    // distances between grid points (dx_2 and dy_2 span two intervals)
+    const double
+      dx   = m_grid->spacing_x(i),
+      dy   = m_grid->spacing_y(j),
+      dx_2 = m_grid->spacing_x(i - 1) + dx,
+      dy_2 = m_grid->spacing_y(j - 1) + dy;
+
     // I-offset
     h_x(i, j, 0) = (h(i + 1, j) - h(i, j)) / dx;
     h_y(i, j, 0) = (+ h(i + 1, j + 1) + h(i, j + 1)
-                    - h(i + 1, j - 1) - h(i, j - 1)) / (4.0*dy);
+                    - h(i + 1, j - 1) - h(i, j - 1)) / (2.0*dy_2);
     // J-offset
     h_y(i, j, 1) = (h(i, j + 1) - h(i, j)) / dy;
     h_x(i, j, 1) = (+ h(i + 1, j + 1) + h(i + 1, j)
-                    - h(i - 1, j + 1) - h(i - 1, j)) / (4.0*dx);
+                    - h(i - 1, j + 1) - h(i - 1, j)) / (2.0*dx_2);
   }
 }
 
@@ -373,9 +385,6 @@ void SIAFD::surface_gradient_mahaffy(const IceModelVec2S &ice_surface_elevation,
 void SIAFD::surface_gradient_haseloff(const IceModelVec2S &ice_surface_elevation,
                                       const IceModelVec2CellType &cell_type,
                                       IceModelVec2Stag &h_x, IceModelVec2Stag &h_y) {
-  const double
-    dx = m_grid->dx(),
-    dy = m_grid->dy();  // convenience
   const IceModelVec2S
     &h = ice_surface_elevation;
   IceModelVec2S
@@ -410,7 +419,7 @@ void SIAFD::surface_gradient_haseloff(const IceModelVec2S &ice_surface_elevation
         w_i(i,j)   = 0;
       } else {
         // default case
-        h_x(i,j,0) = (h(i+1,j) - h(i,j)) / dx;
+        h_x(i,j,0) = (h(i+1,j) - h(i,j)) / m_grid->spacing_x(i);
         w_i(i,j)   = 1;
       }
     }
@@ -429,7 +438,7 @@ void SIAFD::surface_gradient_haseloff(const IceModelVec2S &ice_surface_elevation
         w_j(i,j)   = 0.0;
       } else {
         // default case
-        h_y(i,j,1) = (h(i,j+1) - h(i,j)) / dy;
+        h_y(i,j,1) = (h(i,j+1) - h(i,j)) / m_grid->spacing_y(j);
         w_j(i,j)   = 1.0;
       }
     }
@@ -612,7 +621,9 @@ void SIAFD::compute_diffusivity(bool full_update,
   std::vector<double> A(Mz), ice_grain_size(Mz, m_config->get_number("constants.ice.grain_size", "m"));
   std::vector<double> e_factor(Mz, enhancement_factor);
 
-  double D_max = 0.0;
+  const bool uniform = m_grid->uniform();
+
+  double D_max = 0.0, D_rate_max = 0.0;
   int high_diffusivity_counter = 0;
   for (int o=0; o<2; o++) {
     ParallelSection loop(m_grid->com);
@@ -728,6 +739,20 @@ void SIAFD::compute_diffusivity(bool full_update,
 
         D_max = std::max(D_max, D);
 
+        if (not uniform and D > 0.0) {
+          // local grid spacing at this staggered grid point (D > 0 implies that it is not
+          // at the edge of the domain, so (i+oi, j+oj) is in the grid)
+          const double
+            dx = o == 0 ? std::min(m_grid->spacing_x(i),
+                                   std::min(m_grid->cell_width(i), m_grid->cell_width(i + 1)))
+                        : m_grid->cell_width(i),
+            dy = o == 1 ? std::min(m_grid->spacing_y(j),
+                                   std::min(m_grid->cell_height(j), m_grid->cell_height(j + 1)))
+                        : m_grid->cell_height(j);
+
+          D_rate_max = std::max(D_rate_max, D * (1.0 / (dx * dx) + 1.0 / (dy * dy)));
+        }
+
         result(i, j, o) = D;
 
         // if doing the full update, fill the delta column above the ice and
@@ -746,6 +771,7 @@ void SIAFD::compute_diffusivity(bool full_update,
   } // o-loop
 
   m_D_max = GlobalMax(m_grid->com, D_max);
+  m_D_rate_max = GlobalMax(m_grid->com, D_rate_max);
 
   high_diffusivity_counter = GlobalSum(m_grid->com, high_diffusivity_counter);
 
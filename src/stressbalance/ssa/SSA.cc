@@ -1,4 +1,4 @@
-// Copyright (C) 2004--2019 Constantine Khroulev, Ed Bueler, Jed Brown, Torsten Albrecht
+// Copyright (C) 2004--2020 Constantine Khroulev, Ed Bueler, Jed Brown, Torsten Albrecht
 //
 // This file is part of PISM.
 //
@@ -256,10 +256,6 @@ void SSA::compute_driving_stress(const IceModelVec2S &ice_thickness,
   bool cfbc = m_config->get_flag("stress_balance.calving_front_stress_bc");
   bool surface_gradient_inward = m_config->get_flag("stress_balance.ssa.compute_surface_gradient_inward");
 
-  double
-    dx = m_grid->dx(),
-    dy = m_grid->dy();
-
   IceModelVec::AccessList list{&surface_elevation, &cell_type, &ice_thickness, &result};
 
   if (no_model_mask) {
@@ -317,7 +313,8 @@ void SSA::compute_driving_stress(const IceModelVec2S &ice_thickness,
         east = weight(cfbc, M.ij, M.e, h.ij, h.e, N.ij, N.e);
 
       if (east + west > 0) {
-        h_x = 1.0 / ((west + east) * dx) * (west * (h.ij - h.w) + east * (h.e - h.ij));
+        h_x = 1.0 / (west * m_grid->spacing_x(i - 1) + east * m_grid->spacing_x(i)) *
+          (west * (h.ij - h.w) + east * (h.e - h.ij));
       } else {
         h_x = 0.0;
       }
@@ -331,7 +328,8 @@ void SSA::compute_driving_stress(const IceModelVec2S &ice_thickness,
         north = weight(cfbc, M.ij, M.n, h.ij, h.n, N.ij, N.n);
 
       if (north + south > 0) {
-        h_y = 1.0 / ((south + north) * dy) * (south * (h.ij - h.s) + north * (h.n - h.ij));
+        h_y = 1.0 / (south * m_grid->spacing_y(j - 1) + north * m_grid->spacing_y(j)) *
+          (south * (h.ij - h.s) + north * (h.n - h.ij));
       } else {
         h_y = 0.0;
       }
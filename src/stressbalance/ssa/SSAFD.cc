@@ -1,4 +1,4 @@
-// Copyright (C) 2004--2019 Constantine Khroulev, Ed Bueler and Jed Brown
+// Copyright (C) 2004--2020 Constantine Khroulev, Ed Bueler and Jed Brown
 //
 // This file is part of PISM.
 //
@@ -17,7 +17,11 @@
 // Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include <cassert>
+#include <cstdio>               // fopen
+#include <cstring>              // strcmp
+#include <limits>
 #include <stdexcept>
+#include <vector>
 
 #include "SSAFD.hh"
 #include "SSAFD_diagnostics.hh"
@@ -32,12 +36,79 @@
 #include "pism/stressbalance/StressBalance.hh"
 #include "pism/geometry/Geometry.hh"
 #include "pism/util/pism_utilities.hh"
+#include "pism/util/io/File.hh"
 
 namespace pism {
 namespace stressbalance {
 
 using namespace pism::mask;
 
+namespace {
+
+//! A combination of KSP, PC and sub-PC types tried by SSAFD::autotune().
+struct SolverChoice {
+  const char *name;
+  KSPType ksp_type;
+  PCType pc_type;
+  PCType sub_pc_type;
+};
+
+const SolverChoice solver_choices[] = {
+  {"gmres+bjacobi+ilu", KSPGMRES, PCBJACOBI, PCILU},
+  {"gmres+bjacobi+lu",  KSPGMRES, PCBJACOBI, PCLU},
+  {"gmres+asm+ilu",     KSPGMRES, PCASM,     PCILU},
+  {"gmres+asm+lu",      KSPGMRES, PCASM,     PCLU},
+  {"bcgs+bjacobi+ilu",  KSPBCGS,  PCBJACOBI, PCILU},
+};
+
+const int n_solver_choices = sizeof(solver_choices) / sizeof(solver_choices[0]);
+
+/*!
+ * Read the solver choice corresponding to `key` from `filename`.
+ *
+ * Returns -1 if the file is missing or does not contain a valid choice for `key`.
+ *
+ * Called on rank 0 only.
+ */
+int read_solver_choice(const std::string &filename, const std::string &key) {
+  if (FILE *f = fopen(filename.c_str(), "r")) {
+    fclose(f);
+  } else {
+    return -1;
+  }
+
+  File file(MPI_COMM_SELF, filename, PISM_NETCDF3, PISM_READONLY);
+
+  auto name = file.read_text_attribute("PISM_GLOBAL", key);
+
+  for (int n = 0; n < n_solver_choices; ++n) {
+    if (name == solver_choices[n].name) {
+      return n;
+    }
+  }
+
+  return -1;
+}
+
+/*!
+ * Save the solver choice `n` in `filename` using `key`, keeping choices for other keys.
+ *
+ * Called on rank 0 only.
+ */
+void write_solver_choice(const std::string &filename, const std::string &key, int n) {
+  IO_Mode mode = PISM_READWRITE_CLOBBER;
+  if (FILE *f = fopen(filename.c_str(), "r")) {
+    fclose(f);
+    mode = PISM_READWRITE;
+  }
+
+  File file(MPI_COMM_SELF, filename, PISM_NETCDF3, mode);
+
+  file.write_attribute("PISM_GLOBAL", key, solver_choices[n].name);
+}
+
+} // end of anonymous namespace
+
 SSAFD::KSPFailure::KSPFailure(const char* reason)
   : RuntimeError(ErrorLocation(), std::string("SSAFD KSP (linear solver) failed: ") + reason){
   // empty
@@ -95,6 +166,12 @@ SSAFD::SSAFD(IceGrid::ConstPtr g)
 
   m_scaling = 1.0e9;  // comparable to typical beta for an ice stream;
 
+  m_autotune      = false;
+  m_solver_choice = -1;
+
+  m_mixed_precision               = false;
+  m_mixed_precision_failure_count = 0;
+
   // The nuH viewer:
   m_view_nuh = false;
   m_nuh_viewer_size = 300;
@@ -102,7 +179,13 @@ SSAFD::SSAFD(IceGrid::ConstPtr g)
   // PETSc objects and settings
   {
     PetscErrorCode ierr;
-    ierr = DMSetMatType(*m_da, MATAIJ);
+
+    // PETSc's ILU and LU do not support the SELL format, so in this case m_A uses AIJ and
+    // a SELL copy is used to compute matrix-vector products (see update_ksp_operator()).
+    const std::string matrix_type = m_config->get_string("stress_balance.ssa.fd.matrix_type");
+    m_use_sell = (matrix_type == "sell");
+
+    ierr = DMSetMatType(*m_da, matrix_type == "baij" ? MATBAIJ : MATAIJ);
     PISM_CHK(ierr, "DMSetMatType");
 
     ierr = DMCreateMatrix(*m_da, m_A.rawptr());
@@ -134,10 +217,12 @@ void SSAFD::pc_setup_bjacobi() {
   PetscErrorCode ierr;
   PC pc;
 
+  m_mixed_precision = false;
+
   ierr = KSPSetType(m_KSP, KSPGMRES);
   PISM_CHK(ierr, "KSPSetType");
 
-  ierr = KSPSetOperators(m_KSP, m_A, m_A);
+  ierr = KSPSetOperators(m_KSP, ksp_operator(), m_A);
   PISM_CHK(ierr, "KSPSetOperators");
 
   // Get the PC from the KSP solver:
@@ -158,13 +243,15 @@ void SSAFD::pc_setup_asm() {
   PetscErrorCode ierr;
   PC pc, sub_pc;
 
+  m_mixed_precision = false;
+
   // Set parameters equivalent to
   // -ksp_type gmres -ksp_norm_type unpreconditioned -ksp_pc_side right -pc_type asm -sub_pc_type lu
 
   ierr = KSPSetType(m_KSP, KSPGMRES);
   PISM_CHK(ierr, "KSPSetType");
 
-  ierr = KSPSetOperators(m_KSP, m_A, m_A);
+  ierr = KSPSetOperators(m_KSP, ksp_operator(), m_A);
   PISM_CHK(ierr, "KSPSetOperators");
 
   // Switch to using the "unpreconditioned" norm.
@@ -207,6 +294,276 @@ void SSAFD::pc_setup_asm() {
   PISM_CHK(ierr, "KSPSetFromOptions");
 }
 
+/*!
+ * Set up the KSP using the combination of KSP, PC and sub-PC types `solver_choice` (an
+ * index in `solver_choices`).
+ *
+ * @note Uses `PetscErrorCode` *intentionally*.
+ */
+void SSAFD::pc_setup(int solver_choice) {
+  PetscErrorCode ierr;
+  PC pc, sub_pc;
+
+  m_mixed_precision = false;
+
+  assert(solver_choice >= 0 and solver_choice < n_solver_choices);
+  const SolverChoice &choice = solver_choices[solver_choice];
+
+  const bool use_asm = strcmp(choice.pc_type, PCASM) == 0;
+
+  ierr = KSPSetType(m_KSP, choice.ksp_type);
+  PISM_CHK(ierr, "KSPSetType");
+
+  ierr = KSPSetOperators(m_KSP, ksp_operator(), m_A);
+  PISM_CHK(ierr, "KSPSetOperators");
+
+  // Use the same norm and preconditioning side as pc_setup_asm() with ASM, and PETSc's
+  // defaults otherwise.
+  ierr = KSPSetNormType(m_KSP, use_asm ? KSP_NORM_UNPRECONDITIONED : KSP_NORM_DEFAULT);
+  PISM_CHK(ierr, "KSPSetNormType");
+
+  ierr = KSPSetPCSide(m_KSP, use_asm ? PC_RIGHT : PC_LEFT);
+  PISM_CHK(ierr, "KSPSetPCSide");
+
+  ierr = KSPGetPC(m_KSP, &pc);
+  PISM_CHK(ierr, "KSPGetPC");
+
+  ierr = PCSetType(pc, choice.pc_type);
+  PISM_CHK(ierr, "PCSetType");
+
+  ierr = PCSetUp(pc);
+  PISM_CHK(ierr, "PCSetUp");
+
+  // Set sub-KSP objects to "preonly" and sub-PCs to the requested type.
+  KSP *sub_ksp = NULL;
+  PetscInt n_local = 0;
+  if (use_asm) {
+    ierr = PCASMGetSubKSP(pc, &n_local, NULL, &sub_ksp);
+    PISM_CHK(ierr, "PCASMGetSubKSP");
+  } else {
+    ierr = PCBJacobiGetSubKSP(pc, &n_local, NULL, &sub_ksp);
+    PISM_CHK(ierr, "PCBJacobiGetSubKSP");
+  }
+
+  for (PetscInt k = 0; k < n_local; ++k) {
+    ierr = KSPSetType(sub_ksp[k], KSPPREONLY);
+    PISM_CHK(ierr, "KSPSetType");
+
+    ierr = KSPGetPC(sub_ksp[k], &sub_pc);
+    PISM_CHK(ierr, "KSPGetPC");
+
+    ierr = PCSetType(sub_pc, choice.sub_pc_type);
+    PISM_CHK(ierr, "PCSetType");
+  }
+
+  // Let the user override all this:
+  ierr = KSPSetFromOptions(m_KSP);
+  PISM_CHK(ierr, "KSPSetFromOptions");
+}
+
+//! Matrix used to compute matrix-vector products in the KSP.
+Mat SSAFD::ksp_operator() const {
+  if (m_use_sell and m_A_sell.get() != NULL) {
+    return m_A_sell;
+  }
+  return m_A;
+}
+
+//! Update the copy of `m_A` in the SELL format (if `stress_balance.ssa.fd.matrix_type` is "sell").
+void SSAFD::update_ksp_operator() {
+  if (not m_use_sell) {
+    return;
+  }
+
+  // The non-zero structure of `m_A` does not change, so the SELL matrix is created once
+  // and then re-used.
+  MatReuse reuse = m_A_sell.get() == NULL ? MAT_INITIAL_MATRIX : MAT_REUSE_MATRIX;
+
+  PetscErrorCode ierr = MatConvert(m_A, MATSELL, reuse, m_A_sell.rawptr());
+  PISM_CHK(ierr, "MatConvert");
+}
+
+//! Set up the KSP using the choice picked by autotune() or block Jacobi if there is none.
+void SSAFD::pc_setup_default() {
+  if (m_solver_choice >= 0) {
+    pc_setup(m_solver_choice);
+  } else {
+    pc_setup_bjacobi();
+  }
+}
+
+/*!
+ * Set up the KSP to use FGMRES (in double precision) preconditioned by the block Jacobi
+ * ILU(0) preconditioner with single precision factors (see SinglePrecisionILU).
+ *
+ * FGMRES tests convergence using the unpreconditioned residual, so the precision of the
+ * preconditioner affects the number of iterations but not the accuracy of the solution.
+ *
+ * @note Uses `PetscErrorCode` *intentionally*.
+ */
+void SSAFD::pc_setup_mixed_precision() {
+  PetscErrorCode ierr;
+  PC pc;
+
+  ierr = KSPSetType(m_KSP, KSPFGMRES);
+  PISM_CHK(ierr, "KSPSetType");
+
+  ierr = KSPSetOperators(m_KSP, ksp_operator(), m_A);
+  PISM_CHK(ierr, "KSPSetOperators");
+
+  ierr = KSPGetPC(m_KSP, &pc);
+  PISM_CHK(ierr, "KSPGetPC");
+
+  m_single_precision_ilu.set_up(pc);
+
+  ierr = KSPSetFromOptions(m_KSP);
+  PISM_CHK(ierr, "KSPSetFromOptions");
+
+  m_mixed_precision = true;
+}
+
+/*!
+ * Pick the fastest combination of KSP, PC and sub-PC types for the current SSA system.
+ *
+ * Re-uses the choice saved in `stress_balance.ssa.fd.autotune.cache_file` for the same
+ * grid size and number of MPI ranks if possible. Otherwise solves the first linear system
+ * of the Picard iteration using each combination in `solver_choices` (limiting the number
+ * of KSP iterations to `stress_balance.ssa.fd.autotune.max_iterations`) and picks the
+ * fastest one that converged. Combinations that fail (with an error or a negative
+ * converged reason) are skipped.
+ *
+ * Does not modify the SSA velocity.
+ */
+void SSAFD::autotune(const Inputs &inputs) {
+  PetscErrorCode ierr;
+
+  // run this once, even if all choices fail
+  m_autotune = false;
+
+  const std::string
+    cache_file = m_config->get_string("stress_balance.ssa.fd.autotune.cache_file"),
+    key        = pism::printf("ssafd_Mx%d_My%d_ranks%d",
+                              (int)m_grid->Mx(), (int)m_grid->My(), (int)m_grid->size());
+
+  if (not cache_file.empty()) {
+    int choice = -1;
+
+    ParallelSection rank0(m_grid->com);
+    try {
+      if (m_grid->rank() == 0) {
+        choice = read_solver_choice(cache_file, key);
+      }
+    } catch (...) {
+      rank0.failed();
+    }
+    rank0.check();
+
+    MPI_Bcast(&choice, 1, MPI_INT, 0, m_grid->com);
+
+    if (choice >= 0) {
+      m_solver_choice = choice;
+      m_log->message(2, "  SSAFD: using %s (read from '%s')\n",
+                     solver_choices[choice].name, cache_file.c_str());
+      return;
+    }
+  }
+
+  m_log->message(2, "  SSAFD: trying %d KSP and PC combinations...\n", n_solver_choices);
+
+  // assemble the first linear system of the Picard iteration
+  const double epsilon = m_config->get_number("stress_balance.ssa.epsilon");
+  if (m_config->get_flag("stress_balance.calving_front_stress_bc")) {
+    compute_nuH_staggered_cfbc(*inputs.geometry, epsilon, m_nuH);
+  } else {
+    compute_nuH_staggered(*inputs.geometry, epsilon, m_nuH);
+  }
+  assemble_matrix(inputs, true, m_A);
+  update_ksp_operator();
+
+  // trial solves are short: save tolerances to restore them when done
+  PetscReal rtol, abstol, dtol;
+  PetscInt max_iterations;
+  ierr = KSPGetTolerances(m_KSP, &rtol, &abstol, &dtol, &max_iterations);
+  PISM_CHK(ierr, "KSPGetTolerances");
+
+  PetscInt trial_max_iterations = static_cast<int>(m_config->get_number("stress_balance.ssa.fd.autotune.max_iterations"));
+
+  int best = -1;
+  double best_time = std::numeric_limits<double>::max();
+  for (int n = 0; n < n_solver_choices; ++n) {
+    m_velocity_global.copy_from(m_velocity);
+
+    double start = get_time();
+
+    // A combination that fails (e.g. because a factorization fails or a sub-PC type is
+    // not supported) is skipped.
+    int failed = 0;
+    KSPConvergedReason reason = KSP_CONVERGED_ITERATING;
+    PetscInt iterations = 0;
+    try {
+      pc_setup(n);
+
+      ierr = KSPSetTolerances(m_KSP, rtol, abstol, dtol, trial_max_iterations);
+      PISM_CHK(ierr, "KSPSetTolerances");
+
+      ierr = KSPSolve(m_KSP, m_b.vec(), m_velocity_global.vec());
+      PISM_CHK(ierr, "KSPSolve");
+
+      ierr = KSPGetConvergedReason(m_KSP, &reason);
+      PISM_CHK(ierr, "KSPGetConvergedReason");
+
+      ierr = KSPGetIterationNumber(m_KSP, &iterations);
+      PISM_CHK(ierr, "KSPGetIterationNumber");
+    } catch (RuntimeError &e) {
+      m_log->message(3, "    %s: %s\n", solver_choices[n].name, e.what());
+      failed = 1;
+    }
+
+    double time = GlobalMax(m_grid->com, get_time() - start);
+
+    if (reason <= 0) {
+      failed = 1;
+    }
+
+    if (GlobalMax(m_grid->com, failed) > 0) {
+      m_log->message(3, "    %s: failed after %d iterations (%f seconds)\n",
+                     solver_choices[n].name, (int)iterations, time);
+      continue;
+    }
+
+    m_log->message(3, "    %s: converged after %d iterations (%f seconds)\n",
+                   solver_choices[n].name, (int)iterations, time);
+
+    if (time < best_time) {
+      best      = n;
+      best_time = time;
+    }
+  }
+
+  ierr = KSPSetTolerances(m_KSP, rtol, abstol, dtol, max_iterations);
+  PISM_CHK(ierr, "KSPSetTolerances");
+
+  if (best < 0) {
+    m_log->message(2, "  SSAFD: none of the combinations converged; using defaults\n");
+    return;
+  }
+
+  m_solver_choice = best;
+  m_log->message(2, "  SSAFD: using %s\n", solver_choices[best].name);
+
+  if (not cache_file.empty()) {
+    ParallelSection rank0(m_grid->com);
+    try {
+      if (m_grid->rank() == 0) {
+        write_solver_choice(cache_file, key, best);
+      }
+    } catch (...) {
+      rank0.failed();
+    }
+    rank0.check();
+  }
+}
+
 void SSAFD::init_impl() {
   SSA::init_impl();
 
@@ -226,6 +583,8 @@ void SSAFD::init_impl() {
 
   m_default_pc_failure_count     = 0;
   m_default_pc_failure_max_count = 5;
+
+  m_autotune = m_config->get_flag("stress_balance.ssa.fd.autotune.enabled");
 }
 
 //! \brief Computes the right-hand side ("rhs") of the linear problem for the
@@ -253,8 +612,6 @@ void SSAFD::assemble_rhs(const Inputs &inputs) {
     *melange_back_pressure = inputs.melange_back_pressure;
 
   const double
-    dx                     = m_grid->dx(),
-    dy                     = m_grid->dy(),
     standard_gravity       = m_config->get_number("constants.standard_gravity"),
     rho_ocean              = m_config->get_number("constants.sea_water.density"),
     rho_ice                = m_config->get_number("constants.ice.density");
@@ -391,8 +748,8 @@ void SSAFD::assemble_rhs(const Inputs &inputs) {
         //
         // Note: signs below (+E, -W, etc) are explained by directions of outward
         // normal vectors at corresponding cell faces.
-        m_b(i, j).u = m_taud(i,j).u + (E - W) * delta_p / dx;
-        m_b(i, j).v = m_taud(i,j).v + (N - S) * delta_p / dy;
+        m_b(i, j).u = m_taud(i,j).u + (E - W) * delta_p / m_grid->cell_width(i);
+        m_b(i, j).v = m_taud(i,j).v + (N - S) * delta_p / m_grid->cell_height(j);
 
         continue;
       } // end of "if (is_marginal(i, j))"
@@ -500,8 +857,6 @@ void SSAFD::assemble_matrix(const Inputs &inputs,
     &tauc              = *inputs.basal_yield_stress;
 
   const double
-    dx                    = m_grid->dx(),
-    dy                    = m_grid->dy(),
     beta_lateral_margin   = m_config->get_number("basal_resistance.beta_lateral_margin"),
     beta_ice_free_bedrock = m_config->get_number("basal_resistance.beta_ice_free_bedrock");
 
@@ -535,6 +890,21 @@ void SSAFD::assemble_matrix(const Inputs &inputs,
   double lateral_drag_viscosity=m_config->get_number("stress_balance.ssa.fd.lateral_drag.viscosity");
   double HminFrozen=0.0;
 
+  const int
+    xs = m_grid->xs(),
+    xm = m_grid->xm(),
+    ys = m_grid->ys(),
+    ym = m_grid->ym();
+
+  // basal drag coefficients (computed one grid row at a time)
+  std::vector<double> basal_drag;
+  if (include_basal_shear) {
+    basal_drag.resize(xm * ym);
+    for (int j = ys; j < ys + ym; ++j) {
+      m_basal_sliding_law->drag(xm, &tauc(xs, j), &vel(xs, j), &basal_drag[(j - ys) * xm]);
+    }
+  }
+
   /* matrix assembly loop */
   ParallelSection loop(m_grid->com);
   try {
@@ -590,8 +960,11 @@ void SSAFD::assemble_matrix(const Inputs &inputs,
       // non-zeros get allocated, even though we use only 13 (or 14). The
       // remaining 5 (or 4) coefficients are zeros, but we set them anyway,
       // because this makes the code easier to understand.
-      const int n_nonzeros = 18;
-      MatStencil row, col[n_nonzeros];
+      //
+      // Coefficients are inserted as 2x2 blocks (one per neighbor), which is the
+      // native layout of MATBAIJ.
+      const int n_nonzeros = 18, n_blocks = n_nonzeros / 2;
+      MatStencil row, col[n_blocks];
 
       // |-----+-----+---+-----+-----|
       // | NW  | NNW | N | NNE | NE  |
@@ -692,14 +1065,28 @@ void SSAFD::assemble_matrix(const Inputs &inputs,
         }   // end of "if (is_marginal(i, j, bedrock_boundary))"
       }     // end of "if (use_cfbc)"
 
+      // Grid spacing. On a non-uniform grid `dx` and `dy` are dimensions of the current
+      // cell. Terms approximating derivatives normal to a cell interface use the distance
+      // between grid points on either side of it, so the corresponding coefficients
+      // (C_w, C_e, C_s, C_n) are scaled by the ratio of the cell size to this distance.
+      // These ratios are equal to one on a uniform grid. Derivatives tangential to an
+      // interface use centered differences (distances 2*dx and 2*dy) and need no scaling.
+      const double
+        dx  = m_grid->cell_width(i),
+        dy  = m_grid->cell_height(j),
+        C_w = c_w * (dx / m_grid->spacing_x(i - 1)),
+        C_e = c_e * (dx / m_grid->spacing_x(i)),
+        C_s = c_s * (dy / m_grid->spacing_y(j - 1)),
+        C_n = c_n * (dy / m_grid->spacing_y(j));
+
       /* begin Maxima-generated code */
       const double dx2 = dx*dx, dy2 = dy*dy, d4 = 4*dx*dy, d2 = 2*dx*dy;
 
       /* Coefficients of the discretization of the first equation; u first, then v. */
       double eq1[] = {
-        0,  -c_n*N/dy2,  0,
-        -4*c_w*W/dx2,  (c_n*N+c_s*S)/dy2+(4*c_e*E+4*c_w*W)/dx2,  -4*c_e*E/dx2,
-        0,  -c_s*S/dy2,  0,
+        0,  -C_n*N/dy2,  0,
+        -4*C_w*W/dx2,  (C_n*N+C_s*S)/dy2+(4*C_e*E+4*C_w*W)/dx2,  -4*C_e*E/dx2,
+        0,  -C_s*S/dy2,  0,
         c_w*W*WNW/d2+c_n*NNW*N/d4,  (c_n*NNE*N-c_n*NNW*N)/d4+(c_w*W*N-c_e*E*N)/d2,  -c_e*E*ENE/d2-c_n*NNE*N/d4,
         (c_w*W*WSW-c_w*W*WNW)/d2+(c_n*W*N-c_s*W*S)/d4,  (c_n*E*N-c_n*W*N-c_s*E*S+c_s*W*S)/d4+(c_e*E*N-c_w*W*N-c_e*E*S+c_w*W*S)/d2,  (c_e*E*ENE-c_e*E*ESE)/d2+(c_s*E*S-c_n*E*N)/d4,
         -c_w*W*WSW/d2-c_s*SSW*S/d4,  (c_s*SSW*S-c_s*SSE*S)/d4+(c_e*E*S-c_w*W*S)/d2,  c_e*E*ESE/d2+c_s*SSE*S/d4,
@@ -710,9 +1097,9 @@ void SSAFD::assemble_matrix(const Inputs &inputs,
         c_w*W*WNW/d4+c_n*NNW*N/d2,  (c_n*NNE*N-c_n*NNW*N)/d2+(c_w*W*N-c_e*E*N)/d4,  -c_e*E*ENE/d4-c_n*NNE*N/d2,
         (c_w*W*WSW-c_w*W*WNW)/d4+(c_n*W*N-c_s*W*S)/d2,  (c_n*E*N-c_n*W*N-c_s*E*S+c_s*W*S)/d2+(c_e*E*N-c_w*W*N-c_e*E*S+c_w*W*S)/d4,  (c_e*E*ENE-c_e*E*ESE)/d4+(c_s*E*S-c_n*E*N)/d2,
         -c_w*W*WSW/d4-c_s*SSW*S/d2,  (c_s*SSW*S-c_s*SSE*S)/d2+(c_e*E*S-c_w*W*S)/d4,  c_e*E*ESE/d4+c_s*SSE*S/d2,
-        0,  -4*c_n*N/dy2,  0,
-        -c_w*W/dx2,  (4*c_n*N+4*c_s*S)/dy2+(c_e*E+c_w*W)/dx2,  -c_e*E/dx2,
-        0,  -4*c_s*S/dy2,  0,
+        0,  -4*C_n*N/dy2,  0,
+        -C_w*W/dx2,  (4*C_n*N+4*C_s*S)/dy2+(C_e*E+C_w*W)/dx2,  -C_e*E/dx2,
+        0,  -4*C_s*S/dy2,  0,
       };
 
       /* i indices */
@@ -734,16 +1121,6 @@ void SSAFD::assemble_matrix(const Inputs &inputs,
         j,  j,  j,
         j-1,  j-1,  j-1,
       };
-
-      /* component indices */
-      const int C[] = {
-        0,  0,  0,
-        0,  0,  0,
-        0,  0,  0,
-        1,  1,  1,
-        1,  1,  1,
-        1,  1,  1,
-      };
       /* end Maxima-generated code */
 
       /* Dragging ice experiences friction at the bed determined by the
@@ -754,7 +1131,7 @@ void SSAFD::assemble_matrix(const Inputs &inputs,
       if (include_basal_shear) {
         double beta = 0.0;
         if (grounded_ice(M_ij)) {
-          beta = m_basal_sliding_law->drag(tauc(i,j), vel(i,j).u, vel(i,j).v);
+          beta = basal_drag[(j - ys) * xm + (i - xs)];
         } else if (ice_free_land(M_ij)) {
           // apply drag even in this case, to help with margins; note ice free
           // areas already have a strength extension
@@ -763,7 +1140,7 @@ void SSAFD::assemble_matrix(const Inputs &inputs,
         if (sub_gl) {
           // reduce the basal drag at grid cells that are partially grounded:
           if (icy(M_ij)) {
-            beta = grounded_fraction(i,j) * m_basal_sliding_law->drag(tauc(i,j), vel(i,j).u, vel(i,j).v);
+            beta = grounded_fraction(i,j) * basal_drag[(j - ys) * xm + (i - xs)];
           }
         }
         beta_u = beta;
@@ -812,23 +1189,25 @@ void SSAFD::assemble_matrix(const Inputs &inputs,
         }
       }
 
-      row.i = i;
-      row.j = j;
-      for (int m = 0; m < n_nonzeros; m++) {
+      // Entries m and m + n_blocks of eq1 and eq2 are coefficients of u and v
+      // (respectively) at the same neighbor. Interleave them to get a row-major 2 x (2 *
+      // n_blocks) array of 2x2 blocks.
+      double block_row[2][n_nonzeros];
+      for (int m = 0; m < n_blocks; m++) {
         col[m].i = I[m];
         col[m].j = J[m];
-        col[m].c = C[m];
-      }
 
-      // set coefficients of the first equation:
-      row.c = 0;
-      ierr = MatSetValuesStencil(A, 1, &row, n_nonzeros, col, eq1, INSERT_VALUES);
-      PISM_CHK(ierr, "MatSetValuesStencil");
+        block_row[0][2 * m + 0] = eq1[m];
+        block_row[0][2 * m + 1] = eq1[m + n_blocks];
+        block_row[1][2 * m + 0] = eq2[m];
+        block_row[1][2 * m + 1] = eq2[m + n_blocks];
+      }
 
-      // set coefficients of the second equation:
-      row.c = 1;
-      ierr = MatSetValuesStencil(A, 1, &row, n_nonzeros, col, eq2, INSERT_VALUES);
-      PISM_CHK(ierr, "MatSetValuesStencil");
+      row.i = i;
+      row.j = j;
+      ierr = MatSetValuesBlockedStencil(A, 1, &row, n_blocks, col, &block_row[0][0],
+                                        INSERT_VALUES);
+      PISM_CHK(ierr, "MatSetValuesBlockedStencil");
     } // i,j-loop
   } catch (...) {
     loop.failed();
@@ -915,6 +1294,10 @@ void SSAFD::solve(const Inputs &inputs) {
     compute_hardav_staggered(inputs);
   }
 
+  if (m_autotune) {
+    autotune(inputs);
+  }
+
   for (unsigned int k = 0; k < 3; ++k) {
     try {
       if (k == 0) {
@@ -959,11 +1342,28 @@ void SSAFD::picard_iteration(const Inputs &inputs,
                              double nuH_regularization,
                              double nuH_iter_failure_underrelax) {
 
+  if (m_config->get_flag("stress_balance.ssa.fd.mixed_precision") and
+      m_mixed_precision_failure_count < m_default_pc_failure_max_count) {
+    try {
+      pc_setup_mixed_precision();
+      picard_manager(inputs, nuH_regularization,
+                     nuH_iter_failure_underrelax);
+      return;
+    } catch (KSPFailure &f) {
+      m_mixed_precision_failure_count += 1;
+
+      m_log->message(1,
+                     "  re-trying using the double precision preconditioner...\n");
+
+      m_velocity.copy_from(m_velocity_old);
+    }
+  }
+
   if (m_default_pc_failure_count < m_default_pc_failure_max_count) {
     // Give BJACOBI another shot if we haven't tried it enough yet
 
     try {
-      pc_setup_bjacobi();
+      pc_setup_default();
       picard_manager(inputs, nuH_regularization,
                      nuH_iter_failure_underrelax);
 
@@ -1035,6 +1435,21 @@ void SSAFD::picard_manager(const Inputs &inputs,
 
     // assemble (or re-assemble) matrix, which depends on updated viscosity
     assemble_matrix(inputs, true, m_A);
+    update_ksp_operator();
+
+    if (m_mixed_precision) {
+      int failed = 0;
+      try {
+        m_single_precision_ilu.factor(m_A);
+      } catch (RuntimeError &e) {
+        m_log->message(1, "PISM WARNING: %s\n", e.what());
+        failed = 1;
+      }
+
+      if (GlobalMax(m_grid->com, failed) > 0) {
+        throw KSPFailure("single precision ILU(0) factorization failed");
+      }
+    }
 
     if (very_verbose) {
 
@@ -1042,7 +1457,7 @@ void SSAFD::picard_manager(const Inputs &inputs,
     }
 
     // Call PETSc to solve linear system by iterative method; "inner iteration":
-    ierr = KSPSetOperators(m_KSP, m_A, m_A);
+    ierr = KSPSetOperators(m_KSP, ksp_operator(), m_A);
     PISM_CHK(ierr, "KSPSetOperator");
 
     ierr = KSPSolve(m_KSP, m_b.vec(), m_velocity_global.vec());
@@ -1220,20 +1635,45 @@ a bit of bad behavior at these few places, and \f$L^1\f$ ignores it more than
  */
 void SSAFD::compute_nuH_norm(double &norm, double &norm_change) {
 
-  const double area = m_grid->cell_area();
   const NormType MY_NORM = NORM_1;
 
   // Test for change in nu
   m_nuH_old.add(-1, m_nuH);
 
-  std::vector<double>
-    nuNorm   = m_nuH.norm_all(MY_NORM),
+  std::vector<double> nuNorm(2), nuChange(2);
+
+  if (m_grid->uniform()) {
+    const double area = m_grid->cell_area();
+
+    nuNorm   = m_nuH.norm_all(MY_NORM);
     nuChange = m_nuH_old.norm_all(MY_NORM);
 
-  nuChange[0] *= area;
-  nuChange[1] *= area;
-  nuNorm[0]   *= area;
-  nuNorm[1]   *= area;
+    nuChange[0] *= area;
+    nuChange[1] *= area;
+    nuNorm[0]   *= area;
+    nuNorm[1]   *= area;
+  } else {
+    // area-weighted 1-norms
+    double local[4] = {0.0, 0.0, 0.0, 0.0}, result[4];
+
+    IceModelVec::AccessList list{&m_nuH, &m_nuH_old};
+
+    for (Points p(*m_grid); p; p.next()) {
+      const int i = p.i(), j = p.j();
+
+      const double area = m_grid->cell_area(i, j);
+
+      for (int o = 0; o < 2; ++o) {
+        local[o]     += area * fabs(m_nuH(i, j, o));
+        local[2 + o] += area * fabs(m_nuH_old(i, j, o));
+      }
+    }
+
+    GlobalSum(m_grid->com, local, result, 4);
+
+    nuNorm   = {result[0], result[1]};
+    nuChange = {result[2], result[3]};
+  }
 
   norm_change = sqrt(PetscSqr(nuChange[0]) + PetscSqr(nuChange[1]));
   norm = sqrt(PetscSqr(nuNorm[0]) + PetscSqr(nuNorm[1]));
@@ -1417,8 +1857,6 @@ void SSAFD::compute_nuH_staggered(const Geometry &geometry,
     n_glen = m_flow_law->exponent(),
     nu_enhancement_scaling = 1.0 / pow(ssa_enhancement_factor, 1.0/n_glen);
 
-  const double dx = m_grid->dx(), dy = m_grid->dy();
-
   for (int o=0; o<2; ++o) {
     const int oi = 1 - o, oj=o;
     for (Points p(*m_grid); p; p.next()) {
@@ -1434,11 +1872,17 @@ void SSAFD::compute_nuH_staggered(const Geometry &geometry,
       double u_x, u_y, v_x, v_y;
       // Check the offset to determine how to differentiate velocity
       if (o == 0) {
+        const double
+          dx = m_grid->spacing_x(i),
+          dy = m_grid->cell_height(j);
         u_x = (uv(i+1,j).u - uv(i,j).u) / dx;
         u_y = (uv(i,j+1).u + uv(i+1,j+1).u - uv(i,j-1).u - uv(i+1,j-1).u) / (4*dy);
         v_x = (uv(i+1,j).v - uv(i,j).v) / dx;
         v_y = (uv(i,j+1).v + uv(i+1,j+1).v - uv(i,j-1).v - uv(i+1,j-1).v) / (4*dy);
       } else {
+        const double
+          dx = m_grid->cell_width(i),
+          dy = m_grid->spacing_y(j);
         u_x = (uv(i+1,j).u + uv(i+1,j+1).u - uv(i-1,j).u - uv(i-1,j+1).u) / (4*dx);
         u_y = (uv(i,j+1).u - uv(i,j).u) / dy;
         v_x = (uv(i+1,j).v + uv(i+1,j+1).v - uv(i-1,j).v - uv(i-1,j+1).v) / (4*dx);
@@ -1498,8 +1942,6 @@ void SSAFD::compute_nuH_staggered_cfbc(const Geometry &geometry,
 
   const unsigned int U_X = 0, V_X = 1, W_I = 2, U_Y = 3, V_Y = 4, W_J = 5;
 
-  const double dx = m_grid->dx(), dy = m_grid->dy();
-
   IceModelVec::AccessList list{&m_mask, &m_work, &m_velocity};
 
   assert(m_velocity.stencil_width() >= 2);
@@ -1512,6 +1954,7 @@ void SSAFD::compute_nuH_staggered_cfbc(const Geometry &geometry,
     // x-derivative, i-offset
     {
       if (m_mask.icy(i,j) && m_mask.icy(i+1,j)) {
+        const double dx = m_grid->spacing_x(i);
         m_work(i,j,U_X) = (uv(i+1,j).u - uv(i,j).u) / dx; // u_x
         m_work(i,j,V_X) = (uv(i+1,j).v - uv(i,j).v) / dx; // v_x
         m_work(i,j,W_I) = 1.0;
@@ -1525,6 +1968,7 @@ void SSAFD::compute_nuH_staggered_cfbc(const Geometry &geometry,
     // y-derivative, j-offset
     {
       if (m_mask.icy(i,j) && m_mask.icy(i,j+1)) {
+        const double dy = m_grid->spacing_y(j);
         m_work(i,j,U_Y) = (uv(i,j+1).u - uv(i,j).u) / dy; // u_y
         m_work(i,j,V_Y) = (uv(i,j+1).v - uv(i,j).v) / dy; // v_y
         m_work(i,j,W_J) = 1.0;
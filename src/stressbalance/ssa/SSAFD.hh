@@ -1,4 +1,4 @@
-// Copyright (C) 2004--2019 Jed Brown, Ed Bueler and Constantine Khroulev
+// Copyright (C) 2004--2020 Jed Brown, Ed Bueler and Constantine Khroulev
 //
 // This file is part of PISM.
 //
@@ -20,6 +20,7 @@
 #define _SSAFD_H_
 
 #include "SSA.hh"
+#include "SinglePrecisionILU.hh"
 
 #include "pism/util/error_handling.hh"
 #include "pism/util/petscwrappers/Viewer.hh"
@@ -45,7 +46,19 @@ protected:
   virtual void pc_setup_bjacobi();
 
   virtual void pc_setup_asm();
-  
+
+  virtual void pc_setup(int solver_choice);
+
+  virtual void pc_setup_default();
+
+  virtual void pc_setup_mixed_precision();
+
+  virtual void autotune(const Inputs &inputs);
+
+  Mat ksp_operator() const;
+
+  void update_ksp_operator();
+
   virtual void solve(const Inputs &inputs);
 
   virtual void picard_iteration(const Inputs &inputs,
@@ -92,6 +105,9 @@ protected:
   IceModelVec2 m_work;
   petsc::KSP m_KSP;
   petsc::Mat m_A;
+  //! copy of m_A in the SELL format (used if m_use_sell is set)
+  petsc::Mat m_A_sell;
+  bool m_use_sell;
   IceModelVec2V m_b;            // right hand side
   double m_scaling;
 
@@ -99,6 +115,17 @@ protected:
 
   unsigned int m_default_pc_failure_count,
     m_default_pc_failure_max_count;
+
+  //! true if autotune() should be called before the next solve
+  bool m_autotune;
+  //! KSP, PC and sub-PC combination picked by autotune() (-1 if none)
+  int m_solver_choice;
+
+  //! preconditioner used by pc_setup_mixed_precision()
+  SinglePrecisionILU m_single_precision_ilu;
+  //! true if the KSP uses m_single_precision_ilu
+  bool m_mixed_precision;
+  unsigned int m_mixed_precision_failure_count;
   
   bool m_view_nuh;
   petsc::Viewer::Ptr m_nuh_viewer;
@@ -1,4 +1,4 @@
-// Copyright (C) 2009--2019 Jed Brown and Ed Bueler and Constantine Khroulev and David Maxwell
+// Copyright (C) 2009--2020 Jed Brown and Ed Bueler and Constantine Khroulev and David Maxwell
 //
 // This file is part of PISM.
 //
@@ -46,6 +46,7 @@ SSAFEM::SSAFEM(IceGrid::ConstPtr g)
     m_element_index(*g),
     m_element(*g),
     m_quadrature(g->dx(), g->dy(), 1.0) {
+  require_uniform_grid(*m_grid, "SSAFEM");
 
   const double ice_density = m_config->get_number("constants.ice.density");
   m_alpha = 1 - ice_density / m_config->get_number("constants.sea_water.density");
@@ -474,34 +475,23 @@ void SSAFEM::driving_stress(const fem::Quadrature &Q,
 }
 
 
-/** @brief Compute the "(regularized effective viscosity) x (ice thickness)" and effective viscous
- *  bed strength from the current solution, at a single quadrature point.
+/** @brief Compute the "(regularized effective viscosity) x (ice thickness)" from the current
+ *  solution, at a single quadrature point.
  *
  * @param[in] thickness ice thickness
  * @param[in] hardness ice hardness
- * @param[in] mask cell type mask
- * @param[in] tauc basal yield stress
- * @param[in] U the value of the solution
  * @param[in] U_x x-derivatives of velocity components
  * @param[in] U_y y-derivatives of velocity components
  * @param[out] nuH product of the ice viscosity and thickness @f$ \nu H @f$
  * @param[out] dnuH derivative of @f$ \nu H @f$ with respect to the
  *                  second invariant @f$ \gamma @f$. Set to NULL if
  *                  not desired.
- * @param[out] beta basal drag coefficient @f$ \beta @f$
- * @param[out] dbeta derivative of @f$ \beta @f$ with respect to the
- *                   second invariant @f$ \gamma @f$. Set to NULL if
- *                   not desired.
  */
-void SSAFEM::PointwiseNuHAndBeta(double thickness,
-                                 double hardness,
-                                 int mask,
-                                 double tauc,
-                                 const Vector2 &U,
-                                 const Vector2 &U_x,
-                                 const Vector2 &U_y,
-                                 double *nuH, double *dnuH,
-                                 double *beta, double *dbeta) {
+void SSAFEM::PointwiseNuH(double thickness,
+                          double hardness,
+                          const Vector2 &U_x,
+                          const Vector2 &U_y,
+                          double *nuH, double *dnuH) {
 
   if (thickness < strength_extension->get_min_thickness()) {
     *nuH = strength_extension->get_notional_strength();
@@ -518,18 +508,39 @@ void SSAFEM::PointwiseNuHAndBeta(double thickness,
       *dnuH *= thickness;
     }
   }
+}
 
-  if (mask::grounded_ice(mask)) {
-    m_basal_sliding_law->drag_with_derivative(tauc, U.u, U.v, beta, dbeta);
-  } else {
-    *beta = 0;
+/** @brief Compute the effective viscous bed strength from the current solution at all
+ *  quadrature points of an element.
+ *
+ * @param[in] n number of quadrature points
+ * @param[in] mask cell type mask
+ * @param[in] tauc basal yield stress
+ * @param[in] U the value of the solution
+ * @param[out] beta basal drag coefficient @f$ \beta @f$
+ * @param[out] dbeta derivative of @f$ \beta @f$ with respect to the
+ *                   second invariant @f$ \gamma @f$. Set to NULL if
+ *                   not desired.
+ */
+void SSAFEM::basal_drag(unsigned int n,
+                        const int *mask,
+                        const double *tauc,
+                        const Vector2 *U,
+                        double *beta, double *dbeta) {
 
-    if (mask::ice_free_land(mask)) {
-      *beta = m_beta_ice_free_bedrock;
-    }
+  m_basal_sliding_law->drag_with_derivative(n, tauc, U, beta, dbeta);
 
-    if (dbeta) {
-      *dbeta = 0;
+  for (unsigned int q = 0; q < n; q++) {
+    if (not mask::grounded_ice(mask[q])) {
+      beta[q] = 0;
+
+      if (mask::ice_free_land(mask[q])) {
+        beta[q] = m_beta_ice_free_bedrock;
+      }
+
+      if (dbeta) {
+        dbeta[q] = 0;
+      }
     }
   }
 }
@@ -806,13 +817,16 @@ void SSAFEM::compute_local_function(Vector2 const *const *const velocity_global,
           residual[k].v = 0;
         }
 
+        // basal drag coefficients at quadrature points
+        double beta_q[Nq_max];
+        basal_drag(Nq, mask, tauc, U, beta_q, NULL);
+
         // loop over quadrature points:
         for (unsigned int q = 0; q < Nq; q++) {
 
-          double eta = 0.0, beta = 0.0;
-          PointwiseNuHAndBeta(thickness[q], hardness[q], mask[q], tauc[q],
-                              U[q], U_x[q], U_y[q], // inputs
-                              &eta, NULL, &beta, NULL);              // outputs
+          double eta = 0.0, beta = beta_q[q];
+          PointwiseNuH(thickness[q], hardness[q], U_x[q], U_y[q], // inputs
+                       &eta, NULL);                               // outputs
 
           // The next few lines compute the actual residual for the element.
           const Vector2 tau_b = U[q] * (- beta); // basal shear stress
@@ -998,6 +1012,10 @@ void SSAFEM::compute_local_jacobian(Vector2 const *const *const velocity_global,
         ierr = PetscMemzero(K, sizeof(K));
         PISM_CHK(ierr, "PetscMemzero");
 
+        // basal drag coefficients and their derivatives at quadrature points
+        double beta_q[Nq_max], dbeta_q[Nq_max];
+        basal_drag(Nq, mask, tauc, U, beta_q, dbeta_q);
+
         for (unsigned int q = 0; q < Nq; q++) {
           const double
             jw           = W[q],
@@ -1007,10 +1025,9 @@ void SSAFEM::compute_local_jacobian(Vector2 const *const *const velocity_global,
             v_y          = U_y[q].v,
             u_y_plus_v_x = U_y[q].u + U_x[q].v;
 
-          double eta = 0.0, deta = 0.0, beta = 0.0, dbeta = 0.0;
-          PointwiseNuHAndBeta(thickness[q], hardness[q], mask[q], tauc[q],
-                              U[q], U_x[q], U_y[q],
-                              &eta, &deta, &beta, &dbeta);
+          double eta = 0.0, deta = 0.0, beta = beta_q[q], dbeta = dbeta_q[q];
+          PointwiseNuH(thickness[q], hardness[q], U_x[q], U_y[q],
+                       &eta, &deta);
 
           for (unsigned int l = 0; l < Nk; l++) { // Trial functions
 
@@ -1,4 +1,4 @@
-// Copyright (C) 2009--2017 Jed Brown and Ed Bueler and Constantine Khroulev and David Maxwell
+// Copyright (C) 2009--2017, 2020 Jed Brown and Ed Bueler and Constantine Khroulev and David Maxwell
 //
 // This file is part of PISM.
 //
@@ -90,15 +90,17 @@ protected:
                       const Coefficients *x,
                       Vector2 *driving_stress) const;
 
-  void PointwiseNuHAndBeta(double thickness,
-                           double hardness,
-                           int mask,
-                           double tauc,
-                           const Vector2 &U,
-                           const Vector2 &U_x,
-                           const Vector2 &U_y,
-                           double *nuH, double *dnuH,
-                           double *beta, double *dbeta);
+  void PointwiseNuH(double thickness,
+                    double hardness,
+                    const Vector2 &U_x,
+                    const Vector2 &U_y,
+                    double *nuH, double *dnuH);
+
+  void basal_drag(unsigned int n,
+                  const int *mask,
+                  const double *tauc,
+                  const Vector2 *U,
+                  double *beta, double *dbeta);
 
   void compute_local_function(Vector2 const *const *const velocity,
                               Vector2 **residual);
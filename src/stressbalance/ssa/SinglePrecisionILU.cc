@@ -0,0 +1,213 @@
+/* Copyright (C) 2020 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "SinglePrecisionILU.hh"
+
+#include "pism/util/error_handling.hh"
+
+namespace pism {
+namespace stressbalance {
+
+SinglePrecisionILU::SinglePrecisionILU()
+  : m_n(0) {
+  // empty
+}
+
+//! Turn `pc` into a PCSHELL that uses this object. Does not change `pc`'s operators.
+void SinglePrecisionILU::set_up(PC pc) {
+  PetscErrorCode ierr = PCSetType(pc, PCSHELL);
+  PISM_CHK(ierr, "PCSetType");
+
+  ierr = PCShellSetContext(pc, this);
+  PISM_CHK(ierr, "PCShellSetContext");
+
+  ierr = PCShellSetApply(pc, apply_callback);
+  PISM_CHK(ierr, "PCShellSetApply");
+
+  ierr = PCShellSetName(pc, "single precision block Jacobi ILU(0)");
+  PISM_CHK(ierr, "PCShellSetName");
+}
+
+/*!
+ * Compute ILU(0) factors of the diagonal block of `A`.
+ *
+ * The factorization uses double precision; only the result is stored in single
+ * precision.
+ *
+ * Not collective.
+ */
+void SinglePrecisionILU::factor(Mat A) {
+  PetscErrorCode ierr;
+
+  Mat A_diagonal;
+  ierr = MatGetDiagonalBlock(A, &A_diagonal);
+  PISM_CHK(ierr, "MatGetDiagonalBlock");
+
+  PetscInt n_local = 0, n_columns = 0;
+  ierr = MatGetLocalSize(A_diagonal, &n_local, &n_columns);
+  PISM_CHK(ierr, "MatGetLocalSize");
+
+  m_n = n_local;
+
+  // copy the diagonal block in the CSR format (this works for AIJ and BAIJ matrices)
+  std::vector<double> values;
+  {
+    m_row_start.resize(m_n + 1);
+    m_diagonal.resize(m_n);
+    m_columns.clear();
+
+    m_row_start[0] = 0;
+    for (PetscInt i = 0; i < m_n; ++i) {
+      PetscInt n_nonzeros = 0;
+      const PetscInt *columns = nullptr;
+      const PetscScalar *row = nullptr;
+
+      ierr = MatGetRow(A_diagonal, i, &n_nonzeros, &columns, &row);
+      PISM_CHK(ierr, "MatGetRow");
+
+      m_diagonal[i] = -1;
+      for (PetscInt k = 0; k < n_nonzeros; ++k) {
+        if (columns[k] == i) {
+          m_diagonal[i] = m_columns.size();
+        }
+        m_columns.push_back(columns[k]);
+        values.push_back(row[k]);
+      }
+
+      ierr = MatRestoreRow(A_diagonal, i, &n_nonzeros, &columns, &row);
+      PISM_CHK(ierr, "MatRestoreRow");
+
+      m_row_start[i + 1] = m_columns.size();
+
+      if (m_diagonal[i] < 0) {
+        throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                      "row %d of the SSA matrix has no diagonal entry",
+                                      (int)i);
+      }
+    }
+  }
+
+  // ILU(0) factorization (IKJ variant); column indices in each row are sorted
+  {
+    // position of a column in the current row (-1 if the current row has no entry in
+    // this column)
+    std::vector<PetscInt> position(m_n, -1);
+
+    for (PetscInt i = 0; i < m_n; ++i) {
+      const PetscInt start = m_row_start[i], end = m_row_start[i + 1];
+
+      for (PetscInt p = start; p < end; ++p) {
+        position[m_columns[p]] = p;
+      }
+
+      for (PetscInt p = start; p < m_diagonal[i]; ++p) {
+        const PetscInt k = m_columns[p];
+
+        // values[m_diagonal[k]] contains the inverse of the pivot
+        values[p] *= values[m_diagonal[k]];
+        const double L_ik = values[p];
+
+        for (PetscInt q = m_diagonal[k] + 1; q < m_row_start[k + 1]; ++q) {
+          const PetscInt r = position[m_columns[q]];
+          if (r >= 0) {
+            values[r] -= L_ik * values[q];
+          }
+        }
+      }
+
+      const double pivot = values[m_diagonal[i]];
+      if (pivot == 0.0) {
+        throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                      "zero pivot in row %d of the SSA matrix",
+                                      (int)i);
+      }
+      values[m_diagonal[i]] = 1.0 / pivot;
+
+      for (PetscInt p = start; p < end; ++p) {
+        position[m_columns[p]] = -1;
+      }
+    }
+  }
+
+  m_factors.assign(values.begin(), values.end());
+  m_work.resize(m_n);
+}
+
+/*!
+ * Apply the preconditioner: compute `y = (LU)^{-1} x` using single precision.
+ *
+ * Not collective.
+ */
+void SinglePrecisionILU::apply(Vec x, Vec y) const {
+  PetscErrorCode ierr;
+
+  const PetscScalar *X = nullptr;
+  ierr = VecGetArrayRead(x, &X);
+  PISM_CHK(ierr, "VecGetArrayRead");
+
+  // forward substitution: L z = x (L has a unit diagonal)
+  for (PetscInt i = 0; i < m_n; ++i) {
+    float sum = X[i];
+    for (PetscInt p = m_row_start[i]; p < m_diagonal[i]; ++p) {
+      sum -= m_factors[p] * m_work[m_columns[p]];
+    }
+    m_work[i] = sum;
+  }
+
+  ierr = VecRestoreArrayRead(x, &X);
+  PISM_CHK(ierr, "VecRestoreArrayRead");
+
+  // backward substitution: U y = z
+  for (PetscInt i = m_n - 1; i >= 0; --i) {
+    float sum = m_work[i];
+    for (PetscInt p = m_diagonal[i] + 1; p < m_row_start[i + 1]; ++p) {
+      sum -= m_factors[p] * m_work[m_columns[p]];
+    }
+    m_work[i] = sum * m_factors[m_diagonal[i]];
+  }
+
+  PetscScalar *Y = nullptr;
+  ierr = VecGetArray(y, &Y);
+  PISM_CHK(ierr, "VecGetArray");
+
+  for (PetscInt i = 0; i < m_n; ++i) {
+    Y[i] = m_work[i];
+  }
+
+  ierr = VecRestoreArray(y, &Y);
+  PISM_CHK(ierr, "VecRestoreArray");
+}
+
+PetscErrorCode SinglePrecisionILU::apply_callback(PC pc, Vec x, Vec y) {
+  try {
+    void *context = nullptr;
+    PetscErrorCode ierr = PCShellGetContext(pc, &context); CHKERRQ(ierr);
+
+    reinterpret_cast<SinglePrecisionILU*>(context)->apply(x, y);
+  } catch (...) {
+    MPI_Comm com = MPI_COMM_SELF;
+    PetscErrorCode ierr = PetscObjectGetComm((PetscObject)pc, &com); CHKERRQ(ierr);
+    handle_fatal_errors(com);
+    SETERRQ(com, 1, "A PISM callback failed");
+  }
+  return 0;
+}
+
+} // end of namespace stressbalance
+} // end of namespace pism
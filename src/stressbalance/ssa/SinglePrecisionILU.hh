@@ -0,0 +1,71 @@
+/* Copyright (C) 2020 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef PISM_SINGLEPRECISIONILU_H
+#define PISM_SINGLEPRECISIONILU_H
+
+#include <vector>
+
+#include <petscpc.h>
+
+namespace pism {
+namespace stressbalance {
+
+//! Block Jacobi preconditioner using ILU(0) factors stored and applied in single precision.
+/*!
+ * Each rank factors the diagonal block of the preconditioning matrix (the part coupling
+ * unknowns owned by this rank) in double precision and stores the factors as `float`,
+ * halving the memory traffic of preconditioner applications. Triangular solves use
+ * single precision, too.
+ *
+ * Use with a Krylov method that tests convergence using the unpreconditioned residual
+ * (for example FGMRES) so that the accuracy of the solution does not depend on the
+ * precision of the preconditioner.
+ *
+ * Call set_up(pc) to turn `pc` into a PCSHELL using this object and factor(A) every time
+ * the preconditioning matrix `A` changes. factor() throws RuntimeError if it encounters a
+ * zero pivot, so that the caller can switch to a different preconditioner.
+ */
+class SinglePrecisionILU {
+public:
+  SinglePrecisionILU();
+
+  void set_up(PC pc);
+
+  void factor(Mat A);
+  void apply(Vec x, Vec y) const;
+private:
+  static PetscErrorCode apply_callback(PC pc, Vec x, Vec y);
+
+  //! number of rows in the diagonal block
+  PetscInt m_n;
+  //! CSR structure of the diagonal block
+  std::vector<PetscInt> m_row_start, m_columns;
+  //! positions of diagonal entries in m_columns
+  std::vector<PetscInt> m_diagonal;
+  //! ILU(0) factors (the unit diagonal of L is not stored, diagonal of U is inverted)
+  std::vector<float> m_factors;
+  //! work space used by apply()
+  mutable std::vector<float> m_work;
+};
+
+} // end of namespace stressbalance
+} // end of namespace pism
+
+#endif /* PISM_SINGLEPRECISIONILU_H */
@@ -1,4 +1,4 @@
-/* Copyright (C) 2016, 2017 PISM Authors
+/* Copyright (C) 2016, 2017, 2020 PISM Authors
  *
  * This file is part of PISM.
  *
@@ -22,6 +22,7 @@
 #include "pism/util/iceModelVec.hh"
 #include "pism/util/IceModelVec2CellType.hh"
 #include "pism/util/pism_utilities.hh"
+#include "pism/util/WallClock.hh"
 
 namespace pism {
 
@@ -29,6 +30,29 @@ CFLData::CFLData() {
   u_max = 0.0;
   v_max = 0.0;
   w_max = 0.0;
+  wall_clock_time = 0.0;
+}
+
+/*!
+ * Compute global maxima of speeds, the global minimum of the time step restriction and the
+ * wall clock time using one reduction.
+ */
+static CFLData reduce(const IceGrid &grid, double u_max, double v_max, double w_max,
+                      double dt_max) {
+  double
+    local[5] = {u_max, v_max, w_max, -dt_max, grid.ctx()->wall_clock().time()},
+    global[5];
+
+  GlobalMax(grid.com, local, global, 5);
+
+  CFLData result;
+  result.u_max           = global[0];
+  result.v_max           = global[1];
+  result.w_max           = global[2];
+  result.dt_max          = MaxTimestep(-global[3]);
+  result.wall_clock_time = global[4];
+
+  return result;
 }
 
 //! Compute the maximum velocities for time-stepping and reporting to user.
@@ -52,10 +76,6 @@ CFLData max_timestep_cfl_3d(const IceModelVec2S &ice_thickness,
   IceModelVec::AccessList list{&ice_thickness, &u3, &v3, &w3, &cell_type};
 
   // update global max of abs of velocities for CFL; only velocities under surface
-  const double
-    one_over_dx = 1.0 / grid->dx(),
-    one_over_dy = 1.0 / grid->dy();
-
   double u_max = 0.0, v_max = 0.0, w_max = 0.0;
   ParallelSection loop(grid->com);
   try {
@@ -64,6 +84,9 @@ CFLData max_timestep_cfl_3d(const IceModelVec2S &ice_thickness,
 
       if (cell_type.icy(i, j)) {
         const int ks = grid->kBelowHeight(ice_thickness(i, j));
+        const double
+          one_over_dx = 1.0 / grid->cell_width(i),
+          one_over_dy = 1.0 / grid->cell_height(j);
         const double
           *u = u3.get_column(i, j),
           *v = v3.get_column(i, j),
@@ -91,14 +114,7 @@ CFLData max_timestep_cfl_3d(const IceModelVec2S &ice_thickness,
   }
   loop.check();
 
-  CFLData result;
-
-  result.u_max = GlobalMax(grid->com, u_max);
-  result.v_max = GlobalMax(grid->com, v_max);
-  result.w_max = GlobalMax(grid->com, w_max);
-  result.dt_max = MaxTimestep(GlobalMin(grid->com, dt_max));
-
-  return result;
+  return reduce(*grid, u_max, v_max, w_max, dt_max);
 }
 
 //! Compute the CFL constant associated to first-order upwinding for the sliding contribution to mass continuity.
@@ -120,10 +136,6 @@ CFLData max_timestep_cfl_2d(const IceModelVec2S &ice_thickness,
 
   double dt_max = config->get_number("time_stepping.maximum_time_step", "seconds");
 
-  const double
-    dx = grid->dx(),
-    dy = grid->dy();
-
   IceModelVec::AccessList list{&velocity, &cell_type};
 
   double u_max = 0.0, v_max = 0.0;
@@ -138,21 +150,14 @@ CFLData max_timestep_cfl_2d(const IceModelVec2S &ice_thickness,
       u_max = std::max(u_max, u_abs);
       v_max = std::max(v_max, v_abs);
 
-      const double denom = u_abs / dx + v_abs / dy;
+      const double denom = u_abs / grid->cell_width(i) + v_abs / grid->cell_height(j);
       if (denom > 0.0) {
         dt_max = std::min(dt_max, 1.0 / denom);
       }
     }
   }
 
-  CFLData result;
-
-  result.u_max = GlobalMax(grid->com, u_max);
-  result.v_max = GlobalMax(grid->com, v_max);
-  result.w_max = 0.0;
-  result.dt_max = MaxTimestep(GlobalMin(grid->com, dt_max));
-
-  return result;
+  return reduce(*grid, u_max, v_max, 0.0, dt_max);
 }
 
 } // end of namespace pism
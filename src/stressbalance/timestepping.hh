@@ -1,4 +1,4 @@
-/* Copyright (C) 2016, 2017 PISM Authors
+/* Copyright (C) 2016, 2017, 2020 PISM Authors
  *
  * This file is part of PISM.
  *
@@ -33,6 +33,13 @@ struct CFLData {
   CFLData();
   MaxTimestep dt_max;
   double u_max, v_max, w_max;
+  //! Wall clock time (see WallClock) when these data were computed, maximum over all ranks.
+  /*!
+   * Reduced together with the rest of CFLData so that decisions based on the wall clock
+   * time (e.g. whether to write a backup) agree across ranks without an additional
+   * collective call.
+   */
+  double wall_clock_time;
 };
 
 /*! @brief Compute the max. time step according to the CFL condition (within the volume of the
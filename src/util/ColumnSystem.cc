@@ -1,4 +1,4 @@
-// Copyright (C) 2004-2019 PISM Authors
+// Copyright (C) 2004-2020 PISM Authors
 //
 // This file is part of PISM.
 //
@@ -247,7 +247,10 @@ columnSystemCtx::columnSystemCtx(const std::vector<double>& storage_grid,
                                  const IceModelVec3 &u3,
                                  const IceModelVec3 &v3,
                                  const IceModelVec3 &w3)
-  : m_dx(dx), m_dy(dy), m_dt(dt), m_u3(u3), m_v3(v3), m_w3(w3) {
+  : m_dx(dx), m_dy(dy), m_dt(dt),
+    m_dx_w(dx), m_dx_e(dx), m_dy_s(dy), m_dy_n(dy),
+    m_u3(u3), m_v3(v3), m_w3(w3),
+    m_grid(u3.grid().get()) {
   assert(dx > 0.0);
   assert(dy > 0.0);
   assert(dt > 0.0);
@@ -319,6 +322,13 @@ void columnSystemCtx::init_column(int i, int j,
   m_j  = j;
   m_ks = static_cast<unsigned int>(floor(ice_thickness / m_dz));
 
+  if (not m_grid->uniform()) {
+    m_dx_w = m_grid->spacing_x(i - 1);
+    m_dx_e = m_grid->spacing_x(i);
+    m_dy_s = m_grid->spacing_y(j - 1);
+    m_dy_n = m_grid->spacing_y(j);
+  }
+
   // Force m_ks to be in the allowed range.
   if (m_ks >= m_z.size()) {
     m_ks = m_z.size() - 1;
@@ -1,4 +1,4 @@
-// Copyright (C) 2009-2011, 2013, 2014, 2015, 2016, 2019 PISM Authors
+// Copyright (C) 2009-2011, 2013, 2014, 2015, 2016, 2019, 2020 PISM Authors
 //
 // This file is part of PISM.
 //
@@ -133,6 +133,7 @@ private:
 
 class IceModelVec3;
 class ColumnInterpolation;
+class IceGrid;
 
 //! Base class for tridiagonal systems in the ice.
 /*! Adds data members used in time-dependent systems with advection
@@ -165,6 +166,10 @@ protected:
 
   double m_dx, m_dy, m_dz, m_dt;
 
+  //! horizontal grid spacing to the west, east, south and north of the current column
+  /*! These are equal to `m_dx` and `m_dy` unless the grid is non-uniform. */
+  double m_dx_w, m_dx_e, m_dy_s, m_dy_n;
+
   //! u-component of the ice velocity
   std::vector<double> m_u;
   //! v-component of the ice velocity
@@ -177,6 +182,9 @@ protected:
   //! pointers to 3D velocity components
   const IceModelVec3 &m_u3, &m_v3, &m_w3;
 
+  //! horizontal grid (used to get local grid spacing)
+  const IceGrid *m_grid;
+
   void init_column(int i, int j, double ice_thickness);
 
   void reportColumnZeroPivotErrorMFile(unsigned int M);
@@ -1,4 +1,4 @@
-/* Copyright (C) 2014, 2015, 2017, 2019 PISM Authors
+/* Copyright (C) 2014, 2015, 2017, 2019, 2020 PISM Authors
  *
  * This file is part of PISM.
  *
@@ -23,8 +23,10 @@
 #include "Config.hh"
 #include "Time.hh"
 #include "Logger.hh"
+#include "WallClock.hh"
 #include "pism/util/EnthalpyConverter.hh"
 #include "pism/util/error_handling.hh"
+#include "pism/util/io/File.hh"
 #include "pism/pism_config.hh"
 
 #if (Pism_USE_PIO==1)
@@ -45,7 +47,7 @@ public:
        LoggerPtr log,
        const std::string &p)
     : com(c), unit_system(sys), config(conf), enthalpy_converter(EC), time(t), prefix(p),
-      logger(log), pio_iosys_id(-1) {
+      wall_clock(c), logger(log), pio_iosys_id(-1) {
     // empty
   }
   MPI_Comm com;
@@ -55,6 +57,7 @@ public:
   TimePtr time;
   std::string prefix;
   Profiling profiling;
+  WallClock wall_clock;
   LoggerPtr logger;
   int pio_iosys_id;
 };
@@ -127,6 +130,10 @@ const Profiling& Context::profiling() const {
   return m_impl->profiling;
 }
 
+const WallClock& Context::wall_clock() const {
+  return m_impl->wall_clock;
+}
+
 Context::ConstLoggerPtr Context::log() const {
   return m_impl->logger;
 }
@@ -179,6 +186,9 @@ Context::Ptr context_from_options(MPI_Comm com, const std::string &prefix) {
   Config::Ptr config = config_from_options(com, *logger, sys);
   print_config(*logger, 3, *config);
 
+  // input files read into memory by the serial I/O backend
+  set_in_memory_size_limit(config->get_number("input.in_memory_size_limit") * 1024 * 1024);
+
   // time manager
   Time::Ptr time = time_from_options(com, config, sys);
 
@@ -1,4 +1,4 @@
-/* Copyright (C) 2014, 2015, 2016, 2019 PISM Authors
+/* Copyright (C) 2014, 2015, 2016, 2019, 2020 PISM Authors
  *
  * This file is part of PISM.
  *
@@ -36,6 +36,7 @@ class EnthalpyConverter;
 class Time;
 class Profiling;
 class Logger;
+class WallClock;
 
 class Context {
 public:
@@ -66,6 +67,7 @@ public:
   ConstTimePtr time() const;
   const std::string& prefix() const;
   const Profiling& profiling() const;
+  const WallClock& wall_clock() const;
 
   ConstLoggerPtr log() const;
   LoggerPtr log();
@@ -1,4 +1,4 @@
-/* Copyright (C) 2015, 2016, 2017, 2019 PISM Authors
+/* Copyright (C) 2015, 2016, 2017, 2019, 2020 PISM Authors
  *
  * This file is part of PISM.
  *
@@ -17,6 +17,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#include <algorithm>            // std::max, std::find
+
 #include "Diagnostic.hh"
 #include "pism/util/Time.hh"
 #include "error_handling.hh"
@@ -63,6 +65,137 @@ void Diagnostic::reset_impl() {
   // empty
 }
 
+/*!
+ * Prepare a fused update of this diagnostic.
+ *
+ * Returns true if the caller has to perform the update described by `result` (see
+ * accumulate()). Returns false if update() has to be called instead.
+ */
+bool Diagnostic::fused_update(double dt, AccumulatorUpdate &result) {
+  return this->fused_update_impl(dt, result);
+}
+
+bool Diagnostic::fused_update_impl(double dt, AccumulatorUpdate &result) {
+  (void) dt;
+  (void) result;
+  return false;
+}
+
+/*!
+ * Perform accumulator updates in one sweep over the grid.
+ *
+ * Each input field is read once per grid point, even if it is used by several
+ * accumulators.
+ */
+void accumulate(const std::vector<AccumulatorUpdate> &updates) {
+  if (updates.empty()) {
+    return;
+  }
+
+  IceGrid::ConstPtr grid = updates[0].accumulator->grid();
+
+  IceModelVec::AccessList list;
+
+  // distinct input fields and their indices used by each update
+  std::vector<const IceModelVec2S*> fields;
+  std::vector<std::vector<int>> inputs(updates.size());
+
+  for (unsigned int n = 0; n < updates.size(); ++n) {
+    list.add(*updates[n].accumulator);
+
+    for (const auto *f : updates[n].inputs) {
+      auto k = std::find(fields.begin(), fields.end(), f) - fields.begin();
+      if (k == (long int)fields.size()) {
+        fields.push_back(f);
+        list.add(*f);
+      }
+      inputs[n].push_back(k);
+    }
+  }
+
+  std::vector<double> values(fields.size());
+
+  for (Points p(*grid); p; p.next()) {
+    const int i = p.i(), j = p.j();
+
+    for (unsigned int k = 0; k < fields.size(); ++k) {
+      values[k] = (*fields[k])(i, j);
+    }
+
+    for (unsigned int n = 0; n < updates.size(); ++n) {
+      double sum = 0.0;
+      for (int k : inputs[n]) {
+        sum += values[k];
+      }
+
+      if (updates[n].per_cell_area) {
+        (*updates[n].accumulator)(i, j) += updates[n].factor * grid->cell_area(i, j) * sum;
+      } else {
+        (*updates[n].accumulator)(i, j) += updates[n].factor * sum;
+      }
+    }
+  }
+}
+
+DiagnosticBuffers::DiagnosticBuffers(IceGrid::ConstPtr grid)
+  : m_grid(grid) {
+  // empty
+}
+
+//! Get buffers shared by all diagnostics using `grid`.
+DiagnosticBuffers::Ptr DiagnosticBuffers::get(IceGrid::ConstPtr grid) {
+  // Buffers are kept alive by diagnostics using them. Each set of buffers holds a pointer
+  // to its grid, so a grid cannot be de-allocated (and its address re-used) while its
+  // buffers are in use.
+  static std::map<const IceGrid*, std::weak_ptr<DiagnosticBuffers> > buffers;
+
+  auto &entry = buffers[grid.get()];
+
+  Ptr result = entry.lock();
+  if (not result) {
+    result = Ptr(new DiagnosticBuffers(grid));
+    entry = result;
+  }
+
+  return result;
+}
+
+//! Returns a buffer nobody else holds, allocating a new one if necessary.
+IceModelVec2S::Ptr DiagnosticBuffers::buffer() {
+  for (const auto &b : m_buffers) {
+    if (b.use_count() == 1) {
+      return b;
+    }
+  }
+
+  IceModelVec2S::Ptr result(new IceModelVec2S(m_grid, "diagnostic", WITHOUT_GHOSTS));
+  m_buffers.push_back(result);
+
+  return result;
+}
+
+/*!
+ * Update all diagnostics in a list.
+ *
+ * Diagnostics supporting fused updates (time-averaged rates of change) are updated in one
+ * sweep over the grid.
+ */
+void update_diagnostics(const DiagnosticList &diagnostics, double dt) {
+  std::vector<AccumulatorUpdate> updates;
+  updates.reserve(diagnostics.size());
+
+  for (const auto &d : diagnostics) {
+    AccumulatorUpdate u;
+    if (d.second->fused_update(dt, u)) {
+      updates.push_back(u);
+    } else {
+      d.second->update(dt);
+    }
+  }
+
+  accumulate(updates);
+}
+
 /*!
  * Convert from external (output) units to internal units.
  */
@@ -392,4 +525,172 @@ const VariableMetadata &TSDiagnostic::metadata() const {
   return m_ts.variable();
 }
 
+//! Values computed but not written yet.
+const Timeseries &TSDiagnostic::buffer() const {
+  return m_ts;
+}
+
+//! Discard buffered values (after they are written by TSDiagnosticWriter).
+void TSDiagnostic::reset_buffer() {
+  m_start += m_ts.times().size();
+  m_ts.reset();
+}
+
+TSDiagnosticWriter::TSDiagnosticWriter(IceGrid::ConstPtr grid,
+                                       const std::string &filename,
+                                       IO_Mode mode)
+  : m_grid(grid), m_n_records(0), m_last_time(0.0) {
+  // OK to use NetCDF-3: all time-series are written by one rank
+  m_file.reset(new File(m_grid->com, filename, PISM_NETCDF3, mode));
+}
+
+TSDiagnosticWriter::~TSDiagnosticWriter() {
+  // empty: buffered values (if any) are written by TSDiagnostic::flush() in
+  // ~TSDiagnostic(), after the file is closed
+}
+
+const File &TSDiagnosticWriter::file() const {
+  return *m_file;
+}
+
+/*!
+ * Initialize diagnostics in `diagnostics` and define all corresponding variables in the
+ * output file.
+ */
+void TSDiagnosticWriter::init(const TSDiagnosticList &diagnostics,
+                              std::shared_ptr<std::vector<double>> requested_times) {
+  m_columns.clear();
+
+  units::System::Ptr sys = m_grid->ctx()->unit_system();
+
+  unsigned int n_records = 0;
+
+  for (auto d : diagnostics) {
+    d.second->init(*m_file, requested_times);
+
+    const Timeseries &ts = d.second->buffer();
+
+    if (m_dimension_name.empty()) {
+      m_dimension_name = ts.dimension().get_name();
+
+      m_time_converter.reset(new units::Converter(sys,
+                                                  ts.dimension().get_string("units"),
+                                                  ts.dimension().get_string("glaciological_units")));
+      m_bounds_converter.reset(new units::Converter(sys,
+                                                    ts.bounds().get_string("units"),
+                                                    ts.bounds().get_string("glaciological_units")));
+
+      // Get the number of records in the file (for appending):
+      n_records = m_file->dimension_length(m_dimension_name);
+      if (n_records > 0) {
+        units::Converter to_internal(sys,
+                                     ts.dimension().get_string("glaciological_units"),
+                                     ts.dimension().get_string("units"));
+        m_last_time = to_internal(vector_max(m_file->read_dimension(m_dimension_name)));
+      }
+    }
+
+    // Define all variables now to avoid switching to define mode when writing.
+    io::define_timeseries(ts.variable(), *m_file, PISM_DOUBLE);
+    io::define_time_bounds(ts.bounds(), *m_file, PISM_DOUBLE);
+
+    const VariableMetadata &variable = ts.variable();
+
+    Column c;
+    c.diagnostic = d.second;
+    c.start      = n_records;
+    c.converter.reset(new units::Converter(sys,
+                                           variable.get_string("units"),
+                                           variable.get_string("glaciological_units")));
+    m_columns.push_back(c);
+  }
+
+  m_n_records = n_records;
+}
+
+//! Maximum number of records buffered by one of the diagnostics.
+size_t TSDiagnosticWriter::buffered_records() const {
+  size_t result = 0;
+  for (const auto &c : m_columns) {
+    result = std::max(result, c.diagnostic->buffer().times().size());
+  }
+  return result;
+}
+
+void TSDiagnosticWriter::write_times(const Timeseries &buffer, unsigned int start) {
+  const auto &times = buffer.times();
+  const unsigned int N = times.size();
+
+  m_tmp = times;
+  m_time_converter->convert_doubles(m_tmp.data(), N);
+  m_file->write_variable(m_dimension_name, {start}, {N}, m_tmp.data());
+
+  m_tmp = buffer.time_bounds();
+  m_bounds_converter->convert_doubles(m_tmp.data(), m_tmp.size());
+  m_file->write_variable(buffer.bounds().get_name(), {start, 0}, {N, 2}, m_tmp.data());
+}
+
+/*!
+ * Write all buffered records to the file.
+ */
+void TSDiagnosticWriter::flush() {
+  // Find the first record of each buffer in the file and the buffer that extends the time
+  // dimension the most. Its times and time bounds are written for all diagnostics.
+  const Timeseries *times = nullptr;
+  unsigned int times_start = 0, n_records = m_n_records;
+
+  for (auto &c : m_columns) {
+    const Timeseries &buffer = c.diagnostic->buffer();
+    const unsigned int N = buffer.times().size();
+
+    if (N == 0) {
+      continue;
+    }
+
+    // All buffered records are after the last one in the file: append them (same as in
+    // TSDiagnostic::flush()).
+    if (m_n_records > 0 and m_last_time < buffer.times().front()) {
+      c.start = m_n_records;
+    }
+
+    if (c.start + N > n_records) {
+      n_records   = c.start + N;
+      times       = &buffer;
+      times_start = c.start;
+    }
+  }
+
+  if (times != nullptr) {
+    write_times(*times, times_start);
+    m_n_records = n_records;
+    m_last_time = times->times().back();
+  }
+
+  for (auto &c : m_columns) {
+    const Timeseries &buffer = c.diagnostic->buffer();
+    const unsigned int N = buffer.times().size();
+
+    if (N == 0) {
+      continue;
+    }
+
+    m_tmp = buffer.values();
+    c.converter->convert_doubles(m_tmp.data(), N);
+
+    const std::string &name = buffer.variable().get_name();
+    try {
+      m_file->write_variable(name, {c.start}, {N}, m_tmp.data());
+    } catch (RuntimeError &e) {
+      e.add_context("writing time-series variable '%s' to '%s'", name.c_str(),
+                    m_file->filename().c_str());
+      throw;
+    }
+
+    c.start += N;
+    c.diagnostic->reset_buffer();
+  }
+
+  m_file->sync();
+}
+
 } // end of namespace pism
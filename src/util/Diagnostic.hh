@@ -1,4 +1,4 @@
-// Copyright (C) 2010--2019 PISM Authors
+// Copyright (C) 2010--2020 PISM Authors
 //
 // This file is part of PISM.
 //
@@ -34,6 +34,37 @@
 
 namespace pism {
 
+//! Accumulator update performed by accumulate(): `accumulator += factor * sum(inputs)`.
+//! If `per_cell_area` is set the sum is also multiplied by the area of each grid cell.
+struct AccumulatorUpdate {
+  IceModelVec2S *accumulator;
+  double factor;
+  bool per_cell_area;
+  std::vector<const IceModelVec2S*> inputs;
+};
+
+void accumulate(const std::vector<AccumulatorUpdate> &updates);
+
+//! Buffers used to return results of time-averaged diagnostics (see DiagAverageRate).
+/*!
+ * All diagnostics using the same grid share one set of buffers. A buffer is re-used once
+ * nobody holds the result stored in it, so the memory cost is one 2D field per result held
+ * by callers at the same time (usually one) instead of one field per diagnostic.
+ */
+class DiagnosticBuffers {
+public:
+  typedef std::shared_ptr<DiagnosticBuffers> Ptr;
+
+  static Ptr get(IceGrid::ConstPtr grid);
+
+  IceModelVec2S::Ptr buffer();
+private:
+  DiagnosticBuffers(IceGrid::ConstPtr grid);
+
+  IceGrid::ConstPtr m_grid;
+  std::vector<IceModelVec2S::Ptr> m_buffers;
+};
+
 //! @brief Class representing diagnostic computations in PISM.
 /*!
  * The main goal of this abstraction is to allow accessing metadata
@@ -67,6 +98,7 @@ public:
   static Ptr wrap(const IceModelVec2V &input);
 
   void update(double dt);
+  bool fused_update(double dt, AccumulatorUpdate &result);
   void reset();
 
   //! @brief Compute a diagnostic quantity and return a pointer to a newly-allocated IceModelVec.
@@ -94,6 +126,7 @@ protected:
                  unsigned int N = 0);
 
   virtual void update_impl(double dt);
+  virtual bool fused_update_impl(double dt, AccumulatorUpdate &result);
   virtual void reset_impl();
 
   virtual IceModelVec::Ptr compute_impl() const = 0;
@@ -115,6 +148,8 @@ protected:
 
 typedef std::map<std::string, Diagnostic::Ptr> DiagnosticList;
 
+void update_diagnostics(const DiagnosticList &diagnostics, double dt);
+
 /*!
  * Helper template wrapping quantities with dedicated storage in diagnostic classes.
  *
@@ -160,6 +195,15 @@ protected:
 /*!
  * Report a time-averaged rate of change of a quantity by accumulating changes over several time
  * steps.
+ *
+ * The accumulated quantity is the sum of fields returned by model_inputs() times
+ * `m_factor` (times the time step length if the input is a rate) and times the cell area
+ * if `m_per_cell_area` is set (to convert from kg m-2 to kg, for example; cells of
+ * non-uniform grids have different areas). Accumulators of all
+ * these diagnostics are updated in one sweep over the grid by update_diagnostics().
+ *
+ * Derived classes overriding update_impl() have to override model_inputs() and return an
+ * empty list.
  */
 template<class M>
 class DiagAverageRate : public Diag<M>
@@ -171,9 +215,11 @@ public:
   DiagAverageRate(const M *m, const std::string &name, InputKind kind)
     : Diag<M>(m),
     m_factor(1.0),
+    m_per_cell_area(false),
     m_input_kind(kind),
     m_accumulator(Diagnostic::m_grid, name + "_accumulator", WITHOUT_GHOSTS),
     m_interval_length(0.0),
+    m_buffers(DiagnosticBuffers::get(Diagnostic::m_grid)),
     m_time_since_reset(name + "_time_since_reset",
                         Diagnostic::m_config->get_string("time.dimension_name"),
                         Diagnostic::m_sys) {
@@ -220,14 +266,37 @@ protected:
   }
 
   virtual void update_impl(double dt) {
+    AccumulatorUpdate update;
+    if (this->fused_update_impl(dt, update)) {
+      accumulate({update});
+    }
+  }
+
+  virtual bool fused_update_impl(double dt, AccumulatorUpdate &result) {
+    auto inputs = this->model_inputs();
+    if (inputs.empty()) {
+      return false;
+    }
+
     // Here the "factor" is used to convert units (from m to kg m-2, for example) and (possibly)
     // integrate over the time integral using the rectangle method.
+    double factor        = m_factor;
+    bool   per_cell_area = m_per_cell_area;
+    if (per_cell_area and Diagnostic::m_grid->uniform()) {
+      // all cells have the same area: multiply by it here to get (factor * area) * dt * sum,
+      // the same order of operations as in the code that supported uniform grids only
+      factor        *= Diagnostic::m_grid->cell_area();
+      per_cell_area  = false;
+    }
 
-    double factor = m_factor * (m_input_kind == TOTAL_CHANGE ? 1.0 : dt);
-
-    m_accumulator.add(factor, this->model_input());
+    result.accumulator   = &m_accumulator;
+    result.factor        = factor * (m_input_kind == TOTAL_CHANGE ? 1.0 : dt);
+    result.per_cell_area = per_cell_area;
+    result.inputs        = inputs;
 
     m_interval_length += dt;
+
+    return true;
   }
 
   virtual void reset_impl() {
@@ -236,8 +305,7 @@ protected:
   }
 
   virtual IceModelVec::Ptr compute_impl() const {
-    IceModelVec2S::Ptr result(new IceModelVec2S(Diagnostic::m_grid,
-                                                "diagnostic", WITHOUT_GHOSTS));
+    IceModelVec2S::Ptr result = m_buffers->buffer();
     result->metadata(0) = Diagnostic::m_vars.at(0);
 
     if (m_interval_length > 0.0) {
@@ -252,17 +320,25 @@ protected:
 protected:
   // constants initialized in the constructor
   double m_factor;
+  bool m_per_cell_area;
   InputKind m_input_kind;
   // the state (read from and written to files)
   IceModelVec2S m_accumulator;
   // length of the reporting interval, accumulated along with the cumulative quantity
   double m_interval_length;
   TimeseriesMetadata m_time_since_reset;
+  // buffers used to return results of compute_impl() (shared with other diagnostics)
+  DiagnosticBuffers::Ptr m_buffers;
 
   // it should be enough to implement the constructor and this method
   virtual const IceModelVec2S& model_input() {
     throw RuntimeError::formatted(PISM_ERROR_LOCATION, "no default implementation");
   }
+
+  //! Fields to accumulate (their sum is accumulated). Defaults to `{&model_input()}`.
+  virtual std::vector<const IceModelVec2S*> model_inputs() {
+    return {&this->model_input()};
+  }
 };
 
 //! @brief PISM's scalar time-series diagnostics.
@@ -284,6 +360,9 @@ public:
 
   void define(const File &file) const;
 
+  const Timeseries &buffer() const;
+  void reset_buffer();
+
 protected:
   virtual void update_impl(double t0, double t1) = 0;
 
@@ -327,6 +406,55 @@ protected:
 
 typedef std::map<std::string, TSDiagnostic::Ptr> TSDiagnosticList;
 
+//! Writes buffered values of a set of scalar diagnostics to one file.
+/*!
+ * All time-series are defined once (in init()) and the file is kept open between
+ * flushes, so flush() writes pending records of all diagnostics without re-opening the
+ * file, re-reading the time dimension, re-entering the define mode or re-creating unit
+ * converters. Each flush writes times, time bounds and each time-series using one
+ * hyperslab per variable and then synchronizes the file.
+ *
+ * Diagnostics added to `diagnostics` after init() are ignored.
+ */
+class TSDiagnosticWriter {
+public:
+  TSDiagnosticWriter(IceGrid::ConstPtr grid, const std::string &filename, IO_Mode mode);
+  ~TSDiagnosticWriter();
+
+  void init(const TSDiagnosticList &diagnostics,
+            std::shared_ptr<std::vector<double>> requested_times);
+
+  void flush();
+
+  size_t buffered_records() const;
+
+  const File &file() const;
+private:
+  struct Column {
+    TSDiagnostic::Ptr diagnostic;
+    //! index of the next record to write
+    unsigned int start;
+    //! converter from internal to glaciological units
+    std::shared_ptr<units::Converter> converter;
+  };
+
+  void write_times(const Timeseries &buffer, unsigned int start);
+
+  IceGrid::ConstPtr m_grid;
+  std::unique_ptr<File> m_file;
+  std::vector<Column> m_columns;
+
+  std::string m_dimension_name;
+  //! number of records in the time dimension
+  unsigned int m_n_records;
+  //! time of the last record in the file (in internal units)
+  double m_last_time;
+  std::shared_ptr<units::Converter> m_time_converter, m_bounds_converter;
+
+  //! temporary storage used to convert units
+  std::vector<double> m_tmp;
+};
+
 //! Scalar diagnostic reporting a snapshot of a quantity modeled by PISM.
 /*!
  * The method compute() should return the instantaneous "snapshot" value.
@@ -0,0 +1,214 @@
+/* Copyright (C) 2020 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <algorithm>            // std::min, std::max
+#include <map>
+
+#include "ForcingGroup.hh"
+
+#include "pism/util/io/File.hh"
+#include "pism/util/error_handling.hh"
+#include "pism/util/interpolation.hh"
+
+namespace pism {
+
+//! Records of one field that have to be read during an update.
+struct ForcingGroup::Request {
+  IceModelVec2T *field;
+  //! in-file index of the first record to read
+  unsigned int start;
+  //! buffer position of the first record to read
+  unsigned int position;
+  //! number of records to read
+  unsigned int count;
+};
+
+ForcingGroup::ForcingGroup(IceGrid::ConstPtr grid)
+  : m_grid(grid) {
+  // empty
+}
+
+//! Add a field to the group. Fields have to be added before calling init().
+void ForcingGroup::add(IceModelVec2T::Ptr field) {
+  if (not m_filename.empty()) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "cannot add %s to a forcing group that is initialized already",
+                                  field->get_name().c_str());
+  }
+
+  m_fields.push_back(field);
+}
+
+/*!
+ * Initialize all fields in the group using data from `filename`.
+ *
+ * Opens the file once and reads each time axis once. If `period` is not zero, reads all
+ * records right away.
+ */
+void ForcingGroup::init(const std::string &filename, unsigned int period,
+                        double reference_time) {
+  m_filename = filename;
+
+  std::vector<IceModelVec2T::TimeAxis> axes;
+  {
+    File file(m_grid->com, m_filename, PISM_GUESS, PISM_READONLY);
+
+    // names of time dimensions used by fields in this group
+    std::vector<std::string> time_names;
+    // true if time bounds corresponding to a time dimension are needed
+    std::map<std::string, bool> need_bounds;
+    for (auto &f : m_fields) {
+      auto name = f->time_dimension(file);
+
+      time_names.push_back(name);
+      need_bounds[name] = (need_bounds[name] or
+                           f->m_interp_type == PIECEWISE_CONSTANT);
+    }
+
+    std::map<std::string, IceModelVec2T::TimeAxis> cache;
+    for (auto &name : time_names) {
+      if (cache.find(name) == cache.end()) {
+        cache[name] = m_fields[0]->read_time_axis(file, name, need_bounds[name]);
+      }
+      axes.push_back(cache[name]);
+    }
+  }
+
+  for (unsigned int k = 0; k < m_fields.size(); ++k) {
+    m_fields[k]->init(m_filename, period, reference_time, axes[k]);
+  }
+
+  if (period != 0) {
+    // read periodic data right away (we need to hold it all in memory anyway)
+    std::vector<Request> requests;
+    for (auto &f : m_fields) {
+      Request r{f.get(), 0, 0, 0};
+      r.count = f->prepare_buffer(r.start, r.position);
+      requests.push_back(r);
+    }
+    read(requests);
+  }
+}
+
+//! Read some data to make sure that the interval (t, t + dt) is covered by all fields.
+void ForcingGroup::update(double t, double dt) {
+  std::vector<Request> requests;
+
+  for (auto &f : m_fields) {
+    int start = f->first_record_needed(t, dt);
+
+    if (start < 0) {
+      continue;
+    }
+
+    Request r{f.get(), static_cast<unsigned int>(start), 0, 0};
+    r.count = f->prepare_buffer(r.start, r.position);
+    requests.push_back(r);
+  }
+
+  read(requests);
+}
+
+/*!
+ * Read records described by `requests`, opening the file once and going through the
+ * union of requested record ranges in order.
+ */
+void ForcingGroup::read(std::vector<Request> &requests) {
+
+  unsigned int
+    first = 0,
+    last  = 0;
+  bool empty = true;
+  for (const auto &r : requests) {
+    if (r.count == 0) {
+      continue;
+    }
+
+    first = empty ? r.start : std::min(first, r.start);
+    last  = empty ? r.start + r.count : std::max(last, r.start + r.count);
+    empty = false;
+  }
+
+  if (empty) {
+    return;
+  }
+
+  File file(m_grid->com, m_filename, PISM_GUESS, PISM_READONLY);
+
+  for (unsigned int record = first; record < last; ++record) {
+    for (const auto &r : requests) {
+      if (record >= r.start and record < r.start + r.count) {
+        r.field->read_record(file, record, r.position + (record - r.start));
+      }
+    }
+  }
+}
+
+/*!
+ * Compute averages of all fields over the time interval `[t, t + dt]`.
+ *
+ * Interpolation weights are computed once and re-used by all fields that have the same
+ * time axis, interpolation type and buffer contents.
+ */
+void ForcingGroup::average(double t, double dt) {
+  std::vector<IceModelVec2T*> done;
+
+  for (auto &f : m_fields) {
+    // if only one record, nothing to do
+    if (f->m_time.size() == 1) {
+      continue;
+    }
+
+    IceModelVec2T *same = nullptr;
+    for (auto g : done) {
+      if (g->m_interp_type == f->m_interp_type and
+          g->m_n_evaluations_per_year == f->m_n_evaluations_per_year and
+          g->m_first == f->m_first and
+          g->m_N == f->m_N and
+          g->m_period == f->m_period and
+          g->m_reference_time == f->m_reference_time and
+          g->m_time == f->m_time) {
+        same = g;
+        break;
+      }
+    }
+
+    if (same != nullptr) {
+      f->m_interp = same->m_interp;
+    } else {
+      f->init_interpolation(f->averaging_times(t, dt));
+      done.push_back(f.get());
+    }
+
+    f->average_using_weights();
+  }
+}
+
+//! Maximum time step allowed by all the fields in the group.
+MaxTimestep ForcingGroup::max_timestep(double t) const {
+  MaxTimestep result;
+
+  for (const auto &f : m_fields) {
+    result = std::min(result, f->max_timestep(t));
+  }
+
+  return result;
+}
+
+} // end of namespace pism
@@ -0,0 +1,64 @@
+/* Copyright (C) 2020 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef PISM_FORCINGGROUP_H
+#define PISM_FORCINGGROUP_H
+
+#include <string>
+#include <vector>
+
+#include "pism/util/iceModelVec2T.hh"
+
+namespace pism {
+
+//! Several forcing fields read from the same file.
+/*!
+ * Forcing fields registered using add() are updated together: the file is opened once
+ * per update, each time axis is read and validated once, all records in the range needed
+ * by any of the fields are read in one pass (record by record) and interpolation weights
+ * are computed once for fields that share the time axis, the buffer state and the
+ * interpolation type.
+ *
+ * Fields do not have to use the same time dimension or the same interpolation type, but
+ * the group is most efficient if they do.
+ */
+class ForcingGroup {
+public:
+  ForcingGroup(IceGrid::ConstPtr grid);
+
+  void add(IceModelVec2T::Ptr field);
+
+  void init(const std::string &filename, unsigned int period, double reference_time);
+
+  void update(double t, double dt);
+  void average(double t, double dt);
+
+  MaxTimestep max_timestep(double t) const;
+private:
+  struct Request;
+  void read(std::vector<Request> &requests);
+
+  IceGrid::ConstPtr m_grid;
+  std::string m_filename;
+  std::vector<IceModelVec2T::Ptr> m_fields;
+};
+
+} // end of namespace pism
+
+#endif /* PISM_FORCINGGROUP_H */
@@ -1,4 +1,4 @@
-// Copyright (C) 2004-2019 Jed Brown, Ed Bueler and Constantine Khroulev
+// Copyright (C) 2004-2020 Jed Brown, Ed Bueler and Constantine Khroulev
 //
 // This file is part of PISM.
 //
@@ -18,6 +18,7 @@
 
 #include <cassert>
 
+#include <algorithm>            // std::upper_bound
 #include <map>
 #include <numeric>
 #include <petscsys.h>
@@ -53,6 +54,7 @@ struct IceGrid::Impl {
                             const std::vector<unsigned int> &procs_y);
 
   void compute_horizontal_coordinates();
+  void compute_local_spacing();
 
   Context::ConstPtr ctx;
 
@@ -85,6 +87,17 @@ struct IceGrid::Impl {
   double dy;
   //! cell area (meters^2)
   double cell_area;
+
+  //! true if the grid is equally spaced in both X and Y directions
+  bool uniform;
+  //! distances between neighboring grid points: `spacing_x[i] = x[i + 1] - x[i]`
+  std::vector<double> spacing_x;
+  //! distances between neighboring grid points: `spacing_y[j] = y[j + 1] - y[j]`
+  std::vector<double> spacing_y;
+  //! cell widths (distances between cell interfaces in the X direction)
+  std::vector<double> cell_width;
+  //! cell heights (distances between cell interfaces in the Y direction)
+  std::vector<double> cell_height;
   //! number of grid points in the x-direction
   unsigned int Mx;
   //! number of grid points in the y-direction
@@ -262,6 +275,18 @@ IceGrid::IceGrid(Context::ConstPtr context, const GridParameters &p)
 
     m_impl->compute_horizontal_coordinates();
 
+    if (not p.x.empty()) {
+      m_impl->x = p.x;
+    }
+
+    if (not p.y.empty()) {
+      m_impl->y = p.y;
+    }
+
+    m_impl->uniform = p.x.empty() and p.y.empty();
+
+    m_impl->compute_local_spacing();
+
     {
       unsigned int stencil_width = (unsigned int)context->config()->get_number("grid.max_stencil_width");
 
@@ -658,6 +683,68 @@ void IceGrid::Impl::compute_horizontal_coordinates() {
                           cell_centered);
 }
 
+/*!
+ * Compute distances between grid points, cell widths and cell heights.
+ *
+ * On non-uniform grids `dx` and `dy` are set to smallest distances between grid points (so
+ * that they can be used in CFL-type time step restrictions) and `cell_area` to `dx * dy`.
+ *
+ * The distance between the last point and the one following it (a ghost) is set to the
+ * distance between the last two points unless the grid is periodic.
+ */
+void IceGrid::Impl::compute_local_spacing() {
+
+  auto spacing = [](const std::vector<double> &coords, double delta,
+                    bool uniform, bool periodic, double width) {
+    const size_t M = coords.size();
+    std::vector<double> result(M, delta);
+
+    if (not uniform) {
+      for (size_t k = 0; k < M - 1; ++k) {
+        result[k] = coords[k + 1] - coords[k];
+      }
+
+      const double wrap = width - (coords[M - 1] - coords[0]);
+      result[M - 1] = (periodic and wrap > 0.0) ? wrap : result[M - 2];
+    }
+
+    return result;
+  };
+
+  auto cell_size = [](const std::vector<double> &spacing, bool periodic) {
+    const size_t M = spacing.size();
+    std::vector<double> result(M);
+
+    for (size_t k = 0; k < M; ++k) {
+      const double previous = k > 0 ? spacing[k - 1] : (periodic ? spacing[M - 1] : spacing[0]);
+
+      result[k] = 0.5 * (previous + spacing[k]);
+    }
+
+    return result;
+  };
+
+  const bool
+    periodic_x = periodicity & X_PERIODIC,
+    periodic_y = periodicity & Y_PERIODIC;
+
+  spacing_x = spacing(x, dx, uniform, periodic_x, 2.0 * Lx);
+  spacing_y = spacing(y, dy, uniform, periodic_y, 2.0 * Ly);
+
+  if (uniform) {
+    cell_width.assign(Mx, dx);
+    cell_height.assign(My, dy);
+  } else {
+    cell_width  = cell_size(spacing_x, periodic_x);
+    cell_height = cell_size(spacing_y, periodic_y);
+
+    dx = vector_min(spacing_x);
+    dy = vector_min(spacing_y);
+
+    cell_area = dx * dy;
+  }
+}
+
 //! \brief Report grid parameters.
 void IceGrid::report_parameters() const {
 
@@ -678,6 +765,13 @@ void IceGrid::report_parameters() const {
               "           spatial domain   %.2f km x %.2f km x %.2f m\n",
               km(2*Lx()), km(2*Ly()), Lz());
 
+  if (not uniform()) {
+    log.message(2,
+                "     non-uniform grid: %.2f km < dx < %.2f km, %.2f km < dy < %.2f km\n",
+                km(dx()), km(vector_max(m_impl->spacing_x)),
+                km(dy()), km(vector_max(m_impl->spacing_y)));
+  }
+
   // report on grid cell dims
   if ((dx() && dy()) > 1000.) {
     log.message(2,
@@ -761,8 +855,16 @@ void IceGrid::report_parameters() const {
 void IceGrid::compute_point_neighbors(double X, double Y,
                                       int &i_left, int &i_right,
                                       int &j_bottom, int &j_top) const {
-  i_left = (int)floor((X - m_impl->x[0])/m_impl->dx);
-  j_bottom = (int)floor((Y - m_impl->y[0])/m_impl->dy);
+  if (m_impl->uniform) {
+    i_left = (int)floor((X - m_impl->x[0])/m_impl->dx);
+    j_bottom = (int)floor((Y - m_impl->y[0])/m_impl->dy);
+  } else {
+    // index of the last grid point to the left of (below) X (Y), or -1
+    auto &x = m_impl->x;
+    auto &y = m_impl->y;
+    i_left = (int)(std::upper_bound(x.begin(), x.end(), X) - x.begin()) - 1;
+    j_bottom = (int)(std::upper_bound(y.begin(), y.end(), Y) - y.begin()) - 1;
+  }
 
   i_right = i_left + 1;
   j_top = j_bottom + 1;
@@ -980,10 +1082,61 @@ double IceGrid::dy() const {
   return m_impl->dy;
 }
 
+//! Cell area (the smallest one on non-uniform grids; see cell_area(int, int)).
 double IceGrid::cell_area() const {
   return m_impl->cell_area;
 }
 
+//! Returns `true` if the grid is equally spaced in both X and Y directions.
+/*!
+ * On non-uniform grids dx() and dy() return the smallest distances between grid points.
+ * Finite difference code should use spacing_x(), spacing_y(), cell_width(), cell_height()
+ * and cell_area(int, int) instead.
+ */
+bool IceGrid::uniform() const {
+  return m_impl->uniform;
+}
+
+//! Map the index `k` (possibly one of a ghost point) to `[0, M - 1]`.
+static inline int grid_index(int k, int M, bool periodic) {
+  if (periodic) {
+    return (k % M + M) % M;
+  }
+  return std::min(std::max(k, 0), M - 1);
+}
+
+//! Distance between grid points `i` and `i + 1` in the X direction.
+/*!
+ * Accepts indexes of ghost points. Outside of the domain of a non-periodic grid the
+ * spacing of the nearest interval at the edge of the domain is used.
+ */
+double IceGrid::spacing_x(int i) const {
+  return m_impl->spacing_x[grid_index(i, m_impl->Mx, m_impl->periodicity & X_PERIODIC)];
+}
+
+//! Distance between grid points `j` and `j + 1` in the Y direction. See spacing_x().
+double IceGrid::spacing_y(int j) const {
+  return m_impl->spacing_y[grid_index(j, m_impl->My, m_impl->periodicity & Y_PERIODIC)];
+}
+
+//! Width of the cell containing the grid point `i` (distance between cell interfaces).
+double IceGrid::cell_width(int i) const {
+  return m_impl->cell_width[grid_index(i, m_impl->Mx, m_impl->periodicity & X_PERIODIC)];
+}
+
+//! Height of the cell containing the grid point `j` (distance between cell interfaces).
+double IceGrid::cell_height(int j) const {
+  return m_impl->cell_height[grid_index(j, m_impl->My, m_impl->periodicity & Y_PERIODIC)];
+}
+
+//! Area of the cell containing the grid point `(i, j)`.
+double IceGrid::cell_area(int i, int j) const {
+  if (m_impl->uniform) {
+    return m_impl->cell_area;
+  }
+  return cell_width(i) * cell_height(j);
+}
+
 //! Minimum vertical spacing.
 double IceGrid::dz_min() const {
   double result = m_impl->z.back();
@@ -1034,6 +1187,36 @@ double radius(const IceGrid &grid, int i, int j) {
   return sqrt(grid.x(i) * grid.x(i) + grid.y(j) * grid.y(j));
 }
 
+/*!
+ * Stop with an error message if `grid` is not uniform.
+ *
+ * Used by components that do not support non-uniform grids yet.
+ */
+void require_uniform_grid(const IceGrid &grid, const std::string &component) {
+  if (not grid.uniform()) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "%s does not support non-uniform grids",
+                                  component.c_str());
+  }
+}
+
+//! Returns `true` if `coords` are equally spaced (up to round-off in an input file).
+static bool equally_spaced(const std::vector<double> &coords) {
+  const size_t M = coords.size();
+  if (M < 3) {
+    return true;
+  }
+
+  const double delta = (coords[M - 1] - coords[0]) / (M - 1);
+
+  for (size_t k = 0; k < M - 1; ++k) {
+    if (fabs((coords[k + 1] - coords[k]) - delta) > 1e-3 * fabs(delta)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 // grid_info
 
 void grid_info::reset() {
@@ -1122,6 +1305,15 @@ grid_info::grid_info(const File &file, const std::string &variable,
           if (r == CELL_CENTER) {
             const double dx = this->x[1] - this->x[0];
             this->Lx += 0.5 * dx;
+
+            if (not equally_spaced(this->x)) {
+              // the domain extends half of the last spacing beyond the last point
+              const double
+                dx_last    = this->x[x_len - 1] - this->x[x_len - 2],
+                correction = 0.25 * (dx_last - dx);
+              this->x0 += correction;
+              this->Lx += correction;
+            }
           }
           break;
         }
@@ -1137,6 +1329,15 @@ grid_info::grid_info(const File &file, const std::string &variable,
           if (r == CELL_CENTER) {
             const double dy = this->y[1] - this->y[0];
             this->Ly += 0.5 * dy;
+
+            if (not equally_spaced(this->y)) {
+              // the domain extends half of the last spacing beyond the last point
+              const double
+                dy_last    = this->y[y_len - 1] - this->y[y_len - 2],
+                correction = 0.25 * (dy_last - dy);
+              this->y0 += correction;
+              this->Ly += correction;
+            }
           }
           break;
         }
@@ -1237,6 +1438,24 @@ void GridParameters::init_from_file(Context::ConstPtr ctx,
   My = input_grid.y_len;
   registration = r;
   z = input_grid.z;
+
+  if (ctx->config()->get_flag("grid.nonuniform")) {
+    // use input coordinates as is unless they are equally spaced
+    x = equally_spaced(input_grid.x) ? std::vector<double>{} : input_grid.x;
+    y = equally_spaced(input_grid.y) ? std::vector<double>{} : input_grid.y;
+  }
+
+  // 3D variables may be saved on a subset of vertical levels (see output.ice_levels). Use
+  // the full vertical grid in this case.
+  auto var = file.find_variable(variable_name, variable_name);
+  for (auto d : file.dimensions(var.name)) {
+    if (file.dimension_type(d, ctx->unit_system()) == Z_AXIS) {
+      auto full_grid = file.read_text_attribute(d, "subset_of");
+      if (not full_grid.empty()) {
+        z = file.read_dimension(full_grid);
+      }
+    }
+  }
 }
 
 GridParameters::GridParameters(Context::ConstPtr ctx,
@@ -1258,9 +1477,23 @@ GridParameters::GridParameters(Context::ConstPtr ctx,
 void GridParameters::horizontal_size_from_options() {
   Mx = options::Integer("-Mx", "grid size in X direction", Mx);
   My = options::Integer("-My", "grid size in Y direction", My);
+
+  // non-uniform coordinates cannot be used with a different grid size
+  if (x.size() != Mx) {
+    x.clear();
+  }
+  if (y.size() != My) {
+    y.clear();
+  }
 }
 
 void GridParameters::horizontal_extent_from_options() {
+  const double
+    Lx_input = Lx,
+    Ly_input = Ly,
+    x0_input = x0,
+    y0_input = y0;
+
   // Domain size
   {
     Lx = 1000.0 * options::Real("-Lx", "Half of the grid extent in the Y direction, in km",
@@ -1284,6 +1517,14 @@ void GridParameters::horizontal_extent_from_options() {
       Ly = (y_range[1] - y_range[0]) / 2.0;
     }
   }
+
+  // non-uniform coordinates cannot be used with a different domain
+  if (Lx != Lx_input or x0 != x0_input) {
+    x.clear();
+  }
+  if (Ly != Ly_input or y0 != y0_input) {
+    y.clear();
+  }
 }
 
 void GridParameters::vertical_grid_from_options(Config::ConstPtr config) {
@@ -1324,6 +1565,16 @@ void GridParameters::validate() const {
     throw RuntimeError::formatted(PISM_ERROR_LOCATION, "last z level is negative: %f", z.back());
   }
 
+  if (not x.empty() and (x.size() != Mx or not is_increasing(x))) {
+    throw RuntimeError(PISM_ERROR_LOCATION,
+                       "x coordinates of a non-uniform grid have to be increasing; their number has to be Mx");
+  }
+
+  if (not y.empty() and (y.size() != My or not is_increasing(y))) {
+    throw RuntimeError(PISM_ERROR_LOCATION,
+                       "y coordinates of a non-uniform grid have to be increasing; their number has to be My");
+  }
+
   if (std::accumulate(procs_x.begin(), procs_x.end(), 0.0) != Mx) {
     throw RuntimeError(PISM_ERROR_LOCATION, "procs_x don't sum up to Mx");
   }
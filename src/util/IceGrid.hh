@@ -1,4 +1,4 @@
-// Copyright (C) 2004-2019 Jed Brown, Ed Bueler and Constantine Khroulev
+// Copyright (C) 2004-2020 Jed Brown, Ed Bueler and Constantine Khroulev
 //
 // This file is part of PISM.
 //
@@ -86,6 +86,9 @@ private:
    are called *or* all data members (`Lx`, `Ly`, `x0`, `y0`, `Mx`, `My`, `z`, `periodicity`,
    `procs_x`, `procs_y`) are set manually before using an instance of GridParameters.
 
+   Set `x` and `y` to use a non-uniform (stretched) grid. `Lx`, `Ly`, `x0`, `y0` still have
+   to describe the domain containing these points.
+
    Call `validate()` to check current parameters.
 */
 class GridParameters {
@@ -137,6 +140,10 @@ public:
   Periodicity periodicity;
   //! Vertical levels.
   std::vector<double> z;
+  //! X coordinates of a non-uniform grid (empty if the grid is uniform in X).
+  std::vector<double> x;
+  //! Y coordinates of a non-uniform grid (empty if the grid is uniform in Y).
+  std::vector<double> y;
   //! Processor ownership ranges in the X direction.
   std::vector<unsigned int> procs_x;
   //! Processor ownership ranges in the Y direction.
@@ -166,7 +173,8 @@ private:
 
   Computational grids PISM can use are
   - rectangular,
-  - equally spaced in the horizintal (X and Y) directions,
+  - equally spaced in the horizintal (X and Y) directions by default; tensor-product
+  non-uniform (stretched) grids are supported, too (see uniform()),
   - distributed across processors in horizontal dimensions only (every column
   is stored on one processor only),
   - are periodic in both X and Y directions (in the topological sence).
@@ -268,6 +276,13 @@ public:
   double dy() const;
   double cell_area() const;
 
+  bool uniform() const;
+  double spacing_x(int i) const;
+  double spacing_y(int j) const;
+  double cell_width(int i) const;
+  double cell_height(int j) const;
+  double cell_area(int i, int j) const;
+
   unsigned int Mx() const;
   unsigned int My() const;
   unsigned int Mz() const;
@@ -316,6 +331,8 @@ private:
 
 double radius(const IceGrid &grid, int i, int j);
 
+void require_uniform_grid(const IceGrid &grid, const std::string &component);
+
 //! @brief Check if a point `(i,j)` is in the strip of `stripwidth`
 //! meters around the edge of the computational domain.
 inline bool in_null_strip(const IceGrid& grid, int i, int j, double strip_width) {
@@ -0,0 +1,152 @@
+/* Copyright (C) 2020 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <algorithm>            // std::min
+#include <climits>              // INT_MAX
+
+#include "NodeSharedArray.hh"
+
+#include "pism/util/error_handling.hh"
+
+namespace pism {
+
+/*!
+ * Allocate an array of `size` doubles shared by all ranks on a node.
+ *
+ * This is a collective operation on `com`.
+ */
+NodeSharedArray::NodeSharedArray(MPI_Comm com, size_t size)
+  : m_com(com),
+    m_node_com(MPI_COMM_NULL),
+    m_leaders_com(MPI_COMM_NULL),
+    m_window(MPI_WIN_NULL),
+    m_data(nullptr),
+    m_size(size) {
+
+  MPI_Comm_rank(m_com, &m_rank);
+
+  // Use m_rank as the key to make sure that rank 0 in m_com is the first rank on its node
+  // and has rank 0 in m_leaders_com.
+  MPI_Comm_split_type(m_com, MPI_COMM_TYPE_SHARED, m_rank, MPI_INFO_NULL, &m_node_com);
+
+  MPI_Comm_rank(m_node_com, &m_node_rank);
+  MPI_Comm_size(m_node_com, &m_node_size);
+
+  MPI_Comm_split(m_com, m_node_rank == 0 ? 0 : MPI_UNDEFINED, m_rank, &m_leaders_com);
+
+  // the first rank on a node allocates all the storage
+  MPI_Aint local_size = m_node_rank == 0 ? m_size * sizeof(double) : 0;
+
+  int stat = MPI_Win_allocate_shared(local_size, sizeof(double), MPI_INFO_NULL,
+                                     m_node_com, &m_data, &m_window);
+  if (stat != MPI_SUCCESS) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "failed to allocate a shared array of %d doubles",
+                                  (int)m_size);
+  }
+
+  if (m_node_rank != 0) {
+    MPI_Aint segment_size = 0;
+    int displacement_unit = 0;
+    MPI_Win_shared_query(m_window, 0, &segment_size, &displacement_unit, &m_data);
+  }
+
+  // start the first access epoch
+  MPI_Win_fence(0, m_window);
+}
+
+NodeSharedArray::~NodeSharedArray() {
+  if (m_window != MPI_WIN_NULL) {
+    MPI_Win_free(&m_window);
+  }
+
+  if (m_leaders_com != MPI_COMM_NULL) {
+    MPI_Comm_free(&m_leaders_com);
+  }
+
+  if (m_node_com != MPI_COMM_NULL) {
+    MPI_Comm_free(&m_node_com);
+  }
+}
+
+double* NodeSharedArray::data() {
+  return m_data;
+}
+
+const double* NodeSharedArray::data() const {
+  return m_data;
+}
+
+size_t NodeSharedArray::size() const {
+  return m_size;
+}
+
+//! Rank in the communicator used to create this array.
+int NodeSharedArray::rank() const {
+  return m_rank;
+}
+
+//! Rank within the node.
+int NodeSharedArray::node_rank() const {
+  return m_node_rank;
+}
+
+//! Number of ranks on this node.
+int NodeSharedArray::node_size() const {
+  return m_node_size;
+}
+
+/*!
+ * Make changes made by any rank on a node visible to all ranks on this node.
+ *
+ * This is a collective operation on ranks of a node (but it is usually called by all
+ * ranks).
+ */
+void NodeSharedArray::sync() {
+  MPI_Win_fence(0, m_window);
+}
+
+/*!
+ * Copy the contents of the array on rank 0 to all other nodes, then synchronize.
+ *
+ * Collective on the communicator used to create this array.
+ */
+void NodeSharedArray::broadcast() {
+  // make sure that data written on rank 0's node are visible before sending
+  sync();
+
+  if (m_leaders_com != MPI_COMM_NULL) {
+    int leaders_size = 0;
+    MPI_Comm_size(m_leaders_com, &leaders_size);
+
+    if (leaders_size > 1) {
+      // broadcast in chunks to support arrays with more than INT_MAX elements
+      size_t start = 0;
+      while (start < m_size) {
+        int count = std::min(m_size - start, (size_t)INT_MAX);
+        MPI_Bcast(m_data + start, count, MPI_DOUBLE, 0, m_leaders_com);
+        start += count;
+      }
+    }
+  }
+
+  sync();
+}
+
+} // end of namespace pism
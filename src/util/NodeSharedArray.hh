@@ -0,0 +1,89 @@
+/* Copyright (C) 2020 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef PISM_NODESHAREDARRAY_H
+#define PISM_NODESHAREDARRAY_H
+
+#include <cstddef>              // size_t
+#include <mpi.h>
+
+namespace pism {
+
+//! An array of doubles stored once per (shared memory) node.
+/*!
+ * Uses an MPI-3 shared memory window: the first rank on each node allocates storage and
+ * all ranks on the same node access it directly.
+ *
+ * Use this to replace whole-domain arrays stored on rank 0 (or replicated on all ranks).
+ * Storage on rank 0's node is allocated once instead of once per rank, and all ranks on a
+ * node can work with the array in parallel.
+ *
+ * Typical use:
+ *
+ * ~~~
+ * NodeSharedArray A(com, N);
+ * if (A.rank() == 0) {
+ *   // fill A.data() on rank 0
+ * }
+ * A.broadcast();               // copy to other nodes and synchronize
+ * // read A.data() on all ranks
+ * ~~~
+ *
+ * Ranks writing to an array have to call sync() before other ranks on the same node can
+ * read what was written.
+ */
+class NodeSharedArray {
+public:
+  NodeSharedArray(MPI_Comm com, size_t size);
+  ~NodeSharedArray();
+
+  double* data();
+  const double* data() const;
+  size_t size() const;
+
+  int rank() const;
+  int node_rank() const;
+  int node_size() const;
+
+  void sync();
+  void broadcast();
+private:
+  // disable copying
+  NodeSharedArray(const NodeSharedArray &);
+  NodeSharedArray& operator=(const NodeSharedArray &);
+
+  //! communicator used to create this array
+  MPI_Comm m_com;
+  //! communicator containing ranks on the same node
+  MPI_Comm m_node_com;
+  //! communicator containing the first rank on each node (MPI_COMM_NULL on other ranks)
+  MPI_Comm m_leaders_com;
+  MPI_Win m_window;
+
+  int m_rank;
+  int m_node_rank;
+  int m_node_size;
+
+  double *m_data;
+  size_t m_size;
+};
+
+} // end of namespace pism
+
+#endif /* PISM_NODESHAREDARRAY_H */
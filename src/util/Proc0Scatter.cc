@@ -0,0 +1,183 @@
+/* Copyright (C) 2020 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "Proc0Scatter.hh"
+
+#include "pism/util/iceModelVec.hh"
+#include "pism/util/Profiling.hh"
+#include "pism/util/error_handling.hh"
+
+namespace pism {
+
+/*!
+ * Allocate storage used to move `n_fields` fields on `grid` to and from rank 0.
+ *
+ * Collective on the communicator of `grid`.
+ */
+Proc0Scatter::Proc0Scatter(IceGrid::ConstPtr grid, unsigned int n_fields)
+  : m_grid(grid),
+    m_n_fields(n_fields),
+    m_get_in_progress(false) {
+
+  if (n_fields == 0) {
+    throw RuntimeError(PISM_ERROR_LOCATION, "Proc0Scatter needs at least one field");
+  }
+
+  m_da = m_grid->get_dm(n_fields, 0);
+
+  PetscErrorCode ierr = DMCreateGlobalVector(*m_da, m_global.rawptr());
+  PISM_CHK(ierr, "DMCreateGlobalVector");
+
+  ierr = DMDACreateNaturalVector(*m_da, m_natural.rawptr());
+  PISM_CHK(ierr, "DMDACreateNaturalVector");
+
+  ierr = VecScatterCreateToZero(m_natural, m_scatter.rawptr(), m_proc0.rawptr());
+  PISM_CHK(ierr, "VecScatterCreateToZero");
+}
+
+Proc0Scatter::~Proc0Scatter() {
+  if (m_get_in_progress) {
+    // finish the scatter to make sure that all messages are received
+    VecScatterEnd(m_scatter, m_proc0, m_natural, INSERT_VALUES, SCATTER_REVERSE);
+  }
+}
+
+void Proc0Scatter::check(size_t n) const {
+  if (n != m_n_fields) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "expected %d fields, got %d",
+                                  (int)m_n_fields, (int)n);
+  }
+}
+
+/*!
+ * Start moving `proc0` (one rank 0 copy per field) from rank 0. Rank 0 copies can be
+ * modified as soon as this call returns.
+ *
+ * Collective.
+ */
+void Proc0Scatter::get_begin(const std::vector<Vec> &proc0) {
+  check(proc0.size());
+
+  if (m_get_in_progress) {
+    throw RuntimeError(PISM_ERROR_LOCATION, "call get_end() before calling get_begin() again");
+  }
+
+  const Profiling &profiling = m_grid->ctx()->profiling();
+  profiling.begin("proc0.get_begin");
+
+  const unsigned int N = m_n_fields;
+
+  // pack on rank 0
+  if (m_grid->rank() == 0) {
+    const size_t size = m_grid->Mx() * m_grid->My();
+
+    petsc::VecArray packed(m_proc0);
+    double *p = packed.get();
+
+    for (unsigned int k = 0; k < N; ++k) {
+      petsc::VecArray input(proc0[k]);
+      const double *data = input.get();
+
+      for (size_t n = 0; n < size; ++n) {
+        p[n * N + k] = data[n];
+      }
+    }
+  }
+
+  PetscErrorCode ierr = VecScatterBegin(m_scatter, m_proc0, m_natural,
+                                        INSERT_VALUES, SCATTER_REVERSE);
+  PISM_CHK(ierr, "VecScatterBegin");
+
+  m_get_in_progress = true;
+
+  profiling.end("proc0.get_begin");
+}
+
+/*!
+ * Finish moving fields from rank 0 (see get_begin()) and store them in `fields`.
+ *
+ * Collective.
+ */
+void Proc0Scatter::get_end(const std::vector<IceModelVec2S*> &fields) {
+  check(fields.size());
+
+  if (not m_get_in_progress) {
+    throw RuntimeError(PISM_ERROR_LOCATION, "call get_begin() before calling get_end()");
+  }
+
+  const Profiling &profiling = m_grid->ctx()->profiling();
+  profiling.begin("proc0.get_end");
+
+  m_get_in_progress = false;
+
+  PetscErrorCode ierr = VecScatterEnd(m_scatter, m_proc0, m_natural,
+                                      INSERT_VALUES, SCATTER_REVERSE);
+  PISM_CHK(ierr, "VecScatterEnd");
+
+  ierr = DMDANaturalToGlobalBegin(*m_da, m_natural, INSERT_VALUES, m_global);
+  PISM_CHK(ierr, "DMDANaturalToGlobalBegin");
+
+  ierr = DMDANaturalToGlobalEnd(*m_da, m_natural, INSERT_VALUES, m_global);
+  PISM_CHK(ierr, "DMDANaturalToGlobalEnd");
+
+  // unpack
+  {
+    const unsigned int N = m_n_fields;
+    const int
+      xs = m_grid->xs(),
+      xm = m_grid->xm(),
+      ys = m_grid->ys();
+
+    IceModelVec::AccessList list;
+    for (auto f : fields) {
+      list.add(*f);
+    }
+
+    petsc::VecArray packed(m_global);
+    const double *p = packed.get();
+
+    for (Points q(*m_grid); q; q.next()) {
+      const int i = q.i(), j = q.j();
+
+      const double *column = p + ((j - ys) * xm + (i - xs)) * N;
+      for (unsigned int k = 0; k < N; ++k) {
+        (*fields[k])(i, j) = column[k];
+      }
+    }
+  }
+
+  for (auto f : fields) {
+    if (f->stencil_width() > 0) {
+      f->update_ghosts();
+    }
+    f->inc_state_counter();     // mark as modified
+  }
+
+  profiling.end("proc0.get_end");
+}
+
+//! Copy `proc0` (one rank 0 copy per field) to `fields`. Collective.
+void Proc0Scatter::get(const std::vector<Vec> &proc0,
+                       const std::vector<IceModelVec2S*> &fields) {
+  get_begin(proc0);
+  get_end(fields);
+}
+
+} // end of namespace pism
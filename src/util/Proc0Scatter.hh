@@ -0,0 +1,80 @@
+/* Copyright (C) 2020 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef PISM_PROC0SCATTER_H
+#define PISM_PROC0SCATTER_H
+
+#include <vector>
+
+#include "pism/util/IceGrid.hh"
+#include "pism/util/petscwrappers/Vec.hh"
+#include "pism/util/petscwrappers/VecScatter.hh"
+
+namespace pism {
+
+class IceModelVec2S;
+
+//! Moves several 2D fields defined on the same grid from rank 0 using one scatter.
+/*!
+ * This is a multi-field version of IceModelVec::get_from_proc0(). Fields are packed into
+ * one vector with `n_fields` degrees of freedom, so all of them are moved using one
+ * scatter and one natural-to-global conversion.
+ *
+ * Rank 0 copies use natural ordering and have to be allocated using
+ * IceModelVec::allocate_proc0_copy().
+ *
+ * Moving fields from rank 0 is split into get_begin() and get_end() so that rank 0 can
+ * compute the next set of fields while this one is in transit.
+ *
+ * The time spent in these calls is reported by PETSc's profiling tools (events
+ * "proc0.get_begin" and "proc0.get_end").
+ */
+class Proc0Scatter {
+public:
+  Proc0Scatter(IceGrid::ConstPtr grid, unsigned int n_fields);
+  ~Proc0Scatter();
+
+  void get(const std::vector<Vec> &proc0,
+           const std::vector<IceModelVec2S*> &fields);
+
+  void get_begin(const std::vector<Vec> &proc0);
+  void get_end(const std::vector<IceModelVec2S*> &fields);
+private:
+  void check(size_t n) const;
+
+  IceGrid::ConstPtr m_grid;
+  unsigned int m_n_fields;
+
+  //! DM with `m_n_fields` degrees of freedom per grid point
+  petsc::DM::Ptr m_da;
+  //! packed fields (PETSc ordering)
+  petsc::Vec m_global;
+  //! packed fields (natural ordering)
+  petsc::Vec m_natural;
+  //! packed fields on rank 0 (natural ordering)
+  petsc::Vec m_proc0;
+  petsc::VecScatter m_scatter;
+
+  //! true between get_begin() and get_end()
+  bool m_get_in_progress;
+};
+
+} // end of namespace pism
+
+#endif /* PISM_PROC0SCATTER_H */
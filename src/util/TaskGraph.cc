@@ -0,0 +1,206 @@
+/* Copyright (C) 2020 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "TaskGraph.hh"
+
+#include "pism/util/Logger.hh"
+#include "pism/util/error_handling.hh"
+#include "pism/util/pism_utilities.hh" // get_time()
+
+namespace pism {
+
+TaskGraph::TaskGraph()
+  : m_total_time(0.0),
+    m_enabled(false) {
+  m_critical_path.length = 0.0;
+}
+
+//! Add a task reading fields `inputs` and writing fields `outputs`.
+void TaskGraph::add_task(const std::string &name,
+                         const std::vector<std::string> &inputs,
+                         const std::vector<std::string> &outputs) {
+  if (m_task_index.find(name) != m_task_index.end()) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION, "task '%s' is already defined",
+                                  name.c_str());
+  }
+
+  Task task;
+  task.count = 0;
+  task.time  = 0.0;
+  task.start = 0.0;
+
+  for (const auto &f : inputs) {
+    task.inputs.push_back(field_index(f));
+  }
+
+  for (const auto &f : outputs) {
+    task.outputs.push_back(field_index(f));
+  }
+
+  m_task_index[name] = m_tasks.size();
+  m_task_names.push_back(name);
+  m_tasks.push_back(task);
+}
+
+int TaskGraph::task_index(const std::string &name) const {
+  auto j = m_task_index.find(name);
+  if (j == m_task_index.end()) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION, "task '%s' is not defined",
+                                  name.c_str());
+  }
+  return j->second;
+}
+
+int TaskGraph::field_index(const std::string &name) {
+  auto j = m_field_index.find(name);
+  if (j != m_field_index.end()) {
+    return j->second;
+  }
+
+  Field f;
+  f.written.length = 0.0;
+  f.read.length    = 0.0;
+
+  int result = m_fields.size();
+  m_field_index[name] = result;
+  m_fields.push_back(f);
+
+  return result;
+}
+
+//! Enable or disable timing. The graph is disabled by default.
+void TaskGraph::enable(bool flag) {
+  m_enabled = flag;
+}
+
+void TaskGraph::begin(const std::string &name) {
+  if (not m_enabled) {
+    return;
+  }
+
+  m_tasks[task_index(name)].start = get_time();
+}
+
+void TaskGraph::end(const std::string &name) {
+  if (not m_enabled) {
+    return;
+  }
+
+  record(name, get_time() - m_tasks[task_index(name)].start);
+}
+
+/*!
+ * Record a run of the task `name` that took `duration` seconds and update the critical
+ * path.
+ *
+ * Called by end(); can be used to build a graph with given durations (e.g. in tests).
+ */
+void TaskGraph::record(const std::string &name, double duration) {
+  int k = task_index(name);
+  Task &task = m_tasks[k];
+
+  task.count += 1;
+  task.time  += duration;
+  m_total_time += duration;
+
+  // find the longest path this task has to wait for
+  const Path *longest = nullptr;
+  for (int j : task.inputs) {
+    const Path &p = m_fields[j].written;
+    if (longest == nullptr or p.length > longest->length) {
+      longest = &p;
+    }
+  }
+  for (int j : task.outputs) {
+    for (const Path *p : {&m_fields[j].written, &m_fields[j].read}) {
+      if (longest == nullptr or p->length > longest->length) {
+        longest = p;
+      }
+    }
+  }
+
+  Path path;
+  path.length = duration;
+  path.contributions.resize(m_tasks.size(), 0.0);
+  if (longest != nullptr) {
+    path.length += longest->length;
+    for (size_t n = 0; n < longest->contributions.size(); ++n) {
+      path.contributions[n] = longest->contributions[n];
+    }
+  }
+  path.contributions[k] += duration;
+
+  for (int j : task.inputs) {
+    if (path.length > m_fields[j].read.length) {
+      m_fields[j].read = path;
+    }
+  }
+
+  for (int j : task.outputs) {
+    m_fields[j].written = path;
+    m_fields[j].read    = path;
+  }
+
+  if (path.length > m_critical_path.length) {
+    m_critical_path = path;
+  }
+}
+
+//! Total time spent in all tasks.
+double TaskGraph::total_time() const {
+  return m_total_time;
+}
+
+//! Length of the critical path.
+double TaskGraph::critical_path_length() const {
+  return m_critical_path.length;
+}
+
+//! Time each task contributes to the critical path (in the order tasks were added).
+std::vector<double> TaskGraph::critical_path() const {
+  std::vector<double> result(m_tasks.size(), 0.0);
+  for (size_t k = 0; k < m_critical_path.contributions.size(); ++k) {
+    result[k] = m_critical_path.contributions[k];
+  }
+  return result;
+}
+
+//! Report time spent in tasks and the critical path.
+void TaskGraph::report(const Logger &log) const {
+  double speedup = m_critical_path.length > 0.0 ? m_total_time / m_critical_path.length : 1.0;
+
+  log.message(2,
+              "Task graph report:\n"
+              "  time spent in tasks:         %f s\n"
+              "  length of the critical path: %f s\n"
+              "  achievable speedup:          %f\n"
+              "  %-25s %10s %15s %20s\n",
+              m_total_time, m_critical_path.length, speedup,
+              "task", "calls", "time (s)", "critical path (s)");
+
+  for (size_t k = 0; k < m_tasks.size(); ++k) {
+    double critical = (k < m_critical_path.contributions.size() ?
+                       m_critical_path.contributions[k] : 0.0);
+
+    log.message(2, "  %-25s %10u %15f %20f\n",
+                m_task_names[k].c_str(), m_tasks[k].count, m_tasks[k].time, critical);
+  }
+}
+
+} // end of namespace pism
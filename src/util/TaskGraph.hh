@@ -0,0 +1,131 @@
+/* Copyright (C) 2020 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef PISM_TASKGRAPH_H
+#define PISM_TASKGRAPH_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace pism {
+
+class Logger;
+
+//! Data dependencies between parts of a time step and the resulting critical path.
+/*!
+ * Each task declares fields it reads and writes. Tasks are run in program order (so
+ * results are not affected), but every time a task ends the graph computes the earliest
+ * time it could have finished if all tasks were started as soon as their inputs were
+ * ready:
+ *
+ * - a task has to wait for the last task writing one of its inputs or outputs, and
+ * - a task has to wait for all the tasks reading one of its outputs (since the last write).
+ *
+ * Dependencies are tracked across time steps, so a task can "overlap" with the next time
+ * step if nothing in it depends on this task.
+ *
+ * The ratio of the total time spent in tasks to the length of the critical path is the
+ * speedup achievable by running independent tasks concurrently.
+ *
+ * This class does *not* run tasks concurrently: all parts of a PISM time step use
+ * collective MPI calls on the same communicator and PETSc objects that are not thread
+ * safe, so they cannot run on separate threads without changing how these components are
+ * parallelized. Use the report to decide if this is worth it.
+ *
+ * The graph is disabled by default: begin() and end() do nothing until enable() is called.
+ *
+ * Usage:
+ *
+ * ~~~
+ * graph.add_task("surface", {"geometry"}, {"surface"});
+ * ...
+ * graph.begin("surface");
+ * surface->update(...);
+ * graph.end("surface");
+ * ~~~
+ */
+class TaskGraph {
+public:
+  TaskGraph();
+
+  void add_task(const std::string &name,
+                const std::vector<std::string> &inputs,
+                const std::vector<std::string> &outputs);
+
+  void enable(bool flag);
+
+  void begin(const std::string &name);
+  void end(const std::string &name);
+
+  void record(const std::string &name, double duration);
+
+  double total_time() const;
+  double critical_path_length() const;
+  std::vector<double> critical_path() const;
+
+  void report(const Logger &log) const;
+private:
+  struct Task {
+    std::vector<int> inputs;
+    std::vector<int> outputs;
+    //! number of times this task was run
+    unsigned int count;
+    //! total wall-clock time spent in this task
+    double time;
+    //! time of the last call to begin()
+    double start;
+  };
+
+  //! Earliest finish time of a task and contributions of tasks on the path leading to it.
+  struct Path {
+    double length;
+    std::vector<double> contributions;
+  };
+
+  struct Field {
+    //! the path ending with the last write
+    Path written;
+    //! the longest path ending with a read (since the last write)
+    Path read;
+  };
+
+  int task_index(const std::string &name) const;
+  int field_index(const std::string &name);
+
+  std::map<std::string, int> m_task_index;
+  std::vector<std::string> m_task_names;
+  std::vector<Task> m_tasks;
+
+  std::map<std::string, int> m_field_index;
+  std::vector<Field> m_fields;
+
+  //! the longest path so far
+  Path m_critical_path;
+
+  //! total time spent in all tasks
+  double m_total_time;
+
+  //! true if begin() and end() record timing information
+  bool m_enabled;
+};
+
+} // end of namespace pism
+
+#endif /* PISM_TASKGRAPH_H */
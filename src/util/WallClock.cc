@@ -0,0 +1,57 @@
+/* Copyright (C) 2020 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "WallClock.hh"
+
+#include "pism/util/pism_utilities.hh" // get_time()
+
+namespace pism {
+
+/*!
+ * Synchronize the local clock with the clock on rank 0.
+ *
+ * Collective on `com`.
+ */
+WallClock::WallClock(MPI_Comm com)
+  : m_offset(0.0) {
+
+  int rank = 0;
+  MPI_Comm_rank(com, &rank);
+
+  // Make sure that all ranks are ready to receive so that the time spent waiting is not
+  // included in the offset.
+  MPI_Barrier(com);
+
+  double rank0_time = rank == 0 ? get_time() : 0.0;
+  MPI_Bcast(&rank0_time, 1, MPI_DOUBLE, 0, com);
+
+  m_offset = rank0_time - get_time();
+}
+
+//! Wall clock time in seconds (using the clock on rank 0). Does not communicate.
+double WallClock::time() const {
+  return get_time() + m_offset;
+}
+
+//! Number of hours since `start` (in seconds, see time()). Does not communicate.
+double WallClock::hours_since(double start) const {
+  return (time() - start) / 3600.0;
+}
+
+} // end of namespace pism
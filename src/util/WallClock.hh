@@ -0,0 +1,51 @@
+/* Copyright (C) 2020 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef PISM_WALLCLOCK_H
+#define PISM_WALLCLOCK_H
+
+#include <mpi.h>
+
+namespace pism {
+
+//! Wall clock time synchronized with rank 0 that can be read without communication.
+/*!
+ * The constructor (collective) measures the offset between the local clock and the clock
+ * on rank 0. After that time() reads the local clock only, so it can be called every time
+ * step without making ranks wait for each other.
+ *
+ * Values returned on different ranks may differ slightly (by the latency of the broadcast
+ * used to synchronize clocks, plus clock drift). Decisions that have to agree across ranks
+ * should use a value that was reduced together with some other quantity (see
+ * CFLData::wall_clock_time).
+ */
+class WallClock {
+public:
+  WallClock(MPI_Comm com);
+
+  double time() const;
+  double hours_since(double start) const;
+private:
+  //! difference between the clock on rank 0 and the local clock, in seconds
+  double m_offset;
+};
+
+} // end of namespace pism
+
+#endif /* PISM_WALLCLOCK_H */
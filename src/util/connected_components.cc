@@ -1,4 +1,4 @@
-/* Copyright (C) 2013, 2014, 2016 PISM Authors
+/* Copyright (C) 2013, 2014, 2016, 2020 PISM Authors
  *
  * This file is part of PISM.
  *
@@ -19,6 +19,106 @@
 
 #include <vector>
 #include <cmath>
+#include <cstdint>
+#include <algorithm>
+
+namespace {
+
+/*!
+ * Compact (one bit per pixel) storage for a row of a mask.
+ *
+ * Labeling works with one row at a time, so converting the current row of the image into
+ * a bitset lets us find runs using word-sized operations instead of a branch per pixel.
+ */
+typedef uint64_t Word;
+const unsigned int word_bits = 64;
+
+//! Index of the least significant set bit in `word`, which has to be non-zero.
+inline unsigned int first_set_bit(Word word) {
+#if defined(__GNUC__)
+  return __builtin_ctzll(word);
+#else
+  unsigned int k = 0;
+  while ((word & 1) == 0) {
+    word >>= 1;
+    k += 1;
+  }
+  return k;
+#endif
+}
+
+//! Convert a row of the image into "foreground" and "grounded" bitsets.
+/*!
+ * The inner loop has no branches, so compilers can vectorize comparisons.
+ */
+void pack_row(const double *row, unsigned int n_cols, double mask_grounded,
+              std::vector<Word> &foreground, std::vector<Word> &grounded) {
+  const double eps = 1e-6;
+
+  for (unsigned int w = 0; w < foreground.size(); ++w) {
+    const unsigned int
+      start = w * word_bits,
+      n     = std::min(word_bits, n_cols - start);
+
+    Word F = 0, G = 0;
+    for (unsigned int k = 0; k < n; ++k) {
+      const double v = row[start + k];
+      F |= Word(v > 0.0) << k;
+      G |= Word(std::fabs(v - mask_grounded) < eps) << k;
+    }
+    foreground[w] = F;
+    grounded[w]   = G & F;
+  }
+}
+
+//! Find the first bit at or after `start` that is set (if `set` is true) or not set.
+/*!
+ * Returns `n_bits` if there is no such bit.
+ */
+unsigned int find_next(const std::vector<Word> &bits, unsigned int start,
+                       unsigned int n_bits, bool set) {
+  if (start >= n_bits) {
+    return n_bits;
+  }
+
+  const Word flip = set ? Word(0) : ~Word(0);
+
+  unsigned int w = start / word_bits;
+  Word word = (bits[w] ^ flip) & (~Word(0) << (start % word_bits));
+
+  while (word == 0) {
+    w += 1;
+    if (w == bits.size()) {
+      return n_bits;
+    }
+    word = bits[w] ^ flip;
+  }
+
+  return std::min(w * word_bits + first_set_bit(word), n_bits);
+}
+
+//! Returns true if at least one bit in `[begin, end)` is set.
+bool any_set(const std::vector<Word> &bits, unsigned int begin, unsigned int end) {
+  const unsigned int
+    first = begin / word_bits,
+    last  = (end - 1) / word_bits;
+
+  for (unsigned int w = first; w <= last; ++w) {
+    Word m = ~Word(0);
+    if (w == first) {
+      m &= ~Word(0) << (begin % word_bits);
+    }
+    if (w == last and end % word_bits != 0) {
+      m &= ~Word(0) >> (word_bits - end % word_bits);
+    }
+    if ((bits[w] & m) != 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+} // end of anonymous namespace
 
 void run_union(std::vector<unsigned int> &parent, unsigned int run1, unsigned int run2) {
   if (parent[run1] == run2 || parent[run2] == run1) {
@@ -44,67 +144,77 @@ void run_union(std::vector<unsigned int> &parent, unsigned int run1, unsigned in
 }
 
 //! In-place labeling of connected components using a 2-scan algorithm with run-length encoding.
+/*!
+ * Runs are extracted from a bitset representation of each row and merged with
+ * overlapping runs in the row above, so the first scan does not look at background
+ * pixels one at a time. Labels are the same as the ones produced by a pixel-by-pixel scan:
+ * blobs are numbered in the order of their first pixel.
+ *
+ * Background pixels are not modified.
+ */
 void label_connected_components(double *image, unsigned int n_rows, unsigned int n_cols, bool identify_icebergs, double mask_grounded) {
-  unsigned int max_runs = 2*n_rows;
-  const double eps = 1e-6;
+  const unsigned int n_words = (n_cols + word_bits - 1) / word_bits;
 
-  std::vector<unsigned int> parents(max_runs), lengths(max_runs),
-    rows(max_runs), columns(max_runs), mask(max_runs);
+  std::vector<Word> foreground(n_words), grounded_pixels(n_words);
 
-  unsigned int run_number = 0, r, c, parent;
+  // run 0 is the background
+  std::vector<unsigned int> parents(1, 0), lengths(1, 0), rows(1, 0), columns(1, 0), mask(1, 0);
+
+  parents.reserve(2 * n_rows);
+  lengths.reserve(2 * n_rows);
+  rows.reserve(2 * n_rows);
+  columns.reserve(2 * n_rows);
+  mask.reserve(2 * n_rows);
+
+  // runs in the previous row have indices in [previous_begin, previous_end)
+  unsigned int previous_begin = 1, previous_end = 1;
 
   // First scan
-  for (r = 0; r < n_rows; ++r) {
-    for (c = 0; c < n_cols; ++c) {
-
-      if (image[r*n_cols + c] > 0.0) {
-        // looking at a foreground pixel
-        if (c > 0 && image[r*n_cols + (c-1)] > 0.0) {
-          // one to the left is also a foreground pixel; continue the run
-          lengths[run_number] += 1;
-        } else {
-          // one to the left is a background pixel (or this is column 0); start a new run
-
-          // set the run just above as a parent (if present)
-          if (r > 0 && image[(r-1)*n_cols + c] > 0.0) {
-            parent = (unsigned int)image[(r-1)*n_cols + c];
-          } else {
-            parent = 0;
-          }
-
-          run_number += 1;
-
-          // allocate more storage (if needed)
-          if (run_number == max_runs) {
-            max_runs += n_rows;
-            parents.resize(max_runs);
-            lengths.resize(max_runs);
-            rows.resize(max_runs);
-            columns.resize(max_runs);
-            mask.resize(max_runs);
-          }
-
-          // Record this run
-          rows[run_number]    = r;
-          columns[run_number] = c;
-          lengths[run_number] = 1;
-          parents[run_number] = parent;
-          mask[run_number]    = 0;
-        }
-
-        if (r > 0 && image[(r-1)*n_cols + c] > 0.0) {
-          run_union(parents, (unsigned int)image[(r-1)*n_cols + c], run_number);
-        }
-
-        if (mask[run_number] == 0 && fabs(image[r*n_cols + c] - mask_grounded) < eps) {
-          mask[run_number] = 1;
-        }
-
-        image[r*n_cols + c] = run_number;
+  for (unsigned int r = 0; r < n_rows; ++r) {
+    pack_row(&image[r*n_cols], n_cols, mask_grounded, foreground, grounded_pixels);
+
+    const unsigned int current_begin = parents.size();
+
+    // extract runs in this row
+    unsigned int c = find_next(foreground, 0, n_cols, true);
+    while (c < n_cols) {
+      const unsigned int end = find_next(foreground, c, n_cols, false);
+
+      rows.push_back(r);
+      columns.push_back(c);
+      lengths.push_back(end - c);
+      parents.push_back(0);
+      mask.push_back(any_set(grounded_pixels, c, end) ? 1 : 0);
+
+      c = find_next(foreground, end, n_cols, true);
+    }
+
+    const unsigned int current_end = parents.size();
+
+    // merge with overlapping runs in the previous row (both lists are sorted by column)
+    unsigned int p = previous_begin, q = current_begin;
+    while (p < previous_end and q < current_end) {
+      const unsigned int
+        p_end = columns[p] + lengths[p],
+        q_end = columns[q] + lengths[q];
+
+      if (columns[p] < q_end and columns[q] < p_end) {
+        run_union(parents, p, q);
+      }
+
+      if (p_end < q_end) {
+        p += 1;
+      } else {
+        q += 1;
       }
     }
+
+    previous_begin = current_begin;
+    previous_end   = current_end;
   }
 
+  const unsigned int run_number = parents.size() - 1;
+
   // Assign labels to runs.
   // This uses the fact that children always follow parents,
   // so we can do just one sweep: by the time we get to a node (run),
@@ -115,7 +225,7 @@ void label_connected_components(double *image, unsigned int n_rows, unsigned int
 
   unsigned int label = 0;
   std::vector<unsigned int> grounded(run_number + 1);
-  for (r = 0; r <= run_number; ++r) {
+  for (unsigned int r = 0; r <= run_number; ++r) {
     if (parents[r] == 0) {
       parents[r] = label;
       label += 1;
@@ -131,18 +241,10 @@ void label_connected_components(double *image, unsigned int n_rows, unsigned int
   }
 
   // Second scan (re-label)
-  if (identify_icebergs) {
-    for (r = 0; r <= run_number; ++r) {
-      for (c = 0; c < lengths[r]; ++c) {
-        image[rows[r]*n_cols + columns[r] + c] = 1 - grounded[parents[r]];
-      }
-    }
-  } else {
-    for (r = 0; r <= run_number; ++r) {
-      for (c = 0; c < lengths[r]; ++c) {
-        image[rows[r]*n_cols + columns[r] + c] = parents[r];
-      }
-    }
+  for (unsigned int r = 1; r <= run_number; ++r) {
+    const double value = identify_icebergs ? 1 - grounded[parents[r]] : parents[r];
+
+    std::fill_n(&image[rows[r]*n_cols + columns[r]], lengths[r], value);
   }
 
   // Done!
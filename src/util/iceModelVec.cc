@@ -1,4 +1,4 @@
-// Copyright (C) 2008--2019 Ed Bueler, Constantine Khroulev, and David Maxwell
+// Copyright (C) 2008--2020 Ed Bueler, Constantine Khroulev, and David Maxwell
 //
 // This file is part of PISM.
 //
@@ -106,9 +106,56 @@ IceModelVec::~IceModelVec() {
 
 //! Returns true if create() was called and false otherwise.
 bool IceModelVec::was_created() const {
+  return (bool)m_da;
+}
+
+//! Returns true if storage of this field was allocated.
+/*!
+ * This is false for fields allocated using `grid.lazy_allocation` and not used yet.
+ */
+bool IceModelVec::is_materialized() const {
   return (m_v != NULL);
 }
 
+//! Allocate storage or defer it until the first use (if `grid.lazy_allocation` is set).
+/*!
+ * Called by create() methods of derived classes after setting `m_da` and `m_has_ghosts`.
+ */
+void IceModelVec::create_storage() {
+  if (not m_grid->ctx()->config()->get_flag("grid.lazy_allocation")) {
+    materialize();
+  }
+}
+
+//! Allocate storage of this field if it was not allocated yet.
+/*!
+ * Values of a newly-allocated field are set to zero.
+ *
+ * This is collective on the communicator of the grid.
+ */
+void IceModelVec::materialize() const {
+  if (m_v != NULL) {
+    return;
+  }
+
+  if (not m_da) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "IceModelVec '%s' was not created", m_name.c_str());
+  }
+
+  PetscErrorCode ierr;
+  if (m_has_ghosts) {
+    ierr = DMCreateLocalVector(*m_da, m_v.rawptr());
+    PISM_CHK(ierr, "DMCreateLocalVector");
+  } else {
+    ierr = DMCreateGlobalVector(*m_da, m_v.rawptr());
+    PISM_CHK(ierr, "DMCreateGlobalVector");
+  }
+
+  ierr = VecSet(m_v, 0.0);
+  PISM_CHK(ierr, "VecSet");
+}
+
 //! Returns the grid type of an IceModelVec. (This is the way to figure out if an IceModelVec is 2D or 3D).
 unsigned int IceModelVec::ndims() const {
   if (m_zlevels.size() > 1) {
@@ -151,7 +198,7 @@ VECSEQ and not VECMPI.  See src/trypetsc/localVecMax.c.
 Range IceModelVec::range() const {
   Range result;
   PetscErrorCode ierr;
-  assert(m_v != NULL);
+  materialize();
 
   ierr = VecMin(m_v, NULL, &result.min);
   PISM_CHK(ierr, "VecMin");
@@ -206,7 +253,7 @@ double IceModelVec::norm(int n) const {
 Name avoids clash with sqrt() in math.h.
  */
 void IceModelVec::squareroot() {
-  assert(m_v != NULL);
+  materialize();
 
   PetscErrorCode ierr = VecSqrtAbs(m_v);
   PISM_CHK(ierr, "VecSqrtAbs");
@@ -215,7 +262,8 @@ void IceModelVec::squareroot() {
 
 //! Result: v <- v + alpha * x. Calls VecAXPY.
 void IceModelVec::add(double alpha, const IceModelVec &x) {
-  assert(m_v != NULL && x.m_v != NULL);
+  materialize();
+  x.materialize();
 
   checkCompatibility("add", x);
 
@@ -227,7 +275,7 @@ void IceModelVec::add(double alpha, const IceModelVec &x) {
 
 //! Result: v[j] <- v[j] + alpha for all j. Calls VecShift.
 void IceModelVec::shift(double alpha) {
-  assert(m_v != NULL);
+  materialize();
 
   PetscErrorCode ierr = VecShift(m_v, alpha);
   PISM_CHK(ierr, "VecShift");
@@ -237,7 +285,7 @@ void IceModelVec::shift(double alpha) {
 
 //! Result: v <- v * alpha. Calls VecScale.
 void IceModelVec::scale(double alpha) {
-  assert(m_v != NULL);
+  materialize();
 
   PetscErrorCode ierr = VecScale(m_v, alpha);
   PISM_CHK(ierr, "VecScale");
@@ -253,7 +301,7 @@ void IceModelVec::scale(double alpha) {
     own.
  */
 void  IceModelVec::copy_to_vec(petsc::DM::Ptr destination_da, Vec destination) const {
-  assert(m_v != NULL);
+  materialize();
 
   // m_dof > 1 for vector, staggered grid 2D fields, etc. In this case
   // zlevels.size() == 1. For 3D fields, m_dof == 1 (all 3D fields are
@@ -272,7 +320,7 @@ void  IceModelVec::copy_to_vec(petsc::DM::Ptr destination_da, Vec destination) c
  */
 void IceModelVec::copy_from_vec(Vec source) {
   PetscErrorCode ierr;
-  assert(m_v != NULL);
+  materialize();
 
   if (m_has_ghosts) {
     global_to_local(m_da, source, m_v);
@@ -291,6 +339,8 @@ void IceModelVec::get_dof(petsc::DM::Ptr da_result, Vec result,
     throw RuntimeError::formatted(PISM_ERROR_LOCATION, "invalid argument (start); got %d", start);
   }
 
+  materialize();
+
   petsc::DMDAVecArrayDOF tmp_res(da_result, result), tmp_v(m_da, m_v);
 
   double
@@ -317,6 +367,8 @@ void IceModelVec::set_dof(petsc::DM::Ptr da_source, Vec source,
     throw RuntimeError::formatted(PISM_ERROR_LOCATION, "invalid argument (start); got %d", start);
   }
 
+  materialize();
+
   petsc::DMDAVecArrayDOF tmp_src(da_source, source), tmp_v(m_da, m_v);
   
   double
@@ -342,7 +394,8 @@ void IceModelVec::set_dof(petsc::DM::Ptr da_source, Vec source,
 //! Result: v <- source.  Leaves metadata alone but copies values in Vec.  Uses VecCopy.
 void  IceModelVec::copy_from(const IceModelVec &source) {
   PetscErrorCode ierr;
-  assert(m_v != NULL && source.m_v != NULL);
+  materialize();
+  source.materialize();
 
   checkCompatibility("copy_from", source);
 
@@ -363,6 +416,7 @@ unsigned int IceModelVec::stencil_width() const {
 }
 
 Vec IceModelVec::vec() {
+  materialize();
   return m_v;
 }
 
@@ -443,6 +497,8 @@ void IceModelVec::regrid_impl(const File &file, RegriddingFlag flag,
 
   bool allow_extrapolation = m_grid->ctx()->config()->get_flag("grid.allow_extrapolation");
 
+  materialize();
+
   if (m_has_ghosts) {
     petsc::TemporaryGlobalVec tmp(m_da);
     petsc::VecArray tmp_array(tmp);
@@ -470,6 +526,8 @@ void IceModelVec::read_impl(const File &file, const unsigned int time) {
                        " IceModelVecs with dof == 1.");
   }
 
+  materialize();
+
   if (m_has_ghosts) {
     petsc::TemporaryGlobalVec tmp(m_da);
     petsc::VecArray tmp_array(tmp);
@@ -522,6 +580,8 @@ void IceModelVec::write_impl(const File &file) const {
                        " IceModelVecs with dof == 1");
   }
 
+  materialize();
+
   if (m_has_ghosts) {
     petsc::TemporaryGlobalVec tmp(m_da);
 
@@ -565,6 +625,9 @@ void IceModelVec::checkCompatibility(const char* func, const IceModelVec &other)
                                   func);
   }
 
+  materialize();
+  other.materialize();
+
   ierr = VecGetSize(m_v, &X_size);
   PISM_CHK(ierr, "VecGetSize");
 
@@ -579,7 +642,7 @@ void IceModelVec::checkCompatibility(const char* func, const IceModelVec &other)
 
 //! Checks if an IceModelVec is allocated and calls DAVecGetArray.
 void  IceModelVec::begin_access() const {
-  assert(m_v != NULL);
+  materialize();
 
   if (m_access_counter < 0) {
     throw RuntimeError(PISM_ERROR_LOCATION, "IceModelVec::begin_access(): m_access_counter < 0");
@@ -633,7 +696,7 @@ void  IceModelVec::update_ghosts() {
     return;
   }
 
-  assert(m_v != NULL);
+  materialize();
 
   ierr = DMLocalToLocalBegin(*m_da, m_v, INSERT_VALUES, m_v);
   PISM_CHK(ierr, "DMLocalToLocalBegin");
@@ -658,7 +721,7 @@ void  IceModelVec::update_ghosts(IceModelVec &destination) const {
   PetscErrorCode ierr;
 
   // Make sure it is allocated:
-  assert(m_v != NULL);
+  materialize();
   // Make sure "destination" has ghosts to update.
   assert(destination.m_has_ghosts);
 
@@ -683,7 +746,7 @@ void  IceModelVec::update_ghosts(IceModelVec &destination) const {
 
 //! Result: v[j] <- c for all j.
 void  IceModelVec::set(const double c) {
-  assert(m_v != NULL);
+  materialize();
 
   PetscErrorCode ierr = VecSet(m_v,c);
   PISM_CHK(ierr, "VecSet");
@@ -762,7 +825,7 @@ void compute_params(const IceModelVec* const x, const IceModelVec* const y,
 
 //! \brief Computes the norm of all components.
 std::vector<double> IceModelVec::norm_all(int n) const {
-  assert(m_v != NULL);
+  materialize();
 
   std::vector<double> result(m_dof);
 
@@ -1187,6 +1250,8 @@ void IceModelVec::put_on_proc0(Vec parallel, Vec onp0) const {
 
 //! Puts a local IceModelVec2S on processor 0.
 void IceModelVec::put_on_proc0(Vec onp0) const {
+  materialize();
+
   if (m_has_ghosts) {
     petsc::TemporaryGlobalVec tmp(m_da);
     this->copy_to_vec(m_da, tmp);
@@ -1230,6 +1295,8 @@ void IceModelVec::get_from_proc0(Vec onp0, Vec parallel) {
 
 //! Gets a local IceModelVec2 from processor 0.
 void IceModelVec::get_from_proc0(Vec onp0) {
+  materialize();
+
   if (m_has_ghosts) {
     petsc::TemporaryGlobalVec tmp(m_da);
     get_from_proc0(onp0, tmp);
@@ -1259,6 +1326,8 @@ uint64_t IceModelVec::fletcher64() const {
   int comm_size = 0;
   MPI_Comm_size(com, &comm_size);
 
+  materialize();
+
   PetscInt local_size = 0;
   PetscErrorCode ierr = VecGetLocalSize(m_v, &local_size); PISM_CHK(ierr, "VecGetLocalSize");
   uint64_t sum = 0;
@@ -1,4 +1,4 @@
-// Copyright (C) 2008--2019 Ed Bueler, Constantine Khroulev, and David Maxwell
+// Copyright (C) 2008--2020 Ed Bueler, Constantine Khroulev, and David Maxwell
 //
 // This file is part of PISM.
 //
@@ -125,6 +125,13 @@ T interpolate(const F &field, double x, double y) {
   ("WITH_GHOSTS" means "can be used in computations using map-plane neighbors
   of grid points.)
 
+  If the configuration parameter `grid.lazy_allocation` is set, create() sets
+  metadata and selects the DM but does not allocate the PETSc Vec used to store
+  values. The Vec is allocated ("materialized") on first use: begin_access(),
+  set(), read(), regrid(), vec(), etc. Because allocating a Vec is collective,
+  the first use of a field has to be collective, too. Use is_materialized() to
+  check if a field was used.
+
   It is usually a good idea to set variable metadata right after creating it.
   The method set_attrs() is used throughout PISM to set commonly used
   attributes.
@@ -222,6 +229,7 @@ public:
 
 
   virtual bool was_created() const;
+  bool is_materialized() const;
   IceGrid::ConstPtr grid() const;
   unsigned int ndims() const;
   std::vector<int> shape() const;
@@ -298,8 +306,11 @@ protected:
 
   std::vector<double> m_zlevels;
 
-  //! Internal storage
-  petsc::Vec  m_v;
+  void create_storage();
+  void materialize() const;
+
+  //! Internal storage (allocated by materialize())
+  mutable petsc::Vec  m_v;
   std::string m_name;
 
   //! stores metadata (NetCDF variable attributes)
@@ -1,4 +1,4 @@
-// Copyright (C) 2008--2019 Ed Bueler and Constantine Khroulev
+// Copyright (C) 2008--2020 Ed Bueler and Constantine Khroulev
 //
 // This file is part of PISM.
 //
@@ -83,7 +83,7 @@ IceModelVec2S::IceModelVec2S(IceGrid::ConstPtr grid, const std::string &name,
 
 
 void  IceModelVec2S::create(IceGrid::ConstPtr grid, const std::string &name, IceModelVecKind ghostedp, int width) {
-  assert(m_v == NULL);
+  assert(not m_da);
   IceModelVec2::create(grid, name, ghostedp, width, m_dof);
 }
 
@@ -140,7 +140,7 @@ void IceModelVec2S::mask_by(const IceModelVec2S &M, double fill) {
 
 void IceModelVec2::write_impl(const File &file) const {
 
-  assert(m_v != NULL);
+  materialize();
 
   // The simplest case:
   if ((m_dof == 1) and (not m_has_ghosts)) {
@@ -178,7 +178,7 @@ void IceModelVec2::read_impl(const File &nc, const unsigned int time) {
   Logger::ConstPtr log = m_grid->ctx()->log();
   log->message(4, "  Reading %s...\n", m_name.c_str());
 
-  assert(m_v != NULL);
+  materialize();
 
   // Get the dof=1, stencil_width=0 DMDA (components are always scalar
   // and we just need a global Vec):
@@ -320,15 +320,33 @@ void IceModelVec2::view(petsc::Viewer::Ptr v1, petsc::Viewer::Ptr v2) const {
   }
 }
 
+/*!
+ * Approximate the derivative at the middle point of a three-point stencil with spacings
+ * `h_minus` and `h_plus` (second order accurate).
+ */
+static inline double centered_difference(double f_minus, double f, double f_plus,
+                                         double h_minus, double h_plus) {
+  return (h_minus * h_minus * (f_plus - f) + h_plus * h_plus * (f - f_minus)) /
+    (h_minus * h_plus * (h_minus + h_plus));
+}
+
 //! \brief Returns the x-derivative at i,j approximated using centered finite
 //! differences.
 double IceModelVec2S::diff_x(int i, int j) const {
+  if (not m_grid->uniform()) {
+    return centered_difference((*this)(i - 1, j), (*this)(i, j), (*this)(i + 1, j),
+                               m_grid->spacing_x(i - 1), m_grid->spacing_x(i));
+  }
   return ((*this)(i + 1,j) - (*this)(i - 1,j)) / (2 * m_grid->dx());
 }
 
 //! \brief Returns the y-derivative at i,j approximated using centered finite
 //! differences.
 double IceModelVec2S::diff_y(int i, int j) const {
+  if (not m_grid->uniform()) {
+    return centered_difference((*this)(i, j - 1), (*this)(i, j), (*this)(i, j + 1),
+                               m_grid->spacing_y(j - 1), m_grid->spacing_y(j));
+  }
   return ((*this)(i,j + 1) - (*this)(i,j - 1)) / (2 * m_grid->dy());
 }
 
@@ -341,9 +359,9 @@ double IceModelVec2S::diff_x_p(int i, int j) const {
   }
   
   if (i == 0) {
-    return ((*this)(i + 1,j) - (*this)(i,j)) / (m_grid->dx());
+    return ((*this)(i + 1,j) - (*this)(i,j)) / (m_grid->spacing_x(i));
   } else if (i == (int)m_grid->Mx() - 1) {
-    return ((*this)(i,j) - (*this)(i - 1,j)) / (m_grid->dx());
+    return ((*this)(i,j) - (*this)(i - 1,j)) / (m_grid->spacing_x(i - 1));
   } else {
     return diff_x(i,j);
  }
@@ -358,9 +376,9 @@ double IceModelVec2S::diff_y_p(int i, int j) const {
   }
   
   if (j == 0) {
-    return ((*this)(i,j + 1) - (*this)(i,j)) / (m_grid->dy());
+    return ((*this)(i,j + 1) - (*this)(i,j)) / (m_grid->spacing_y(j));
   } else if (j == (int)m_grid->My() - 1) {
-    return ((*this)(i,j) - (*this)(i,j - 1)) / (m_grid->dy());
+    return ((*this)(i,j) - (*this)(i,j - 1)) / (m_grid->spacing_y(j - 1));
   } else {
     return diff_y(i,j);
   }
@@ -432,19 +450,20 @@ IceModelVec2::IceModelVec2(IceGrid::ConstPtr grid, const std::string &short_name
 
 void IceModelVec2::get_component(unsigned int n, IceModelVec2S &result) const {
 
-  IceModelVec2::get_dof(result.dm(), result.m_v, n);
+  IceModelVec2::get_dof(result.dm(), result.vec(), n);
 }
 
 void IceModelVec2::set_component(unsigned int n, const IceModelVec2S &source) {
 
+  source.materialize();
+
   IceModelVec2::set_dof(source.dm(), source.m_v, n);
 }
 
 void IceModelVec2::create(IceGrid::ConstPtr grid, const std::string & name,
                            IceModelVecKind ghostedp,
                            unsigned int stencil_width, int dof) {
-  PetscErrorCode ierr;
-  assert(m_v == NULL);
+  assert(not m_da);
 
   m_dof  = dof;
   m_grid = grid;
@@ -458,17 +477,11 @@ void IceModelVec2::create(IceGrid::ConstPtr grid, const std::string & name,
   // initialize the da member:
   m_da = m_grid->get_dm(this->m_dof, this->m_da_stencil_width);
 
-  if (ghostedp) {
-    ierr = DMCreateLocalVector(*m_da, m_v.rawptr());
-    PISM_CHK(ierr, "DMCreateLocalVector");
-  } else {
-    ierr = DMCreateGlobalVector(*m_da, m_v.rawptr());
-    PISM_CHK(ierr, "DMCreateGlobalVector");
-  }
-
   m_has_ghosts = (ghostedp == WITH_GHOSTS);
   m_name       = name;
 
+  create_storage();
+
   if (m_dof == 1) {
     m_metadata.push_back(SpatialVariableMetadata(m_grid->ctx()->unit_system(),
                                                  name));
@@ -1,4 +1,4 @@
-// Copyright (C) 2009--2019 Constantine Khroulev
+// Copyright (C) 2009--2020 Constantine Khroulev
 //
 // This file is part of PISM.
 //
@@ -167,60 +167,101 @@ void IceModelVec2T::end_access() const {
 
 void IceModelVec2T::init(const std::string &fname, unsigned int period, double reference_time) {
 
-  const Logger &log = *m_grid->ctx()->log();
+  File file(m_grid->com, fname, PISM_GUESS, PISM_READONLY);
 
-  m_filename       = fname;
-  m_period         = period;
-  m_reference_time = reference_time;
+  auto time_name = time_dimension(file);
 
-  // We find the variable in the input file and
-  // try to find the corresponding time dimension.
+  init(fname, period, reference_time,
+       read_time_axis(file, time_name, m_interp_type == PIECEWISE_CONSTANT));
 
-  File file(m_grid->com, m_filename, PISM_GUESS, PISM_READONLY);
+  if (m_period != 0) {
+    // read periodic data right away (we need to hold it all in memory anyway)
+    update(0);
+  }
+}
+
+/*!
+ * Find the variable corresponding to this field in `file` and return the name of its time
+ * dimension (empty if it does not depend on time).
+ */
+std::string IceModelVec2T::time_dimension(const File &file) const {
   auto var = file.find_variable(m_metadata[0].get_name(), m_metadata[0].get_string("standard_name"));
   if (not var.exists) {
     throw RuntimeError::formatted(PISM_ERROR_LOCATION, "can't find %s (%s) in %s.",
                                   m_metadata[0].get_string("long_name").c_str(),
                                   m_metadata[0].get_name().c_str(),
-                                  m_filename.c_str());
+                                  file.filename().c_str());
   }
 
-  auto time_name = io::time_dimension(m_grid->ctx()->unit_system(),
-                                      file, var.name);
+  return io::time_dimension(m_grid->ctx()->unit_system(), file, var.name);
+}
 
-  if (not time_name.empty()) {
-    // we're found the time dimension
-    TimeseriesMetadata time_dimension(time_name, time_name, m_grid->ctx()->unit_system());
+/*!
+ * Read times (and time bounds if `read_bounds` is true and they are present) corresponding
+ * to the time dimension `time_name` from `file`.
+ */
+IceModelVec2T::TimeAxis IceModelVec2T::read_time_axis(const File &file,
+                                                      const std::string &time_name,
+                                                      bool read_bounds) const {
+  TimeAxis result;
+  result.name = time_name;
+
+  if (time_name.empty()) {
+    return result;
+  }
+
+  const Logger &log = *m_grid->ctx()->log();
+
+  TimeseriesMetadata time_dimension(time_name, time_name, m_grid->ctx()->unit_system());
 
-    auto time_units = m_grid->ctx()->time()->units_string();
-    time_dimension.set_string("units", time_units);
+  auto time_units = m_grid->ctx()->time()->units_string();
+  time_dimension.set_string("units", time_units);
 
-    io::read_timeseries(file, time_dimension,
-                        *m_grid->ctx()->time(), log, m_time);
+  io::read_timeseries(file, time_dimension,
+                      *m_grid->ctx()->time(), log, result.times);
 
-    std::string bounds_name = file.read_text_attribute(time_name, "bounds");
+  result.bounds_name = file.read_text_attribute(time_name, "bounds");
+
+  if (read_bounds and result.times.size() > 1 and not result.bounds_name.empty()) {
+    TimeBoundsMetadata tb(result.bounds_name, time_name, m_grid->ctx()->unit_system());
+    tb.set_string("units", time_units);
+
+    io::read_time_bounds(file, tb, *m_grid->ctx()->time(),
+                         log, result.bounds);
+  }
+
+  return result;
+}
+
+/*!
+ * Initialize using the time axis `axis` read from `fname`. Does not read any records.
+ */
+void IceModelVec2T::init(const std::string &fname, unsigned int period, double reference_time,
+                         const TimeAxis &axis) {
+
+  m_filename       = fname;
+  m_period         = period;
+  m_reference_time = reference_time;
+
+  if (not axis.name.empty()) {
+    // we're found the time dimension
+    m_time = axis.times;
 
     if (m_time.size() > 1) {
 
       if (m_interp_type == PIECEWISE_CONSTANT) {
-        if (bounds_name.empty()) {
+        if (axis.bounds_name.empty()) {
           // no time bounds attribute
           throw RuntimeError::formatted(PISM_ERROR_LOCATION,
                                         "Variable '%s' does not have the time_bounds attribute.\n"
                                         "Cannot use time-dependent forcing data '%s' (%s) without time bounds.",
-                                        time_name.c_str(),  m_metadata[0].get_string("long_name").c_str(),
+                                        axis.name.c_str(),  m_metadata[0].get_string("long_name").c_str(),
                                         m_metadata[0].get_name().c_str());
         }
 
-        // read time bounds data from a file
-        TimeBoundsMetadata tb(bounds_name, time_name, m_grid->ctx()->unit_system());
-        tb.set_string("units", time_units);
-
-        io::read_time_bounds(file, tb, *m_grid->ctx()->time(),
-                             log, m_time_bounds);
-
         // time bounds data overrides the time variable: we make t[j] be the
         // left end-point of the j-th interval
+        m_time_bounds = axis.bounds;
         for (unsigned int k = 0; k < m_time.size(); ++k) {
           m_time[k] = m_time_bounds[2*k + 0];
         }
@@ -261,9 +302,6 @@ void IceModelVec2T::init(const std::string &fname, unsigned int period, double r
       throw RuntimeError(PISM_ERROR_LOCATION,
                          "buffer has to be big enough to hold all records of periodic data");
     }
-
-    // read periodic data right away (we need to hold it all in memory anyway)
-    update(0);
   }
 }
 
@@ -285,20 +323,31 @@ void IceModelVec2T::init_constant(double value) {
 
 //! Read some data to make sure that the interval (t, t + dt) is covered.
 void IceModelVec2T::update(double t, double dt) {
+  int start = first_record_needed(t, dt);
+
+  if (start >= 0) {
+    update(static_cast<unsigned int>(start));
+  }
+}
+
+/*!
+ * Return the in-file index of the first record that has to be read to cover the
+ * interval (t, t + dt) or -1 if all the necessary records are in memory already.
+ */
+int IceModelVec2T::first_record_needed(double t, double dt) const {
 
   if (m_filename.empty()) {
     // We are not reading data from a file.
-    return;
+    return -1;
   }
 
   if (m_time_bounds.size() == 0) {
-    update(0);
-    return;
+    return 0;
   }
 
   if (m_period != 0) {
     // we read all data in IceModelVec2T::init() (see above)
-    return;
+    return -1;
   }
 
   if (m_N > 0) {
@@ -311,7 +360,7 @@ void IceModelVec2T::update(double t, double dt) {
 
     // just return if we have all the data we need:
     if (t >= t0 and t + dt <= t1) {
-      return;
+      return -1;
     }
   }
 
@@ -330,12 +379,37 @@ void IceModelVec2T::update(double t, double dt) {
                                   N, m_name.c_str(), m_n_records);
   }
 
-  update(first);
+  return first;
 }
 
 //! Update by reading at most n_records records from the file.
 void IceModelVec2T::update(unsigned int start) {
 
+  unsigned int kept = 0;
+  unsigned int missing = prepare_buffer(start, kept);
+
+  if (missing == 0) {
+    return;
+  }
+
+  File file(m_grid->com, m_filename, PISM_GUESS, PISM_READONLY);
+
+  for (unsigned int j = 0; j < missing; ++j) {
+    read_record(file, start + j, kept + j);
+  }
+}
+
+/*!
+ * Prepare the buffer for reading records starting from `start`: discard records that are
+ * no longer needed and keep the ones that can be re-used.
+ *
+ * On return `start` is the in-file index of the first record to read and `kept` is its
+ * position in the buffer.
+ *
+ * Returns the number of records to read.
+ */
+unsigned int IceModelVec2T::prepare_buffer(unsigned int &start, unsigned int &kept) {
+
   unsigned int time_size = (int)m_time.size();
 
   if (start >= time_size) {
@@ -345,12 +419,13 @@ void IceModelVec2T::update(unsigned int start) {
 
   unsigned int missing = std::min(m_n_records, time_size - start);
 
+  kept = 0;
+
   if (start == static_cast<unsigned int>(m_first)) {
     // nothing to do
-    return;
+    return 0;
   }
 
-  int kept = 0;
   if (m_first >= 0) {
     unsigned int last = m_first + (m_N - 1);
     if ((m_N > 0) && (start >= (unsigned int)m_first) && (start <= last)) {
@@ -368,7 +443,7 @@ void IceModelVec2T::update(unsigned int start) {
   }
 
   if (missing <= 0) {
-    return;
+    return 0;
   }
 
   m_N = kept + missing;
@@ -390,25 +465,29 @@ void IceModelVec2T::update(unsigned int start) {
     m_report_range = true;
   }
 
-  File file(m_grid->com, m_filename, PISM_GUESS, PISM_READONLY);
+  return missing;
+}
 
-  const bool allow_extrapolation = m_grid->ctx()->config()->get_flag("grid.allow_extrapolation");
+//! Read the record number `record` from `file` and store it at `position` in the buffer.
+void IceModelVec2T::read_record(const File &file, unsigned int record, unsigned int position) {
 
-  for (unsigned int j = 0; j < missing; ++j) {
-    {
-      petsc::VecArray tmp_array(m_v);
-      io::regrid_spatial_variable(m_metadata[0], *m_grid, file, start + j, CRITICAL,
-                                  m_report_range, allow_extrapolation,
-                                  0.0, m_interpolation_type, tmp_array.get());
-    }
+  const bool allow_extrapolation = m_grid->ctx()->config()->get_flag("grid.allow_extrapolation");
 
-    m_grid->ctx()->log()->message(5, " %s: reading entry #%02d, year %s...\n",
-                                  m_name.c_str(),
-                                  start + j,
-                                  t->date(m_time[start + j]).c_str());
+  materialize();
 
-    set_record(kept + j);
+  {
+    petsc::VecArray tmp_array(m_v);
+    io::regrid_spatial_variable(m_metadata[0], *m_grid, file, record, CRITICAL,
+                                m_report_range, allow_extrapolation,
+                                0.0, m_interpolation_type, tmp_array.get());
   }
+
+  m_grid->ctx()->log()->message(5, " %s: reading entry #%02d, year %s...\n",
+                                m_name.c_str(),
+                                record,
+                                m_grid->ctx()->time()->date(m_time[record]).c_str());
+
+  set_record(position);
 }
 
 //! Discard the first N records, shifting the rest of them towards the "beginning".
@@ -506,14 +585,22 @@ void IceModelVec2T::interp(double t) {
  */
 void IceModelVec2T::average(double t, double dt) {
 
-  double dt_years = units::convert(m_grid->ctx()->unit_system(),
-                                   dt, "seconds", "years"); // *not* time->year(dt)
-
   // if only one record, nothing to do
   if (m_time.size() == 1) {
     return;
   }
 
+  init_interpolation(averaging_times(t, dt));
+
+  average_using_weights();
+}
+
+//! Times used to compute the average over the time interval `[t, t + dt]`.
+std::vector<double> IceModelVec2T::averaging_times(double t, double dt) const {
+
+  double dt_years = units::convert(m_grid->ctx()->unit_system(),
+                                   dt, "seconds", "years"); // *not* time->year(dt)
+
   // Determine the number of small time-steps to use for averaging:
   int M = (int) ceil(m_n_evaluations_per_year * (dt_years));
   if (M < 1) {
@@ -526,8 +613,11 @@ void IceModelVec2T::average(double t, double dt) {
     ts[k] = t + k * ts_dt;
   }
 
-  init_interpolation(ts);
+  return ts;
+}
 
+//! Compute the average using interpolation weights set by init_interpolation().
+void IceModelVec2T::average_using_weights() {
   double **a2 = get_array();         // calls begin_access()
   for (Points p(*m_grid); p; p.next()) {
     const int i = p.i(), j = p.j();
@@ -1,4 +1,4 @@
-// Copyright (C) 2009--2019 Constantine Khroulev
+// Copyright (C) 2009--2020 Constantine Khroulev
 //
 // This file is part of PISM.
 //
@@ -77,6 +77,32 @@ public:
   void init_interpolation(const std::vector<double> &ts);
 
 private:
+  friend class ForcingGroup;
+
+  //! Time axis of a forcing file (shared by all variables that use the same time dimension).
+  struct TimeAxis {
+    //! name of the time dimension (empty if the variable does not depend on time)
+    std::string name;
+    //! name of the time bounds variable (empty if not present)
+    std::string bounds_name;
+    std::vector<double> times;
+    //! time bounds (read only if requested)
+    std::vector<double> bounds;
+  };
+
+  std::string time_dimension(const File &file) const;
+  TimeAxis read_time_axis(const File &file, const std::string &time_name,
+                          bool read_bounds) const;
+  void init(const std::string &filename, unsigned int period, double reference_time,
+            const TimeAxis &axis);
+
+  int first_record_needed(double t, double dt) const;
+  unsigned int prepare_buffer(unsigned int &start, unsigned int &kept);
+  void read_record(const File &file, unsigned int record, unsigned int position);
+
+  std::vector<double> averaging_times(double t, double dt) const;
+  void average_using_weights();
+
   std::vector<double> m_time,             //!< all the times available in filename
     m_time_bounds;                //!< time bounds
   std::string m_filename;         //!< file to read (regrid) from
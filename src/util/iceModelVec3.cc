@@ -1,4 +1,4 @@
-// Copyright (C) 2008--2018 Ed Bueler and Constantine Khroulev
+// Copyright (C) 2008--2018, 2020 Ed Bueler and Constantine Khroulev
 //
 // This file is part of PISM.
 //
@@ -72,11 +72,10 @@ IceModelVec3::Ptr IceModelVec3::To3DScalar(IceModelVec::Ptr input) {
   return result;
 }
 
-//! Allocate a DA and a Vec from information in IceGrid.
+//! Allocate a DA and a Vec (see IceModelVec::create_storage()) from information in IceGrid.
 void IceModelVec3D::allocate(IceGrid::ConstPtr grid, const std::string &name,
                              IceModelVecKind ghostedp, const std::vector<double> &levels,
                              unsigned int stencil_width) {
-  PetscErrorCode ierr;
   m_grid = grid;
 
   m_zlevels = levels;
@@ -86,16 +85,10 @@ void IceModelVec3D::allocate(IceGrid::ConstPtr grid, const std::string &name,
 
   m_has_ghosts = (ghostedp == WITH_GHOSTS);
 
-  if (m_has_ghosts == true) {
-    ierr = DMCreateLocalVector(*m_da, m_v.rawptr());
-    PISM_CHK(ierr, "DMCreateLocalVector");
-  } else {
-    ierr = DMCreateGlobalVector(*m_da, m_v.rawptr());
-    PISM_CHK(ierr, "DMCreateGlobalVector");
-  }
-
   m_name = name;
 
+  create_storage();
+
   m_metadata.push_back(SpatialVariableMetadata(m_grid->ctx()->unit_system(),
                                                name, m_zlevels));
 }
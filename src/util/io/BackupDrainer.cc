@@ -0,0 +1,382 @@
+/* Copyright (C) 2020 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <cstdio>               // fopen, fread, fwrite, rename, remove, snprintf
+#include <cstdint>              // uint64_t
+#include <cstdlib>              // realpath, free
+#include <ctime>                // time
+#include <vector>
+#include <limits>
+#include <sstream>
+#include <unistd.h>             // getpid
+#include <petscsys.h>           // PetscGetHostName
+
+#include "BackupDrainer.hh"
+
+#include "pism/util/io/File.hh"
+#include "pism/util/ConfigInterface.hh"
+#include "pism/util/Logger.hh"
+#include "pism/util/error_handling.hh"
+
+namespace pism {
+
+BackupDrainer::BackupDrainer(MPI_Comm com)
+  : m_com(com), m_rank(0) {
+  MPI_Comm_rank(m_com, &m_rank);
+}
+
+BackupDrainer::~BackupDrainer() {
+  // Don't leave a copy half-done. Note that we cannot report errors from here.
+  if (m_thread.joinable()) {
+    m_thread.join();
+  }
+}
+
+//! Start copying `source` to `destination` (waits for the previous copy to finish first).
+/*!
+ * This is a collective operation.
+ */
+void BackupDrainer::start(const std::string &source, const std::string &destination) {
+  wait();
+
+  if (m_rank == 0) {
+    m_thread = std::thread([this, source, destination]() {
+        try {
+          copy_file(source, destination);
+        } catch (std::exception &e) {
+          m_error = e.what();
+        }
+      });
+  }
+}
+
+//! Wait for the current copy (if any) to finish. Throws if the copy failed.
+/*!
+ * This is a collective operation.
+ */
+void BackupDrainer::wait() {
+  int failed = 0;
+
+  if (m_rank == 0) {
+    if (m_thread.joinable()) {
+      m_thread.join();
+    }
+    failed = m_error.empty() ? 0 : 1;
+  }
+
+  MPI_Bcast(&failed, 1, MPI_INT, 0, m_com);
+
+  if (failed != 0) {
+    std::string message = m_error;
+    m_error.clear();
+
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "failed to copy a staged backup: %s",
+                                  m_rank == 0 ? message.c_str() : "see the error message from rank 0");
+  }
+}
+
+//! Copy `source` to `destination`, replacing `destination` only if the copy succeeded.
+/*!
+ * Not a collective operation: this should be called by one rank only.
+ */
+void copy_file(const std::string &source, const std::string &destination) {
+  const std::string tmp = destination + ".partial";
+
+  FILE *in = fopen(source.c_str(), "rb");
+  if (in == nullptr) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "failed to open '%s' for reading", source.c_str());
+  }
+
+  FILE *out = fopen(tmp.c_str(), "wb");
+  if (out == nullptr) {
+    fclose(in);
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "failed to open '%s' for writing", tmp.c_str());
+  }
+
+  std::vector<char> buffer(4 * 1024 * 1024);
+  bool success = true;
+  while (true) {
+    size_t n = fread(buffer.data(), 1, buffer.size(), in);
+    if (n > 0 and fwrite(buffer.data(), 1, n, out) != n) {
+      success = false;
+      break;
+    }
+    if (n < buffer.size()) {
+      success = ferror(in) == 0;
+      break;
+    }
+  }
+
+  fclose(in);
+  if (fclose(out) != 0) {
+    success = false;
+  }
+
+  if (not success) {
+    remove(tmp.c_str());
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "failed to copy '%s' to '%s'",
+                                  source.c_str(), tmp.c_str());
+  }
+
+  if (rename(tmp.c_str(), destination.c_str()) != 0) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "failed to move '%s' to '%s'",
+                                  tmp.c_str(), destination.c_str());
+  }
+}
+
+//! Absolute path corresponding to `filename` (the directory containing it has to exist).
+/*!
+ * Resolves "..", "." and symbolic links in the directory part, so that different names of
+ * the same file give the same result.
+ */
+static std::string absolute_path(const std::string &filename) {
+  std::string directory = ".", basename = filename;
+
+  auto k = filename.rfind('/');
+  if (k != std::string::npos) {
+    directory = k > 0 ? filename.substr(0, k) : "/";
+    basename  = filename.substr(k + 1);
+  }
+
+  char *path = realpath(directory.c_str(), nullptr);
+  if (path == nullptr) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "failed to get the absolute path of '%s'", directory.c_str());
+  }
+
+  std::string result = path;
+  free(path);
+
+  return result == "/" ? result + basename : result + "/" + basename;
+}
+
+//! Name of the staged copy of `filename` in `staging_dir`.
+/*!
+ * The name includes a hash of the absolute path of `filename`, so that runs writing
+ * backups with the same name to different directories can share a staging directory.
+ */
+std::string staged_file_name(const std::string &staging_dir, const std::string &filename) {
+  const std::string path = absolute_path(filename);
+
+  // 64-bit FNV-1a hash: simple and does not depend on the standard library implementation
+  uint64_t hash = 14695981039346656037ULL;
+  for (unsigned char c : path) {
+    hash ^= c;
+    hash *= 1099511628211ULL;
+  }
+
+  char hex[17];
+  snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(hash));
+
+  std::string basename = path.substr(path.rfind('/') + 1);
+
+  return staging_dir + "/" + hex + "-" + basename;
+}
+
+//! Creates a string identifying this run (the same on all ranks).
+std::string backup_run_id(MPI_Comm com) {
+  PetscErrorCode ierr;
+
+  char hostname[100];
+  ierr = PetscGetHostName(hostname, sizeof(hostname));
+  PISM_CHK(ierr, "PetscGetHostName");
+
+  std::ostringstream message;
+  message << hostname << ":" << getpid() << ":" << time(NULL);
+
+  std::string result = message.str();
+  unsigned int length = result.size();
+  MPI_Bcast(&length, 1, MPI_UNSIGNED, 0, com);
+
+  result.resize(length);
+  MPI_Bcast(&result[0], length, MPI_CHAR, 0, com);
+
+  return result;
+}
+
+static const char *run_id_attribute = "pism_backup_run_id";
+static const char *backup_file_attribute = "pism_backup_file";
+
+//! Record the run that wrote a staged backup and the (absolute) name of the backup file.
+void write_backup_id(const File &file, const std::string &run_id,
+                     const std::string &backup_filename) {
+  file.write_attribute("PISM_GLOBAL", run_id_attribute, run_id);
+  file.write_attribute("PISM_GLOBAL", backup_file_attribute, absolute_path(backup_filename));
+}
+
+namespace {
+struct BackupInfo {
+  std::string run_id;
+  std::string backup_file;
+  //! model time of the last record or -infinity if not available
+  double time;
+};
+}
+
+static BackupInfo backup_info(MPI_Comm com, const std::string &filename,
+                              const std::string &time_name) {
+  // note: only rank 0 needs to be able to access the file
+  File file(com, filename, PISM_NETCDF3, PISM_READONLY);
+
+  BackupInfo result;
+  result.run_id      = file.read_text_attribute("PISM_GLOBAL", run_id_attribute);
+  result.backup_file = file.read_text_attribute("PISM_GLOBAL", backup_file_attribute);
+  result.time        = -std::numeric_limits<double>::infinity();
+
+  if (file.find_variable(time_name)) {
+    unsigned int n_records = file.dimension_length(time_name);
+    if (n_records > 0) {
+      file.read_variable(time_name, {n_records - 1}, {1}, &result.time);
+    }
+  }
+
+  return result;
+}
+
+//! Returns 1 if `filename` exists on rank 0, 0 otherwise.
+static bool exists_on_rank_0(MPI_Comm com, const std::string &filename) {
+  int rank = 0, exists = 0;
+  MPI_Comm_rank(com, &rank);
+
+  if (rank == 0) {
+    if (FILE *f = fopen(filename.c_str(), "r")) {
+      fclose(f);
+      exists = 1;
+    }
+  }
+
+  MPI_Bcast(&exists, 1, MPI_INT, 0, com);
+
+  return exists == 1;
+}
+
+//! Move `input_file` to `input_file.bak` (if present) and replace it with `staged`.
+/*!
+ * Not a collective operation: this should be called by one rank only.
+ */
+static void restore_backup(const std::string &staged, const std::string &input_file,
+                           bool input_exists) {
+  const std::string original = input_file + ".bak";
+
+  if (input_exists and rename(input_file.c_str(), original.c_str()) != 0) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION, "failed to move '%s' to '%s'",
+                                  input_file.c_str(), original.c_str());
+  }
+
+  try {
+    copy_file(staged, input_file);
+  } catch (...) {
+    if (input_exists) {
+      rename(original.c_str(), input_file.c_str());
+    }
+    throw;
+  }
+}
+
+/*!
+ * If a run is re-started from a backup file and the staged copy of this file is newer
+ * (i.e. the run was stopped before this copy was drained), use the staged copy.
+ *
+ * The staged copy is used only if it was staged for this file (the staging directory may
+ * be shared by several runs) and written by the same run as the backup file (if present).
+ * The backup file is moved to `input_file.bak` and replaced by a copy of the staged file:
+ * it has to be on the storage visible to all ranks.
+ *
+ * This has to be called before the input file is used for anything.
+ */
+void recover_staged_backup(MPI_Comm com, const Config &config, const Logger &log) {
+  const std::string
+    staging_dir = config.get_string("output.backup_staging_dir"),
+    input_file  = config.get_string("input.file");
+
+  if (staging_dir.empty() or input_file.empty() or config.get_flag("input.bootstrap")) {
+    return;
+  }
+
+  const std::string staged = staged_file_name(staging_dir, input_file);
+
+  if (not exists_on_rank_0(com, staged)) {
+    return;
+  }
+
+  try {
+    const std::string time_name = config.get_string("time.dimension_name");
+
+    auto staged_info = backup_info(com, staged, time_name);
+
+    if (staged_info.backup_file != absolute_path(input_file)) {
+      log.message(2, "* Staged backup '%s' is a copy of '%s', not '%s'. Ignoring it...\n",
+                  staged.c_str(), staged_info.backup_file.c_str(), input_file.c_str());
+      return;
+    }
+
+    const bool input_exists = exists_on_rank_0(com, input_file);
+
+    if (input_exists) {
+      auto input_info = backup_info(com, input_file, time_name);
+
+      if (input_info.run_id != staged_info.run_id) {
+        log.message(2, "* Staged backup '%s' was not written by the run that wrote '%s'. Ignoring it...\n",
+                    staged.c_str(), input_file.c_str());
+        return;
+      }
+
+      if (staged_info.time <= input_info.time) {
+        return;
+      }
+    }
+
+    log.message(2, "* Staged backup '%s' is newer than '%s'. Using the staged copy...\n",
+                staged.c_str(), input_file.c_str());
+
+    int rank = 0, failed = 0;
+    MPI_Comm_rank(com, &rank);
+
+    std::string message;
+    if (rank == 0) {
+      try {
+        restore_backup(staged, input_file, input_exists);
+      } catch (std::exception &e) {
+        message = e.what();
+        failed = 1;
+      }
+    }
+
+    MPI_Bcast(&failed, 1, MPI_INT, 0, com);
+
+    if (failed != 0) {
+      throw RuntimeError(PISM_ERROR_LOCATION,
+                         rank == 0 ? message : "see the error message from rank 0");
+    }
+
+    if (input_exists) {
+      log.message(2, "  The original backup was moved to '%s.bak'.\n", input_file.c_str());
+    }
+  } catch (RuntimeError &e) {
+    e.add_context("recovering the staged backup '%s'", staged.c_str());
+    throw;
+  }
+}
+
+} // end of namespace pism
@@ -0,0 +1,79 @@
+/* Copyright (C) 2020 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef PISM_BACKUPDRAINER_H
+#define PISM_BACKUPDRAINER_H
+
+#include <string>
+#include <thread>
+#include <mpi.h>
+
+namespace pism {
+
+class Config;
+class Logger;
+class File;
+
+//! Copies a file staged on fast storage to its final location in the background.
+/*!
+ * Automatic backups can be written to a directory on fast (usually node-local) storage
+ * first (see `output.backup_staging_dir`). This class then copies ("drains") them to the
+ * parallel file system while the model keeps stepping.
+ *
+ * All the work is done by a thread on rank 0. This thread does not make any MPI calls.
+ *
+ * Copies are written to `destination.partial` first and renamed once complete, so the
+ * file at `destination` is always a complete backup.
+ *
+ * Note that this moves only the copy to the parallel file system off the critical path.
+ * The staged file itself is still written by rank 0 (model state is gathered on rank 0
+ * and written using the NetCDF-3 backend), so writing it takes as long as writing a
+ * NetCDF-3 file to fast storage. Writing per-rank patches of the model state would
+ * require a matching input path for re-starting from them and is not implemented.
+ */
+class BackupDrainer {
+public:
+  BackupDrainer(MPI_Comm com);
+  ~BackupDrainer();
+
+  void start(const std::string &source, const std::string &destination);
+  void wait();
+private:
+  MPI_Comm m_com;
+  int m_rank;
+
+  std::thread m_thread;
+  //! error message set by the copying thread
+  std::string m_error;
+};
+
+void copy_file(const std::string &source, const std::string &destination);
+
+std::string staged_file_name(const std::string &staging_dir, const std::string &filename);
+
+std::string backup_run_id(MPI_Comm com);
+
+void write_backup_id(const File &file, const std::string &run_id,
+                     const std::string &backup_filename);
+
+void recover_staged_backup(MPI_Comm com, const Config &config, const Logger &log);
+
+} // end of namespace pism
+
+#endif /* PISM_BACKUPDRAINER_H */
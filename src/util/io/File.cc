@@ -1,4 +1,4 @@
-// Copyright (C) 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019 PISM Authors
+// Copyright (C) 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019, 2020 PISM Authors
 //
 // This file is part of PISM.
 //
@@ -16,6 +16,7 @@
 // along with PISM; if not, write to the Free Software
 // Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
+#include <algorithm>            // std::min
 #include <cassert>
 #include <cstdio>
 #include <memory>
@@ -54,6 +55,7 @@ struct File::Impl {
   MPI_Comm com;
   IO_Backend backend;
   io::NCFile::Ptr nc;
+  WriteSession session;
 };
 
 IO_Backend string_to_backend(const std::string &backend) {
@@ -82,9 +84,19 @@ IO_Backend string_to_backend(const std::string &backend) {
                                 "unknown or unsupported I/O backend: %s", backend.c_str());
 }
 
+void set_in_memory_size_limit(size_t size) {
+  io::NC3File::set_in_memory_size_limit(size);
+}
+
 // Chooses the best available I/O backend for reading from 'filename'.
 static IO_Backend choose_backend(MPI_Comm com, const std::string &filename) {
 
+  if (io::NC3File::fits_in_memory(com, filename)) {
+    // small files are read into memory by the serial backend, so there is no need to
+    // check the format
+    return PISM_NETCDF3;
+  }
+
   std::string format;
   {
     // This is the rank-0-only purely-serial mode of accessing NetCDF files, but it
@@ -233,6 +245,7 @@ void File::remove_attribute(const std::string &variable_name, const std::string
 
 void File::close() {
   try {
+    m_impl->session = WriteSession();
     m_impl->nc->close();
   } catch (RuntimeError &e) {
     e.add_context("closing \"" + filename() + "\"");
@@ -651,6 +664,31 @@ std::string File::read_text_attribute(const std::string &var_name, const std::st
   }
 }
 
+//! \brief Get all attributes of a variable (in the order they appear in the file).
+/*!
+ * Prefer this to reading attributes one at a time: with some I/O backends it is much
+ * faster.
+ */
+std::vector<Attribute> File::read_attributes(const std::string &var_name) const {
+  try {
+    std::vector<Attribute> result;
+    m_impl->nc->get_atts(var_name, result);
+    return result;
+  } catch (RuntimeError &e) {
+    e.add_context("reading attributes of variable '%s' from %s", var_name.c_str(), filename().c_str());
+    throw;
+  }
+}
+
+File::WriteSession& File::write_session() const {
+  return m_impl->session;
+}
+
+//! Number of switches to define mode since the file was opened (used in regression tests).
+unsigned int File::define_mode_switches() const {
+  return m_impl->nc->define_mode_switches();
+}
+
 unsigned int File::nattributes(const std::string &var_name) const {
   try {
     int result = 0;
@@ -730,12 +768,137 @@ void File::write_distributed_array(const std::string &variable_name,
 }
 
 
+/*!
+ * Copy `input` (a contiguous array with dimensions `count`, in the file storage order) to
+ * `output` using `imap[k]` as the stride of the dimension `k` in `output`.
+ *
+ * Loops over the dimension that is contiguous in `input` and the one that is contiguous
+ * in `output` are blocked so that both reads and writes use cache lines efficiently.
+ */
+static void transpose(const double *input,
+                      const std::vector<unsigned int> &count,
+                      const std::vector<unsigned int> &imap,
+                      double *output) {
+  // strides of dimensions with more than one element
+  std::vector<size_t> n, in_stride, out_stride;
+  {
+    size_t stride = 1;
+    for (int k = (int)count.size() - 1; k >= 0; --k) {
+      if (count[k] > 1) {
+        n.insert(n.begin(), count[k]);
+        in_stride.insert(in_stride.begin(), stride);
+        out_stride.insert(out_stride.begin(), imap[k]);
+      }
+      stride *= count[k];
+    }
+  }
+
+  if (n.empty()) {
+    output[0] = input[0];
+    return;
+  }
+
+  // "a" is contiguous in input, "b" is the one with the smallest stride in output
+  const int a = n.size() - 1;
+  int b = a;
+  for (unsigned int k = 0; k < n.size(); ++k) {
+    if (out_stride[k] < out_stride[b]) {
+      b = k;
+    }
+  }
+
+  // remaining dimensions are handled by the outer loop below
+  std::vector<size_t> outer;
+  for (unsigned int k = 0; k < n.size(); ++k) {
+    if ((int)k != a and (int)k != b) {
+      outer.push_back(k);
+    }
+  }
+
+  const size_t
+    block = 32,
+    N_a   = n[a],
+    N_b   = n[b],
+    in_a  = in_stride[a],
+    in_b  = in_stride[b],
+    out_a = out_stride[a],
+    out_b = out_stride[b];
+
+  std::vector<size_t> index(outer.size(), 0);
+  while (true) {
+    size_t in_offset = 0, out_offset = 0;
+    for (unsigned int k = 0; k < outer.size(); ++k) {
+      in_offset  += index[k] * in_stride[outer[k]];
+      out_offset += index[k] * out_stride[outer[k]];
+    }
+
+    const double *in  = input + in_offset;
+    double       *out = output + out_offset;
+
+    if (a == b) {
+      for (size_t p = 0; p < N_a; ++p) {
+        out[p * out_a] = in[p];
+      }
+    } else {
+      for (size_t q0 = 0; q0 < N_b; q0 += block) {
+        const size_t q1 = std::min(q0 + block, N_b);
+        for (size_t p0 = 0; p0 < N_a; p0 += block) {
+          const size_t p1 = std::min(p0 + block, N_a);
+
+          for (size_t q = q0; q < q1; ++q) {
+            for (size_t p = p0; p < p1; ++p) {
+              out[q * out_b + p * out_a] = in[q * in_b + p * in_a];
+            }
+          }
+        }
+      }
+    }
+
+    // advance the multi-index over the outer dimensions
+    int k = (int)outer.size() - 1;
+    for (; k >= 0; --k) {
+      index[k] += 1;
+      if (index[k] < n[outer[k]]) {
+        break;
+      }
+      index[k] = 0;
+    }
+    if (k < 0) {
+      break;
+    }
+  }
+}
+
+/*!
+ * Read a variable stored in an order different from the one used by PISM.
+ *
+ * `imap[k]` is the stride (in `ip`) of the dimension `k` of the variable in the file.
+ *
+ * Reads a contiguous hyperslab (in the file storage order) into a staging buffer and
+ * transposes it in memory. This is much faster than mapped (`nc_get_varm`) access, which
+ * is slow in NetCDF and is emulated (or not supported) by some parallel I/O libraries.
+ */
 void File::read_variable_transposed(const std::string &variable_name,
                                     const std::vector<unsigned int> &start,
                                     const std::vector<unsigned int> &count,
                                     const std::vector<unsigned int> &imap, double *ip) const {
   try {
-    m_impl->nc->get_varm_double(variable_name, start, count, imap, ip);
+    if (start.size() != count.size() or start.size() != imap.size()) {
+      throw RuntimeError(PISM_ERROR_LOCATION,
+                         "start, count and imap arrays have to have the same size");
+    }
+
+    size_t size = 1;
+    for (auto c : count) {
+      size *= c;
+    }
+
+    std::vector<double> buffer(size);
+    m_impl->nc->get_vara_double(variable_name, start, count, buffer.data());
+
+    if (size > 0) {
+      transpose(buffer.data(), count, imap, ip);
+    }
   } catch (RuntimeError &e) {
     e.add_context("reading variable '%s' from '%s'", variable_name.c_str(), filename().c_str());
     throw;
@@ -1,4 +1,4 @@
-// Copyright (C) 2012, 2013, 2014, 2015, 2016, 2017, 2019 PISM Authors
+// Copyright (C) 2012, 2013, 2014, 2015, 2016, 2017, 2019, 2020 PISM Authors
 //
 // This file is part of PISM.
 //
@@ -21,6 +21,9 @@
 
 #include <vector>
 #include <string>
+#include <set>
+#include <map>
+#include <memory>
 #include <mpi.h>
 
 #include "pism/util/Units.hh"
@@ -37,6 +40,13 @@ class IceGrid;
  */
 IO_Backend string_to_backend(const std::string &backend);
 
+/*!
+ * Set the maximum size (in bytes) of input files that are read by rank 0 once, broadcast
+ * and then accessed from memory by all ranks. Applies to files read using the serial
+ * (`netcdf3`) backend. Set to zero to disable.
+ */
+void set_in_memory_size_limit(size_t size);
+
 struct VariableLookupData {
   bool exists;
   bool found_using_standard_name;
@@ -142,7 +152,32 @@ public:
 
   std::string read_text_attribute(const std::string &var_name, const std::string &att_name) const;
 
+  std::vector<Attribute> read_attributes(const std::string &var_name) const;
+
   void append_history(const std::string &history) const;
+
+  //! Information cached to speed up repeated writes to the same file.
+  /*!
+   * Used by io::define_spatial_variable() and io::write_spatial_variable().
+   *
+   * Note that this relies on the fact that PISM never deletes variables.
+   */
+  struct WriteSession {
+    //! variables known to be defined in this file
+    std::set<std::string> defined;
+    //! time-independent (and coordinate) variables known to be written
+    std::set<std::string> written;
+    //! unit converters (key: "internal units -> output units")
+    std::map<std::string, std::shared_ptr<units::Converter> > converters;
+    //! storage for data converted to output units
+    std::vector<double> buffer;
+    //! indices of saved vertical levels (empty if all levels are saved)
+    std::map<std::string, std::vector<unsigned int> > saved_levels;
+  };
+
+  WriteSession& write_session() const;
+
+  unsigned int define_mode_switches() const;
 private:
   struct Impl;
   Impl *m_impl;
@@ -1,4 +1,4 @@
-/* Copyright (C) 2014, 2015, 2018, 2019 PISM Authors
+/* Copyright (C) 2014, 2015, 2018, 2019, 2020 PISM Authors
  *
  * This file is part of PISM.
  *
@@ -20,6 +20,9 @@
 #ifndef _IO_FLAGS_H_
 #define _IO_FLAGS_H_
 
+#include <string>
+#include <vector>
+
 namespace pism {
 
 // I/O Flags used by File and NCFile. They are used in both interfaces,
@@ -65,6 +68,14 @@ enum Fill_Mode {
 
 enum RegriddingFlag {OPTIONAL, OPTIONAL_FILL_MISSING, CRITICAL, CRITICAL_FILL_MISSING};
 
+//! An attribute of a variable: a string (if type == PISM_CHAR) or a list of numbers.
+struct Attribute {
+  std::string name;
+  IO_Type type;
+  std::string text;
+  std::vector<double> numbers;
+};
+
 } // end of namespace pism
 
 #endif /* _IO_FLAGS_H_ */
@@ -1,4 +1,4 @@
-// Copyright (C) 2012, 2013, 2014, 2015, 2016, 2017, 2019 PISM Authors
+// Copyright (C) 2012, 2013, 2014, 2015, 2016, 2017, 2019, 2020 PISM Authors
 //
 // This file is part of PISM.
 //
@@ -24,7 +24,16 @@
 #define MPI_INCLUDED 1
 #endif
 #include <netcdf.h>
-#include <cstring>              // memset
+
+#include "pism/pism_config.hh"
+
+#if (Pism_HAVE_NC_OPEN_MEM==1)
+#include <netcdf_mem.h>         // nc_open_mem
+#endif
+
+#include <algorithm>            // std::min
+#include <climits>              // INT_MAX
+#include <cstring>              // memset, memcpy, strlen
 #include <cstdio>               // stderr, fprintf
 
 #include "pism/util/pism_utilities.hh" // join
@@ -50,14 +59,61 @@ static void check_and_abort(MPI_Comm com, const ErrorLocation &where, int return
   }
 }
 
+//! Input files smaller than this (in bytes) are read into memory on all ranks (0 disables).
+static size_t in_memory_size_limit = 0;
+
+/*!
+ * Set the maximum size of input files that are read once by rank 0, broadcast and then
+ * accessed from memory on all ranks. Set to zero to disable.
+ *
+ * Reading attributes and small variables from such files requires no communication.
+ */
+void NC3File::set_in_memory_size_limit(size_t size) {
+  in_memory_size_limit = size;
+}
+
+//! Return the size of `filename` in bytes or -1 if it cannot be opened.
+static long int file_size(const std::string &filename) {
+  long int result = -1;
+
+  FILE *f = fopen(filename.c_str(), "rb");
+  if (f != nullptr) {
+    if (fseek(f, 0, SEEK_END) == 0) {
+      result = ftell(f);
+    }
+    fclose(f);
+  }
+
+  return result;
+}
+
+//! Return true if `filename` will be read into memory when opened for reading. Collective.
+bool NC3File::fits_in_memory(MPI_Comm com, const std::string &filename) {
+  if (in_memory_size_limit == 0 or not Pism_HAVE_NC_OPEN_MEM) {
+    return false;
+  }
+
+  int rank = 0;
+  MPI_Comm_rank(com, &rank);
+
+  int result = 0;
+  if (rank == 0) {
+    long int size = file_size(filename);
+    result = (size > 0 and (size_t)size <= in_memory_size_limit) ? 1 : 0;
+  }
+  MPI_Bcast(&result, 1, MPI_INT, 0, com);
+
+  return result == 1;
+}
+
 NC3File::NC3File(MPI_Comm c)
-  : NCFile(c), m_rank(0) {
+  : NCFile(c), m_rank(0), m_in_memory(false) {
   MPI_Comm_rank(m_com, &m_rank);
 }
 
 NC3File::~NC3File() {
   if (m_file_id >= 0) {
-    if (m_rank == 0) {
+    if (m_rank == 0 or m_in_memory) {
       nc_close(m_file_id);
       fprintf(stderr, "NC3File::~NC3File: NetCDF file %s is still open\n",
               m_filename.c_str());
@@ -66,19 +122,107 @@ NC3File::~NC3File() {
   }
 }
 
+//! MPI_Barrier() unless every rank has a copy of the file.
+void NC3File::barrier() const {
+  if (not m_in_memory) {
+    MPI_Barrier(m_com);
+  }
+}
+
+//! Broadcast from rank 0 unless every rank has a copy of the file.
+void NC3File::broadcast(void *buffer, int count, MPI_Datatype type) const {
+  if (not m_in_memory) {
+    MPI_Bcast(buffer, count, type, 0, m_com);
+  }
+}
+
+/*!
+ * Read `filename` on rank 0 and broadcast its contents if it is smaller than the limit
+ * set using set_in_memory_size_limit().
+ *
+ * Returns true if the file was read. Collective.
+ */
+bool NC3File::read_into_memory(const std::string &filename) {
+  m_buffer.clear();
+
+  if (in_memory_size_limit == 0 or not Pism_HAVE_NC_OPEN_MEM) {
+    return false;
+  }
+
+  long int size = -1;
+  if (m_rank == 0) {
+    long int length = file_size(filename);
+
+    if (length > 0 and (size_t)length <= in_memory_size_limit) {
+      FILE *f = fopen(filename.c_str(), "rb");
+      if (f != nullptr) {
+        m_buffer.resize(length);
+        if (fread(m_buffer.data(), 1, length, f) == (size_t)length) {
+          size = length;
+        }
+        fclose(f);
+      }
+    }
+  }
+  MPI_Bcast(&size, 1, MPI_LONG, 0, m_com);
+
+  if (size < 0) {
+    m_buffer.clear();
+    return false;
+  }
+
+  m_buffer.resize(size);
+
+  // broadcast in chunks to support files with more than INT_MAX bytes
+  long int start = 0;
+  while (start < size) {
+    int count = std::min(size - start, (long int)INT_MAX);
+    MPI_Bcast(m_buffer.data() + start, count, MPI_CHAR, 0, m_com);
+    start += count;
+  }
+
+  return true;
+}
+
 // open/create/close
 void NC3File::open_impl(const std::string &fname, IO_Mode mode) {
   int stat = NC_NOERR;
 
+  m_in_memory = false;
+
+#if (Pism_HAVE_NC_OPEN_MEM==1)
+  if (mode == PISM_READONLY and read_into_memory(fname)) {
+    stat = nc_open_mem(fname.c_str(), NC_NOWRITE, m_buffer.size(), m_buffer.data(),
+                       &m_file_id);
+
+    // use the in-memory copy only if all ranks succeeded
+    int min_stat = stat;
+    MPI_Allreduce(&stat, &min_stat, 1, MPI_INT, MPI_MIN, m_com);
+
+    if (min_stat == NC_NOERR) {
+      m_in_memory = true;
+      return;
+    }
+
+    // Fall back to reading on rank 0 (nc_open_mem() may not be supported by the
+    // NetCDF library).
+    if (stat == NC_NOERR) {
+      nc_close(m_file_id);
+    }
+    m_file_id = -1;
+    m_buffer.clear();
+  }
+#endif
+
   int open_mode = mode == PISM_READONLY ? NC_NOWRITE : NC_WRITE;
 
   if (m_rank == 0) {
     stat = nc_open(fname.c_str(), open_mode, &m_file_id);
   }
 
-  MPI_Barrier(m_com);
-  MPI_Bcast(&m_file_id, 1, MPI_INT, 0, m_com);
-  MPI_Bcast(&stat, 1, MPI_INT, 0, m_com);
+  barrier();
+  broadcast(&m_file_id, 1, MPI_INT);
+  broadcast(&stat, 1, MPI_INT);
 
   check(PISM_ERROR_LOCATION, stat);
 }
@@ -87,13 +231,15 @@ void NC3File::open_impl(const std::string &fname, IO_Mode mode) {
 void NC3File::create_impl(const std::string &fname) {
   int stat = NC_NOERR;
 
+  m_in_memory = false;
+
   if (m_rank == 0) {
     stat = nc_create(fname.c_str(), NC_CLOBBER | NC_64BIT_OFFSET, &m_file_id);
   }
 
-  MPI_Barrier(m_com);
-  MPI_Bcast(&m_file_id, 1, MPI_INT, 0, m_com);
-  MPI_Bcast(&stat, 1, MPI_INT, 0, m_com);
+  barrier();
+  broadcast(&m_file_id, 1, MPI_INT);
+  broadcast(&stat, 1, MPI_INT);
 
   check(PISM_ERROR_LOCATION, stat);
 }
@@ -102,14 +248,17 @@ void NC3File::create_impl(const std::string &fname) {
 void NC3File::close_impl() {
   int stat = NC_NOERR;
 
-  if (m_rank == 0) {
+  if (m_rank == 0 or m_in_memory) {
     stat = nc_close(m_file_id);
   }
 
   m_file_id = -1;
 
-  MPI_Barrier(m_com);
-  MPI_Bcast(&stat, 1, MPI_INT, 0, m_com);
+  barrier();
+  broadcast(&stat, 1, MPI_INT);
+
+  m_in_memory = false;
+  m_buffer.clear();
 
   check(PISM_ERROR_LOCATION, stat);
 }
@@ -118,12 +267,12 @@ void NC3File::close_impl() {
 void NC3File::sync_impl() const {
   int stat = NC_NOERR;
 
-  if (m_rank == 0) {
+  if (m_rank == 0 or m_in_memory) {
     stat = nc_sync(m_file_id);
   }
 
-  MPI_Barrier(m_com);
-  MPI_Bcast(&stat, 1, MPI_INT, 0, m_com);
+  barrier();
+  broadcast(&stat, 1, MPI_INT);
 
   check(PISM_ERROR_LOCATION, stat);
 }
@@ -135,12 +284,12 @@ void NC3File::enddef_impl() const {
 
   int header_size = 200 * 1024;
 
-  if (m_rank == 0) {
+  if (m_rank == 0 or m_in_memory) {
     stat = nc__enddef(m_file_id, header_size, 4, 0, 4);
   }
 
-  MPI_Barrier(m_com);
-  MPI_Bcast(&stat, 1, MPI_INT, 0, m_com);
+  barrier();
+  broadcast(&stat, 1, MPI_INT);
 
   check(PISM_ERROR_LOCATION, stat);
 }
@@ -149,12 +298,12 @@ void NC3File::enddef_impl() const {
 void NC3File::redef_impl() const {
   int stat = NC_NOERR;
 
-  if (m_rank == 0) {
+  if (m_rank == 0 or m_in_memory) {
     stat = nc_redef(m_file_id);
   }
 
-  MPI_Barrier(m_com);
-  MPI_Bcast(&stat, 1, MPI_INT, 0, m_com);
+  barrier();
+  broadcast(&stat, 1, MPI_INT);
 
   check(PISM_ERROR_LOCATION, stat);
 }
@@ -164,13 +313,13 @@ void NC3File::redef_impl() const {
 void NC3File::def_dim_impl(const std::string &name, size_t length) const {
   int stat = NC_NOERR;
 
-  if (m_rank == 0) {
+  if (m_rank == 0 or m_in_memory) {
     int dimid;
     stat = nc_def_dim(m_file_id, name.c_str(), length, &dimid);
   }
 
-  MPI_Barrier(m_com);
-  MPI_Bcast(&stat, 1, MPI_INT, 0, m_com);
+  barrier();
+  broadcast(&stat, 1, MPI_INT);
 
   check(PISM_ERROR_LOCATION, stat);
 }
@@ -178,13 +327,13 @@ void NC3File::def_dim_impl(const std::string &name, size_t length) const {
 void NC3File::inq_dimid_impl(const std::string &dimension_name, bool &exists) const {
   int stat, flag = -1;
 
-  if (m_rank == 0) {
+  if (m_rank == 0 or m_in_memory) {
     stat = nc_inq_dimid(m_file_id, dimension_name.c_str(), &flag);
 
     flag = (stat == NC_NOERR) ? 1 : 0;
   }
-  MPI_Barrier(m_com);
-  MPI_Bcast(&flag, 1, MPI_INT, 0, m_com);
+  barrier();
+  broadcast(&flag, 1, MPI_INT);
 
   exists = (flag == 1);
 }
@@ -194,7 +343,7 @@ void NC3File::inq_dimid_impl(const std::string &dimension_name, bool &exists) co
 void NC3File::inq_dimlen_impl(const std::string &dimension_name, unsigned int &result) const {
   int stat = NC_NOERR;
 
-  if (m_rank == 0) {
+  if (m_rank == 0 or m_in_memory) {
     int dimid;
     size_t length;
 
@@ -206,9 +355,9 @@ void NC3File::inq_dimlen_impl(const std::string &dimension_name, unsigned int &r
     }
   }
 
-  MPI_Barrier(m_com);
-  MPI_Bcast(&result, 1, MPI_UNSIGNED, 0, m_com);
-  MPI_Bcast(&stat,   1, MPI_INT,      0, m_com);
+  barrier();
+  broadcast(&result, 1, MPI_UNSIGNED);
+  broadcast(&stat,   1, MPI_INT);
 
   check(PISM_ERROR_LOCATION, stat);
 }
@@ -218,7 +367,7 @@ void NC3File::inq_unlimdim_impl(std::string &result) const {
   int stat = NC_NOERR;
   std::vector<char> dimname(NC_MAX_NAME + 1, 0);
 
-  if (m_rank == 0) {
+  if (m_rank == 0 or m_in_memory) {
     int dimid;
     stat = nc_inq_unlimdim(m_file_id, &dimid);
 
@@ -231,10 +380,10 @@ void NC3File::inq_unlimdim_impl(std::string &result) const {
     }
   }
 
-  MPI_Barrier(m_com);
+  barrier();
 
-  MPI_Bcast(&stat,   1, MPI_INT, 0, m_com);
-  MPI_Bcast(dimname.data(), NC_MAX_NAME, MPI_CHAR, 0, m_com);
+  broadcast(&stat,   1, MPI_INT);
+  broadcast(dimname.data(), NC_MAX_NAME, MPI_CHAR);
 
   check(PISM_ERROR_LOCATION, stat);
 
@@ -247,7 +396,7 @@ void NC3File::def_var_impl(const std::string &name,
                            const std::vector<std::string> &dims) const {
   int stat = NC_NOERR;
 
-  if (m_rank == 0) {
+  if (m_rank == 0 or m_in_memory) {
     std::vector<int> dimids;
     int varid;
 
@@ -266,8 +415,8 @@ void NC3File::def_var_impl(const std::string &name,
     }
   }
 
-  MPI_Barrier(m_com);
-  MPI_Bcast(&stat, 1, MPI_INT, 0, m_com);
+  barrier();
+  broadcast(&stat, 1, MPI_INT);
 
   check(PISM_ERROR_LOCATION, stat);
 }
@@ -313,6 +462,32 @@ void NC3File::get_var_double(const std::string &variable_name,
     imap.resize(ndims);
   }
 
+  if (m_in_memory) {
+    // every rank has a copy of the file: read locally
+    std::vector<size_t> nc_start(ndims), nc_count(ndims);
+    std::vector<ptrdiff_t> nc_imap(ndims), nc_stride(ndims, 1);
+
+    for (int k = 0; k < ndims; ++k) {
+      nc_start[k] = start[k];
+      nc_count[k] = count[k];
+      nc_imap[k]  = imap[k];
+    }
+
+    int varid = -1;
+    stat = nc_inq_varid(m_file_id, variable_name.c_str(), &varid);
+    check_and_abort(m_com, PISM_ERROR_LOCATION, stat);
+
+    if (transposed) {
+      stat = nc_get_varm_double(m_file_id, varid, nc_start.data(), nc_count.data(),
+                                nc_stride.data(), nc_imap.data(), ip);
+    } else {
+      stat = nc_get_vara_double(m_file_id, varid, nc_start.data(), nc_count.data(), ip);
+    }
+    check_and_abort(m_com, PISM_ERROR_LOCATION, stat);
+
+    return;
+  }
+
   // get the size of the communicator
   MPI_Comm_size(m_com, &com_size);
 
@@ -478,15 +653,15 @@ void NC3File::put_vara_double_impl(const std::string &variable_name,
 void NC3File::inq_nvars_impl(int &result) const {
   int stat = NC_NOERR;
 
-  if (m_rank == 0) {
+  if (m_rank == 0 or m_in_memory) {
     stat = nc_inq_nvars(m_file_id, &result);
   }
-  MPI_Barrier(m_com);
+  barrier();
 
-  MPI_Bcast(&stat,   1, MPI_INT, 0, m_com);
+  broadcast(&stat,   1, MPI_INT);
   check(PISM_ERROR_LOCATION, stat);
 
-  MPI_Bcast(&result, 1, MPI_INT, 0, m_com);
+  broadcast(&result, 1, MPI_INT);
 }
 
 //! \brief Get dimensions a variable depends on.
@@ -495,7 +670,7 @@ void NC3File::inq_vardimid_impl(const std::string &variable_name,
   int stat, ndims, varid = -1;
   std::vector<int> dimids;
 
-  if (m_rank == 0) {
+  if (m_rank == 0 or m_in_memory) {
     stat = nc_inq_varid(m_file_id, variable_name.c_str(), &varid);
 
     if (stat == NC_NOERR) {
@@ -503,10 +678,10 @@ void NC3File::inq_vardimid_impl(const std::string &variable_name,
     }
   }
 
-  MPI_Bcast(&stat,   1, MPI_INT, 0, m_com);
+  broadcast(&stat,   1, MPI_INT);
   check(PISM_ERROR_LOCATION, stat);
 
-  MPI_Bcast(&ndims, 1, MPI_INT, 0, m_com);
+  broadcast(&ndims, 1, MPI_INT);
 
   if (ndims == 0) {
     result.clear();
@@ -516,27 +691,27 @@ void NC3File::inq_vardimid_impl(const std::string &variable_name,
   result.resize(ndims);
   dimids.resize(ndims);
 
-  if (m_rank == 0) {
+  if (m_rank == 0 or m_in_memory) {
     stat = nc_inq_vardimid(m_file_id, varid, &dimids[0]);
   }
 
-  MPI_Bcast(&stat,   1, MPI_INT, 0, m_com);
+  broadcast(&stat,   1, MPI_INT);
   check(PISM_ERROR_LOCATION, stat);
 
-  MPI_Barrier(m_com);
+  barrier();
 
   for (int k = 0; k < ndims; ++k) {
     std::vector<char> name(NC_MAX_NAME + 1, 0);
 
-    if (m_rank == 0) {
+    if (m_rank == 0 or m_in_memory) {
       stat = nc_inq_dimname(m_file_id, dimids[k], name.data());
     }
 
-    MPI_Bcast(&stat,   1, MPI_INT, 0, m_com);
+    broadcast(&stat,   1, MPI_INT);
     check(PISM_ERROR_LOCATION, stat);
 
-    MPI_Barrier(m_com);
-    MPI_Bcast(name.data(), name.size(), MPI_CHAR, 0, m_com);
+    barrier();
+    broadcast(name.data(), name.size(), MPI_CHAR);
 
     result[k] = name.data();
   }
@@ -549,7 +724,7 @@ void NC3File::inq_vardimid_impl(const std::string &variable_name,
 void NC3File::inq_varnatts_impl(const std::string &variable_name, int &result) const {
   int stat = NC_NOERR;
 
-  if (m_rank == 0) {
+  if (m_rank == 0 or m_in_memory) {
     int varid = get_varid(variable_name);
 
     if (varid >= NC_GLOBAL) {
@@ -558,25 +733,25 @@ void NC3File::inq_varnatts_impl(const std::string &variable_name, int &result) c
       stat = varid;             // LCOV_EXCL_LINE
     }
   }
-  MPI_Barrier(m_com);
+  barrier();
 
-  MPI_Bcast(&stat, 1, MPI_INT, 0, m_com);
+  broadcast(&stat, 1, MPI_INT);
   check(PISM_ERROR_LOCATION, stat);
 
-  MPI_Bcast(&result, 1, MPI_INT, 0, m_com);
+  broadcast(&result, 1, MPI_INT);
 }
 
 //! \brief Finds a variable and sets the "exists" flag.
 void NC3File::inq_varid_impl(const std::string &variable_name, bool &exists) const {
   int stat, flag = -1;
 
-  if (m_rank == 0) {
+  if (m_rank == 0 or m_in_memory) {
     stat = nc_inq_varid(m_file_id, variable_name.c_str(), &flag);
 
     flag = (stat == NC_NOERR) ? 1 : 0;
   }
-  MPI_Barrier(m_com);
-  MPI_Bcast(&flag, 1, MPI_INT, 0, m_com);
+  barrier();
+  broadcast(&flag, 1, MPI_INT);
 
   exists = (flag == 1);
 }
@@ -585,14 +760,14 @@ void NC3File::inq_varname_impl(unsigned int j, std::string &result) const {
   int stat = NC_NOERR;
   std::vector<char> varname(NC_MAX_NAME + 1, 0);
 
-  if (m_rank == 0) {
+  if (m_rank == 0 or m_in_memory) {
     stat = nc_inq_varname(m_file_id, j, varname.data());
   }
 
-  MPI_Barrier(m_com);
+  barrier();
 
-  MPI_Bcast(&stat,   1, MPI_INT, 0, m_com);
-  MPI_Bcast(varname.data(), NC_MAX_NAME, MPI_CHAR, 0, m_com);
+  broadcast(&stat,   1, MPI_INT);
+  broadcast(varname.data(), NC_MAX_NAME, MPI_CHAR);
 
   check(PISM_ERROR_LOCATION, stat);
 
@@ -611,7 +786,7 @@ void NC3File::get_att_double_impl(const std::string &variable_name,
   int varid = get_varid(variable_name);
 
   // Read and broadcast the attribute length:
-  if (m_rank == 0) {
+  if (m_rank == 0 or m_in_memory) {
     size_t attlen = 0;
 
     if (varid >= NC_GLOBAL) {
@@ -626,7 +801,7 @@ void NC3File::get_att_double_impl(const std::string &variable_name,
       len = 0;
     }
   }
-  MPI_Bcast(&len, 1, MPI_INT, 0, m_com);
+  broadcast(&len, 1, MPI_INT);
 
   if (len == 0) {
     result.clear();
@@ -636,15 +811,15 @@ void NC3File::get_att_double_impl(const std::string &variable_name,
   result.resize(len);
 
   // Now read data and broadcast stat to see if we succeeded:
-  if (m_rank == 0) {
+  if (m_rank == 0 or m_in_memory) {
     stat = nc_get_att_double(m_file_id, varid, att_name.c_str(), &result[0]);
   }
-  MPI_Bcast(&stat, 1, MPI_INT, 0, m_com);
+  broadcast(&stat, 1, MPI_INT);
 
   check(PISM_ERROR_LOCATION, stat);
 
   // Broadcast data
-  MPI_Bcast(&result[0], len, MPI_DOUBLE, 0, m_com);
+  broadcast(&result[0], len, MPI_DOUBLE);
 }
 
 // Get a text (character array) attribute on rank 0.
@@ -709,7 +884,7 @@ void NC3File::get_att_text_impl(const std::string &variable_name,
   int stat = NC_NOERR;
 
   // Read and broadcast the attribute length:
-  if (m_rank == 0) {
+  if (m_rank == 0 or m_in_memory) {
 
     int varid = get_varid(variable_name);
 
@@ -737,14 +912,14 @@ void NC3File::get_att_text_impl(const std::string &variable_name,
       stat = varid;             // LCOV_EXCL_LINE
     }
   }
-  MPI_Bcast(&stat, 1, MPI_INT, 0, m_com);
+  broadcast(&stat, 1, MPI_INT);
   check(PISM_ERROR_LOCATION, stat);
 
   int len = result.size();
-  MPI_Bcast(&len, 1, MPI_INT, 0, m_com);
+  broadcast(&len, 1, MPI_INT);
 
   result.resize(len);
-  MPI_Bcast(&result[0], len, MPI_CHAR, 0, m_com);
+  broadcast(&result[0], len, MPI_CHAR);
 }
 
 
@@ -756,7 +931,7 @@ void NC3File::put_att_double_impl(const std::string &variable_name, const std::s
                                IO_Type nctype, const std::vector<double> &data) const {
   int stat = NC_NOERR;
 
-  if (m_rank == 0) {
+  if (m_rank == 0 or m_in_memory) {
     int varid = get_varid(variable_name);
 
     if (varid >= NC_GLOBAL) {
@@ -767,8 +942,8 @@ void NC3File::put_att_double_impl(const std::string &variable_name, const std::s
     }
   }
 
-  MPI_Barrier(m_com);
-  MPI_Bcast(&stat, 1, MPI_INT, 0, m_com);
+  barrier();
+  broadcast(&stat, 1, MPI_INT);
 
   check(PISM_ERROR_LOCATION, stat);
 }
@@ -783,7 +958,7 @@ void NC3File::put_att_text_impl(const std::string &variable_name, const std::str
                                const std::string &value) const {
   int stat = NC_NOERR;
 
-  if (m_rank == 0) {
+  if (m_rank == 0 or m_in_memory) {
     int varid = get_varid(variable_name);
 
     if (varid >= NC_GLOBAL) {
@@ -793,8 +968,8 @@ void NC3File::put_att_text_impl(const std::string &variable_name, const std::str
     }
   }
 
-  MPI_Barrier(m_com);
-  MPI_Bcast(&stat, 1, MPI_INT, 0, m_com);
+  barrier();
+  broadcast(&stat, 1, MPI_INT);
 
   check(PISM_ERROR_LOCATION, stat);
 }
@@ -807,7 +982,7 @@ void NC3File::inq_attname_impl(const std::string &variable_name, unsigned int n,
   int stat = NC_NOERR;
   std::vector<char> name(NC_MAX_NAME + 1, 0);
 
-  if (m_rank == 0) {
+  if (m_rank == 0 or m_in_memory) {
     int varid = get_varid(variable_name);
 
     if (varid >= NC_GLOBAL) {
@@ -816,9 +991,9 @@ void NC3File::inq_attname_impl(const std::string &variable_name, unsigned int n,
       stat = varid;             // LCOV_EXCL_LINE
     }
   }
-  MPI_Barrier(m_com);
-  MPI_Bcast(name.data(), NC_MAX_NAME, MPI_CHAR, 0, m_com);
-  MPI_Bcast(&stat, 1, MPI_INT, 0, m_com);
+  barrier();
+  broadcast(name.data(), NC_MAX_NAME, MPI_CHAR);
+  broadcast(&stat, 1, MPI_INT);
 
   check(PISM_ERROR_LOCATION, stat);
 
@@ -832,7 +1007,7 @@ void NC3File::inq_attname_impl(const std::string &variable_name, unsigned int n,
 void NC3File::inq_atttype_impl(const std::string &variable_name, const std::string &att_name, IO_Type &result) const {
   int stat, tmp;
 
-  if (m_rank == 0) {
+  if (m_rank == 0 or m_in_memory) {
     int varid = get_varid(variable_name);
 
     if (varid >= NC_GLOBAL) {
@@ -849,27 +1024,167 @@ void NC3File::inq_atttype_impl(const std::string &variable_name, const std::stri
       stat = varid;             // LCOV_EXCL_LINE
     }
   }
-  MPI_Barrier(m_com);
-  MPI_Bcast(&tmp, 1, MPI_INT, 0, m_com);
+  barrier();
+  broadcast(&tmp, 1, MPI_INT);
 
-  MPI_Bcast(&stat, 1, MPI_INT, 0, m_com);
+  broadcast(&stat, 1, MPI_INT);
   check(PISM_ERROR_LOCATION, stat);
 
   result = nc_type_to_pism_type(tmp);
 }
 
 
+// Append a number or an array to a buffer used to broadcast attributes.
+static void pack(std::vector<char> &buffer, const void *data, size_t size) {
+  const char *begin = static_cast<const char*>(data);
+  buffer.insert(buffer.end(), begin, begin + size);
+}
+
+// Get all attributes of a variable on rank 0 and serialize them.
+static int pack_attributes(int ncid, int varid, std::vector<char> &buffer) {
+  int stat = NC_NOERR, n_attributes = 0;
+
+  stat = nc_inq_varnatts(ncid, varid, &n_attributes);
+  if (stat != NC_NOERR) {
+    return stat;
+  }
+
+  pack(buffer, &n_attributes, sizeof(int));
+
+  for (int j = 0; j < n_attributes; ++j) {
+    std::vector<char> name(NC_MAX_NAME + 1, 0);
+    stat = nc_inq_attname(ncid, varid, j, name.data());
+    if (stat != NC_NOERR) {
+      return stat;
+    }
+
+    nc_type nctype = NC_NAT;
+    stat = nc_inq_atttype(ncid, varid, name.data(), &nctype);
+    if (stat != NC_NOERR) {
+      return stat;
+    }
+
+    int type = nc_type_to_pism_type(nctype);
+    int name_length = strlen(name.data());
+
+    pack(buffer, &type, sizeof(int));
+    pack(buffer, &name_length, sizeof(int));
+    pack(buffer, name.data(), name_length);
+
+    if (type == PISM_CHAR) {
+      std::string text;
+      if (nctype == NC_CHAR) {
+        stat = get_att_text(ncid, varid, name.data(), text);
+      } else {
+        stat = get_att_string(ncid, varid, name.data(), text);
+      }
+      if (stat != NC_NOERR) {
+        return stat;
+      }
+
+      int length = text.size();
+      pack(buffer, &length, sizeof(int));
+      pack(buffer, text.data(), length);
+    } else {
+      size_t attlen = 0;
+      stat = nc_inq_attlen(ncid, varid, name.data(), &attlen);
+      if (stat != NC_NOERR) {
+        return stat;
+      }
+
+      std::vector<double> values(attlen);
+      if (attlen > 0) {
+        stat = nc_get_att_double(ncid, varid, name.data(), values.data());
+        if (stat != NC_NOERR) {
+          return stat;
+        }
+      }
+
+      int length = attlen;
+      pack(buffer, &length, sizeof(int));
+      pack(buffer, values.data(), length * sizeof(double));
+    }
+  }
+
+  return NC_NOERR;
+}
+
+// Read a number or an array from a buffer and advance the position.
+static void unpack(const std::vector<char> &buffer, size_t &position, void *data, size_t size) {
+  memcpy(data, buffer.data() + position, size);
+  position += size;
+}
+
+//! \brief Gets all attributes of a variable.
+/*!
+ * Rank 0 reads all attributes and broadcasts them in one message. This is a lot faster
+ * than broadcasting the name, type, and value of each attribute separately when a
+ * variable has many attributes (e.g. `pism_config`).
+ *
+ * Use "PISM_GLOBAL" as the "variable_name" to get global attributes.
+ */
+void NC3File::get_atts_impl(const std::string &variable_name,
+                            std::vector<Attribute> &result) const {
+  std::vector<char> buffer;
+  // stat and buffer size
+  int header[2] = {NC_NOERR, 0};
+
+  if (m_rank == 0 or m_in_memory) {
+    int varid = get_varid(variable_name);
+
+    if (varid >= NC_GLOBAL) {
+      header[0] = pack_attributes(m_file_id, varid, buffer);
+    } else {
+      header[0] = varid;        // LCOV_EXCL_LINE
+    }
+    header[1] = buffer.size();
+  }
+  broadcast(header, 2, MPI_INT);
+
+  check(PISM_ERROR_LOCATION, header[0]);
+
+  buffer.resize(header[1]);
+  broadcast(buffer.data(), header[1], MPI_CHAR);
+
+  size_t position = 0;
+  int n_attributes = 0;
+  unpack(buffer, position, &n_attributes, sizeof(int));
+
+  result.resize(n_attributes);
+  for (auto &a : result) {
+    int type = 0, name_length = 0, length = 0;
+
+    unpack(buffer, position, &type, sizeof(int));
+    a.type = static_cast<IO_Type>(type);
+
+    unpack(buffer, position, &name_length, sizeof(int));
+    a.name.assign(buffer.data() + position, name_length);
+    position += name_length;
+
+    unpack(buffer, position, &length, sizeof(int));
+    if (a.type == PISM_CHAR) {
+      a.text.assign(buffer.data() + position, length);
+      a.numbers.clear();
+      position += length;
+    } else {
+      a.text.clear();
+      a.numbers.resize(length);
+      unpack(buffer, position, a.numbers.data(), length * sizeof(double));
+    }
+  }
+}
+
 //! \brief Sets the fill mode.
 void NC3File::set_fill_impl(int fillmode, int &old_modep) const {
   int stat = NC_NOERR;
 
-  if (m_rank == 0) {
+  if (m_rank == 0 or m_in_memory) {
     stat = nc_set_fill(m_file_id, fillmode, &old_modep);
   }
 
-  MPI_Barrier(m_com);
-  MPI_Bcast(&old_modep, 1, MPI_INT, 0, m_com);
-  MPI_Bcast(&stat, 1, MPI_INT, 0, m_com);
+  barrier();
+  broadcast(&old_modep, 1, MPI_INT);
+  broadcast(&stat, 1, MPI_INT);
 
   check(PISM_ERROR_LOCATION, stat);
 }
@@ -877,11 +1192,11 @@ void NC3File::set_fill_impl(int fillmode, int &old_modep) const {
 std::string NC3File::get_format() const {
   int format;
 
-  if (m_rank == 0) {
+  if (m_rank == 0 or m_in_memory) {
     int stat = nc_inq_format(m_file_id, &format); check(PISM_ERROR_LOCATION, stat);
   }
-  MPI_Barrier(m_com);
-  MPI_Bcast(&format, 1, MPI_INT, 0, m_com);
+  barrier();
+  broadcast(&format, 1, MPI_INT);
 
   switch(format) {
   case NC_FORMAT_CLASSIC:
@@ -899,7 +1214,7 @@ std::string NC3File::get_format() const {
 void NC3File::del_att_impl(const std::string &variable_name, const std::string &att_name) const {
   int stat = NC_NOERR;
 
-  if (m_rank == 0) {
+  if (m_rank == 0 or m_in_memory) {
     int varid = get_varid(variable_name);
 
     if (varid >= NC_GLOBAL) {
@@ -907,8 +1222,8 @@ void NC3File::del_att_impl(const std::string &variable_name, const std::string &
     }
   }
 
-  MPI_Barrier(m_com);
-  MPI_Bcast(&stat, 1, MPI_INT, 0, m_com);
+  barrier();
+  broadcast(&stat, 1, MPI_INT);
 
   check(PISM_ERROR_LOCATION, stat);
 }
@@ -924,7 +1239,7 @@ int NC3File::get_varid(const std::string &variable_name) const {
     return NC_GLOBAL;
   }
 
-  if (m_rank == 0) {
+  if (m_rank == 0 or m_in_memory) {
     int varid = -2;
     int stat = nc_inq_varid(m_file_id, variable_name.c_str(), &varid);
 
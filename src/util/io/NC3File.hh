@@ -1,4 +1,4 @@
-// Copyright (C) 2012, 2013, 2014, 2015, 2017, 2019 PISM Authors
+// Copyright (C) 2012, 2013, 2014, 2015, 2017, 2019, 2020 PISM Authors
 //
 // This file is part of PISM.
 //
@@ -32,6 +32,9 @@ public:
 
   std::string get_format() const;
 
+  static void set_in_memory_size_limit(size_t size);
+  static bool fits_in_memory(MPI_Comm com, const std::string &filename);
+
 protected:
   // implementations:
   // open/create/close
@@ -99,6 +102,8 @@ protected:
 
   void inq_atttype_impl(const std::string &variable_name, const std::string &att_name, IO_Type &result) const;
 
+  void get_atts_impl(const std::string &variable_name, std::vector<Attribute> &result) const;
+
   // misc
   void set_fill_impl(int fillmode, int &old_modep) const;
 
@@ -106,6 +111,16 @@ protected:
 private:
   int m_rank;
 
+  //! true if every rank has a copy of the file (opened using nc_open_mem())
+  bool m_in_memory;
+  //! contents of the file (used if m_in_memory is true)
+  std::vector<char> m_buffer;
+
+  bool read_into_memory(const std::string &filename);
+
+  void barrier() const;
+  void broadcast(void *buffer, int count, MPI_Datatype type) const;
+
   void get_var_double(const std::string &variable_name,
                      const std::vector<unsigned int> &start,
                      const std::vector<unsigned int> &count,
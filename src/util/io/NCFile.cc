@@ -1,4 +1,4 @@
-// Copyright (C) 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019 PISM Authors
+// Copyright (C) 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019, 2020 PISM Authors
 //
 // This file is part of PISM.
 //
@@ -34,7 +34,7 @@ namespace pism {
 namespace io {
 
 NCFile::NCFile(MPI_Comm c)
-  : m_com(c), m_file_id(-1), m_define_mode(false) {
+  : m_com(c), m_file_id(-1), m_define_mode(false), m_define_mode_switches(0) {
 }
 
 NCFile::~NCFile() {
@@ -57,12 +57,14 @@ void NCFile::open(const std::string &filename, IO_Mode mode) {
   this->open_impl(filename, mode);
   m_filename = filename;
   m_define_mode = false;
+  m_define_mode_switches = 0;
 }
 
 void NCFile::create(const std::string &filename) {
   this->create_impl(filename);
   m_filename = filename;
   m_define_mode = true;
+  m_define_mode_switches = 0;
 }
 
 void NCFile::sync() const {
@@ -87,9 +89,14 @@ void NCFile::redef() const {
   if (not m_define_mode) {
     this->redef_impl();
     m_define_mode = true;
+    m_define_mode_switches += 1;
   }
 }
 
+unsigned int NCFile::define_mode_switches() const {
+  return m_define_mode_switches;
+}
+
 void NCFile::def_dim(const std::string &name, size_t length) const {
   redef();
   this->def_dim_impl(name, length);
@@ -274,6 +281,38 @@ void NCFile::inq_atttype(const std::string &variable_name,
   this->inq_atttype_impl(variable_name, att_name, result);
 }
 
+//! Get all attributes of a variable (in the order they appear in the file).
+/*!
+ * Use "PISM_GLOBAL" as the "variable_name" to get global attributes.
+ */
+void NCFile::get_atts(const std::string &variable_name,
+                      std::vector<Attribute> &result) const {
+  this->get_atts_impl(variable_name, result);
+}
+
+/*!
+ * The default implementation reads attributes one at a time.
+ */
+void NCFile::get_atts_impl(const std::string &variable_name,
+                           std::vector<Attribute> &result) const {
+  int n_attributes = 0;
+  this->inq_varnatts_impl(variable_name, n_attributes);
+
+  result.resize(n_attributes);
+  for (int j = 0; j < n_attributes; ++j) {
+    Attribute &a = result[j];
+
+    this->inq_attname_impl(variable_name, j, a.name);
+    this->inq_atttype_impl(variable_name, a.name, a.type);
+
+    if (a.type == PISM_CHAR) {
+      this->get_att_text_impl(variable_name, a.name, a.text);
+    } else {
+      this->get_att_double_impl(variable_name, a.name, a.numbers);
+    }
+  }
+}
+
 void NCFile::set_fill(int fillmode, int &old_modep) const {
   redef();
   this->set_fill_impl(fillmode, old_modep);
@@ -1,4 +1,4 @@
-// Copyright (C) 2012, 2013, 2014, 2015, 2016, 2017, 2019 PISM Authors
+// Copyright (C) 2012, 2013, 2014, 2015, 2016, 2017, 2019, 2020 PISM Authors
 //
 // This file is part of PISM.
 //
@@ -75,6 +75,9 @@ public:
 
   void redef() const;
 
+  //! Number of switches to define mode since the file was opened or created.
+  unsigned int define_mode_switches() const;
+
   // dim
   void def_dim(const std::string &name, size_t length) const;
 
@@ -139,6 +142,8 @@ public:
 
   void inq_atttype(const std::string &variable_name, const std::string &att_name, IO_Type &result) const;
 
+  void get_atts(const std::string &variable_name, std::vector<Attribute> &result) const;
+
   // misc
   void set_fill(int fillmode, int &old_modep) const;
 
@@ -221,6 +226,8 @@ protected:
 
   virtual void inq_atttype_impl(const std::string &variable_name, const std::string &att_name, IO_Type &result) const = 0;
 
+  virtual void get_atts_impl(const std::string &variable_name, std::vector<Attribute> &result) const;
+
   // misc
   virtual void set_fill_impl(int fillmode, int &old_modep) const = 0;
 
@@ -233,6 +240,7 @@ protected:                      // data members
   std::string m_filename;
 private:
   mutable bool m_define_mode;
+  mutable unsigned int m_define_mode_switches;
 };
 
 } // end of namespace io
@@ -19,6 +19,9 @@
 
 #include <memory>
 #include <cassert>
+#include <algorithm>
+#include <cstdlib>              // strtod
+#include <set>
 
 #include "io_helpers.hh"
 #include "File.hh"
@@ -327,35 +330,148 @@ static void define_dimensions(const SpatialVariableMetadata& var,
   }
 }
 
+/*!
+ * Write coordinate data if it is not written yet. Adds `name` to `not_written` if its
+ * "not_written" attribute has to be removed.
+ */
 static void write_dimension_data(const File &file, const std::string &name,
-                                 const std::vector<double> &data) {
-  bool written = file.attribute_type(name, "not_written") == PISM_NAT;
-  if (not written) {
+                                 const std::vector<double> &data,
+                                 std::vector<std::string> &not_written) {
+  auto &written = file.write_session().written;
+
+  if (name.empty() or written.find(name) != written.end()) {
+    return;
+  }
+
+  if (not file.find_dimension(name)) {
+    return;
+  }
+
+  if (file.attribute_type(name, "not_written") != PISM_NAT) {
     file.write_variable(name, {0}, {(unsigned int)data.size()}, data.data());
-    file.redef();
+    not_written.push_back(name);
+  }
+
+  written.insert(name);
+}
+
+static void write_dimensions(const SpatialVariableMetadata& var,
+                             const IceGrid& grid, const File &file,
+                             std::vector<std::string> &not_written) {
+  write_dimension_data(file, var.get_x().get_name(), grid.x(), not_written);
+  write_dimension_data(file, var.get_y().get_name(), grid.y(), not_written);
+  write_dimension_data(file, var.get_z().get_name(), var.get_levels(), not_written);
+}
+
+/*!
+ * Remove "not_written" attributes of variables in `names`.
+ *
+ * This is done *after* writing all the data so that we switch to define mode at most once
+ * per io::write_spatial_variable() call.
+ */
+static void remove_not_written(const File &file, const std::vector<std::string> &names) {
+  if (names.empty()) {
+    return;
+  }
+
+  file.redef();
+  for (const auto &name : names) {
     file.remove_attribute(name, "not_written");
   }
 }
 
-void write_dimensions(const SpatialVariableMetadata& var,
-                      const IceGrid& grid, const File &file) {
-  // x
-  std::string x_name = var.get_x().get_name();
-  if (file.find_dimension(x_name)) {
-    write_dimension_data(file, x_name, grid.x());
+/*!
+ * Indices of vertical levels of `var` to save (see `output.ice_levels`).
+ *
+ * Returns an empty vector if all levels should be saved.
+ */
+static std::vector<unsigned int> saved_levels(const SpatialVariableMetadata &var,
+                                              const Config &config) {
+  const std::vector<double> &levels = var.get_levels();
+  const std::string heights = config.get_string("output.ice_levels");
+
+  if (heights.empty() or var.get_z().get_name() != "z" or levels.size() < 2) {
+    return {};
   }
 
-  // y
-  std::string y_name = var.get_y().get_name();
-  if (file.find_dimension(y_name)) {
-    write_dimension_data(file, y_name, grid.y());
+  std::set<unsigned int> result;
+  for (const auto &h : split(heights, ',')) {
+    char *end = nullptr;
+    double z = strtod(h.c_str(), &end);
+    while (*end == ' ') {
+      ++end;
+    }
+
+    if (end == h.c_str() or *end != '\0') {
+      throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                    "invalid output.ice_levels: '%s'", heights.c_str());
+    }
+
+    // use the closest level
+    unsigned int k = std::lower_bound(levels.begin(), levels.end(), z) - levels.begin();
+    if (k == levels.size() or
+        (k > 0 and z - levels[k - 1] < levels[k] - z)) {
+      k -= 1;
+    }
+    result.insert(k);
   }
 
-  // z
-  std::string z_name = var.get_z().get_name();
-  if (file.find_dimension(z_name)) {
-    write_dimension_data(file, z_name, var.get_levels());
+  if (result.size() == levels.size()) {
+    return {};
+  }
+
+  return {result.begin(), result.end()};
+}
+
+//! Name of the dimension used to save `var` on a subset of its vertical levels.
+static std::string subset_dimension_name(const SpatialVariableMetadata &var) {
+  return var.get_z().get_name() + "_subset";
+}
+
+//! Define the dimension used to save `var` on a subset of levels. Returns its name.
+static std::string define_subset_dimension(const SpatialVariableMetadata &var,
+                                           const std::vector<unsigned int> &levels,
+                                           const File &file) {
+  auto name = subset_dimension_name(var);
+
+  if (not file.find_dimension(name)) {
+    VariableMetadata z = var.get_z();
+    z.set_name(name);
+    // used to find the full vertical grid (e.g. when re-starting)
+    z.set_string("subset_of", var.get_z().get_name());
+
+    define_dimension(file, levels.size(), z);
+    file.write_attribute(name, "not_written", PISM_INT, {1.0});
+  }
+
+  return name;
+}
+
+/*!
+ * Indices of vertical levels of `var` saved in `file`: an empty vector if `var` uses the
+ * full vertical grid.
+ */
+static std::vector<unsigned int> levels_in_file(const SpatialVariableMetadata &var,
+                                                const IceGrid &grid,
+                                                const File &file) {
+  auto name = subset_dimension_name(var);
+  auto dims = file.dimensions(var.get_name());
+
+  if (std::find(dims.begin(), dims.end(), name) == dims.end()) {
+    return {};
   }
+
+  auto result = saved_levels(var, *grid.ctx()->config());
+
+  if (result.size() != file.dimension_length(name)) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "'%s' in '%s' is saved on %d levels; "
+                                  "output.ice_levels selects %d",
+                                  var.get_name().c_str(), file.filename().c_str(),
+                                  (int)file.dimension_length(name), (int)result.size());
+  }
+
+  return result;
 }
 
 /**
@@ -551,7 +667,14 @@ void define_spatial_variable(const SpatialVariableMetadata &var,
   std::vector<std::string> dims;
   std::string name = var.get_name();
 
+  auto &defined = file.write_session().defined;
+
+  if (defined.find(name) != defined.end()) {
+    return;
+  }
+
   if (file.find_variable(name)) {
+    defined.insert(name);
     return;
   }
 
@@ -570,7 +693,13 @@ void define_spatial_variable(const SpatialVariableMetadata &var,
   dims.push_back(x);
 
   if (not z.empty()) {
-    dims.push_back(z);
+    auto levels = saved_levels(var, *grid.ctx()->config());
+
+    if (levels.empty()) {
+      dims.push_back(z);
+    } else {
+      dims.push_back(define_subset_dimension(var, levels, file));
+    }
   }
 
   assert(dims.size() > 1);
@@ -598,6 +727,8 @@ void define_spatial_variable(const SpatialVariableMetadata &var,
     // writing it more than once.
     file.write_attribute(var.get_name(), "not_written", PISM_INT, {1.0});
   }
+
+  defined.insert(name);
 }
 
 //! Read a variable from a file into an array `output`.
@@ -619,6 +750,9 @@ void read_spatial_variable(const SpatialVariableMetadata &variable,
                                   file.filename().c_str());
   }
 
+  // true if this variable is saved on a subset of vertical levels
+  bool subset = false;
+
   // Sanity check: the variable in an input file should have the expected
   // number of spatial dimensions.
   {
@@ -642,6 +776,10 @@ void read_spatial_variable(const SpatialVariableMetadata &variable,
         ++input_ndims;
       }
 
+      if (tmp == Z_AXIS and not file.read_text_attribute(d, "subset_of").empty()) {
+        subset = true;
+      }
+
       if (axes.find(tmp) != axes.end()) {
         ++matching_dim_count;
       }
@@ -663,6 +801,20 @@ void read_spatial_variable(const SpatialVariableMetadata &variable,
     }
   }
 
+  if (subset) {
+    // the variable was saved on a subset of levels (see output.ice_levels): interpolate
+    // to the current vertical grid
+    log.message(2,
+                "  Variable '%s' in '%s' is saved on a subset of vertical levels.\n"
+                "  Interpolating vertically...\n",
+                var.name.c_str(), file.filename().c_str());
+
+    SpatialVariableMetadata tmp = variable;
+    regrid_spatial_variable(tmp, grid, file, time, CRITICAL,
+                            false, true, 0.0, LINEAR, output);
+    return;
+  }
+
   // make sure we have at least one level
   const std::vector<double>& zlevels = variable.get_levels();
   unsigned int nlevels = std::max(zlevels.size(), (size_t)1);
@@ -692,6 +844,10 @@ void read_spatial_variable(const SpatialVariableMetadata &variable,
 //! \brief Write a double array to a file.
 /*!
   Converts units if internal and "glaciological" units are different.
+
+  Uses File::write_session() to avoid repeating checks, re-writing coordinate variables
+  and re-creating unit converters when writing to the same file many times (e.g. when
+  saving spatially-variable diagnostics).
  */
 void write_spatial_variable(const SpatialVariableMetadata &var,
                             const IceGrid& grid,
@@ -700,29 +856,71 @@ void write_spatial_variable(const SpatialVariableMetadata &var,
 
   auto name = var.get_name();
 
-  if (not file.find_variable(name)) {
-    throw RuntimeError::formatted(PISM_ERROR_LOCATION, "Can't find '%s' in '%s'.",
-                                  name.c_str(),
-                                  file.filename().c_str());
+  auto &session = file.write_session();
+
+  if (session.defined.find(name) == session.defined.end()) {
+    if (not file.find_variable(name)) {
+      throw RuntimeError::formatted(PISM_ERROR_LOCATION, "Can't find '%s' in '%s'.",
+                                    name.c_str(),
+                                    file.filename().c_str());
+    }
+    session.defined.insert(name);
   }
 
-  write_dimensions(var, grid, file);
+  // variables that have "not_written" attributes that should be removed
+  std::vector<std::string> not_written;
+
+  write_dimensions(var, grid, file, not_written);
 
   // avoid writing time-independent variables more than once (saves time when writing to
   // extra_files)
   if (var.get_time_independent()) {
+    if (session.written.find(name) != session.written.end()) {
+      remove_not_written(file, not_written);
+      return;
+    }
+
     bool written = file.attribute_type(var.get_name(), "not_written") == PISM_NAT;
     if (written) {
+      session.written.insert(name);
+      remove_not_written(file, not_written);
       return;
     } else {
-      file.redef();
-      file.remove_attribute(var.get_name(), "not_written");
+      not_written.push_back(name);
     }
   }
 
   // make sure we have at least one level
   unsigned int nlevels = std::max(var.get_levels().size(), (size_t)1);
 
+  // 3D variables may be saved on a subset of levels
+  auto saved = session.saved_levels.find(name);
+  if (saved == session.saved_levels.end()) {
+    saved = session.saved_levels.emplace(name, levels_in_file(var, grid, file)).first;
+  }
+
+  std::vector<double> subset;
+  if (not saved->second.empty()) {
+    const auto &levels = saved->second;
+
+    std::vector<double> z;
+    for (auto k : levels) {
+      z.push_back(var.get_levels()[k]);
+    }
+    write_dimension_data(file, subset_dimension_name(var), z, not_written);
+
+    const size_t n_columns = grid.xm() * grid.ym();
+    subset.resize(n_columns * levels.size());
+    for (size_t c = 0; c < n_columns; ++c) {
+      for (unsigned int m = 0; m < levels.size(); ++m) {
+        subset[c * levels.size() + m] = input[c * nlevels + levels[m]];
+      }
+    }
+
+    input   = subset.data();
+    nlevels = levels.size();
+  }
+
   std::string
     units               = var.get_string("units"),
     glaciological_units = var.get_string("glaciological_units");
@@ -730,21 +928,29 @@ void write_spatial_variable(const SpatialVariableMetadata &var,
   if (units != glaciological_units) {
     size_t data_size = grid.xm() * grid.ym() * nlevels;
 
-    // create a temporary array, convert to glaciological units, and
-    // save
-    std::vector<double> tmp(data_size);
-    for (size_t k = 0; k < data_size; ++k) {
-      tmp[k] = input[k];
+    auto &converter = session.converters[units + " -> " + glaciological_units];
+    if (not converter) {
+      converter.reset(new units::Converter(var.unit_system(), units, glaciological_units));
     }
 
-    units::Converter(var.unit_system(),
-                     units,
-                     glaciological_units).convert_doubles(&tmp[0], tmp.size());
+    // convert to glaciological units (using a buffer re-used by all variables written
+    // to this file) and save
+    auto &tmp = session.buffer;
+    tmp.resize(data_size);
+    std::copy(input, input + data_size, tmp.begin());
+
+    converter->convert_doubles(tmp.data(), tmp.size());
 
-    file.write_distributed_array(name, grid, nlevels, &tmp[0]);
+    file.write_distributed_array(name, grid, nlevels, tmp.data());
   } else {
     file.write_distributed_array(name, grid, nlevels, input);
   }
+
+  if (var.get_time_independent()) {
+    session.written.insert(name);
+  }
+
+  remove_not_written(file, not_written);
 }
 
 //! \brief Regrid from a NetCDF file into a distributed array `output`.
@@ -1302,20 +1508,15 @@ void read_attributes(const File &file,
     variable.clear_all_strings();
     variable.clear_all_doubles();
 
-    unsigned int nattrs = file.nattributes(variable_name);
-
-    for (unsigned int j = 0; j < nattrs; ++j) {
-      std::string attribute_name = file.attribute_name(variable_name, j);
-      IO_Type nctype = file.attribute_type(variable_name, attribute_name);
-
-      if (nctype == PISM_CHAR) {
-        variable.set_string(attribute_name,
-                            file.read_text_attribute(variable_name, attribute_name));
+    // read all attributes at once (this matters for variables with many attributes, such
+    // as pism_config)
+    for (const auto &a : file.read_attributes(variable_name)) {
+      if (a.type == PISM_CHAR) {
+        variable.set_string(a.name, a.text);
       } else {
-        variable.set_numbers(attribute_name,
-                             file.read_double_attribute(variable_name, attribute_name));
+        variable.set_numbers(a.name, a.numbers);
       }
-    } // end of for (int j = 0; j < nattrs; ++j)
+    }
   } catch (RuntimeError &e) {
     e.add_context("reading attributes of variable '%s' from '%s'",
                   variable_name.c_str(), file.filename().c_str());
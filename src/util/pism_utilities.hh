@@ -45,8 +45,6 @@ std::string filename_add_suffix(const std::string &filename,
                                 const std::string &separator,
                                 const std::string &suffix);
 
-double wall_clock_hours(MPI_Comm com, double start_time);
-
 
 // array
 bool is_increasing(const std::vector<double> &a);
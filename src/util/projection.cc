@@ -19,6 +19,7 @@
 
 #include <cstdlib>              // strtol
 #include <cmath>                // fabs
+#include <vector>
 
 #include "projection.hh"
 #include "VariableMetadata.hh"
@@ -269,21 +270,26 @@ void compute_cell_areas(const std::string &projection, IceModelVec2S &result) {
 // +-----------+
 // (sw)        (se)
 
-  double dx2 = 0.5 * grid->dx(), dy2 = 0.5 * grid->dy();
-
   IceModelVec::AccessList list(result);
 
   for (Points p(*grid); p; p.next()) {
     const int i = p.i(), j = p.j();
 
+    // distances from the grid point to cell interfaces
+    const double
+      dx_w = 0.5 * grid->spacing_x(i - 1),
+      dx_e = 0.5 * grid->spacing_x(i),
+      dy_s = 0.5 * grid->spacing_y(j - 1),
+      dy_n = 0.5 * grid->spacing_y(j);
+
     const double
       x = grid->x(i),
       y = grid->y(j);
     double
-      x_nw = x - dx2, y_nw = y + dy2,
-      x_ne = x + dx2, y_ne = y + dy2,
-      x_se = x + dx2, y_se = y - dy2,
-      x_sw = x - dx2, y_sw = y - dy2;
+      x_nw = x - dx_w, y_nw = y + dy_n,
+      x_ne = x + dx_e, y_ne = y + dy_n,
+      x_se = x + dx_e, y_se = y - dy_s,
+      x_sw = x - dx_w, y_sw = y - dy_s;
 
     PJ_COORD in, out;
 
@@ -307,77 +313,130 @@ void compute_cell_areas(const std::string &projection, IceModelVec2S &result) {
   }
 }
 
-static void compute_lon_lat(const std::string &projection,
-                            LonLat which, IceModelVec2S &result) {
-
+/*!
+ * Transform coordinates in `x` and `y` (in place) from `projection` to EPSG:4326 using one
+ * proj_trans_generic() call.
+ *
+ * On return `x` contains latitudes and `y` contains longitudes (EPSG:4326 uses the
+ * "latitude, longitude" axis order).
+ */
+static void transform_to_lat_lon(const std::string &projection,
+                                 std::vector<double> &x,
+                                 std::vector<double> &y) {
   Proj crs(projection, "EPSG:4326");
 
-// Cell layout:
-// (nw)        (ne)
-// +-----------+
-// |           |
-// |           |
-// |     o     |
-// |           |
-// |           |
-// +-----------+
-// (sw)        (se)
+  size_t N = x.size();
 
-  IceGrid::ConstPtr grid = result.grid();
+  size_t n_transformed = proj_trans_generic(*crs, PJ_FWD,
+                                            x.data(), sizeof(double), N,
+                                            y.data(), sizeof(double), N,
+                                            nullptr, 0, 0,
+                                            nullptr, 0, 0);
+  if (n_transformed != N) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "failed to transform coordinates using '%s' (%d of %d transformed)",
+                                  projection.c_str(), (int)n_transformed, (int)N);
+  }
+}
 
-  IceModelVec::AccessList list{&result};
+/*!
+ * Compute longitude and latitude of cell centers in this sub-domain.
+ *
+ * Either `lon` or `lat` may be NULL.
+ */
+static void compute_lon_lat(const std::string &projection,
+                            IceModelVec2S *lon, IceModelVec2S *lat) {
+
+  IceGrid::ConstPtr grid = lon != nullptr ? lon->grid() : lat->grid();
 
+  const int
+    xs = grid->xs(),
+    ys = grid->ys(),
+    xm = grid->xm(),
+    ym = grid->ym();
+
+  // coordinates of all cell centers in this sub-domain, in the order used by Points
+  std::vector<double> x(xm * ym), y(xm * ym);
   for (Points p(*grid); p; p.next()) {
-    const int i = p.i(), j = p.j();
+    const int i = p.i(), j = p.j(), n = (j - ys) * xm + (i - xs);
 
-    PJ_COORD in, out;
+    x[n] = grid->x(i);
+    y[n] = grid->y(j);
+  }
 
-    in.xy = {grid->x(i), grid->y(j)};
-    out = proj_trans(*crs, PJ_FWD, in);
+  transform_to_lat_lon(projection, x, y);
 
-    if (which == LONGITUDE) {
-      result(i, j) = out.lp.phi;
-    } else {
-      result(i, j) = out.lp.lam;
+  IceModelVec::AccessList list;
+  if (lon != nullptr) {
+    list.add(*lon);
+  }
+  if (lat != nullptr) {
+    list.add(*lat);
+  }
+
+  for (Points p(*grid); p; p.next()) {
+    const int i = p.i(), j = p.j(), n = (j - ys) * xm + (i - xs);
+
+    if (lat != nullptr) {
+      (*lat)(i, j) = x[n];
+    }
+    if (lon != nullptr) {
+      (*lon)(i, j) = y[n];
     }
   }
 }
 
+/*!
+ * Compute longitude or latitude of cell corners in this sub-domain.
+ */
 static void compute_lon_lat_bounds(const std::string &projection,
                                    LonLat which,
                                    IceModelVec3D &result) {
 
-  Proj crs(projection, "EPSG:4326");
-
   IceGrid::ConstPtr grid = result.grid();
 
-  double dx2 = 0.5 * grid->dx(), dy2 = 0.5 * grid->dy();
-  double x_offsets[] = {-dx2, dx2, dx2, -dx2};
-  double y_offsets[] = {-dy2, -dy2, dy2, dy2};
-
-  IceModelVec::AccessList list{&result};
+  const int
+    xs = grid->xs(),
+    ys = grid->ys(),
+    xm = grid->xm(),
+    ym = grid->ym();
 
+  // coordinates of all cell corners in this sub-domain
+  std::vector<double> x(4 * xm * ym), y(4 * xm * ym);
   for (Points p(*grid); p; p.next()) {
-    const int i = p.i(), j = p.j();
+    const int i = p.i(), j = p.j(), n = (j - ys) * xm + (i - xs);
 
     double x0 = grid->x(i), y0 = grid->y(j);
 
-    double *values = result.get_column(i, j);
+    // distances from the grid point to cell interfaces
+    const double
+      dx_w = 0.5 * grid->spacing_x(i - 1),
+      dx_e = 0.5 * grid->spacing_x(i),
+      dy_s = 0.5 * grid->spacing_y(j - 1),
+      dy_n = 0.5 * grid->spacing_y(j);
+
+    double x_offsets[] = {-dx_w, dx_e, dx_e, -dx_w};
+    double y_offsets[] = {-dy_s, -dy_s, dy_n, dy_n};
 
     for (int k = 0; k < 4; ++k) {
+      x[4 * n + k] = x0 + x_offsets[k];
+      y[4 * n + k] = y0 + y_offsets[k];
+    }
+  }
 
-      PJ_COORD in, out;
+  transform_to_lat_lon(projection, x, y);
 
-      in.xy = {x0 + x_offsets[k], y0 + y_offsets[k]};
+  const std::vector<double> &values = which == LATITUDE ? x : y;
 
-      // compute lon,lat coordinates:
-      out = proj_trans(*crs, PJ_FWD, in);
+  IceModelVec::AccessList list{&result};
 
-      if (which == LATITUDE) {
-        values[k] = out.lp.lam;
-      } else {
-        values[k] = out.lp.phi;
-      }
+  for (Points p(*grid); p; p.next()) {
+    const int i = p.i(), j = p.j(), n = (j - ys) * xm + (i - xs);
+
+    double *column = result.get_column(i, j);
+
+    for (int k = 0; k < 4; ++k) {
+      column[k] = values[4 * n + k];
     }
   }
 }
@@ -388,14 +447,26 @@ void compute_cell_areas(const std::string &projection, IceModelVec2S &result) {
   (void) projection;
 
   IceGrid::ConstPtr grid = result.grid();
-  result.set(grid->dx() * grid->dy());
+
+  if (grid->uniform()) {
+    result.set(grid->dx() * grid->dy());
+    return;
+  }
+
+  IceModelVec::AccessList list(result);
+
+  for (Points p(*grid); p; p.next()) {
+    const int i = p.i(), j = p.j();
+
+    result(i, j) = grid->cell_area(i, j);
+  }
 }
 
-static void compute_lon_lat(const std::string &projection, LonLat which,
-                            IceModelVec2S &result) {
+static void compute_lon_lat(const std::string &projection,
+                            IceModelVec2S *lon, IceModelVec2S *lat) {
   (void) projection;
-  (void) which;
-  (void) result;
+  (void) lon;
+  (void) lat;
 
   throw RuntimeError(PISM_ERROR_LOCATION, "Cannot compute longitude and latitude."
                      " Please rebuild PISM with PROJ.");
@@ -415,10 +486,16 @@ static void compute_lon_lat_bounds(const std::string &projection,
 #endif
 
 void compute_longitude(const std::string &projection, IceModelVec2S &result) {
-  compute_lon_lat(projection, LONGITUDE, result);
+  compute_lon_lat(projection, &result, nullptr);
 }
 void compute_latitude(const std::string &projection, IceModelVec2S &result) {
-  compute_lon_lat(projection, LATITUDE, result);
+  compute_lon_lat(projection, nullptr, &result);
+}
+
+//! Compute longitude and latitude using one coordinate transformation.
+void compute_lon_lat(const std::string &projection,
+                     IceModelVec2S &longitude, IceModelVec2S &latitude) {
+  compute_lon_lat(projection, &longitude, &latitude);
 }
 
 void compute_lon_bounds(const std::string &projection, IceModelVec3D &result) {
@@ -58,6 +58,9 @@ MappingInfo get_projection_info(const File &input_file, const std::string &mappi
 void compute_longitude(const std::string &projection, IceModelVec2S &result);
 void compute_latitude(const std::string &projection, IceModelVec2S &result);
 
+void compute_lon_lat(const std::string &projection,
+                     IceModelVec2S &longitude, IceModelVec2S &latitude);
+
 void compute_lon_bounds(const std::string &projection, IceModelVec3D &result);
 void compute_lat_bounds(const std::string &projection, IceModelVec3D &result);
 
@@ -0,0 +1,185 @@
+#!/usr/bin/env python3
+
+"""Tests of connected component labeling (label_components()).
+
+The implementation is compared to a pixel-by-pixel version of the same 2-scan algorithm
+(the implementation used by PISM before run extraction from bitsets was added)."""
+
+import PISM
+import numpy as np
+
+ctx = PISM.Context()
+
+mask_grounded = 2.0
+
+
+def run_union(parents, run1, run2):
+    if parents[run1] == run2 or parents[run2] == run1:
+        return
+
+    while parents[run1] != 0:
+        run1 = parents[run1]
+
+    while parents[run2] != 0:
+        run2 = parents[run2]
+
+    if run1 > run2:
+        parents[run1] = run2
+    elif run1 < run2:
+        parents[run2] = run1
+
+
+def label_reference(image, identify_icebergs):
+    "Pixel-by-pixel 2-scan labeling with run-length encoding."
+    image = np.array(image, dtype=float)
+    n_rows, n_cols = image.shape
+
+    parents, rows, columns, lengths, mask = [0], [0], [0], [0], [0]
+
+    # first scan
+    for r in range(n_rows):
+        for c in range(n_cols):
+            if image[r, c] > 0.0:
+                if c > 0 and image[r, c - 1] > 0.0:
+                    lengths[-1] += 1
+                else:
+                    parent = int(image[r - 1, c]) if r > 0 and image[r - 1, c] > 0.0 else 0
+
+                    rows.append(r)
+                    columns.append(c)
+                    lengths.append(1)
+                    parents.append(parent)
+                    mask.append(0)
+
+                run = len(parents) - 1
+
+                if r > 0 and image[r - 1, c] > 0.0:
+                    run_union(parents, int(image[r - 1, c]), run)
+
+                if abs(image[r, c] - mask_grounded) < 1e-6:
+                    mask[run] = 1
+
+                image[r, c] = run
+
+    # assign labels to runs
+    label = 0
+    grounded = [0] * len(parents)
+    for r in range(len(parents)):
+        if parents[r] == 0:
+            parents[r] = label
+            label += 1
+        else:
+            parents[r] = parents[parents[r]]
+
+        if mask[r] == 1:
+            grounded[parents[r]] = 1
+
+    # second scan
+    for r in range(1, len(parents)):
+        value = 1 - grounded[parents[r]] if identify_icebergs else parents[r]
+        image[rows[r], columns[r]:columns[r] + lengths[r]] = value
+
+    return image
+
+
+def label(image, identify_icebergs):
+    "Label `image` using PISM's label_components()."
+    n_rows, n_cols = image.shape
+
+    grid = PISM.IceGrid_Shallow(ctx.ctx, 1e5, 1e5, 0, 0, n_cols, n_rows,
+                                PISM.CELL_CENTER, PISM.NOT_PERIODIC)
+
+    mask = PISM.IceModelVec2Int(grid, "mask", PISM.WITHOUT_GHOSTS)
+    with PISM.vec.Access(nocomm=mask):
+        for (i, j) in grid.points():
+            mask[i, j] = image[j, i]
+
+    PISM.label_components(mask, identify_icebergs, mask_grounded)
+
+    return mask.numpy()
+
+
+def compare(image):
+    for identify_icebergs in [False, True]:
+        result = label(image, identify_icebergs)
+
+        if ctx.rank == 0:
+            expected = label_reference(image, identify_icebergs)
+            np.testing.assert_array_equal(result, expected)
+
+
+def random_masks_test():
+    "Labels of random masks match the pixel-by-pixel implementation"
+    rng = np.random.RandomState(0)
+
+    # sizes near multiples of 64 exercise word boundaries in row bitsets
+    shapes = [(3, 3), (3, 70), (70, 3), (7, 63), (7, 64), (7, 65), (5, 127), (5, 128),
+              (5, 129), (41, 37)]
+
+    for shape in shapes:
+        for density in [0.3, 0.6, 0.9]:
+            ice = rng.uniform(size=shape) < density
+            grounded = rng.uniform(size=shape) < 0.1
+            image = np.where(ice, np.where(grounded, mask_grounded, 1.0), 0.0)
+            compare(image)
+
+
+def periodic_patterns_test():
+    "Labels of periodic patterns (stripes, checkerboards, grids of blobs) match"
+    n_rows, n_cols = 19, 67
+    J, I = np.mgrid[0:n_rows, 0:n_cols]
+
+    patterns = [I % 2,                     # vertical stripes
+                J % 2,                     # horizontal stripes
+                (I + J) % 2,               # checkerboard: every pixel is a component
+                (I % 4 < 3) & (J % 3 < 2), # grid of rectangular blobs
+                (I % 5 == 0) | (J % 4 == 0), # one connected grid of lines
+                (I + 2 * J) % 7 < 3]        # diagonal stripes
+
+    for pattern in patterns:
+        image = np.where(pattern, 1.0, 0.0)
+        compare(image)
+
+        # mark the first column as grounded
+        image[:, 0] = np.where(image[:, 0] > 0, mask_grounded, 0.0)
+        compare(image)
+
+
+def edge_cases_test():
+    "Empty and full masks, components touching domain edges and corners"
+    n_rows, n_cols = 9, 65
+
+    empty = np.zeros((n_rows, n_cols))
+    full = np.ones((n_rows, n_cols))
+
+    # one pixel in each corner
+    corners = np.zeros((n_rows, n_cols))
+    corners[0, 0] = corners[0, -1] = corners[-1, 0] = corners[-1, -1] = 1.0
+
+    # a frame along the domain boundary, grounded in one corner
+    frame = np.zeros((n_rows, n_cols))
+    frame[0, :] = frame[-1, :] = frame[:, 0] = frame[:, -1] = 1.0
+    frame[-1, -1] = mask_grounded
+
+    # a "U" shape: two runs in one row merged by a later row
+    u_shape = np.zeros((n_rows, n_cols))
+    u_shape[:, 1] = u_shape[:, 63] = 1.0
+    u_shape[-1, 1:64] = 1.0
+
+    # runs that touch diagonally only are different components
+    diagonal = np.eye(n_rows, n_cols)
+
+    for image in [empty, full, corners, frame, u_shape, diagonal]:
+        compare(image)
+
+    # label() is collective
+    results = [label(empty, False), label(full, False), label(frame, True),
+               label(u_shape, False), label(diagonal, False)]
+
+    if ctx.rank == 0:
+        assert np.all(results[0] == 0)
+        assert np.all(results[1] == 1)
+        # all pixels on the frame belong to one grounded component
+        assert np.all(results[2][frame > 0] == 0)
+        assert np.all(results[3][u_shape > 0] == 1)
+        assert results[4].max() == n_rows
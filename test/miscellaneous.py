@@ -920,6 +920,56 @@ def vertical_extrapolation_during_regridding_test():
     import os
     os.remove("test.nc")
 
+def saved_ice_levels_test():
+    "Test saving 3D variables on a subset of levels (output.ice_levels)"
+    ctx = PISM.Context()
+    params = PISM.GridParameters(ctx.config)
+    params.Lx = 1e5
+    params.Ly = 1e5
+    params.Mx = 3
+    params.My = 3
+    params.Mz = 11
+    params.Lz = 1000
+    params.registration = PISM.CELL_CORNER
+    params.periodicity = PISM.NOT_PERIODIC
+    params.ownership_ranges_from_options(ctx.size)
+
+    z = np.linspace(0, params.Lz, params.Mz)
+    params.z[:] = z
+
+    grid = PISM.IceGrid(ctx.ctx, params)
+
+    v = PISM.IceModelVec3()
+    v.create(grid, "test", PISM.WITHOUT_GHOSTS)
+
+    with PISM.vec.Access(nocomm=[v]):
+        for (i, j) in grid.points():
+            v.set_column(i, j, z)
+
+    filename = "saved_ice_levels.nc"
+    try:
+        ctx.config.set_string("output.ice_levels", "0, 480, 1000")
+        v.dump(filename)
+        ctx.config.set_string("output.ice_levels", "")
+
+        f = PISM.File(ctx.com, filename, PISM.PISM_NETCDF3, PISM.PISM_READONLY)
+        assert f.dimension_length("z_subset") == 3
+        assert f.read_text_attribute("z_subset", "subset_of") == "z"
+        f.close()
+
+        # reading interpolates vertically (exact for a linear function)
+        w = PISM.IceModelVec3()
+        w.create(grid, "test", PISM.WITHOUT_GHOSTS)
+        w.read(filename, 0)
+
+        with PISM.vec.Access(nocomm=[w]):
+            for (i, j) in grid.points():
+                np.testing.assert_almost_equal(w.get_column_vector(i, j), z)
+    finally:
+        ctx.config.set_string("output.ice_levels", "")
+        import os
+        os.remove(filename)
+
 class PrincipalStrainRates(TestCase):
     def u_exact(self, x, y):
         "Velocity field for testing"
@@ -1219,3 +1269,100 @@ class ForcingOptions(TestCase):
         ctx.config.import_from(self.config)
 
         os.remove(self.filename)
+
+def front_band_test():
+    "FrontBand contains cells at the ice front and only those"
+
+    grid = PISM.IceGrid.Shallow(ctx.ctx, 1e5, 1e5, 0, 0, 21, 21,
+                                PISM.CELL_CENTER, PISM.NOT_PERIODIC)
+
+    # a square ice cap, an ice-free "hole" in it, and an isolated icy cell
+    icy = set((i, j) for i in range(5, 15) for j in range(5, 15))
+    icy.remove((9, 9))
+    icy.add((2, 17))
+
+    cell_type = PISM.IceModelVec2CellType(grid, "cell_type", PISM.WITH_GHOSTS)
+
+    def set_mask(icy):
+        with PISM.vec.Access(nocomm=cell_type):
+            for (i, j) in grid.points():
+                cell_type[i, j] = PISM.MASK_GROUNDED if (i, j) in icy else PISM.MASK_ICE_FREE_OCEAN
+        cell_type.update_ghosts()
+
+    def expected(icy):
+        "Cells in this sub-domain that are in the band, using the 4-point stencil"
+        result = set()
+        for (i, j) in grid.points():
+            neighbors = [(i + 1, j), (i - 1, j), (i, j + 1), (i, j - 1)]
+            if (i, j) in icy:
+                if any(n not in icy for n in neighbors):
+                    result.add((i, j))
+            elif any(n in icy for n in neighbors):
+                result.add((i, j))
+        return result
+
+    def cells(band):
+        c = list(band.cells())
+        result = list(zip(c[0::2], c[1::2]))
+        # no duplicates
+        assert len(result) == band.size()
+        assert len(set(result)) == len(result)
+        return set(result)
+
+    set_mask(icy)
+
+    band = PISM.FrontBand(grid)
+    band.reset(cell_type)
+
+    assert cells(band) == expected(icy)
+
+    # remove ice at the front, including the isolated cell, and add a cell next to it
+    icy.difference_update([(5, 5), (14, 10), (2, 17)])
+    icy.add((4, 10))
+    set_mask(icy)
+
+    band.update(cell_type)
+    assert cells(band) == expected(icy)
+
+    # the updated band is the same as the one re-built from scratch
+    band2 = PISM.FrontBand(grid)
+    band2.reset(cell_type)
+    assert list(band.cells()) == list(band2.cells())
+
+def task_graph_test():
+    "TaskGraph: the critical path of a small graph"
+
+    graph = PISM.TaskGraph()
+
+    graph.add_task("A", [], ["x"])
+    graph.add_task("B", ["x"], ["y"])
+    graph.add_task("C", ["x"], ["z"])
+    graph.add_task("D", ["y", "z"], ["w"])
+    graph.add_task("E", [], ["y"])
+    graph.add_task("F", [], ["v"])
+
+    # B and C depend on A, D depends on B and C: the critical path is A, C, D
+    graph.record("A", 1.0)
+    graph.record("B", 2.0)
+    graph.record("C", 5.0)
+    graph.record("D", 1.0)
+    # F is independent of all the other tasks
+    graph.record("F", 3.0)
+
+    assert graph.total_time() == 12.0
+    assert graph.critical_path_length() == 7.0
+    assert list(graph.critical_path()) == [1.0, 0.0, 5.0, 1.0, 0.0, 0.0]
+
+    # E overwrites y, so it has to wait for D (reading y) even though it has no inputs
+    graph.record("E", 1.0)
+
+    assert graph.total_time() == 13.0
+    assert graph.critical_path_length() == 8.0
+    assert list(graph.critical_path()) == [1.0, 0.0, 5.0, 1.0, 1.0, 0.0]
+
+    # tasks have to be defined before use
+    try:
+        graph.record("G", 1.0)
+        assert False, "failed to catch an undefined task"
+    except RuntimeError:
+        pass
@@ -0,0 +1,234 @@
+#!/usr/bin/env python3
+
+"""Tests of non-uniform (stretched) horizontal grids: grid spacing, cell areas, the
+convergence of centered finite differences, and the convergence of the SSAFD solver."""
+
+import PISM
+import numpy as np
+
+ctx = PISM.Context()
+ctx.log.set_threshold(1)
+
+L = 1e5
+
+
+def stretched(N, a=0.5):
+    "Coordinates in [-L, L] that are finer near the center of the domain."
+    xi = np.linspace(-1.0, 1.0, N)
+    return L * (xi + a * xi**3) / (1.0 + a)
+
+
+def domain(x):
+    "Returns the half-width and the center of the cell-centered domain with points x."
+    width = (x[-1] - x[0]) + 0.5 * ((x[1] - x[0]) + (x[-1] - x[-2]))
+    center = 0.5 * (x[0] + x[-1]) + 0.25 * ((x[-1] - x[-2]) - (x[1] - x[0]))
+    return 0.5 * width, center
+
+
+def create_grid(N, uniform=False):
+    P = PISM.GridParameters(ctx.config)
+    P.Mx = N
+    P.My = N
+    P.registration = PISM.CELL_CENTER
+    P.periodicity = PISM.NOT_PERIODIC
+
+    if uniform:
+        P.Lx = L
+        P.Ly = L
+        P.x0 = 0.0
+        P.y0 = 0.0
+    else:
+        x = stretched(N)
+        P.Lx, P.x0 = domain(x)
+        P.Ly, P.y0 = domain(x)
+        P.x = PISM.DoubleVector(list(x))
+        P.y = PISM.DoubleVector(list(x))
+
+    P.ownership_ranges_from_options(ctx.size)
+
+    return PISM.IceGrid(ctx.ctx, P)
+
+
+def uniform_spacing_test():
+    "Spacing and cell areas of a uniform grid are exactly dx, dy, and dx*dy"
+    grid = create_grid(11, uniform=True)
+
+    assert grid.uniform()
+
+    for i in range(-1, grid.Mx() + 1):
+        assert grid.spacing_x(i) == grid.dx()
+        assert grid.cell_width(i) == grid.dx()
+
+    for j in range(-1, grid.My() + 1):
+        assert grid.spacing_y(j) == grid.dy()
+        assert grid.cell_height(j) == grid.dy()
+
+    assert grid.cell_area(3, 5) == grid.cell_area()
+
+
+def nonuniform_spacing_test():
+    "Spacing of a non-uniform grid"
+    grid = create_grid(21)
+
+    assert not grid.uniform()
+
+    x = stretched(21)
+
+    for i in range(grid.Mx() - 1):
+        np.testing.assert_allclose(grid.x(i), x[i])
+        np.testing.assert_allclose(grid.spacing_x(i), x[i + 1] - x[i])
+
+    # dx() is the smallest spacing
+    np.testing.assert_allclose(grid.dx(), np.diff(x).min())
+
+
+def cell_area_test():
+    "Cell areas of a non-uniform grid add up to the area of the domain"
+    grid = create_grid(21)
+
+    area = 0.0
+    for (i, j) in grid.points():
+        area += grid.cell_area(i, j)
+    area = PISM.GlobalSum(grid.com, area)
+
+    x = stretched(21)
+    Lx, _ = domain(x)
+
+    np.testing.assert_allclose(area, (2 * Lx)**2)
+
+
+def diff_error(N):
+    "Maximum error of diff_x() and diff_y() at interior points"
+    grid = create_grid(N)
+
+    k = np.pi / L
+
+    f = PISM.IceModelVec2S(grid, "f", PISM.WITH_GHOSTS, 1)
+    with PISM.vec.Access(nocomm=f):
+        for (i, j) in grid.points():
+            f[i, j] = np.sin(k * grid.x(i)) * np.cos(k * grid.y(j))
+    f.update_ghosts()
+
+    error = 0.0
+    with PISM.vec.Access(nocomm=f):
+        for (i, j) in grid.points():
+            if i in (0, grid.Mx() - 1) or j in (0, grid.My() - 1):
+                continue
+
+            x = grid.x(i)
+            y = grid.y(j)
+
+            f_x = k * np.cos(k * x) * np.cos(k * y)
+            f_y = -k * np.sin(k * x) * np.sin(k * y)
+
+            error = max(error,
+                        abs(f.diff_x(i, j) - f_x),
+                        abs(f.diff_y(i, j) - f_y))
+
+    return PISM.GlobalMax(grid.com, error)
+
+
+def diff_convergence_test():
+    "Centered differences on a non-uniform grid converge with second order"
+    Ns = [21, 41, 81]
+    errors = [diff_error(N) for N in Ns]
+
+    rates = np.log2(np.array(errors[:-1]) / np.array(errors[1:]))
+
+    assert np.all(rates > 1.8), rates
+
+
+class LinearSSA(PISM.ssa.SSAExactTestCase):
+    """Linear SSA problem with the exact solution u = v0 * exp(-alpha * (x - L)), v = 0,
+    solved using SSAFD on a stretched grid."""
+
+    H0 = 500.0
+    tauc0 = 1e3
+    nu0 = PISM.util.convert(30.0, "MPa year", "Pa s")
+    v0 = PISM.util.convert(100.0, "m / year", "m / s")
+
+    def _initGrid(self):
+        self.grid = create_grid(self.Mx)
+
+    def _initPhysics(self):
+        config = self.config
+        config.set_flag("basal_resistance.pseudo_plastic.enabled", True)
+        config.set_number("basal_resistance.pseudo_plastic.q", 1.0)
+        config.set_string("stress_balance.ssa.flow_law", "isothermal_glen")
+
+        self.modeldata.setPhysics(PISM.EnthalpyConverter(config))
+
+    def _constructSSA(self):
+        return PISM.SSAFD(self.modeldata.grid)
+
+    def _initSSACoefficients(self):
+        self._allocStdSSACoefficients()
+        self._allocateBCs()
+
+        vecs = self.modeldata.vecs
+
+        vecs.land_ice_thickness.set(self.H0)
+        vecs.surface_altitude.set(self.H0)
+        vecs.bedrock_altitude.set(0.0)
+        vecs.mask.set(PISM.MASK_GROUNDED)
+        vecs.tauc.set(self.tauc0)
+
+        grid = self.grid
+        with PISM.vec.Access(nocomm=[vecs.bc_mask, vecs.vel_bc]):
+            for (i, j) in grid.points():
+                if i in (0, grid.Mx() - 1) or j in (0, grid.My() - 1):
+                    u, v = self.exactSolution(i, j, grid.x(i), grid.y(j))
+                    vecs.bc_mask[i, j] = 1
+                    vecs.vel_bc[i, j].u = u
+                    vecs.vel_bc[i, j].v = v
+                else:
+                    vecs.bc_mask[i, j] = 0
+
+    def _initSSA(self):
+        # use the strength extension everywhere to get a constant viscosity
+        se = self.ssa.strength_extension
+        se.set_notional_strength(self.nu0 * self.H0)
+        se.set_min_thickness(4000 * 10)
+
+    def exactSolution(self, i, j, x, y):
+        u_threshold = self.config.get_number("basal_resistance.pseudo_plastic.u_threshold",
+                                             "m / s")
+        alpha = np.sqrt((self.tauc0 / u_threshold) / (4 * self.nu0 * self.H0))
+        return [self.v0 * np.exp(-alpha * (x - L)), 0.0]
+
+    def error(self):
+        "Maximum error in the velocity relative to the maximum exact velocity"
+        grid = self.grid
+        velocity = self.ssa.velocity()
+
+        error = 0.0
+        with PISM.vec.Access(nocomm=velocity):
+            for (i, j) in grid.points():
+                u, v = self.exactSolution(i, j, grid.x(i), grid.y(j))
+                error = max(error,
+                            abs(velocity[i, j].u - u),
+                            abs(velocity[i, j].v - v))
+
+        u_max, _ = self.exactSolution(0, 0, -L, 0.0)
+
+        return PISM.GlobalMax(grid.com, error) / u_max
+
+
+def ssafd_error(N):
+    "Relative error of the SSAFD solution of the linear SSA problem on an N*N stretched grid"
+    problem = LinearSSA(N, N)
+    problem.setup()
+    problem.solve()
+
+    return problem.error()
+
+
+def ssafd_convergence_test():
+    "SSAFD converges with second order on a stretched grid"
+    Ns = [21, 41, 81]
+    errors = [ssafd_error(N) for N in Ns]
+
+    rates = np.log2(np.array(errors[:-1]) / np.array(errors[1:]))
+
+    assert errors[-1] < 1e-3, errors
+    assert np.all(rates > 1.5), rates
@@ -0,0 +1,162 @@
+#!/usr/bin/env python3
+
+"""Tests of the cache of the elastic load response matrix used by the Lingle-Clark bed
+deformation model (bed_deformation.lc.load_response_matrix_file).
+
+- the matrix is saved to the cache file and re-used when the model is re-created,
+- it is re-computed if the grid or the parameters of the Earth model do not match.
+"""
+
+import os
+
+import numpy as np
+
+import PISM
+
+ctx = PISM.Context()
+config = ctx.config
+
+# silence models' initialization messages
+ctx.log.set_threshold(1)
+
+config.set_number("bed_deformation.lc.grid_size_factor", 2)
+
+cache_file = "lingle_clark_lrm_cache.nc"
+variable = "elastic_lrm"
+
+
+def create_grid(N, L=1e6):
+    return PISM.IceGrid.Shallow(ctx.ctx, L, L, 0, 0, N, N,
+                                PISM.CELL_CORNER, PISM.NOT_PERIODIC)
+
+
+def lrm(grid, cache=cache_file):
+    "Elastic load response matrix on the extended grid (on rank 0)"
+    parameter = "bed_deformation.lc.load_response_matrix_file"
+    old_value = config.get_string(parameter)
+    try:
+        config.set_string(parameter, cache)
+        return PISM.LingleClark(grid).elastic_load_response_matrix().numpy()
+    finally:
+        config.set_string(parameter, old_value)
+
+
+def remove_cache():
+    if ctx.rank == 0 and os.path.exists(cache_file):
+        os.remove(cache_file)
+
+
+def attribute(name):
+    f = PISM.File(ctx.com, cache_file, PISM.PISM_NETCDF3, PISM.PISM_READONLY)
+    return f.read_double_attribute(variable, name)[0]
+
+
+def scale_cache(factor):
+    "Multiply the matrix in the cache file by `factor` to mark it."
+    f = PISM.File(ctx.com, cache_file, PISM.PISM_NETCDF3, PISM.PISM_READWRITE)
+
+    start = [0, 0]
+    count = [f.dimension_length("y_lrm"), f.dimension_length("x_lrm")]
+
+    data = np.array(f.read_variable(variable, start, count))
+    f.write_variable(variable, start, count, list(factor * data))
+    f.close()
+
+
+def cache_write_and_read_test():
+    "The load response matrix is saved to the cache file and read from it later"
+    grid = create_grid(11)
+    remove_cache()
+
+    try:
+        reference = lrm(grid, cache="")
+
+        # computes the matrix and saves it
+        A = lrm(grid)
+
+        assert os.path.exists(cache_file)
+        np.testing.assert_allclose(attribute("dx"), grid.dx())
+        np.testing.assert_allclose(attribute("dy"), grid.dy())
+
+        # The second model should use the cached matrix. Mark it to make sure that it is
+        # not re-computed.
+        scale_cache(2.0)
+        B = lrm(grid)
+    finally:
+        remove_cache()
+
+    if ctx.rank == 0:
+        np.testing.assert_equal(A, reference)
+        np.testing.assert_equal(B, 2.0 * reference)
+
+
+def cache_grid_mismatch_test():
+    "The cached load response matrix is re-computed if the grid changes"
+    grid = create_grid(11)
+    remove_cache()
+
+    try:
+        reference = lrm(grid, cache="")
+
+        # different grid spacing
+        grid2 = create_grid(11, L=2e6)
+        reference2 = lrm(grid2, cache="")
+        lrm(grid)
+        scale_cache(2.0)
+        A = lrm(grid2)
+        np.testing.assert_allclose(attribute("dx"), grid2.dx())
+
+        # different grid size
+        grid3 = create_grid(13)
+        reference3 = lrm(grid3, cache="")
+        lrm(grid)
+        scale_cache(2.0)
+        B = lrm(grid3)
+        Nx = grid3.Mx()
+        np.testing.assert_allclose(attribute("Nx"), 2 * (Nx - 1) + 1)
+
+        # back to the original grid
+        scale_cache(2.0)
+        C = lrm(grid)
+    finally:
+        remove_cache()
+
+    if ctx.rank == 0:
+        np.testing.assert_equal(A, reference2)
+        np.testing.assert_equal(B, reference3)
+        np.testing.assert_equal(C, reference)
+
+
+def cache_parameter_mismatch_test():
+    "The cached load response matrix is re-computed if Earth model parameters change"
+    grid = create_grid(11)
+    remove_cache()
+
+    def tolerance(f):
+        f.write_attribute(variable, "tolerance", PISM.PISM_DOUBLE, [1e-4])
+
+    def earth_model(f):
+        f.write_attribute(variable, "earth_model", "a different Earth model")
+
+    results = []
+    try:
+        reference = lrm(grid, cache="")
+
+        for modify in [tolerance, earth_model]:
+            lrm(grid)
+            scale_cache(2.0)
+
+            f = PISM.File(ctx.com, cache_file, PISM.PISM_NETCDF3, PISM.PISM_READWRITE)
+            modify(f)
+            f.close()
+
+            results.append(lrm(grid))
+
+            # the re-computed matrix replaced the one in the file
+            np.testing.assert_allclose(attribute("tolerance"), 1e-8)
+    finally:
+        remove_cache()
+
+    if ctx.rank == 0:
+        for A in results:
+            np.testing.assert_equal(A, reference)
@@ -573,6 +573,198 @@ class File(TestCase):
             os.remove(f)
             pass
 
+class TransposedIO(TestCase):
+    "Test reading variables stored as (time, x, y)."
+
+    def check(self, vec):
+        with PISM.vec.Access(nocomm=[vec]):
+            for (i, j) in vec.grid().points():
+                assert abs(vec[i, j] - (10 * i + j)) < 1e-12, (i, j, vec[i, j])
+
+    def test_read(self):
+        "IceModelVec2S.read() and regrid() (transposed)"
+        f = PISM.File(ctx.com(), self.filename, PISM.PISM_NETCDF3, PISM.PISM_READONLY)
+        grid = PISM.IceGrid.FromFile(ctx, f, "v", PISM.CELL_CORNER)
+        f.close()
+
+        v = PISM.IceModelVec2S(grid, "v", PISM.WITHOUT_GHOSTS)
+
+        v.read(self.filename, 0)
+        self.check(v)
+
+        v.set(0.0)
+        v.regrid(self.filename, PISM.CRITICAL)
+        self.check(v)
+
+    def setUp(self):
+        self.basename = "transposed_io_test"
+        self.filename = self.basename + ".nc"
+
+        Mx, My = 5, 7
+        v = ["{}".format(10 * i + j) for i in range(Mx) for j in range(My)]
+
+        cdl = """
+netcdf {basename} {{
+dimensions:
+  time = UNLIMITED ;
+  x = {Mx} ;
+  y = {My} ;
+variables:
+  double time(time) ;
+    time:units = "seconds since 1-1-1" ;
+  double x(x) ;
+    x:units = "m" ;
+    x:axis = "X" ;
+  double y(y) ;
+    y:units = "m" ;
+    y:axis = "Y" ;
+  double v(time, x, y) ;
+    v:units = "m" ;
+data:
+  time = 0 ;
+  x = {x} ;
+  y = {y} ;
+  v = {v} ;
+}}
+""".format(basename=self.basename, Mx=Mx, My=My,
+           x=", ".join(str(1000.0 * i) for i in range(Mx)),
+           y=", ".join(str(1000.0 * j) for j in range(My)),
+           v=", ".join(v))
+        with open(self.basename + ".cdl", "w") as f:
+            f.write(cdl)
+
+        os.system("ncgen -o %s %s.cdl" % (self.filename, self.basename))
+
+    def tearDown(self):
+        os.remove(self.basename + ".nc")
+        os.remove(self.basename + ".cdl")
+
+class ReadAttributes(TestCase):
+    "Test reading all attributes of a variable at once (File.read_attributes())."
+
+    def test_read_attributes(self):
+        "File.read_attributes() matches reading attributes one at a time"
+
+        for backend in backends:
+            f = PISM.File(ctx.com(), self.filename, backend, PISM.PISM_READONLY,
+                          ctx.pio_iosys_id())
+
+            for var in ["v", "PISM_GLOBAL"]:
+                attributes = f.read_attributes(var)
+
+                assert len(attributes) == f.nattributes(var)
+
+                for n, a in enumerate(attributes):
+                    assert a.name == f.attribute_name(var, n), (a.name, n)
+                    assert a.type == f.attribute_type(var, a.name), a.name
+
+                    if a.type == PISM.PISM_CHAR:
+                        assert a.text == f.read_text_attribute(var, a.name), a.name
+                        assert a.text == self.attributes[a.name]
+                    else:
+                        assert tuple(a.numbers) == f.read_double_attribute(var, a.name), a.name
+                        assert tuple(a.numbers) == self.attributes[a.name][1]
+            f.close()
+
+    def setUp(self):
+        self.filename = "read_attributes_test.nc"
+
+        types = {"byte" : PISM.PISM_BYTE,
+                 "short" : PISM.PISM_SHORT,
+                 "int" : PISM.PISM_INT,
+                 "float" : PISM.PISM_FLOAT,
+                 "double" : PISM.PISM_DOUBLE}
+
+        # Many attributes of each type, some with more than one value. All values are
+        # exactly representable in all these types.
+        self.attributes = {}
+        for k in range(25):
+            for name, T in types.items():
+                offset = 0.5 if T in [PISM.PISM_FLOAT, PISM.PISM_DOUBLE] else 0.0
+                values = tuple(k - 12 + m + offset for m in range(k % 3 + 1))
+                self.attributes["{}_{}".format(name, k)] = (T, values)
+            self.attributes["text_{}".format(k)] = "text attribute number {}".format(k)
+
+        f = PISM.File(ctx.com(), self.filename, PISM.PISM_NETCDF3, PISM.PISM_READWRITE_CLOBBER)
+        f.define_dimension("x", 3)
+        f.define_variable("v", PISM.PISM_DOUBLE, ["x"])
+        for var in ["v", "PISM_GLOBAL"]:
+            for name, value in self.attributes.items():
+                if isinstance(value, str):
+                    f.write_attribute(var, name, value)
+                else:
+                    f.write_attribute(var, name, value[0], value[1])
+        f.close()
+
+    def tearDown(self):
+        os.remove(self.filename)
+
+class WriteSession(TestCase):
+    "Test writing several variables to the same file (File::WriteSession)."
+
+    def check(self, vec, value):
+        with PISM.vec.Access(nocomm=[vec]):
+            for (i, j) in vec.grid().points():
+                expected = value + 10 * i + j
+                assert abs(vec[i, j] - expected) < 1e-12 * abs(expected) + 1e-12, (i, j, vec[i, j])
+
+    def set(self, vec, value):
+        with PISM.vec.Access(nocomm=[vec]):
+            for (i, j) in vec.grid().points():
+                vec[i, j] = value + 10 * i + j
+
+    def test_write_session(self):
+        "Writing several variables to the same file switches to define mode only once"
+
+        n_records = 3
+        config = ctx.config()
+
+        for backend in backends:
+            f = PISM.File(ctx.com(), self.filename, backend, PISM.PISM_READWRITE_CLOBBER,
+                          ctx.pio_iosys_id())
+            PISM.define_time(f, ctx)
+
+            for v in self.variables:
+                v.define(f)
+
+            for r in range(n_records):
+                PISM.append_time(f, config, float(r))
+                for k, v in enumerate(self.variables):
+                    self.set(v, 100 * r + k)
+                    v.write(f)
+
+            # A new file starts in define mode. We switch back to define mode once, to
+            # remove "not_written" attributes of x, y and the time-independent variable
+            # after writing them.
+            assert f.define_mode_switches() == 1, (backend_names[backend],
+                                                   f.define_mode_switches())
+            f.close()
+
+            # check that the data round-trips
+            for r in range(n_records):
+                for k, v in enumerate(self.variables):
+                    if v.metadata(0).get_time_independent() and r > 0:
+                        continue
+                    v.set(0.0)
+                    v.read(self.filename, r)
+                    self.check(v, 100 * r + k)
+
+    def setUp(self):
+        self.filename = "write_session_test.nc"
+
+        grid = PISM.testing.shallow_grid()
+
+        self.variables = []
+        for name in ["time_independent", "a", "b", "c"]:
+            v = PISM.IceModelVec2S(grid, name, PISM.WITHOUT_GHOSTS)
+            # use different internal and output units to test unit conversion
+            v.set_attrs("testing", "dummy variable for testing", "m s-1", "m year-1", "", 0)
+            v.set_time_independent(name == "time_independent")
+            self.variables.append(v)
+
+    def tearDown(self):
+        os.remove(self.filename)
+
 class StringAttribute(TestCase):
     "Test reading a NetCDF-4 string attribute."
 
@@ -591,6 +783,12 @@ class StringAttribute(TestCase):
             # multi-valued string attributes are turned into comma-separated lists
             assert "{0},{0}".format(self.attribute) == f.read_text_attribute("PISM_GLOBAL",
                                                                              "string_multi_value")
+
+            # the same, reading all attributes at once
+            text = {a.name : a.text for a in f.read_attributes("PISM_GLOBAL")}
+            assert self.attribute == text["string_attribute"]
+            assert self.attribute == text["text_attribute"]
+            assert "{0},{0}".format(self.attribute) == text["string_multi_value"]
             f.close()
 
     def setUp(self):
@@ -612,3 +810,60 @@ netcdf string_attribute_test {{
     def tearDown(self):
         os.remove(self.basename + ".nc")
         os.remove(self.basename + ".cdl")
+
+class InMemory(TestCase):
+    "Test reading files into memory (input.in_memory_size_limit)."
+
+    def check(self, vec):
+        with PISM.vec.Access(nocomm=[vec]):
+            for (i, j) in vec.grid().points():
+                assert vec[i, j] == 10 * i + j, (i, j, vec[i, j])
+
+    def test_read(self):
+        "Reading with input.in_memory_size_limit above and below the file size"
+
+        size = os.path.getsize(self.filename)
+
+        try:
+            # disabled, above the file size (read into memory), below the file size
+            for limit in [0, 2 * size, size // 2]:
+                PISM.set_in_memory_size_limit(limit)
+
+                for backend in [PISM.PISM_GUESS, PISM.PISM_NETCDF3]:
+                    f = PISM.File(ctx.com(), self.filename, backend, PISM.PISM_READONLY)
+                    assert f.nrecords() == 1
+                    assert f.find_variable("v")
+                    assert f.read_text_attribute("PISM_GLOBAL", "text_attr") == "in memory"
+                    assert f.read_double_attribute("PISM_GLOBAL", "double_attr") == (12.0,)
+                    f.close()
+
+                self.v.set(0.0)
+                self.v.read(self.filename, 0)
+                self.check(self.v)
+
+                self.v.set(0.0)
+                self.v.regrid(self.filename, PISM.CRITICAL)
+                self.check(self.v)
+        finally:
+            PISM.set_in_memory_size_limit(0)
+
+    def setUp(self):
+        self.filename = "in_memory_test.nc"
+
+        grid = PISM.testing.shallow_grid()
+        self.v = PISM.IceModelVec2S(grid, "v", PISM.WITHOUT_GHOSTS)
+        self.v.set_attrs("testing", "dummy variable for testing", "m", "m", "", 0)
+        self.v.set_time_independent(False)
+
+        with PISM.vec.Access(nocomm=[self.v]):
+            for (i, j) in grid.points():
+                self.v[i, j] = 10 * i + j
+        self.v.dump(self.filename)
+
+        f = PISM.File(ctx.com(), self.filename, PISM.PISM_NETCDF3, PISM.PISM_READWRITE)
+        f.write_attribute("PISM_GLOBAL", "text_attr", "in memory")
+        f.write_attribute("PISM_GLOBAL", "double_attr", PISM.PISM_DOUBLE, [12.0])
+        f.close()
+
+    def tearDown(self):
+        os.remove(self.filename)
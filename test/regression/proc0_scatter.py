@@ -0,0 +1,83 @@
+#!/usr/bin/env python3
+
+"""Moving fields from rank 0 using Proc0Scatter gives the same results as
+IceModelVec::get_from_proc0() on any number of MPI ranks."""
+
+import PISM
+
+ctx = PISM.Context()
+
+# a grid that is not square and has an odd number of points in both directions
+Mx, My = 23, 17
+
+
+def value(k, i, j):
+    "Value of field number k at the grid point (i, j)"
+    return 1000.0 * k + 100.0 * j + i
+
+
+def check(fields, shift=0.0):
+    grid = fields[0].grid()
+    with PISM.vec.Access(nocomm=fields):
+        for (i, j) in grid.points():
+            for k, f in enumerate(fields):
+                assert f[i, j] == value(k, i, j) + shift, (k, i, j, f[i, j])
+
+            # ghosts of the first field are updated
+            if 0 < i < Mx - 1 and 0 < j < My - 1:
+                f = fields[0]
+                assert f[i + 1, j] == value(0, i + 1, j) + shift
+                assert f[i, j - 1] == value(0, i, j - 1) + shift
+
+
+def proc0_scatter_test():
+    grid = PISM.IceGrid_Shallow(ctx.ctx, 1e5, 1e5, 0, 0, Mx, My,
+                                PISM.CELL_CENTER, PISM.NOT_PERIODIC)
+
+    fields = [PISM.IceModelVec2S(grid, "a", PISM.WITH_GHOSTS, 1),
+              PISM.IceModelVec2S(grid, "b", PISM.WITHOUT_GHOSTS),
+              PISM.IceModelVec2S(grid, "c", PISM.WITHOUT_GHOSTS)]
+
+    with PISM.vec.Access(nocomm=fields):
+        for (i, j) in grid.points():
+            for k, f in enumerate(fields):
+                f[i, j] = value(k, i, j)
+
+    # rank 0 copies (natural ordering)
+    proc0 = []
+    for f in fields:
+        v = f.allocate_proc0_copy()
+        f.put_on_proc0(v.get())
+        proc0.append(v)
+
+    scatter = PISM.Proc0Scatter(grid, len(fields))
+
+    # round trip
+    for f in fields:
+        f.set(0.0)
+    scatter.get(proc0, fields)
+    check(fields)
+
+    # rank 0 copies can be modified after get_begin()
+    for v in proc0:
+        if ctx.rank == 0:
+            v.get().shift(1.0)
+    scatter.get_begin(proc0)
+    for v in proc0:
+        if ctx.rank == 0:
+            v.get().set(-1.0)
+    for f in fields:
+        f.set(0.0)
+    scatter.get_end(fields)
+    check(fields, shift=1.0)
+
+    # the number of fields has to match
+    try:
+        scatter.get(proc0[:2], fields[:2])
+        assert False, "Proc0Scatter.get() failed to check the number of fields"
+    except RuntimeError:
+        pass
+
+
+if __name__ == "__main__":
+    proc0_scatter_test()
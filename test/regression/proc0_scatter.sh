@@ -0,0 +1,18 @@
+#!/bin/bash
+
+# Proc0Scatter: moving fields from rank 0 on 1, 2, 3 and 4 MPI ranks
+
+PISM_PATH=$1
+MPIEXEC=$2
+PISM_SOURCE_DIR=$3
+PYTHONEXEC=$5
+
+export PYTHONPATH=${PISM_PATH}/site-packages:${PYTHONPATH}
+
+set -e
+set -x
+
+for n in 1 2 3 4;
+do
+    $MPIEXEC -n $n $PYTHONEXEC $PISM_SOURCE_DIR/test/regression/proc0_scatter.py
+done
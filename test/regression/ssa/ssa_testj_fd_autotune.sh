@@ -0,0 +1,104 @@
+#!/bin/bash
+
+# SSAFD KSP and PC autotuning: picks a solver, saves it in the cache file and re-uses it in
+# a later run; solutions agree with the one computed using the default solver
+
+PISM_PATH=$1
+MPIEXEC=$2
+MPIEXEC_COMMAND="$MPIEXEC -n 2"
+
+# List of files to remove when done:
+files="foo-fd-j-default.nc foo-fd-j-autotune-1.nc foo-fd-j-autotune-2.nc foo-fd-j-default.nc~ foo-fd-j-autotune-1.nc~ foo-fd-j-autotune-2.nc~ ssafd-autotune-cache.nc test-J-default.txt test-J-autotune-1.txt test-J-autotune-2.txt"
+
+rm -f $files
+
+set -e
+
+OPTS="-verbose 2 -ssa_method fd -Mx 61 -My 61"
+AUTOTUNE="-ssafd_autotune -ssafd_autotune_cache ssafd-autotune-cache.nc"
+
+# reference run using the default solver
+$MPIEXEC_COMMAND $PISM_PATH/ssa_testj $OPTS -o foo-fd-j-default.nc > test-J-default.txt
+# the first run tries all combinations and saves the choice
+$MPIEXEC_COMMAND $PISM_PATH/ssa_testj $OPTS $AUTOTUNE -o foo-fd-j-autotune-1.nc > test-J-autotune-1.txt
+# the second run re-uses it
+$MPIEXEC_COMMAND $PISM_PATH/ssa_testj $OPTS $AUTOTUNE -o foo-fd-j-autotune-2.nc > test-J-autotune-2.txt
+
+set +e
+
+# The first run tried all combinations, the second one did not.
+grep -q "SSAFD: trying" test-J-autotune-1.txt
+if [ $? != 0 ];
+then
+    exit 1
+fi
+
+grep -q "SSAFD: trying" test-J-autotune-2.txt
+if [ $? == 0 ];
+then
+    exit 1
+fi
+
+# The cache file contains a valid choice for this grid and number of MPI ranks, and both
+# runs used it.
+choice=$(/usr/bin/env python3 <<EOF
+from netCDF4 import Dataset as NC
+
+choices = ["gmres+bjacobi+ilu", "gmres+bjacobi+lu", "gmres+asm+ilu", "gmres+asm+lu",
+           "bcgs+bjacobi+ilu"]
+
+with NC("ssafd-autotune-cache.nc", "r") as nc:
+    choice = nc.getncattr("ssafd_Mx61_My61_ranks2")
+
+if choice in choices:
+    print(choice)
+EOF
+)
+
+if [ -z "$choice" ];
+then
+    exit 1
+fi
+
+grep -q -F "SSAFD: using $choice" test-J-autotune-1.txt
+if [ $? != 0 ];
+then
+    exit 1
+fi
+
+grep -q -F "SSAFD: using $choice (read from 'ssafd-autotune-cache.nc')" test-J-autotune-2.txt
+if [ $? != 0 ];
+then
+    exit 1
+fi
+
+# Solutions computed using the chosen solver agree with the one computed using the
+# default solver. Picard iterations stop when the relative change in nu*H is below 1e-4,
+# so we allow a relative difference (with respect to the maximum speed) of 1e-3.
+/usr/bin/env python3 <<EOF
+from netCDF4 import Dataset as NC
+import numpy as np
+from sys import exit
+
+def velocity(filename):
+    with NC(filename, "r") as nc:
+        return np.array(nc.variables["u_ssa"][:]), np.array(nc.variables["v_ssa"][:])
+
+u0, v0 = velocity("foo-fd-j-default.nc")
+scale = np.max(np.sqrt(u0**2 + v0**2))
+
+for filename in ["foo-fd-j-autotune-1.nc", "foo-fd-j-autotune-2.nc"]:
+    u, v = velocity(filename)
+    difference = max(np.max(np.abs(u - u0)), np.max(np.abs(v - v0))) / scale
+    if difference > 1e-3:
+        print("%s: relative difference %e exceeds 1e-3" % (filename, difference))
+        exit(1)
+exit(0)
+EOF
+
+if [ $? != 0 ];
+then
+    exit 1
+fi
+
+rm -f $files; exit 0
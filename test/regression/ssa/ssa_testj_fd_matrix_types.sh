@@ -0,0 +1,37 @@
+#!/bin/bash
+
+# SSAFD: AIJ, BAIJ and SELL matrix formats give the same results (verification test J)
+
+PISM_PATH=$1
+MPIEXEC=$2
+MPIEXEC_COMMAND="$MPIEXEC -n 2"
+
+# List of files to remove when done:
+files="foo-fd-j-matrix.nc foo-fd-j-matrix.nc~ test-J-aij.txt test-J-baij.txt test-J-sell.txt"
+
+rm -f $files
+
+set -e
+
+OPTS="-verbose 1 -ssa_method fd -o foo-fd-j-matrix.nc -Mx 61 -My 61"
+
+$MPIEXEC_COMMAND $PISM_PATH/ssa_testj $OPTS -ssafd_matrix_type aij > test-J-aij.txt
+$MPIEXEC_COMMAND $PISM_PATH/ssa_testj $OPTS -ssafd_matrix_type baij > test-J-baij.txt
+$MPIEXEC_COMMAND $PISM_PATH/ssa_testj $OPTS -ssafd_matrix_type sell > test-J-sell.txt
+
+set +e
+
+# Check results:
+diff test-J-aij.txt test-J-baij.txt
+if [ $? != 0 ];
+then
+    exit 1
+fi
+
+diff test-J-aij.txt test-J-sell.txt
+if [ $? != 0 ];
+then
+    exit 1
+fi
+
+rm -f $files; exit 0
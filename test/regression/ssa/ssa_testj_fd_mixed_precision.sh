@@ -0,0 +1,36 @@
+#!/bin/bash
+
+# SSAFD with the single precision preconditioner (verification test J); errors relative to
+# the exact solution have to match the ones obtained using the default preconditioner
+
+PISM_PATH=$1
+MPIEXEC=$2
+MPIEXEC_COMMAND="$MPIEXEC -n 2"
+
+# List of files to remove when done:
+files="foo-fd-j-mixed.nc foo-fd-j-mixed.nc~ test-J-out-fd-mixed.txt"
+
+rm -f $files
+
+set -e
+
+OPTS="-verbose 1 -ssa_method fd -ssafd_mixed_precision -o foo-fd-j-mixed.nc"
+
+$MPIEXEC_COMMAND $PISM_PATH/ssa_testj -Mx 61 -My 61 $OPTS > test-J-out-fd-mixed.txt
+
+set +e
+
+# Check results:
+diff test-J-out-fd-mixed.txt -  <<END-OF-OUTPUT
+NUMERICAL ERRORS in velocity relative to exact solution:
+velocity  :  maxvector   prcntavvec      maxu      maxv       avu       avv
+                0.2888      0.08782    0.2584    0.1457    0.1158    0.0933
+NUM ERRORS DONE
+END-OF-OUTPUT
+
+if [ $? != 0 ];
+then
+    exit 1
+fi
+
+rm -f $files; exit 0
@@ -0,0 +1,103 @@
+#!/bin/bash
+
+echo "Test: staging automatic backups in a separate directory."
+PISM_PATH=$1
+MPIEXEC=$2
+
+# "local" and "global" storage tiers; two runs writing backups with the same name share
+# the staging directory
+dirs="local-backups global-a global-b"
+files="in-backups.nc old-a.nc restart-backups.log"
+
+rm -rf $dirs $files
+mkdir -p $dirs
+
+set -e -x
+
+# generate an input file
+$PISM_PATH/pisms -Mx 11 -My 11 -Mz 11 -y 1000 -o in-backups.nc
+
+# write a backup after every time step
+for run in a b;
+do
+  $MPIEXEC -n 2 $PISM_PATH/pismr -i in-backups.nc -y 100 -max_dt 10 \
+           -backup_interval 0 -backup_staging_dir local-backups \
+           -o global-$run/out.nc
+done
+
+set +x
+
+# Finds the staged copy of a backup file. Fails unless there is exactly one.
+function staged_copy() {
+  /usr/bin/env python3 - "$1" <<PYEND
+import os, sys, glob
+from netCDF4 import Dataset
+
+backup = os.path.realpath(sys.argv[1])
+staged = [f for f in glob.glob("local-backups/*.nc")
+          if Dataset(f).getncattr("pism_backup_file") == backup]
+if len(staged) != 1:
+    sys.exit("expected one staged copy of %s, got %s" % (backup, staged))
+print(staged[0])
+PYEND
+}
+
+# the staged copies did not collide and the last backups were copied to their final
+# locations
+for run in a b;
+do
+  staged=$(staged_copy global-$run/out_backup.nc) || exit 1
+  cmp $staged global-$run/out_backup.nc || exit 1
+done
+
+staged_a=$(staged_copy global-a/out_backup.nc) || exit 1
+staged_b=$(staged_copy global-b/out_backup.nc) || exit 1
+
+# pretend that the run "a" was stopped before the last backup was copied (the backup file
+# is from the same run but older) and that the run "b" was stopped before the first one
+# was copied
+/usr/bin/env python3 <<PYEND
+from netCDF4 import Dataset
+f = Dataset("global-a/out_backup.nc", "a")
+f.variables["time"][-1] -= 1.0
+f.close()
+PYEND
+cp global-a/out_backup.nc old-a.nc
+rm global-b/out_backup.nc
+
+set -e -x
+
+# re-starting from these backups should use the (newer) staged copies
+for run in a b;
+do
+  $MPIEXEC -n 2 $PISM_PATH/pismr -i global-$run/out_backup.nc -y 0 \
+           -backup_staging_dir local-backups \
+           -o global-$run/restarted.nc
+done
+
+set +x +e
+
+cmp $staged_a global-a/out_backup.nc || exit 1
+cmp $staged_b global-b/out_backup.nc || exit 1
+# the original backup was not overwritten
+cmp old-a.nc global-a/out_backup.nc.bak || exit 1
+
+set -e -x
+
+# a later run (without staging) writes an older backup with the same name
+$MPIEXEC -n 2 $PISM_PATH/pismr -i in-backups.nc -y 10 -max_dt 10 \
+         -backup_interval 0 -o global-a/out.nc
+cp global-a/out_backup.nc old-a.nc
+
+# the staged copy left by the first run must not be used
+$MPIEXEC -n 2 $PISM_PATH/pismr -i global-a/out_backup.nc -y 0 \
+         -backup_staging_dir local-backups \
+         -o global-a/restarted.nc > restart-backups.log
+
+set +x +e
+
+cat restart-backups.log
+cmp old-a.nc global-a/out_backup.nc || exit 1
+grep -q "Using the staged copy" restart-backups.log && exit 1
+
+rm -rf $dirs $files; exit 0
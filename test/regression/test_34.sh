@@ -0,0 +1,83 @@
+#!/bin/bash
+
+PISM_PATH=$1
+MPIEXEC=$2
+
+# Test name:
+echo "Test #34: implicit horizontal advection in the energy balance (EISMINT II and test K)."
+# The list of files to delete when done.
+files="explicit-34.nc implicit-34.nc explicit-enth-34.nc implicit-enth-34.nc ts-explicit-34.nc ts-implicit-34.nc ts-explicit-enth-34.nc ts-implicit-enth-34.nc test-K-34.txt"
+
+rm -f $files
+
+set -e
+set -x
+
+# EISMINT II experiment A; -max_dt ensures that both runs take the same time steps
+# (it starts with no ice, so time series are saved starting at year 100)
+OPTS="-eisII A -Mx 31 -My 31 -Mz 31 -y 1000 -max_dt 10 -o_size small"
+TS="-ts_vars ice_volume,ice_enthalpy -ts_times 100:100:1000"
+
+# cold ice (temperature-based) model
+$MPIEXEC -n 2 $PISM_PATH/pisms $OPTS $TS -ts_file ts-explicit-34.nc -o explicit-34.nc
+$MPIEXEC -n 2 $PISM_PATH/pisms $OPTS $TS -ts_file ts-implicit-34.nc -energy_implicit_advection -o implicit-34.nc
+
+# enthalpy-based model
+$MPIEXEC -n 2 $PISM_PATH/pisms $OPTS $TS -ts_file ts-explicit-enth-34.nc -energy enthalpy -o explicit-enth-34.nc
+$MPIEXEC -n 2 $PISM_PATH/pisms $OPTS $TS -ts_file ts-implicit-enth-34.nc -energy enthalpy -energy_implicit_advection -o implicit-enth-34.nc
+
+set +x
+set +e
+
+# Compare total ice volume and enthalpy. Both runs take the same (short) time steps and
+# differ only in the time discretization of the first-order upwinded horizontal advection
+# term, so the difference is O(dt) and small compared to the totals: we require the
+# relative difference to be below 1e-4 at all times.
+for mode in "" "-enth";
+do
+/usr/bin/env python3 <<EOF
+from numpy import abs
+from sys import exit
+from netCDF4 import Dataset
+
+explicit = Dataset("ts-explicit${mode}-34.nc", 'r')
+implicit = Dataset("ts-implicit${mode}-34.nc", 'r')
+
+tolerance = 1e-4
+status = 0
+for name in ["ice_volume", "ice_enthalpy"]:
+    a = explicit.variables[name][:]
+    b = implicit.variables[name][:]
+    difference = (abs(a - b) / abs(a)).max()
+    if difference > tolerance:
+        print("%s: relative difference %e > %e" % (name, difference, tolerance))
+        status = 1
+    else:
+        print("%s: relative difference %e" % (name, difference))
+
+exit(status)
+EOF
+
+if [ $? != 0 ];
+then
+    exit 1
+fi
+done
+
+# test K has no horizontal flow, so implicit advection should not change results (see test_18.sh)
+OPTS="-test K -Mx 4 -My 4 -y 13000.0 -Lbz 1000 -z_spacing equal -verbose 1 -o_size none"
+$PISM_PATH/pismv -Mz 41 -Mbz 11 -max_dt 60.0 $OPTS -energy_implicit_advection > test-K-34.txt
+
+diff test-K-34.txt -  <<END-OF-OUTPUT
+NUMERICAL ERRORS evaluated at final time (relative to exact solution):
+temp      :        maxT         avT       maxTb        avTb
+               0.005298    0.002065    0.001899    0.001297
+NUM ERRORS DONE
+END-OF-OUTPUT
+
+if [ $? != 0 ];
+then
+    exit 1
+fi
+
+rm -f $files; exit 0
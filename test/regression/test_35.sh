@@ -0,0 +1,38 @@
+#!/bin/bash
+
+PISM_PATH=$1
+MPIEXEC=$2
+
+# Test name:
+echo "Test #35: lazy allocation of 2D and 3D fields does not change results."
+# The list of files to delete when done.
+files="eager-35.nc lazy-35.nc lazy-35.txt"
+
+rm -f $files
+
+set -e
+set -x
+
+OPTS="-eisII A -Mx 31 -My 31 -Mz 31 -y 1000 -o_size small"
+
+$MPIEXEC -n 2 $PISM_PATH/pisms $OPTS -o eager-35.nc
+$MPIEXEC -n 2 $PISM_PATH/pisms $OPTS -lazy_allocation -o lazy-35.nc > lazy-35.txt
+
+set +x
+set +e
+
+# check that the report was printed
+grep -q "Lazy allocation:" lazy-35.txt
+if [ $? != 0 ];
+then
+    exit 1
+fi
+
+# compare results
+$PISM_PATH/nccmp.py -v thk,temp eager-35.nc lazy-35.nc
+if [ $? != 0 ];
+then
+    exit 1
+fi
+
+rm -f $files; exit 0
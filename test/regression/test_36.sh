@@ -0,0 +1,69 @@
+#!/bin/bash
+
+PISM_PATH=$1
+MPIEXEC=$2
+
+# Test name:
+echo "Test #36: scalar time-series written in several flushes and appended to after a re-start."
+# The list of files to delete when done.
+files="ts-whole-36.nc ts-split-36.nc ts-split-36.nc~ whole-36.nc part1-36.nc part2-36.nc"
+
+rm -f $files
+
+set -e
+set -x
+
+OPTS="-eisII A -Mx 21 -My 21 -Mz 21 -max_dt 10"
+# a small buffer makes PISM flush time-series several times during a run
+TS="-ts_vars ice_volume,ice_mass,tendency_of_ice_mass_due_to_surface_mass_flux -ts_times 0:100:1000 -output.timeseries.buffer_size 3"
+
+# one run from 0 to 1000 years
+$MPIEXEC -n 2 $PISM_PATH/pisms $OPTS $TS -ys 0 -ye 1000 -ts_file ts-whole-36.nc -o whole-36.nc -o_size small
+
+# the same run split in two, the second one appending to the same time-series file
+$MPIEXEC -n 2 $PISM_PATH/pisms $OPTS $TS -ys 0 -ye 500 -ts_file ts-split-36.nc -o part1-36.nc -o_size big
+$MPIEXEC -n 2 $PISM_PATH/pisms -i part1-36.nc -max_dt 10 $TS -ye 1000 -ts_file ts-split-36.nc -ts_append -o part2-36.nc -o_size small
+
+set +x
+set +e
+
+# Times and time bounds have to match exactly. Values may differ slightly because
+# re-starting changes time steps, but they have to be in the right records.
+/usr/bin/env python3 <<EOF
+import numpy as np
+from sys import exit
+from netCDF4 import Dataset
+
+whole = Dataset("ts-whole-36.nc", 'r')
+split = Dataset("ts-split-36.nc", 'r')
+
+status = 0
+for name in ["time", "time_bounds"]:
+    a = whole.variables[name][:]
+    b = split.variables[name][:]
+    if a.shape != b.shape or np.any(a != b):
+        print("%s: %s != %s" % (name, a, b))
+        status = 1
+
+# consecutive records: each reporting interval starts where the previous one ends
+bounds = whole.variables["time_bounds"][:]
+if len(bounds) != 10 or np.any(bounds[1:, 0] != bounds[:-1, 1]):
+    print("unexpected time bounds: %s" % bounds)
+    status = 1
+
+for name in ["ice_volume", "ice_mass", "tendency_of_ice_mass_due_to_surface_mass_flux"]:
+    a = whole.variables[name][:]
+    b = split.variables[name][:]
+    if a.shape != b.shape or not np.allclose(a, b, rtol=1e-6):
+        print("%s: %s != %s" % (name, a, b))
+        status = 1
+
+exit(status)
+EOF
+
+if [ $? != 0 ];
+then
+    exit 1
+fi
+
+rm -f $files; exit 0
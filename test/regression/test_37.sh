@@ -0,0 +1,92 @@
+#!/bin/bash
+
+PISM_PATH=$1
+MPIEXEC=$2
+
+# Test name:
+echo "Test #37: fused updates of time-averaged diagnostics do not change results."
+# The list of files to delete when done.
+files="boot-37.nc fused-37.nc unfused-37.nc ex-fused-37.nc ex-unfused-37.nc"
+
+rm -f $files
+
+set -e
+
+# Create a bootstrapping file: a dome on a bed sloping down below sea level, with floating
+# ice near the margin (to get non-zero basal_mass_flux_floating and grounding_line_flux).
+/usr/bin/env python3 <<EOF
+import numpy as np
+from netCDF4 import Dataset
+
+M = 41
+L = 500e3
+x = np.linspace(-L, L, M)
+xx, yy = np.meshgrid(x, x)
+r = np.sqrt(xx**2 + yy**2)
+
+nc = Dataset("boot-37.nc", "w")
+for name in ["x", "y"]:
+    nc.createDimension(name, M)
+    v = nc.createVariable(name, "f8", (name,))
+    v.units = "m"
+    v[:] = x
+
+def var(name, units, data):
+    v = nc.createVariable(name, "f8", ("y", "x"))
+    v.units = units
+    v[:] = data
+
+var("topg", "m", 500.0 - r / 250.0)
+var("thk", "m", np.where(r < 200e3, 1000.0, np.where(r < 300e3, 500.0, 0.0)))
+var("climatic_mass_balance", "kg m-2 year-1", 300.0 * np.ones_like(r))
+var("ice_surface_temp", "Kelvin", 248.0 * np.ones_like(r))
+nc.close()
+EOF
+
+set -x
+
+VARS="tendency_of_ice_amount,tendency_of_ice_mass,tendency_of_ice_amount_due_to_flow,tendency_of_ice_amount_due_to_surface_mass_flux,tendency_of_ice_amount_due_to_basal_mass_flux,tendency_of_ice_mass_due_to_basal_mass_flux,tendency_of_ice_amount_due_to_discharge,basal_mass_flux_grounded,basal_mass_flux_floating,grounding_line_flux"
+
+OPTS="-i boot-37.nc -bootstrap -Mx 41 -My 41 -Mz 21 -Lz 2000 -ys 0 -y 20 -max_dt 1 \
+      -surface given -surface_given_file boot-37.nc -stress_balance ssa+sia -ssa_method fd \
+      -extra_times 0:5:20 -extra_vars $VARS -o_size small"
+
+$MPIEXEC -n 2 $PISM_PATH/pismr $OPTS -extra_file ex-fused-37.nc -o fused-37.nc
+$MPIEXEC -n 2 $PISM_PATH/pismr $OPTS -output.fused_diagnostic_updates no \
+         -extra_file ex-unfused-37.nc -o unfused-37.nc
+
+set +x
+set +e
+
+# Updating all accumulators in one sweep and one at a time has to produce identical results.
+$PISM_PATH/nccmp.py -x -v timestamp ex-fused-37.nc ex-unfused-37.nc
+if [ $? != 0 ];
+then
+    exit 1
+fi
+
+# BMBSplit and GroundingLineFlux are not fused. Make sure that this setup exercises them.
+/usr/bin/env python3 <<EOF
+import numpy as np
+from sys import exit
+from netCDF4 import Dataset
+
+nc = Dataset("ex-fused-37.nc", "r")
+
+status = 0
+for name in ["basal_mass_flux_floating", "grounding_line_flux",
+             "tendency_of_ice_amount_due_to_basal_mass_flux"]:
+    data = nc.variables[name][:].filled(0.0)
+    if np.abs(data).max() == 0.0:
+        print("%s is zero everywhere: this test is not meaningful" % name)
+        status = 1
+
+exit(status)
+EOF
+
+if [ $? != 0 ];
+then
+    exit 1
+fi
+
+rm -f $files; exit 0